@@ -3,8 +3,12 @@
  *
  * Features:
  * - Full NATS client with NKEYS authentication
- * - Publishes device status and sensor data
- * - Subscribes to command topics
+ * - Publishes device status and sensor data (sensors at-least-once via
+ *   JetStream when the server has it)
+ * - Samples sensors at a fixed rate and publishes windowed aggregates
+ *   (JSON, or an optional compact binary encoding)
+ * - Subscribes to command topics; commands sent as requests are answered
+ *   on their reply subject
  * - Auto-reconnect with exponential backoff
  * - Integrates with Octavia NATS server (192.168.4.38:4222)
  *
@@ -17,6 +21,19 @@
 #include <WiFiClient.h>
 #include <HTTPClient.h>
 #include <ArduinoJson.h>
+#include <JsonWriter.h>
+#include <OutboundJournal.h>
+#include <NatsParser.h>
+#include <NatsOutbox.h>
+#include <OfflineRing.h>
+#include <NatsInbox.h>
+#include <JetStreamPublisher.h>
+#include <SensorPipeline.h>
+#include <TelemetryCodec.h>
+#include <CommandRouter.h>
+#include <SPIFFS.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
 #include <base64.h>
 
 // Forward declarations
@@ -27,10 +44,22 @@ bool connectNATS();
 void publishDeviceStatus();
 void publishHeartbeat();
 void publishSensorData();
-void processNATSMessage();
-String readLine();
+void natsReadTick();
+void natsDisconnect(const char* why);
+void onNATSOp(const NatsOp& op, void* ctx);
 void subscribeToCommands();
-void handleCommand(String payload);
+void handleCommand(const NatsOp& op);
+void natsReplayTick();
+void natsRingDrainTick();
+void initOfflineRing();
+void natsJsGiveUp(const char* subject, const char* data, size_t len, void* ctx);
+void natsProbeJetStream();
+void onJetStreamInfo(uint32_t token, const NatsOp* reply, void* ctx);
+void initSensorPipeline();
+void cmdEncoding(const CommandCall& c);
+void cmdPing(const CommandCall& c);
+void cmdReboot(const CommandCall& c);
+void cmdStatus(const CommandCall& c);
 
 // ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
 // CONFIGURATION - UPDATE THESE VALUES
@@ -59,18 +88,159 @@ const char* SUBJECT_STATUS = "blackroad.devices.esp32.status";
 const char* SUBJECT_SENSORS = "blackroad.devices.esp32.sensors";
 const char* SUBJECT_COMMANDS = "blackroad.devices.esp32.commands";
 const char* SUBJECT_HEARTBEAT = "blackroad.devices.esp32.heartbeat";
+// Per-device commands: the last token is the command, the body holds only
+// its arguments (blackroad.devices.esp32-device1.cmd.reboot {"delay_ms":0})
+const char* SUBJECT_DEVICE_COMMANDS = "blackroad.devices.esp32-device1.cmd.*";
 
 // ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
 // GLOBALS
 // ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
 
 WiFiClient natsClient;
-bool natsConnected = false;
+bool natsConnected = false;    // Authenticated and subscribed
 unsigned long lastReconnectAttempt = 0;
 unsigned long lastHeartbeat = 0;
 unsigned long lastSensorPublish = 0;
 int reconnectDelay = 1000; // Start with 1 second, exponential backoff
 
+// Offline journal - telemetry the offline ring (below) can't hold is
+// spilled to flash and replayed in order after reconnecting. Each replay
+// batch ends with a PING; the server's PONG means it processed the
+// batch, so the journal is acked up to the batch's last record.
+#define NATS_JOURNAL_SEGMENT_BYTES 4096
+#define NATS_JOURNAL_SEGMENTS 16           // 64KB, ~25 min of sensor data
+#define NATS_REPLAY_BATCH 10               // Records per loop pass (~100/s)
+#define NATS_REPLAY_PONG_TIMEOUT_MS 5000
+
+OutboundJournal natsJournal(SPIFFS, "/jrnl_nats", NATS_JOURNAL_SEGMENT_BYTES, NATS_JOURNAL_SEGMENTS);
+bool natsJournalReady = false;
+bool natsReplayAwaitingPong = false;
+uint32_t natsReplayBatchSeq = 0;           // Acked when the PONG arrives
+unsigned long natsReplayPingAt = 0;
+
+// Offline ring - everything published while NATS is down (or while older
+// messages are still queued) lands here first, in RAM, so short
+// reconnect windows leave no gap and cost no flash writes. Each subject
+// has a slot quota and a drop policy; evicted messages of journaled
+// subjects spill to the flash journal. After reconnecting the journal
+// (older) drains first, then the ring at NATS_RING_DRAIN_BATCH messages
+// per NATS_RING_DRAIN_INTERVAL_MS.
+#define NATS_RING_DRAIN_BATCH 5
+#define NATS_RING_DRAIN_INTERVAL_MS 50     // ~100 messages/s
+
+struct NatsSubjectPolicy {
+  const char* subject;
+  uint8_t maxSlots;
+  RingDropPolicy policy;
+  bool journal;                            // Spill evicted messages to flash
+  bool jetstream;                          // Publish with acks (see below)
+};
+
+NatsSubjectPolicy natsSubjectPolicies[] = {
+  {SUBJECT_SENSORS, OFFLINE_RING_SLOTS, RING_DROP_OLDEST, true, true},
+  {SUBJECT_STATUS, 2, RING_DROP_OLDEST, true, false},       // Latest matters
+  {SUBJECT_HEARTBEAT, 4, RING_DROP_NEWEST, false, false},   // When it went quiet
+  {NULL, 4, RING_DROP_OLDEST, true, false},                 // Anything else
+};
+#define NATS_SUBJECT_POLICY_COUNT 4
+
+OfflineRing natsRing;
+unsigned long natsRingDrainAt = 0;
+
+// Inbound protocol - everything the socket has is drained each loop()
+// into a small buffer and fed to the incremental parser, which hands
+// complete ops to onNATSOp(). The handshake runs through the same path:
+// INFO -> CONNECT + PING -> PONG (auth ok) or -ERR.
+#define NATS_RX_CHUNK 512
+#define NATS_RX_BYTES_PER_TICK 16384       // Bound the time spent in loop()
+#define NATS_HANDSHAKE_TIMEOUT_MS 5000
+
+enum NatsHandshake {
+  NATS_HS_NONE,                // Not connecting (or done)
+  NATS_HS_INFO,                // TCP up, waiting for the server INFO
+  NATS_HS_PONG                 // CONNECT + PING sent, waiting for PONG
+};
+
+NatsParser natsParser(onNATSOp, NULL);
+NatsHandshake natsHandshake = NATS_HS_NONE;
+unsigned long natsHandshakeAt = 0;
+
+// Outbound protocol - PUBs are framed into one buffer and leave together
+// when it fills, NATS_FLUSH_MS after the first one, or on an explicit
+// flush. Raising the publish rate costs bytes, not TCP segments.
+#define NATS_FLUSH_MS 20
+
+NatsOutbox natsOutbox(natsClient, NATS_FLUSH_MS);
+
+// Request/reply - one wildcard subscription (_INBOX.<device>.*) carries
+// the replies to everything this device asks, each request under its own
+// token, so many can be outstanding at once. Incoming requests (commands
+// with a reply subject) are answered directly on that subject.
+NatsInbox natsInbox(natsOutbox, DEVICE_ID);
+
+// JetStream - a $JS.API.INFO request after every connect (and every
+// NATS_JS_PROBE_MS while JetStream is off) decides whether subjects with
+// `jetstream` set go out as HPUB with a Nats-Msg-Id and are tracked
+// until the stream acks them: up to JS_WINDOW in flight, retransmitted
+// (same Msg-Id, deduped server side) when an ack is late. A publish the
+// window can't take waits in the offline ring like any other backlog.
+#define NATS_JS_PROBE_TIMEOUT_MS 2000
+#define NATS_JS_PROBE_MS 60000             // Ask again while JetStream is off
+uint32_t natsBootId = 0;
+unsigned long natsJsProbeAt = 0;
+bool natsJsProbePending = false;
+JetStreamPublisher natsJs(natsOutbox, natsInbox, DEVICE_ID);
+
+// Sensor sampling - a FreeRTOS task reads every source SENSOR_SAMPLE_HZ
+// times a second into the pipeline's lock-free ring, loop() drains it,
+// and each SENSOR_PUBLISH_MS window goes out as min / max / mean / last /
+// count per channel. A higher sample rate means better aggregates, not
+// more messages. The sources are mocks until real sensors are fitted.
+#define SENSOR_SAMPLE_HZ 100
+#define SENSOR_PUBLISH_MS 5000
+#define SENSOR_TASK_STACK 2048
+#define SENSOR_TASK_PRIORITY 2             // Above loop(), for steady timing
+
+SensorPipeline sensorPipeline;
+SyntheticSource mockTemperature = {24, 3, 600000, 0.3f, 1000.0f / SENSOR_SAMPLE_HZ, 1, 0};
+SyntheticSource mockHumidity = {50, 8, 900000, 1.0f, 1000.0f / SENSOR_SAMPLE_HZ, 2, 0};
+
+// Telemetry encoding - sensor and heartbeat bodies are JSON unless
+// natsTelemetryBinary is set; then they use the compact encoding in
+// lib/TelemetryCodec (varints, fixed point, deltas: ~6x fewer bytes and
+// no number formatting). Subscribers tell the two apart by the first
+// byte, and tools/telemetry_decode turns binary bodies back into JSON.
+// Switch at runtime with {"command":"encoding","binary":true}.
+#define NATS_TELEMETRY_BINARY false
+
+bool natsTelemetryBinary = NATS_TELEMETRY_BINARY;
+
+// Commands - one table, sorted by name (checked at compile time) and
+// binary-searched by lib/CommandRouter, served on two routes: the shared
+// SUBJECT_COMMANDS with {"command":...} bodies, and SUBJECT_DEVICE_COMMANDS
+// with the command in the subject. Handlers only see declared arguments,
+// already type checked.
+constexpr Command natsCommands[] = {
+  {"encoding", cmdEncoding, {{"binary", CMD_ARG_BOOL, true}}},
+  {"ping", cmdPing, {}},
+  {"reboot", cmdReboot, {{"delay_ms", CMD_ARG_INT, false}}},
+  {"status", cmdStatus, {}},
+};
+static_assert(commandTableSorted(natsCommands), "natsCommands must be sorted by name");
+#define NATS_COMMAND_COUNT (sizeof(natsCommands) / sizeof(natsCommands[0]))
+
+const CommandRoute natsCommandRoutes[] = {
+  {SUBJECT_COMMANDS, natsCommands, NATS_COMMAND_COUNT, CMD_NAME_FROM_FIELD},
+  {SUBJECT_DEVICE_COMMANDS, natsCommands, NATS_COMMAND_COUNT, CMD_NAME_FROM_SUBJECT},
+};
+#define NATS_COMMAND_ROUTE_COUNT (sizeof(natsCommandRoutes) / sizeof(natsCommandRoutes[0]))
+CommandRouter natsCommandRouter(natsCommandRoutes, NATS_COMMAND_ROUTE_COUNT);
+
+// "reboot" only schedules the restart - handlers run inside the NATS
+// parser callback, so loop() restarts once the deadline passes
+bool restartPending = false;
+unsigned long restartAt = 0;
+
 // ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
 // SETUP
 // ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
@@ -81,15 +251,30 @@ void setup() {
 
   printHeader();
 
+  // Mount the offline journal before anything can be published
+  if (SPIFFS.begin(true) && natsJournal.begin()) {
+    natsJournalReady = true;
+    Serial.printf("📼 NATS journal: %lu message(s) waiting\n", (unsigned long)natsJournal.pending());
+  } else {
+    Serial.println("⚠️  NATS journal unavailable - offline telemetry is kept in RAM only");
+  }
+  initOfflineRing();
+
   // Connect to WiFi
   connectWiFi();
 
   // Verify NATS server is accessible
   verifyNATSServer();
+  natsBootId = esp_random();
+  natsInbox.begin(natsBootId);
+  natsJs.onGiveUp(natsJsGiveUp, NULL);  // Switched on by the probe once connected
 
   // Connect to NATS
   connectNATS();
 
+  // Start sampling once the blocking setup is done (loop() drains the ring)
+  initSensorPipeline();
+
   // Publish initial status
   publishDeviceStatus();
 }
@@ -105,37 +290,66 @@ void loop() {
     connectWiFi();
   }
 
+  // Notice a dropped socket (the server never says goodbye)
+  if ((natsConnected || natsHandshake != NATS_HS_NONE) && !natsClient.connected()) {
+    natsDisconnect("connection lost");
+  }
+
   // Maintain NATS connection
-  if (!natsConnected) {
+  if (!natsConnected && natsHandshake == NATS_HS_NONE) {
     unsigned long now = millis();
     if (now - lastReconnectAttempt > reconnectDelay) {
       lastReconnectAttempt = now;
-      if (connectNATS()) {
-        reconnectDelay = 1000; // Reset backoff on success
-      } else {
+      if (!connectNATS()) {
         reconnectDelay = min(reconnectDelay * 2, 30000); // Max 30s
       }
     }
+  } else if (natsHandshake != NATS_HS_NONE && millis() - natsHandshakeAt > NATS_HANDSHAKE_TIMEOUT_MS) {
+    natsDisconnect("handshake timed out");
   }
 
-  // Publish heartbeat every 30 seconds
-  if (natsConnected && millis() - lastHeartbeat > 30000) {
+  // Process everything the server has sent (handshake included)
+  natsReadTick();
+
+  // Publish heartbeat every 30 seconds (buffered while offline)
+  if (millis() - lastHeartbeat > 30000) {
     publishHeartbeat();
     lastHeartbeat = millis();
   }
 
-  // Publish sensor data every 5 seconds
-  if (natsConnected && millis() - lastSensorPublish > 5000) {
+  // Fold new samples into the window; publish it (buffered while offline)
+  sensorPipeline.drain();
+  if (millis() - lastSensorPublish > SENSOR_PUBLISH_MS) {
     publishSensorData();
     lastSensorPublish = millis();
   }
 
-  // Process NATS messages
-  if (natsConnected && natsClient.available()) {
-    processNATSMessage();
+  // Drain the offline journal, then the offline ring
+  natsReplayTick();
+  natsRingDrainTick();
+
+  // Expire unanswered requests; retransmit JetStream publishes whose ack is late
+  natsInbox.tick();
+  if (natsConnected) natsJs.tick();
+
+  // JetStream off (never found, or a 503 switched it off) - ask again
+  if (natsConnected && !natsJs.enabled() && !natsJsProbePending &&
+      millis() - natsJsProbeAt > NATS_JS_PROBE_MS) {
+    natsProbeJetStream();
+  }
+
+  // Send whatever has waited NATS_FLUSH_MS
+  if (natsConnected && !natsOutbox.tick()) {
+    natsDisconnect("write failed");
   }
 
-  delay(100);
+  // Scheduled by the "reboot" command
+  if (restartPending && (long)(millis() - restartAt) >= 0) {
+    if (natsConnected) natsOutbox.flush();
+    ESP.restart();
+  }
+
+  delay(10);
 }
 
 // ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
@@ -190,8 +404,13 @@ void verifyNATSServer() {
     Serial.println("✅ NATS server is reachable");
     String payload = http.getString();
 
-    StaticJsonDocument<1024> doc;
-    DeserializationError error = deserializeJson(doc, payload);
+    // /varz runs to several KB - keep only the fields printed below
+    StaticJsonDocument<64> filter;
+    filter["server_name"] = true;
+    filter["version"] = true;
+    filter["uptime"] = true;
+    StaticJsonDocument<256> doc;
+    DeserializationError error = deserializeJson(doc, payload, DeserializationOption::Filter(filter));
 
     if (!error) {
       Serial.println("   Server info:");
@@ -201,8 +420,6 @@ void verifyNATSServer() {
       Serial.println(doc["version"].as<const char*>());
       Serial.print("   - Uptime: ");
       Serial.println(doc["uptime"].as<const char*>());
-      Serial.print("   - JetStream: ");
-      Serial.println(doc["jetstream"]["config"]["max_memory"].as<long>() > 0 ? "enabled" : "disabled");
     }
   } else {
     Serial.print("❌ Failed to reach NATS server (HTTP ");
@@ -217,6 +434,7 @@ void verifyNATSServer() {
 // NATS CONNECTION
 // ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
 
+// Open the TCP connection; the handshake finishes in onNATSOp()
 bool connectNATS() {
   Serial.println("\n🚀 Connecting to NATS server...");
   Serial.print("   ");
@@ -224,97 +442,255 @@ bool connectNATS() {
   Serial.print(":");
   Serial.println(NATS_PORT);
 
-  if (natsClient.connect(NATS_SERVER, NATS_PORT)) {
-    Serial.println("✅ TCP connection established");
-
-    // Read server INFO
-    String info = readLine();
-    if (info.startsWith("INFO")) {
-      Serial.println("✅ Received NATS server INFO");
-
-      // Send CONNECT with JWT
-      String connectMsg = "CONNECT {\"jwt\":\"";
-      connectMsg += NATS_USER_JWT;
-      connectMsg += "\",\"name\":\"";
-      connectMsg += DEVICE_ID;
-      connectMsg += "\",\"verbose\":false,\"pedantic\":false,\"protocol\":1}\r\n";
-
-      natsClient.print(connectMsg);
-
-      // Wait for +OK or -ERR
-      delay(100);
-      if (natsClient.available()) {
-        String response = readLine();
-        if (response.startsWith("+OK") || response.length() == 0) {
-          Serial.println("✅ NATS authentication successful");
-          natsConnected = true;
-
-          // Subscribe to command topic
-          subscribeToCommands();
-
-          return true;
-        } else {
-          Serial.print("❌ NATS auth failed: ");
-          Serial.println(response);
-        }
-      }
-    }
-  } else {
+  if (!natsClient.connect(NATS_SERVER, NATS_PORT)) {
     Serial.println("❌ TCP connection failed");
+    natsClient.stop();
+    return false;
   }
 
+  Serial.println("✅ TCP connection established");
+  natsClient.setNoDelay(true);
+  natsParser.reset();
+  natsOutbox.clear();
+  natsHandshake = NATS_HS_INFO;
+  natsHandshakeAt = millis();
+  return true;
+}
+
+// Server INFO arrived - authenticate. The PING makes the server answer
+// with PONG once CONNECT is accepted (verbose mode would send +OK).
+void sendNATSConnect() {
+  char connectMsg[1024];
+  strcpy(connectMsg, "CONNECT ");
+  JsonWriter w(connectMsg + 8, sizeof(connectMsg) - 16);  // Room for CRLF
+  w.beginObject();
+  w.field("jwt", NATS_USER_JWT);
+  w.field("name", DEVICE_ID);
+  w.field("verbose", false);
+  w.field("pedantic", false);
+  w.field("protocol", 1);
+  w.field("headers", true);
+  w.field("no_responders", true);  // 503 when no stream takes a JetStream publish
+  w.endObject();
+  size_t len = 8 + w.length();
+  connectMsg[len++] = '\r';
+  connectMsg[len++] = '\n';
+
+  natsOutbox.control(connectMsg, len);
+  natsOutbox.control("PING\r\n");
+  natsOutbox.flush();
+  natsHandshake = NATS_HS_PONG;
+}
+
+// Handshake PONG - we're in
+void onNATSReady() {
+  Serial.println("✅ NATS authentication successful");
+  natsHandshake = NATS_HS_NONE;
+  natsConnected = true;
+  reconnectDelay = 1000; // Reset backoff on success
+
+  // Subscribe to command topic and the reply inbox (JetStream acks too)
+  subscribeToCommands();
+  natsInbox.subscribe();
+  natsProbeJetStream();
+
+  // Resend whatever the last connection never confirmed
+  natsReplayAwaitingPong = false;
+  natsJournal.rewind();
+  natsJs.rewind();
+}
+
+void natsDisconnect(const char* why) {
+  Serial.printf("⚠️  NATS %s\n", why);
+  if (natsHandshake != NATS_HS_NONE) {
+    reconnectDelay = min(reconnectDelay * 2, 30000);  // Failed attempt
+  }
   natsConnected = false;
+  natsHandshake = NATS_HS_NONE;
+  natsReplayAwaitingPong = false;
   natsClient.stop();
-  return false;
+  natsParser.abort(why);  // Drop anything still buffered, both ways
+  natsOutbox.clear();
 }
 
+// One subscription per command route, sids from 10 (the inbox owns 2)
 void subscribeToCommands() {
-  String sub = "SUB ";
-  sub += SUBJECT_COMMANDS;
-  sub += " 1\r\n";
-  natsClient.print(sub);
-  Serial.print("📬 Subscribed to: ");
-  Serial.println(SUBJECT_COMMANDS);
+  for (size_t i = 0; i < NATS_COMMAND_ROUTE_COUNT; i++) {
+    char sub[96];
+    int len = snprintf(sub, sizeof(sub), "SUB %s %u\r\n", natsCommandRoutes[i].subject, (unsigned)(10 + i));
+    natsOutbox.control(sub, len);
+    Serial.print("📬 Subscribed to: ");
+    Serial.println(natsCommandRoutes[i].subject);
+  }
+  natsOutbox.flush();
 }
 
 // ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
 // NATS PUBLISHING
 // ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
 
-void publishToNATS(const char* subject, String payload) {
-  if (!natsConnected) return;
+uint8_t natsSubjectKind(const char* subject) {
+  for (uint8_t k = 0; k < NATS_SUBJECT_POLICY_COUNT - 1; k++) {
+    if (strcmp(subject, natsSubjectPolicies[k].subject) == 0) return k;
+  }
+  return NATS_SUBJECT_POLICY_COUNT - 1;
+}
 
-  String msg = "PUB ";
-  msg += subject;
-  msg += " ";
-  msg += payload.length();
-  msg += "\r\n";
-  msg += payload;
-  msg += "\r\n";
+// Ring eviction: keep journaled subjects in flash
+bool natsRingSpill(const OfflineRing::Entry& e, void* ctx) {
+  if (!natsJournalReady || !natsSubjectPolicies[e.kind].journal) return false;
+  return natsJournal.append(e.kind, e.topic, e.data, e.dataLen) != 0;
+}
 
-  natsClient.print(msg);
+void initOfflineRing() {
+  for (uint8_t k = 0; k < NATS_SUBJECT_POLICY_COUNT; k++) {
+    natsRing.setPolicy(k, natsSubjectPolicies[k].maxSlots, natsSubjectPolicies[k].policy);
+  }
+  natsRing.onSpill(natsRingSpill, NULL);
 }
 
-void publishDeviceStatus() {
-  Serial.println("\n📤 Publishing device status...");
+// One message onto the wire: JetStream for subjects that want acks, a
+// plain PUB otherwise. False = not sent (window full or socket gone).
+bool natsSend(const char* subject, const char* payload, size_t len) {
+  if (natsSubjectPolicies[natsSubjectKind(subject)].jetstream && natsJs.enabled() && len <= JS_DATA_MAX) {
+    return natsJs.publish(subject, payload, len);
+  }
+  return natsOutbox.publish(subject, payload, len);
+}
+
+// Acks never came - back in line behind the current backlog
+void natsJsGiveUp(const char* subject, const char* data, size_t len, void* ctx) {
+  natsRing.push(natsSubjectKind(subject), subject, data, len);
+}
+
+// Ask the server whether this account has JetStream; onJetStreamInfo()
+// gets the answer through the inbox
+void natsProbeJetStream() {
+  natsJsProbeAt = millis();
+  natsJsProbePending =
+    natsInbox.request("$JS.API.INFO", "", 0, onJetStreamInfo, NULL, NATS_JS_PROBE_TIMEOUT_MS) != 0;
+}
+
+// A 503 means no JetStream on the server, an "error" body that it's not
+// enabled for the account. A timeout leaves things as they are.
+void onJetStreamInfo(uint32_t token, const NatsOp* reply, void* ctx) {
+  natsJsProbePending = false;
+  if (!reply) {
+    Serial.println("⚠️  JetStream probe timed out");
+    return;
+  }
 
-  StaticJsonDocument<512> doc;
-  doc["device_id"] = DEVICE_ID;
-  doc["device_type"] = DEVICE_TYPE;
-  doc["status"] = "online";
-  doc["ip"] = WiFi.localIP().toString();
-  doc["rssi"] = WiFi.RSSI();
-  doc["uptime_seconds"] = millis() / 1000;
-  doc["free_heap"] = ESP.getFreeHeap();
-  doc["chip_model"] = ESP.getChipModel();
-  doc["chip_revision"] = ESP.getChipRevision();
-  doc["cpu_freq_mhz"] = ESP.getCpuFreqMHz();
-  doc["timestamp"] = millis();
+  bool available = !NatsInbox::noResponders(*reply) && !strstr(reply->payload, "\"error\"");
+  if (available && !natsJs.enabled()) {
+    natsJs.begin(natsBootId);
+    Serial.println("📮 JetStream publishing enabled for sensors");
+  } else if (!available && natsJs.enabled()) {
+    natsJs.end();
+    Serial.println("📮 JetStream unavailable - sensors go out as plain PUB");
+  }
+}
 
-  String json;
-  serializeJson(doc, json);
+// Publish (buffered in the outbox), or keep it in the offline ring while
+// NATS is down. Messages also queue behind older buffered ones so
+// subscribers see them in order.
+void publishToNATS(const char* subject, const char* payload, size_t len) {
+  bool backlog = natsRing.count() > 0 ||
+                 (natsJournalReady && (natsJournal.unread() > 0 || natsReplayAwaitingPong));
+  if (natsConnected && !backlog && natsSend(subject, payload, len)) return;
+
+  natsRing.push(natsSubjectKind(subject), subject, payload, len);
+}
 
-  publishToNATS(SUBJECT_STATUS, json);
+// Replay one batch from the journal, then PING. Call every loop().
+void natsReplayTick() {
+  if (!natsConnected || !natsJournalReady) return;
+
+  if (natsReplayAwaitingPong) {
+    if (millis() - natsReplayPingAt < NATS_REPLAY_PONG_TIMEOUT_MS) return;
+    Serial.println("⚠️  No PONG for replay batch - resending");
+    natsReplayAwaitingPong = false;
+    natsJournal.rewind();
+  }
+
+  // Only what the JetStream window can take, so no record is refused
+  int batch = natsJs.enabled() ? min(NATS_REPLAY_BATCH, (int)natsJs.room()) : NATS_REPLAY_BATCH;
+  if (batch == 0) return;
+
+  OutboundJournal::Record rec;
+  int sent = 0;
+  while (sent < batch && natsJournal.read(rec)) {
+    if (!natsSend(rec.topic, rec.data, rec.dataLen)) {
+      natsJournal.rewind();  // Socket died - resend after reconnect
+      return;
+    }
+    natsReplayBatchSeq = rec.seq;
+    sent++;
+  }
+  if (sent == 0) return;
+
+  // The batch and its PING leave in one write
+  natsOutbox.control("PING\r\n");
+  natsOutbox.flush();
+  natsReplayAwaitingPong = true;
+  natsReplayPingAt = millis();
+  Serial.printf("📼 Replayed %d journaled message(s), %lu left\n", sent,
+                (unsigned long)natsJournal.unread());
+}
+
+// Send a few ring messages once the journal is drained. Call every loop().
+void natsRingDrainTick() {
+  if (!natsConnected || natsRing.count() == 0) return;
+  if (natsJournalReady && (natsJournal.unread() > 0 || natsReplayAwaitingPong)) return;  // Older first
+  if (millis() - natsRingDrainAt < NATS_RING_DRAIN_INTERVAL_MS) return;
+  natsRingDrainAt = millis();
+
+  const OfflineRing::Entry* e;
+  int sent = 0;
+  while (sent < NATS_RING_DRAIN_BATCH && (e = natsRing.peek()) != NULL) {
+    if (!natsSend(e->topic, e->data, e->dataLen)) return;  // Window full or socket gone
+    natsRing.pop();
+    sent++;
+  }
+  if (natsRing.count() == 0) {
+    Serial.printf("📦 Offline ring drained (%lu buffered, %lu spilled, %lu dropped)\n",
+                  (unsigned long)natsRing.stats.pushed, (unsigned long)natsRing.stats.spilled,
+                  (unsigned long)natsRing.stats.dropped);
+  }
+}
+
+// The full status document - published on SUBJECT_STATUS or sent as a reply
+size_t writeDeviceStatus(char* buf, size_t size) {
+  IPAddress ip = WiFi.localIP();
+  char ipStr[16];
+  snprintf(ipStr, sizeof(ipStr), "%u.%u.%u.%u", ip[0], ip[1], ip[2], ip[3]);
+
+  JsonWriter w(buf, size);
+  w.beginObject();
+  w.field("device_id", DEVICE_ID);
+  w.field("device_type", DEVICE_TYPE);
+  w.field("status", "online");
+  w.field("ip", ipStr);
+  w.field("rssi", WiFi.RSSI());
+  w.field("uptime_seconds", millis() / 1000);
+  w.field("free_heap", ESP.getFreeHeap());
+  w.field("chip_model", ESP.getChipModel());
+  w.field("chip_revision", ESP.getChipRevision());
+  w.field("cpu_freq_mhz", ESP.getCpuFreqMHz());
+  w.field("jetstream", natsJs.enabled());
+  w.field("js_acked", (unsigned long)natsJs.stats.acked);
+  w.field("js_retransmits", (unsigned long)natsJs.stats.retransmits);
+  w.field("js_ack_ms", (unsigned long)natsJs.avgAckMs());
+  w.field("timestamp", millis());
+  w.endObject();
+  return w.length();
+}
+
+void publishDeviceStatus() {
+  Serial.println("\n📤 Publishing device status...");
+
+  char json[512];
+  size_t len = writeDeviceStatus(json, sizeof(json));
+  publishToNATS(SUBJECT_STATUS, json, len);
 
   Serial.print("   Subject: ");
   Serial.println(SUBJECT_STATUS);
@@ -322,39 +698,148 @@ void publishDeviceStatus() {
   Serial.println(json);
 }
 
-void publishSensorData() {
-  StaticJsonDocument<512> doc;
-  doc["device_id"] = DEVICE_ID;
-  doc["timestamp"] = millis();
+// Runs SENSOR_SAMPLE_HZ times a second on its own task
+void sensorSampleTask(void* param) {
+  TickType_t wake = xTaskGetTickCount();
+  for (;;) {
+    sensorPipeline.sample(millis());
+    vTaskDelayUntil(&wake, pdMS_TO_TICKS(1000 / SENSOR_SAMPLE_HZ));
+  }
+}
+
+void initSensorPipeline() {
+  mockTemperature.seed = esp_random();
+  mockHumidity.seed = esp_random();
+  sensorPipeline.addSource("temperature_c", SyntheticSource::read, &mockTemperature);
+  sensorPipeline.addSource("humidity_pct", SyntheticSource::read, &mockHumidity);
 
-  // Mock sensor data (replace with real sensors)
-  doc["temperature_c"] = 20 + random(0, 10);
-  doc["humidity_pct"] = 40 + random(0, 20);
-  doc["wifi_rssi"] = WiFi.RSSI();
-  doc["free_heap"] = ESP.getFreeHeap();
+  if (xTaskCreate(sensorSampleTask, "sensors", SENSOR_TASK_STACK, NULL,
+                  SENSOR_TASK_PRIORITY, NULL) != pdPASS) {
+    Serial.println("⚠️  No task for sensor sampling - publishing empty windows");
+    return;
+  }
+  Serial.printf("📈 Sampling %d sensor(s) at %d Hz, publishing every %d s\n",
+                sensorPipeline.channels(), SENSOR_SAMPLE_HZ, SENSOR_PUBLISH_MS / 1000);
+}
 
-  String json;
-  serializeJson(doc, json);
+// {"min":..,"max":..,"mean":..,"last":..,"count":..}, null for an empty window
+void writeSensorWindow(JsonWriter& w, const char* name, const SensorWindow& win) {
+  if (win.count == 0) {
+    w.key(name);
+    w.nullValue();
+    return;
+  }
+  w.objectField(name);
+  w.field("min", (double)win.min, 2);
+  w.field("max", (double)win.max, 2);
+  w.field("mean", (double)win.mean(), 2);
+  w.field("last", (double)win.last, 2);
+  w.field("count", (unsigned long)win.count);
+  w.endObject();
+}
 
-  publishToNATS(SUBJECT_SENSORS, json);
+// Compact encoding of one window (see NATS_TELEMETRY_BINARY)
+void publishSensorDataBinary(const SensorWindow* windows, uint32_t windowMs) {
+  TelSensorRecord r;
+  r.timestamp = millis();
+  r.windowMs = windowMs;
+  r.sampleHz = SENSOR_SAMPLE_HZ;
+  r.overruns = sensorPipeline.overruns();
+  r.rssi = WiFi.RSSI();
+  r.freeHeap = ESP.getFreeHeap();
+  r.channels = 0;
+  for (uint8_t c = 0; c < sensorPipeline.channels() && r.channels < TEL_MAX_CHANNELS; c++) {
+    TelChannelStats& s = r.ch[r.channels];
+    s.id = telChannelId(sensorPipeline.name(c));
+    if (s.id == 0) continue;  // Not in the schema yet - JSON only
+    s.count = windows[c].count;
+    s.min = s.count ? windows[c].min : 0;
+    s.max = s.count ? windows[c].max : 0;
+    s.mean = windows[c].mean();
+    s.last = windows[c].last;
+    r.channels++;
+  }
+
+  uint8_t buf[128];
+  TelemetryEncoder e(buf, sizeof(buf));
+  e.begin(TEL_KIND_SENSORS, DEVICE_ID, r.timestamp);
+  e.sensors(r);
+  if (!e.finish()) {
+    Serial.println("⚠️  Sensor record too large - window dropped");
+    return;
+  }
+  publishToNATS(SUBJECT_SENSORS, (const char*)buf, e.length());
+  Serial.printf("📊 Sensor: %u byte(s), binary\n", (unsigned)e.length());
+}
+
+// One message per window, whatever the sample rate
+void publishSensorData() {
+  SensorWindow windows[SENSOR_PIPELINE_CHANNELS];
+  sensorPipeline.drain();
+  uint32_t windowMs = sensorPipeline.takeWindow(windows, millis());
+  if (natsTelemetryBinary) {
+    publishSensorDataBinary(windows, windowMs);
+    return;
+  }
+
+  char json[JS_DATA_MAX];  // Fits a JetStream / offline ring slot
+  JsonWriter w(json, sizeof(json));
+  w.beginObject();
+  w.field("device_id", DEVICE_ID);
+  w.field("timestamp", millis());
+  w.field("window_ms", (unsigned long)windowMs);
+  w.field("sample_hz", SENSOR_SAMPLE_HZ);
+  w.field("overruns", (unsigned long)sensorPipeline.overruns());
+  for (uint8_t c = 0; c < sensorPipeline.channels(); c++) {
+    writeSensorWindow(w, sensorPipeline.name(c), windows[c]);
+  }
+  w.field("wifi_rssi", WiFi.RSSI());
+  w.field("free_heap", ESP.getFreeHeap());
+  w.endObject();
+
+  if (w.overflowed()) {
+    Serial.println("⚠️  Sensor payload too large - window dropped");
+    return;
+  }
+  publishToNATS(SUBJECT_SENSORS, w.c_str(), w.length());
 
   Serial.print("📊 Sensor: ");
   Serial.println(json);
 }
 
 void publishHeartbeat() {
-  StaticJsonDocument<256> doc;
-  doc["device_id"] = DEVICE_ID;
-  doc["status"] = "alive";
-  doc["uptime"] = millis() / 1000;
-  doc["free_heap"] = ESP.getFreeHeap();
-
-  String json;
-  serializeJson(doc, json);
-
-  publishToNATS(SUBJECT_HEARTBEAT, json);
+  TelHeartbeat h;
+  h.timestamp = millis();
+  h.uptimeS = millis() / 1000;
+  h.freeHeap = ESP.getFreeHeap();
+  h.connected = natsConnected;
+  h.buffered = natsRing.count();
+  h.journaled = natsJournalReady ? natsJournal.pending() : 0;
+  h.dropped = natsRing.stats.dropped + natsJournal.stats.dropped;
+
+  if (natsTelemetryBinary) {
+    uint8_t buf[64];
+    TelemetryEncoder e(buf, sizeof(buf));
+    e.begin(TEL_KIND_HEARTBEAT, DEVICE_ID, h.timestamp);
+    e.heartbeat(h);
+    if (e.finish()) publishToNATS(SUBJECT_HEARTBEAT, (const char*)buf, e.length());
+  } else {
+    char json[256];
+    JsonWriter w(json, sizeof(json));
+    w.beginObject();
+    w.field("device_id", DEVICE_ID);
+    w.field("status", "alive");
+    w.field("uptime", (unsigned long)h.uptimeS);
+    w.field("free_heap", (unsigned long)h.freeHeap);
+    w.field("connected", h.connected);
+    w.field("buffered", (unsigned long)h.buffered);
+    w.field("journaled", (unsigned long)h.journaled);
+    w.field("dropped", (unsigned long)h.dropped);
+    w.endObject();
+    publishToNATS(SUBJECT_HEARTBEAT, w.c_str(), w.length());
+  }
 
-  Serial.print("💓 Heartbeat sent (uptime: ");
+  Serial.print(natsConnected ? "💓 Heartbeat sent (uptime: " : "💓 Heartbeat buffered (uptime: ");
   Serial.print(millis() / 1000);
   Serial.println("s)");
 }
@@ -363,87 +848,153 @@ void publishHeartbeat() {
 // NATS MESSAGE PROCESSING
 // ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
 
-void processNATSMessage() {
-  String msg = readLine();
-
-  if (msg.startsWith("MSG")) {
-    // Parse: MSG <subject> <sid> <size>
-    int firstSpace = msg.indexOf(' ');
-    int secondSpace = msg.indexOf(' ', firstSpace + 1);
-    int thirdSpace = msg.indexOf(' ', secondSpace + 1);
-
-    String subject = msg.substring(firstSpace + 1, secondSpace);
-    int size = msg.substring(thirdSpace + 1).toInt();
-
-    // Read payload
-    char payload[size + 1];
-    natsClient.readBytes(payload, size);
-    payload[size] = '\0';
-
-    Serial.print("\n📨 Received command: ");
-    Serial.println(payload);
-
-    // Process command
-    handleCommand(payload);
-
-    // Read trailing \r\n
-    readLine();
-  } else if (msg.startsWith("PING")) {
-    natsClient.print("PONG\r\n");
-    Serial.println("🏓 PONG");
-  } else if (msg.startsWith("-ERR")) {
-    Serial.print("❌ NATS error: ");
-    Serial.println(msg);
-    natsConnected = false;
-    natsClient.stop();
+// Drain everything that has arrived into the parser. Ops are handled
+// as they complete, so a burst of messages lands in one loop() pass.
+void natsReadTick() {
+  if (!natsConnected && natsHandshake == NATS_HS_NONE) return;
+
+  uint8_t buf[NATS_RX_CHUNK];
+  size_t budget = NATS_RX_BYTES_PER_TICK;
+  while (budget > 0 && natsClient.available() > 0) {
+    int n = natsClient.read(buf, min(sizeof(buf), budget));
+    if (n <= 0) break;
+    budget -= n;
+    if (!natsParser.parse(buf, n)) {
+      // Already disconnected if a handler stopped the parser
+      if (natsConnected || natsHandshake != NATS_HS_NONE) {
+        Serial.printf("❌ NATS protocol error: %s\n", natsParser.error());
+        natsDisconnect("protocol error");
+      }
+      return;
+    }
   }
 }
 
-void handleCommand(String command) {
-  StaticJsonDocument<256> doc;
-  DeserializationError error = deserializeJson(doc, command);
+void onNATSOp(const NatsOp& op, void* ctx) {
+  switch (op.type) {
+    case NATS_OP_INFO:
+      // Servers resend INFO on cluster changes - only the first one matters
+      if (natsHandshake == NATS_HS_INFO) {
+        Serial.println("✅ Received NATS server INFO");
+        sendNATSConnect();
+      }
+      break;
 
-  if (error) {
-    Serial.println("❌ Invalid JSON command");
-    return;
+    case NATS_OP_MSG:
+      if (natsInbox.handle(op)) break;  // Replies, JetStream acks included
+      if (op.truncated) {
+        Serial.printf("⚠️  Dropped oversized message on %s\n", op.subject);
+        break;
+      }
+      Serial.print("\n📨 Received command: ");
+      Serial.println(op.payload);
+      handleCommand(op);
+      break;
+
+    case NATS_OP_PING:
+      natsOutbox.control("PONG\r\n");
+      natsOutbox.flush();
+      Serial.println("🏓 PONG");
+      break;
+
+    case NATS_OP_PONG:
+      // PONGs come back in PING order: the handshake's first, then replays
+      if (natsHandshake == NATS_HS_PONG) {
+        onNATSReady();
+      } else if (natsReplayAwaitingPong) {
+        // Server processed the replay batch sent before our PING
+        natsJournal.ack(natsReplayBatchSeq);
+        natsReplayAwaitingPong = false;
+        if (natsJournal.pending() == 0) {
+          Serial.printf("📼 Journal drained (write amplification %lu%%)\n",
+                        (unsigned long)natsJournal.writeAmplificationX100());
+        }
+      }
+      break;
+
+    case NATS_OP_OK:
+      break;
+
+    case NATS_OP_ERR:
+      Serial.print("❌ NATS error: ");
+      Serial.println(op.args);
+      natsDisconnect(natsHandshake != NATS_HS_NONE ? "auth failed" : "server error");
+      break;
   }
+}
 
-  const char* cmd = doc["command"];
+// Commands sent as requests (reply subject set) are answered on it, so a
+// controller polling many devices gets each answer straight back. Plain
+// publishes keep the broadcast behaviour: status goes to SUBJECT_STATUS.
+void replyToCommand(const NatsOp& op, const char* json) {
+  natsInbox.respond(op, json, strlen(json));
+}
 
-  if (strcmp(cmd, "reboot") == 0) {
-    Serial.println("🔄 Rebooting in 3 seconds...");
-    delay(3000);
-    ESP.restart();
-  } else if (strcmp(cmd, "status") == 0) {
-    publishDeviceStatus();
-  } else if (strcmp(cmd, "ping") == 0) {
+// ─────────────────────────────────────────────────────────────────────
+// COMMAND HANDLERS
+// ─────────────────────────────────────────────────────────────────────
+
+void cmdEncoding(const CommandCall& c) {
+  natsTelemetryBinary = c.flag(0);
+  Serial.printf("🗜️  Telemetry encoding: %s\n", natsTelemetryBinary ? "binary" : "JSON");
+  replyToCommand(c.op, natsTelemetryBinary ? "{\"encoding\":\"binary\"}" : "{\"encoding\":\"json\"}");
+}
+
+void cmdPing(const CommandCall& c) {
+  if (!c.isRequest()) {
     Serial.println("🏓 Ping received, sending status");
     publishDeviceStatus();
-  } else {
-    Serial.print("❓ Unknown command: ");
-    Serial.println(cmd);
+    return;
   }
+  Serial.println("🏓 Ping request, replying");
+  char json[128];
+  JsonWriter w(json, sizeof(json));
+  w.beginObject();
+  w.field("device_id", DEVICE_ID);
+  w.field("pong", true);
+  w.field("uptime_seconds", millis() / 1000);
+  w.endObject();
+  natsInbox.respond(c.op, w.c_str(), w.length());
 }
 
-// ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
-// UTILITY FUNCTIONS
-// ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
-
-String readLine() {
-  String line = "";
-  unsigned long timeout = millis() + 1000;
+void cmdReboot(const CommandCall& c) {
+  long delayMs = c.integer(0, 3000);
+  if (delayMs < 0) delayMs = 0;
+  if (delayMs > 60000) delayMs = 60000;
+  replyToCommand(c.op, "{\"ok\":true}");
+  natsOutbox.flush();
+  Serial.printf("🔄 Rebooting in %ld ms...\n", delayMs);
+  restartAt = millis() + delayMs;
+  restartPending = true;
+}
 
-  while (millis() < timeout) {
-    if (natsClient.available()) {
-      char c = natsClient.read();
-      if (c == '\n') break;
-      if (c != '\r') line += c;
-    }
+void cmdStatus(const CommandCall& c) {
+  if (!c.isRequest()) {
+    publishDeviceStatus();
+    return;
   }
+  char json[512];
+  size_t len = writeDeviceStatus(json, sizeof(json));
+  natsInbox.respond(c.op, json, len);
+}
 
-  return line;
+void handleCommand(const NatsOp& op) {
+  if (natsCommandRouter.dispatch(op) == CMD_OK) return;
+
+  Serial.print("❓ Command rejected: ");
+  Serial.println(natsCommandRouter.error());
+  char json[96];
+  JsonWriter w(json, sizeof(json));
+  w.beginObject();
+  w.field("error", natsCommandRouter.error());
+  w.endObject();
+  replyToCommand(op, w.c_str());
 }
 
+// ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+// UTILITY FUNCTIONS
+// ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+
 void printHeader() {
   Serial.println("");
   Serial.println("━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━");
@@ -467,6 +1018,8 @@ void printHeader() {
   Serial.println(SUBJECT_SENSORS);
   Serial.print("  - Commands: ");
   Serial.println(SUBJECT_COMMANDS);
+  Serial.print("  - Device commands: ");
+  Serial.println(SUBJECT_DEVICE_COMMANDS);
   Serial.print("  - Heartbeat: ");
   Serial.println(SUBJECT_HEARTBEAT);
   Serial.println("");
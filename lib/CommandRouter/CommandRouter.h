@@ -0,0 +1,429 @@
+#ifndef COMMAND_ROUTER_H
+#define COMMAND_ROUTER_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <NatsParser.h>
+
+/*
+ * ═══════════════════════════════════════════════════════════════════════
+ * BLACKROAD COMMAND ROUTER
+ * ═══════════════════════════════════════════════════════════════════════
+ *
+ * Table-driven dispatch for commands arriving over NATS:
+ * - Commands live in a constant table sorted by name - checked at compile
+ *   time with commandTableSorted() - and are found by binary search, so
+ *   dozens of commands cost a handful of compares
+ * - Routes map subjects (NATS wildcards * and >) to a command table. The
+ *   command name comes from the body's "command" field, or from the last
+ *   subject token (devices.x.cmd.reboot) with only arguments in the body
+ * - The JSON body is scanned once, in place, for its top-level fields.
+ *   Only the arguments the command declares are converted and type
+ *   checked; everything else is skipped unparsed
+ * - Handlers get a CommandCall: the message (reply subject included) and
+ *   the declared arguments, by declaration index
+ *
+ * Platform neutral (no Arduino headers).
+ *
+ * Usage:
+ *   void cmdReboot(const CommandCall& c) { restartIn(c.integer(0, 3000)); }
+ *   constexpr Command COMMANDS[] = {           // Sorted by name
+ *     {"ping", cmdPing, {}},
+ *     {"reboot", cmdReboot, {{"delay_ms", CMD_ARG_INT, false}}},
+ *   };
+ *   static_assert(commandTableSorted(COMMANDS), "COMMANDS must be sorted");
+ *   const CommandRoute ROUTES[] = {{"devices.commands", COMMANDS, 2, CMD_NAME_FROM_FIELD}};
+ *   CommandRouter router(ROUTES, 1);
+ *   if (router.dispatch(op) != CMD_OK) replyError(router.error());
+ *
+ * Used by the NATS firmware (esp32/device1).
+ */
+
+#define CMD_MAX_ARGS 4               // Declared per command
+#define CMD_MAX_FIELDS 12            // Top-level body fields looked at
+#define CMD_NAME_MAX 31
+#define CMD_TEXT_MAX 128             // Unescaped string arguments, all together
+#define CMD_NAME_FIELD "command"
+
+enum CommandArgType {
+  CMD_ARG_STRING,
+  CMD_ARG_INT,
+  CMD_ARG_FLOAT,
+  CMD_ARG_BOOL
+};
+
+enum CommandNameSource {
+  CMD_NAME_FROM_FIELD,               // {"command":"reboot", ...}
+  CMD_NAME_FROM_SUBJECT              // Last subject token
+};
+
+enum CommandResult {
+  CMD_OK,
+  CMD_UNROUTED,                      // No route for the subject
+  CMD_BAD_JSON,
+  CMD_NO_NAME,                       // No command name
+  CMD_UNKNOWN,
+  CMD_BAD_ARGS                       // Required argument missing, or wrong type
+};
+
+struct CommandArgSpec {
+  const char* name;
+  CommandArgType type;
+  bool required;
+};
+
+class CommandCall;
+typedef void (*CommandHandler)(const CommandCall& call);
+
+struct Command {
+  const char* name;
+  CommandHandler handler;
+  CommandArgSpec args[CMD_MAX_ARGS];  // Unused entries have a NULL name
+};
+
+struct CommandRoute {
+  const char* subject;               // May contain * and >
+  const Command* commands;           // Sorted by name
+  size_t count;
+  CommandNameSource nameFrom;
+};
+
+struct CommandRouterStats {
+  uint32_t dispatched;
+  uint32_t unknown;
+  uint32_t rejected;                 // Bad JSON, no name or bad arguments
+};
+
+// ─────────────────────────────────────────────────────────────────────
+// COMPILE-TIME TABLE CHECK
+// ─────────────────────────────────────────────────────────────────────
+
+constexpr int commandNameCompare(const char* a, const char* b) {
+  return (*a == '\0' || *a != *b) ? (int)(unsigned char)*a - (int)(unsigned char)*b
+                                  : commandNameCompare(a + 1, b + 1);
+}
+
+template <size_t N>
+constexpr bool commandTableSorted(const Command (&table)[N], size_t i = 1) {
+  return i >= N || (commandNameCompare(table[i - 1].name, table[i].name) < 0 && commandTableSorted(table, i + 1));
+}
+
+// NATS subject match: * is one token, > is one or more trailing tokens
+inline bool natsSubjectMatches(const char* pattern, const char* subject) {
+  for (;;) {
+    const char* pe = strchr(pattern, '.');
+    const char* se = strchr(subject, '.');
+    size_t pl = pe ? (size_t)(pe - pattern) : strlen(pattern);
+    size_t sl = se ? (size_t)(se - subject) : strlen(subject);
+    if (pl == 1 && *pattern == '>') return sl > 0;
+    bool star = pl == 1 && *pattern == '*';
+    if (!star && (pl != sl || memcmp(pattern, subject, pl) != 0)) return false;
+    if (star && sl == 0) return false;
+    if (!pe || !se) return !pe && !se;
+    pattern = pe + 1;
+    subject = se + 1;
+  }
+}
+
+// ─────────────────────────────────────────────────────────────────────
+// HANDLER VIEW
+// ─────────────────────────────────────────────────────────────────────
+
+class CommandCall {
+public:
+  CommandCall(const NatsOp& message, const Command& cmd) : op(message), command(cmd) {
+    memset(_present, 0, sizeof(_present));
+  }
+
+  const NatsOp& op;
+  const Command& command;
+
+  bool isRequest() const { return op.replyTo[0] != '\0'; }
+  bool has(uint8_t arg) const { return arg < CMD_MAX_ARGS && _present[arg]; }
+
+  const char* str(uint8_t arg, const char* fallback = "") const { return has(arg) ? _value[arg].s : fallback; }
+  long integer(uint8_t arg, long fallback = 0) const { return has(arg) ? _value[arg].i : fallback; }
+  double number(uint8_t arg, double fallback = 0) const { return has(arg) ? _value[arg].f : fallback; }
+  bool flag(uint8_t arg, bool fallback = false) const { return has(arg) ? _value[arg].b : fallback; }
+
+private:
+  friend class CommandRouter;
+
+  union Value {
+    const char* s;
+    long i;
+    double f;
+    bool b;
+  };
+
+  bool _present[CMD_MAX_ARGS];
+  Value _value[CMD_MAX_ARGS];
+  char _text[CMD_TEXT_MAX];
+};
+
+// ─────────────────────────────────────────────────────────────────────
+// ROUTER
+// ─────────────────────────────────────────────────────────────────────
+
+class CommandRouter {
+public:
+  CommandRouter(const CommandRoute* routes, size_t count) : _routes(routes), _routeCount(count) {
+    memset(&stats, 0, sizeof(stats));
+    _error[0] = '\0';
+  }
+
+  size_t routes() const { return _routeCount; }
+  const CommandRoute& route(size_t i) const { return _routes[i]; }
+
+  // Route, parse and run one message. On failure error() says why.
+  CommandResult dispatch(const NatsOp& op) {
+    const CommandRoute* match = findRoute(op.subject);
+    if (!match) return fail(CMD_UNROUTED, "no route for subject");
+
+    // One pass over the body: top-level fields, values left unparsed
+    Field fields[CMD_MAX_FIELDS];
+    uint8_t fieldCount = 0;
+    const Field* nameField = NULL;
+    Field named;
+    const char* p = skipSpace(op.payload, op.payload + op.payloadLen);
+    if (p < op.payload + op.payloadLen) {
+      if (!scanObject(p, op.payload + op.payloadLen, fields, &fieldCount, &named)) {
+        return fail(CMD_BAD_JSON, "invalid json");
+      }
+      if (named.key) nameField = &named;
+    }
+
+    char name[CMD_NAME_MAX + 1];
+    name[0] = '\0';
+    if (match->nameFrom == CMD_NAME_FROM_SUBJECT) {
+      const char* token = strrchr(op.subject, '.');
+      token = token ? token + 1 : op.subject;
+      if (strlen(token) <= CMD_NAME_MAX) strcpy(name, token);
+    } else if (nameField && nameField->value[0] == '"' &&
+               !unescape(nameField->value, nameField->valueLen, name, sizeof(name))) {
+      name[0] = '\0';  // Too long to be one of ours
+    }
+    if (!name[0]) return fail(CMD_NO_NAME, "missing command");
+
+    const Command* cmd = findCommand(match, name);
+    if (!cmd) {
+      stats.unknown++;
+      snprintf(_error, sizeof(_error), "unknown command %s", name);
+      return CMD_UNKNOWN;
+    }
+
+    CommandCall call(op, *cmd);
+    size_t textUsed = 0;
+    for (uint8_t a = 0; a < CMD_MAX_ARGS && cmd->args[a].name; a++) {
+      const CommandArgSpec& spec = cmd->args[a];
+      const Field* f = findField(fields, fieldCount, spec.name);
+      if (!f || isNull(*f)) {
+        if (spec.required) return failArg(CMD_BAD_ARGS, "missing argument", spec.name);
+        continue;
+      }
+      if (!convert(*f, spec.type, &call._value[a], call._text, &textUsed)) {
+        return failArg(CMD_BAD_ARGS, "bad argument", spec.name);
+      }
+      call._present[a] = true;
+    }
+
+    stats.dispatched++;
+    _error[0] = '\0';
+    cmd->handler(call);
+    return CMD_OK;
+  }
+
+  const char* error() const { return _error; }
+
+  CommandRouterStats stats;
+
+private:
+  struct Field {
+    const char* key;                 // Raw key text, between the quotes
+    size_t keyLen;
+    const char* value;               // Raw JSON value
+    size_t valueLen;
+  };
+
+  const CommandRoute* _routes;
+  size_t _routeCount;
+  char _error[64];
+
+  CommandResult fail(CommandResult r, const char* why) {
+    stats.rejected++;
+    snprintf(_error, sizeof(_error), "%s", why);
+    return r;
+  }
+
+  CommandResult failArg(CommandResult r, const char* why, const char* arg) {
+    stats.rejected++;
+    snprintf(_error, sizeof(_error), "%s %s", why, arg);
+    return r;
+  }
+
+  const CommandRoute* findRoute(const char* subject) const {
+    for (size_t i = 0; i < _routeCount; i++) {
+      if (natsSubjectMatches(_routes[i].subject, subject)) return &_routes[i];
+    }
+    return NULL;
+  }
+
+  static const Command* findCommand(const CommandRoute* route, const char* name) {
+    size_t lo = 0, hi = route->count;
+    while (lo < hi) {
+      size_t mid = (lo + hi) / 2;
+      int c = strcmp(name, route->commands[mid].name);
+      if (c == 0) return &route->commands[mid];
+      if (c < 0) hi = mid;
+      else lo = mid + 1;
+    }
+    return NULL;
+  }
+
+  static const Field* findField(const Field* fields, uint8_t count, const char* key) {
+    size_t len = strlen(key);
+    for (uint8_t i = 0; i < count; i++) {
+      if (fields[i].keyLen == len && memcmp(fields[i].key, key, len) == 0) return &fields[i];
+    }
+    return NULL;
+  }
+
+  // ── JSON scanning (structure only, values stay raw) ──
+
+  static bool isSpace(char c) { return c == ' ' || c == '\t' || c == '\r' || c == '\n'; }
+
+  static const char* skipSpace(const char* p, const char* end) {
+    while (p < end && isSpace(*p)) p++;
+    return p;
+  }
+
+  // p at the opening quote. Returns just past the closing quote.
+  static const char* skipString(const char* p, const char* end) {
+    for (p++; p < end; p++) {
+      if (*p == '\\') p++;
+      else if (*p == '"') return p + 1;
+    }
+    return NULL;
+  }
+
+  static const char* skipValue(const char* p, const char* end) {
+    if (p >= end) return NULL;
+    if (*p == '"') return skipString(p, end);
+    if (*p == '{' || *p == '[') {
+      int depth = 0;
+      while (p < end) {
+        if (*p == '"') {
+          if (!(p = skipString(p, end))) return NULL;
+          continue;
+        }
+        if (*p == '{' || *p == '[') depth++;
+        else if ((*p == '}' || *p == ']') && --depth == 0) return p + 1;
+        p++;
+      }
+      return NULL;
+    }
+    const char* start = p;
+    while (p < end && !isSpace(*p) && *p != ',' && *p != '}' && *p != ']') p++;
+    return p > start ? p : NULL;
+  }
+
+  // Top-level fields of an object; the command-name field is kept aside
+  // so it's found wherever it sits
+  static bool scanObject(const char* p, const char* end, Field* fields, uint8_t* count, Field* named) {
+    named->key = NULL;
+    if (*p++ != '{') return false;
+    p = skipSpace(p, end);
+    if (p < end && *p == '}') return true;
+    while (p < end) {
+      if (*p != '"') return false;
+      const char* keyEnd = skipString(p, end);
+      if (!keyEnd) return false;
+      Field f;
+      f.key = p + 1;
+      f.keyLen = keyEnd - p - 2;
+      p = skipSpace(keyEnd, end);
+      if (p >= end || *p++ != ':') return false;
+      p = skipSpace(p, end);
+      const char* valueEnd = skipValue(p, end);
+      if (!valueEnd) return false;
+      f.value = p;
+      f.valueLen = valueEnd - p;
+
+      if (f.keyLen == sizeof(CMD_NAME_FIELD) - 1 && memcmp(f.key, CMD_NAME_FIELD, f.keyLen) == 0) *named = f;
+      else if (*count < CMD_MAX_FIELDS) fields[(*count)++] = f;
+
+      p = skipSpace(valueEnd, end);
+      if (p >= end) return false;
+      if (*p == '}') return true;
+      if (*p++ != ',') return false;
+      p = skipSpace(p, end);
+    }
+    return false;
+  }
+
+  // ── Conversion of declared arguments only ──
+
+  static bool isNull(const Field& f) { return f.valueLen == 4 && memcmp(f.value, "null", 4) == 0; }
+
+  // Quoted JSON string -> out (NUL-terminated). False if it doesn't fit.
+  static bool unescape(const char* v, size_t len, char* out, size_t cap) {
+    size_t n = 0;
+    for (size_t i = 1; i + 1 < len; i++) {
+      char c = v[i];
+      if (c == '\\') {
+        c = v[++i];
+        switch (c) {
+          case 'n': c = '\n'; break;
+          case 't': c = '\t'; break;
+          case 'r': c = '\r'; break;
+          case 'b': c = '\b'; break;
+          case 'f': c = '\f'; break;
+          case 'u': {
+            if (i + 4 >= len) return false;
+            char hex[5] = {v[i + 1], v[i + 2], v[i + 3], v[i + 4], '\0'};
+            long cp = strtol(hex, NULL, 16);
+            c = cp < 0x80 ? (char)cp : '?';  // Commands are ASCII
+            i += 4;
+            break;
+          }
+          default: break;                   // \" \\ \/
+        }
+      }
+      if (n + 1 >= cap) return false;
+      out[n++] = c;
+    }
+    out[n] = '\0';
+    return true;
+  }
+
+  static bool convert(const Field& f, CommandArgType type, CommandCall::Value* out, char* text, size_t* textUsed) {
+    if (type == CMD_ARG_STRING) {
+      if (f.value[0] != '"') return false;
+      char* dst = text + *textUsed;
+      if (!unescape(f.value, f.valueLen, dst, CMD_TEXT_MAX - *textUsed)) return false;
+      out->s = dst;
+      *textUsed += strlen(dst) + 1;
+      return true;
+    }
+    if (type == CMD_ARG_BOOL) {
+      if (f.valueLen == 4 && memcmp(f.value, "true", 4) == 0) out->b = true;
+      else if (f.valueLen == 5 && memcmp(f.value, "false", 5) == 0) out->b = false;
+      else return false;
+      return true;
+    }
+
+    char num[32];
+    if (f.valueLen >= sizeof(num)) return false;
+    memcpy(num, f.value, f.valueLen);
+    num[f.valueLen] = '\0';
+    char* end;
+    if (type == CMD_ARG_INT) out->i = strtol(num, &end, 10);
+    else out->f = strtod(num, &end);
+    return end != num && *end == '\0';
+  }
+};
+
+#endif // COMMAND_ROUTER_H
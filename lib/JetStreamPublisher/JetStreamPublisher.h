@@ -0,0 +1,239 @@
+#ifndef JETSTREAM_PUBLISHER_H
+#define JETSTREAM_PUBLISHER_H
+
+#include <Arduino.h>
+#include <NatsOutbox.h>
+#include <NatsInbox.h>
+
+/*
+ * ═══════════════════════════════════════════════════════════════════════
+ * BLACKROAD JETSTREAM PUBLISHER
+ * ═══════════════════════════════════════════════════════════════════════
+ *
+ * At-least-once publishing into JetStream streams:
+ * - Every message goes out as HPUB with a Nats-Msg-Id header and a reply
+ *   subject from the device's NatsInbox; the stream answers
+ *   {"stream":..,"seq":..} there
+ * - Up to JS_WINDOW publishes are in flight at once (pipelined, not
+ *   stop-and-wait); each keeps a copy until its ack arrives
+ * - No ack within JS_ACK_TIMEOUT_MS (or an error ack): retransmitted with
+ *   the same Msg-Id, so the server's duplicate window drops any copy it
+ *   already stored. After JS_MAX_ATTEMPTS the message goes to the give-up
+ *   callback (e.g. back to an offline buffer)
+ * - A 503 "no responders" status means no stream captures the subject:
+ *   JetStream is switched off and everything in flight is given up;
+ *   begin() again switches it back on, end() switches it off by hand
+ * - Msg-Ids are <name>-<boot id>-<counter>: retransmits dedup, distinct
+ *   messages never collide, even across reboots
+ *
+ * Usage:
+ *   JetStreamPublisher js(outbox, inbox, "esp32-device1");
+ *   js.begin(bootId);                        // Acks arrive via inbox.handle()
+ *   if (!js.publish(subject, json, len)) queueForLater();   // Window full
+ *   js.tick();                               // Every loop()
+ *
+ * Used by the NATS firmware (esp32/device1).
+ */
+
+#ifndef JS_WINDOW
+#define JS_WINDOW 8
+#endif
+#ifndef JS_SUBJECT_MAX
+#define JS_SUBJECT_MAX 48
+#endif
+#ifndef JS_DATA_MAX
+#define JS_DATA_MAX 384
+#endif
+#define JS_ACK_TIMEOUT_MS 2000
+#define JS_MAX_ATTEMPTS 5
+
+struct JetStreamStats {
+  uint32_t published;        // Distinct messages
+  uint32_t acked;
+  uint32_t duplicates;       // Acks flagged "duplicate" (a retransmit landed twice)
+  uint32_t retransmits;
+  uint32_t errors;           // Error acks
+  uint32_t gaveUp;
+  uint32_t ackMsTotal;       // Sum of publish -> ack latency
+};
+
+class JetStreamPublisher {
+public:
+  // Called with a message that is no longer tracked
+  typedef void (*GiveUpFn)(const char* subject, const char* data, size_t len, void* ctx);
+
+  JetStreamPublisher(NatsOutbox& outbox, NatsInbox& inbox, const char* name)
+    : _outbox(outbox), _inbox(inbox), _name(name), _enabled(false), _nextId(0),
+      _giveUp(NULL), _giveUpCtx(NULL) {
+    memset(&stats, 0, sizeof(stats));
+    memset(_slots, 0, sizeof(_slots));
+  }
+
+  // bootId goes into every Msg-Id (the inbox should get the same one).
+  // Calling it again after end() keeps counting, so Msg-Ids stay unique.
+  void begin(uint32_t bootId) {
+    snprintf(_boot, sizeof(_boot), "%08lx", (unsigned long)bootId);
+    _enabled = true;
+  }
+
+  // Plain PUB from now on - everything in flight goes to the give-up callback
+  void end() {
+    _enabled = false;
+    giveUpAll();
+  }
+
+  void onGiveUp(GiveUpFn fn, void* ctx) {
+    _giveUp = fn;
+    _giveUpCtx = ctx;
+  }
+
+  bool enabled() const { return _enabled; }
+
+  // Publish into the window. False when it's full (or the message can't
+  // be tracked) - the caller keeps it and tries again later.
+  bool publish(const char* subject, const char* data, size_t len) {
+    if (!_enabled || len > JS_DATA_MAX || strlen(subject) > JS_SUBJECT_MAX) return false;
+    Slot* s = freeSlot();
+    if (!s) return false;
+    s->token = _inbox.open(onAck, this, s->reply, sizeof(s->reply));
+    if (!s->token) return false;
+
+    s->used = true;
+    s->id = ++_nextId;
+    s->attempts = 0;
+    strcpy(s->subject, subject);
+    memcpy(s->data, data, len);
+    s->len = len;
+    s->firstSentAt = millis();
+    stats.published++;
+    send(s);  // A failed write is retransmitted like a lost ack
+    return true;
+  }
+
+  // Retransmit what timed out. Call every loop() while connected.
+  void tick() {
+    if (!_enabled) return;
+    unsigned long now = millis();
+    for (int i = 0; i < JS_WINDOW; i++) {
+      Slot* s = &_slots[i];
+      if (!s->used || now - s->sentAt < JS_ACK_TIMEOUT_MS) continue;
+      if (s->attempts >= JS_MAX_ATTEMPTS) {
+        giveUp(s);
+        continue;
+      }
+      stats.retransmits++;
+      send(s);
+    }
+  }
+
+  // After a reconnect: resend everything in flight (same Msg-Ids)
+  void rewind() {
+    for (int i = 0; i < JS_WINDOW; i++) {
+      if (_slots[i].used) send(&_slots[i]);
+    }
+  }
+
+  uint8_t inFlight() const {
+    uint8_t n = 0;
+    for (int i = 0; i < JS_WINDOW; i++) n += _slots[i].used;
+    return n;
+  }
+
+  uint8_t room() const { return _enabled ? JS_WINDOW - inFlight() : 0; }
+
+  uint32_t avgAckMs() const { return stats.acked ? stats.ackMsTotal / stats.acked : 0; }
+
+  JetStreamStats stats;
+
+private:
+  struct Slot {
+    bool used;
+    uint8_t attempts;
+    uint16_t len;
+    uint32_t id;               // Msg-Id counter
+    uint32_t token;            // Inbox token the acks come back on
+    unsigned long firstSentAt;
+    unsigned long sentAt;
+    char reply[NATS_INBOX_REPLY_MAX + 1];
+    char subject[JS_SUBJECT_MAX + 1];
+    char data[JS_DATA_MAX];
+  };
+
+  NatsOutbox& _outbox;
+  NatsInbox& _inbox;
+  const char* _name;
+  bool _enabled;
+  uint32_t _nextId;
+  char _boot[9];
+  Slot _slots[JS_WINDOW];
+  GiveUpFn _giveUp;
+  void* _giveUpCtx;
+
+  Slot* freeSlot() {
+    for (int i = 0; i < JS_WINDOW; i++) {
+      if (!_slots[i].used) return &_slots[i];
+    }
+    return NULL;
+  }
+
+  Slot* findSlot(uint32_t token) {
+    for (int i = 0; i < JS_WINDOW; i++) {
+      if (_slots[i].used && _slots[i].token == token) return &_slots[i];
+    }
+    return NULL;
+  }
+
+  static void onAck(uint32_t token, const NatsOp* reply, void* ctx) {
+    ((JetStreamPublisher*)ctx)->handleAck(token, *reply);
+  }
+
+  void handleAck(uint32_t token, const NatsOp& op) {
+    Slot* s = findSlot(token);
+    if (!s) return;  // Late ack for something already settled
+
+    if (NatsInbox::noResponders(op)) {
+      // No stream listens on this subject - plain PUB from now on
+      end();
+      return;
+    }
+    if (strstr(op.payload, "\"error\"")) {
+      stats.errors++;
+      s->sentAt = millis() - JS_ACK_TIMEOUT_MS;  // Retransmit on the next tick
+      return;
+    }
+
+    if (strstr(op.payload, "\"duplicate\":true")) stats.duplicates++;
+    stats.acked++;
+    stats.ackMsTotal += millis() - s->firstSentAt;
+    release(s);
+  }
+
+  void release(Slot* s) {
+    _inbox.close(s->token);
+    s->used = false;
+  }
+
+  bool send(Slot* s) {
+    char headers[96];
+    int headersLen = snprintf(headers, sizeof(headers), "NATS/1.0\r\nNats-Msg-Id: %s-%s-%lu\r\n\r\n",
+                              _name, _boot, (unsigned long)s->id);
+
+    s->attempts++;
+    s->sentAt = millis();
+    return _outbox.publish(s->subject, s->reply, headers, headersLen, s->data, s->len);
+  }
+
+  void giveUp(Slot* s) {
+    stats.gaveUp++;
+    release(s);
+    if (_giveUp) _giveUp(s->subject, s->data, s->len, _giveUpCtx);
+  }
+
+  void giveUpAll() {
+    for (int i = 0; i < JS_WINDOW; i++) {
+      if (_slots[i].used) giveUp(&_slots[i]);
+    }
+  }
+};
+
+#endif // JETSTREAM_PUBLISHER_H
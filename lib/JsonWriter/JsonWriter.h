@@ -0,0 +1,234 @@
+#ifndef JSON_WRITER_H
+#define JSON_WRITER_H
+
+#include <Arduino.h>
+#include <math.h>
+
+/*
+ * ═══════════════════════════════════════════════════════════════════════
+ * BLACKROAD ZERO-ALLOCATION JSON WRITER
+ * ═══════════════════════════════════════════════════════════════════════
+ *
+ * Builds JSON into a caller-provided buffer - no String, no heap:
+ * - Buffer mode: the whole document lands in buf (c_str() / length())
+ * - Stream mode: buf is scratch space, flushed to any Print (WiFiClient,
+ *   File, Serial) whenever it fills, so documents can exceed the buffer
+ * - Commas and escaping are handled; overflow is sticky and reported
+ *
+ * Usage:
+ *   char buf[256];
+ *   JsonWriter w(buf, sizeof(buf));
+ *   w.beginObject();
+ *   w.field("device", "esp32-01");
+ *   w.field("rssi", WiFi.RSSI());
+ *   w.endObject();
+ *   if (!w.overflowed()) send(w.c_str(), w.length());
+ *
+ * Shared by the dashboard (src/) and the NATS firmware (esp32/device1).
+ */
+
+#define JSON_WRITER_MAX_DEPTH 16
+#define JSON_WRITER_NUM_MAX 21      // "-9223372036854775808" + NUL: 64-bit long
+
+class JsonWriter {
+public:
+  // Buffer mode
+  JsonWriter(char* buf, size_t cap) : _buf(buf), _cap(cap), _len(0), _out(NULL) { reset(); }
+
+  // Stream mode - buf is scratch, flushed to out as it fills
+  JsonWriter(Print& out, char* buf, size_t cap) : _buf(buf), _cap(cap), _len(0), _out(&out) { reset(); }
+
+  void reset() {
+    _len = 0;
+    _written = 0;
+    _depth = 0;
+    _overflow = false;
+    _afterKey = false;
+    _inString = false;
+    _first[0] = true;
+    if (_cap) _buf[0] = '\0';
+  }
+
+  // ───────────────────────────────────────────────────────────────────
+  // STRUCTURE
+  // ───────────────────────────────────────────────────────────────────
+
+  void beginObject() { open('{'); }
+  void endObject() { close('}'); }
+  void beginArray() { open('['); }
+  void endArray() { close(']'); }
+
+  void key(const char* k) {
+    separator();
+    putQuoted(k);
+    put(':');
+    _afterKey = true;
+  }
+
+  // ───────────────────────────────────────────────────────────────────
+  // VALUES
+  // ───────────────────────────────────────────────────────────────────
+
+  void value(const char* v) {
+    if (!v) { nullValue(); return; }
+    separator();
+    putQuoted(v);
+  }
+
+  void value(bool v) { separator(); putRaw(v ? "true" : "false"); }
+  void value(int v) { value((long)v); }
+  void value(unsigned int v) { value((unsigned long)v); }
+
+  void value(long v) {
+    char num[JSON_WRITER_NUM_MAX];
+    snprintf(num, sizeof(num), "%ld", v);
+    separator();
+    putRaw(num);
+  }
+
+  void value(unsigned long v) {
+    char num[JSON_WRITER_NUM_MAX];
+    snprintf(num, sizeof(num), "%lu", v);
+    separator();
+    putRaw(num);
+  }
+
+  void value(double v, uint8_t decimals = 2) {
+    if (isnan(v) || isinf(v)) { nullValue(); return; }  // Not representable in JSON
+    char num[24];
+    snprintf(num, sizeof(num), "%.*f", decimals, v);
+    separator();
+    putRaw(num);
+  }
+
+  void nullValue() { separator(); putRaw("null"); }
+
+  // Pre-serialized JSON (caller guarantees validity)
+  void rawValue(const char* json) { separator(); putRaw(json); }
+
+  // A string value assembled from pieces, without a temporary String:
+  //   w.beginString(); w.stringPart(emoji); w.stringPart(" *"); ... w.endString();
+  void beginString() { separator(); put('"'); _inString = true; }
+  void stringPart(const char* s) { if (s && _inString) putEscaped(s); }
+  void stringPart(long v) { char num[JSON_WRITER_NUM_MAX]; snprintf(num, sizeof(num), "%ld", v); stringPart(num); }
+  void endString() { if (_inString) { put('"'); _inString = false; } }
+
+  // ───────────────────────────────────────────────────────────────────
+  // KEY + VALUE SHORTHANDS
+  // ───────────────────────────────────────────────────────────────────
+
+  template <typename T>
+  void field(const char* k, T v) { key(k); value(v); }
+  void field(const char* k, double v, uint8_t decimals) { key(k); value(v, decimals); }
+
+  void objectField(const char* k) { key(k); beginObject(); }
+  void arrayField(const char* k) { key(k); beginArray(); }
+
+  // ───────────────────────────────────────────────────────────────────
+  // RESULT
+  // ───────────────────────────────────────────────────────────────────
+
+  // Stream mode: push what's buffered to the Print
+  void flush() {
+    if (_out && _len) {
+      _out->write((const uint8_t*)_buf, _len);
+      _len = 0;
+      if (_cap) _buf[0] = '\0';
+    }
+  }
+
+  const char* c_str() const { return _buf; }
+  size_t length() const { return _len; }           // Bytes currently in buf
+  size_t bytesWritten() const { return _written; } // Total document size
+  bool overflowed() const { return _overflow; }
+  bool complete() const { return _depth == 0 && !_overflow; }
+
+private:
+  char* _buf;
+  size_t _cap;
+  size_t _len;
+  size_t _written;
+  Print* _out;
+  uint8_t _depth;
+  bool _first[JSON_WRITER_MAX_DEPTH + 1];  // No element yet at this depth
+  bool _overflow;
+  bool _afterKey;
+  bool _inString;
+
+  void put(char c) {
+    // Keep one byte for the terminator
+    if (_len + 1 >= _cap) {
+      if (_out) {
+        flush();
+      }
+      if (_len + 1 >= _cap) {
+        _overflow = true;
+        return;
+      }
+    }
+    _buf[_len++] = c;
+    _buf[_len] = '\0';
+    _written++;
+  }
+
+  void putRaw(const char* s) {
+    while (*s) put(*s++);
+  }
+
+  void putEscaped(const char* s) {
+    static const char hex[] = "0123456789abcdef";
+    for (; *s; s++) {
+      uint8_t c = (uint8_t)*s;
+      switch (c) {
+        case '"':  put('\\'); put('"'); break;
+        case '\\': put('\\'); put('\\'); break;
+        case '\n': put('\\'); put('n'); break;
+        case '\r': put('\\'); put('r'); break;
+        case '\t': put('\\'); put('t'); break;
+        case '\b': put('\\'); put('b'); break;
+        case '\f': put('\\'); put('f'); break;
+        default:
+          if (c < 0x20) {
+            put('\\'); put('u'); put('0'); put('0');
+            put(hex[c >> 4]); put(hex[c & 0xF]);
+          } else {
+            put((char)c);  // UTF-8 (emoji) passes through
+          }
+      }
+    }
+  }
+
+  void putQuoted(const char* s) {
+    put('"');
+    putEscaped(s);
+    put('"');
+  }
+
+  // Comma before every element except the first at this depth
+  void separator() {
+    if (_afterKey) {
+      _afterKey = false;
+      return;
+    }
+    if (!_first[_depth]) put(',');
+    _first[_depth] = false;
+  }
+
+  void open(char c) {
+    separator();
+    put(c);
+    if (_depth < JSON_WRITER_MAX_DEPTH) {
+      _depth++;
+      _first[_depth] = true;
+    } else {
+      _overflow = true;
+    }
+  }
+
+  void close(char c) {
+    if (_depth > 0) _depth--;
+    put(c);
+  }
+};
+
+#endif // JSON_WRITER_H
@@ -0,0 +1,212 @@
+#ifndef NATS_INBOX_H
+#define NATS_INBOX_H
+
+#include <Arduino.h>
+#include <NatsOutbox.h>
+#include <NatsParser.h>
+
+/*
+ * ═══════════════════════════════════════════════════════════════════════
+ * BLACKROAD NATS INBOX
+ * ═══════════════════════════════════════════════════════════════════════
+ *
+ * Request/reply over a single subscription. The device subscribes once to
+ * _INBOX.<name>.* and every outstanding request gets its own token under
+ * that prefix, so any number can be in flight without a SUB/UNSUB round
+ * trip each:
+ * - request() publishes with reply subject _INBOX.<name>.<boot><token>
+ *   and files the callback under the token. The reply (or the timeout)
+ *   calls it exactly once and frees the slot
+ * - open() / close() reserve a token without publishing, for owners that
+ *   reuse one reply subject and settle it themselves (JetStream acks)
+ * - A 503 status reply means nobody was listening - see noResponders()
+ * - respond() answers an incoming request on its reply subject
+ * - The boot id in every token keeps replies addressed to a previous boot
+ *   from matching anything
+ *
+ * Usage:
+ *   NatsInbox inbox(outbox, "esp32-device1");
+ *   inbox.begin(esp_random());
+ *   inbox.subscribe();                        // After every (re)connect
+ *   inbox.request("svc.time", "{}", 2, onTime, NULL, 1000);
+ *   if (inbox.handle(op)) return;             // From the parser callback
+ *   inbox.tick();                             // Every loop()
+ *
+ * Used by the NATS firmware (esp32/device1).
+ */
+
+#ifndef NATS_INBOX_SLOTS
+#define NATS_INBOX_SLOTS 16
+#endif
+#define NATS_INBOX_REPLY_MAX 64      // "_INBOX." + name + "." + boot + token
+#define NATS_INBOX_SID "2"
+
+struct NatsInboxStats {
+  uint32_t requests;
+  uint32_t replies;
+  uint32_t timeouts;
+  uint32_t unmatched;        // Late, stale-boot or unknown tokens
+  uint32_t full;             // Refused: every slot taken
+  uint32_t responses;        // Answers we sent to incoming requests
+};
+
+class NatsInbox {
+public:
+  // reply is NULL when a request() timed out
+  typedef void (*ReplyFn)(uint32_t token, const NatsOp* reply, void* ctx);
+
+  NatsInbox(NatsOutbox& outbox, const char* name)
+    : _outbox(outbox), _name(name), _nextToken(0), _baseLen(0), _prefixLen(0) {
+    memset(&stats, 0, sizeof(stats));
+    memset(_slots, 0, sizeof(_slots));
+    _prefix[0] = '\0';
+  }
+
+  void begin(uint32_t bootId) {
+    _baseLen = snprintf(_prefix, sizeof(_prefix), "_INBOX.%s.", _name);
+    _prefixLen = _baseLen + snprintf(_prefix + _baseLen, sizeof(_prefix) - _baseLen, "%08lx",
+                                     (unsigned long)bootId);
+  }
+
+  // The wildcard subscription - needed on every connection
+  void subscribe() {
+    char sub[96];
+    int len = snprintf(sub, sizeof(sub), "SUB %.*s* " NATS_INBOX_SID "\r\n", (int)_baseLen, _prefix);
+    _outbox.control(sub, len);
+  }
+
+  // Publish a request. Returns its token, 0 if it couldn't be sent.
+  uint32_t request(const char* subject, const char* payload, size_t len,
+                   ReplyFn fn, void* ctx, uint32_t timeoutMs) {
+    char reply[NATS_INBOX_REPLY_MAX + 1];
+    uint32_t token = open(fn, ctx, reply, sizeof(reply));
+    if (!token) return 0;
+    if (!_outbox.publish(subject, reply, NULL, 0, payload, len)) {
+      close(token);
+      return 0;
+    }
+    Slot* s = findSlot(token);
+    s->once = true;
+    s->timeoutMs = timeoutMs;
+    stats.requests++;
+    return token;
+  }
+
+  // Reserve a token and write its reply subject. The slot stays until
+  // close(). Returns 0 when every slot is taken.
+  uint32_t open(ReplyFn fn, void* ctx, char* reply, size_t replySize) {
+    if (_prefixLen == 0) return 0;
+    Slot* s = freeSlot();
+    if (!s) {
+      stats.full++;
+      return 0;
+    }
+    if (++_nextToken == 0) _nextToken = 1;
+    s->token = _nextToken;
+    s->once = false;
+    s->fn = fn;
+    s->ctx = ctx;
+    s->openedAt = millis();
+    s->timeoutMs = 0;
+    snprintf(reply, replySize, "%s%lu", _prefix, (unsigned long)s->token);
+    return s->token;
+  }
+
+  void close(uint32_t token) {
+    Slot* s = findSlot(token);
+    if (s) s->token = 0;
+  }
+
+  // Feed every MSG from the parser. True if it was addressed to the inbox.
+  bool handle(const NatsOp& op) {
+    if (_baseLen == 0 || strncmp(op.subject, _prefix, _baseLen) != 0) return false;
+
+    Slot* s = NULL;
+    if (strncmp(op.subject + _baseLen, _prefix + _baseLen, _prefixLen - _baseLen) == 0) {
+      char* end;
+      uint32_t token = strtoul(op.subject + _prefixLen, &end, 10);
+      if (*end == '\0') s = findSlot(token);
+    }
+    if (!s) {
+      stats.unmatched++;
+      return true;
+    }
+
+    stats.replies++;
+    uint32_t token = s->token;
+    ReplyFn fn = s->fn;
+    void* ctx = s->ctx;
+    if (s->once) s->token = 0;  // Free first: the callback may request again
+    if (fn) fn(token, &op, ctx);
+    return true;
+  }
+
+  // Expire requests nobody answered. Call every loop().
+  void tick() {
+    unsigned long now = millis();
+    for (int i = 0; i < NATS_INBOX_SLOTS; i++) {
+      Slot* s = &_slots[i];
+      if (!s->token || !s->once || now - s->openedAt < s->timeoutMs) continue;
+      uint32_t token = s->token;
+      s->token = 0;
+      stats.timeouts++;
+      if (s->fn) s->fn(token, NULL, s->ctx);
+    }
+  }
+
+  // Answer an incoming request. False if it had no reply subject.
+  bool respond(const NatsOp& req, const char* payload, size_t len) {
+    if (!req.replyTo[0]) return false;
+    stats.responses++;
+    _outbox.publish(req.replyTo, payload, len);
+    return true;
+  }
+
+  // A 503 status reply: no subscriber (or stream) took the request
+  static bool noResponders(const NatsOp& reply) {
+    return strncmp(reply.headers, "NATS/1.0 503", 12) == 0;
+  }
+
+  uint8_t pending() const {
+    uint8_t n = 0;
+    for (int i = 0; i < NATS_INBOX_SLOTS; i++) n += _slots[i].token != 0;
+    return n;
+  }
+
+  NatsInboxStats stats;
+
+private:
+  struct Slot {
+    uint32_t token;            // 0 = free
+    bool once;                 // request(): freed on reply or timeout
+    ReplyFn fn;
+    void* ctx;
+    unsigned long openedAt;
+    uint32_t timeoutMs;
+  };
+
+  NatsOutbox& _outbox;
+  const char* _name;
+  uint32_t _nextToken;
+  size_t _baseLen;           // "_INBOX.<name>."
+  size_t _prefixLen;         // ... + boot id
+  char _prefix[NATS_INBOX_REPLY_MAX - 10 + 1];
+  Slot _slots[NATS_INBOX_SLOTS];
+
+  Slot* freeSlot() {
+    for (int i = 0; i < NATS_INBOX_SLOTS; i++) {
+      if (!_slots[i].token) return &_slots[i];
+    }
+    return NULL;
+  }
+
+  Slot* findSlot(uint32_t token) {
+    if (!token) return NULL;
+    for (int i = 0; i < NATS_INBOX_SLOTS; i++) {
+      if (_slots[i].token == token) return &_slots[i];
+    }
+    return NULL;
+  }
+};
+
+#endif // NATS_INBOX_H
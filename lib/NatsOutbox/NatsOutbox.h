@@ -0,0 +1,196 @@
+#ifndef NATS_OUTBOX_H
+#define NATS_OUTBOX_H
+
+#include <Arduino.h>
+#include <Client.h>
+
+/*
+ * ═══════════════════════════════════════════════════════════════════════
+ * BLACKROAD NATS OUTBOX
+ * ═══════════════════════════════════════════════════════════════════════
+ *
+ * Write buffer for the client side of the NATS protocol. PUB / HPUB frames
+ * are built in place ("PUB <subject> <len>\r\n<payload>\r\n"), and many of them
+ * go out together in one socket write instead of one small TCP segment
+ * per message:
+ * - Size: a frame that doesn't fit flushes what's buffered first
+ * - Time: tick() flushes once the oldest buffered byte is flushMs old
+ * - Explicit: flush(), for things that must leave now (CONNECT, PONG)
+ * - Control lines (SUB, PING, PONG) go through the same buffer, so a PING
+ *   is always sent after the PUBs queued before it
+ * - No heap: one fixed buffer; frames larger than it are written straight
+ *   through after a flush
+ *
+ * A failed write drops the buffer and returns false - the connection is
+ * gone, and anything that must survive that is journaled by the caller.
+ *
+ * Usage:
+ *   NatsOutbox outbox(client, 20);
+ *   outbox.publish("sensors", json, len);   // Buffered
+ *   outbox.tick();                          // Every loop()
+ *
+ * Used by the NATS firmware (esp32/device1).
+ */
+
+#ifndef NATS_OUTBOX_BYTES
+#define NATS_OUTBOX_BYTES 1436       // One TCP segment at the lwIP default MSS
+#endif
+#define NATS_OUTBOX_SUBJECT_MAX 64
+
+struct NatsOutboxStats {
+  uint32_t frames;           // PUBs framed
+  uint32_t writes;           // Socket writes
+  uint32_t bytes;
+  uint32_t sizeFlushes;
+  uint32_t timeFlushes;
+  uint32_t explicitFlushes;
+  uint32_t failures;         // Writes the socket refused
+};
+
+class NatsOutbox {
+public:
+  NatsOutbox(Client& client, uint32_t flushMs) : _client(client), _flushMs(flushMs) {
+    memset(&stats, 0, sizeof(stats));
+    clear();
+  }
+
+  // Frame one PUB. Returns false if a write failed.
+  bool publish(const char* subject, const char* payload, size_t len) {
+    return publish(subject, NULL, NULL, 0, payload, len);
+  }
+
+  // PUB with a reply subject, or HPUB when there are headers
+  // ("NATS/1.0\r\nKey: value\r\n\r\n"). reply may be NULL.
+  bool publish(const char* subject, const char* reply, const char* headers, size_t headersLen,
+               const char* payload, size_t len) {
+    size_t subjectLen = strlen(subject);
+    size_t replyLen = reply ? strlen(reply) : 0;
+    if (subjectLen > NATS_OUTBOX_SUBJECT_MAX || replyLen > NATS_OUTBOX_SUBJECT_MAX) {
+      return true;  // Retrying won't help
+    }
+
+    // "HPUB <subject> <reply> <#header bytes> <#total bytes>\r\n"
+    char line[5 + NATS_OUTBOX_SUBJECT_MAX + 1 + NATS_OUTBOX_SUBJECT_MAX + 1 + 10 + 1 + 10 + 2];
+    size_t n = 0;
+    if (headersLen) append(line, n, "HPUB ", 5);
+    else append(line, n, "PUB ", 4);
+    append(line, n, subject, subjectLen);
+    line[n++] = ' ';
+    if (replyLen) {
+      append(line, n, reply, replyLen);
+      line[n++] = ' ';
+    }
+    if (headersLen) {
+      n += formatSize(line + n, headersLen);
+      line[n++] = ' ';
+    }
+    n += formatSize(line + n, headersLen + len);
+    append(line, n, "\r\n", 2);
+
+    size_t frameLen = n + headersLen + len + 2;
+    stats.frames++;
+
+    if (_len + frameLen > sizeof(_buf) && _len > 0) {
+      stats.sizeFlushes++;
+      if (!writeBuffered()) return false;
+    }
+
+    if (frameLen > sizeof(_buf)) {
+      // Too big to buffer - straight through
+      return writeRaw(line, n) && (!headersLen || writeRaw(headers, headersLen)) &&
+             writeRaw(payload, len) && writeRaw("\r\n", 2);
+    }
+
+    if (_len == 0) _firstAt = millis();
+    append(_buf, _len, line, n);
+    append(_buf, _len, headers, headersLen);
+    append(_buf, _len, payload, len);
+    append(_buf, _len, "\r\n", 2);
+    return true;
+  }
+
+  // A protocol line ("PING\r\n", "SUB x 1\r\n"), kept in order with PUBs
+  bool control(const char* line, size_t len) {
+    if (_len + len > sizeof(_buf)) {
+      if (_len > 0) {
+        stats.sizeFlushes++;
+        if (!writeBuffered()) return false;
+      }
+      if (len > sizeof(_buf)) return writeRaw(line, len);
+    }
+    if (_len == 0) _firstAt = millis();
+    append(_buf, _len, line, len);
+    return true;
+  }
+
+  bool control(const char* line) { return control(line, strlen(line)); }
+
+  bool flush() {
+    if (_len == 0) return true;
+    stats.explicitFlushes++;
+    return writeBuffered();
+  }
+
+  // Time-based flush. Call every loop().
+  bool tick() {
+    if (_len == 0 || millis() - _firstAt < _flushMs) return true;
+    stats.timeFlushes++;
+    return writeBuffered();
+  }
+
+  // Drop anything unsent (connection closed)
+  void clear() {
+    _len = 0;
+    _firstAt = 0;
+  }
+
+  size_t buffered() const { return _len; }
+
+  // Average PUBs per socket write x100
+  uint32_t framesPerWriteX100() const {
+    return stats.writes ? (uint32_t)((uint64_t)stats.frames * 100 / stats.writes) : 0;
+  }
+
+  NatsOutboxStats stats;
+
+private:
+  Client& _client;
+  uint32_t _flushMs;
+  char _buf[NATS_OUTBOX_BYTES];
+  size_t _len;
+  unsigned long _firstAt;
+
+  static void append(char* dst, size_t& pos, const char* src, size_t n) {
+    if (n) memcpy(dst + pos, src, n);
+    pos += n;
+  }
+
+  static size_t formatSize(char* out, size_t v) {
+    char rev[10];
+    size_t n = 0;
+    do {
+      rev[n++] = '0' + v % 10;
+      v /= 10;
+    } while (v && n < sizeof(rev));
+    for (size_t i = 0; i < n; i++) out[i] = rev[n - 1 - i];
+    return n;
+  }
+
+  bool writeRaw(const char* data, size_t len) {
+    stats.writes++;
+    if (_client.write((const uint8_t*)data, len) != len) {
+      stats.failures++;
+      return false;
+    }
+    stats.bytes += len;
+    return true;
+  }
+
+  bool writeBuffered() {
+    bool ok = writeRaw(_buf, _len);
+    clear();
+    return ok;
+  }
+};
+
+#endif // NATS_OUTBOX_H
@@ -0,0 +1,324 @@
+#ifndef NATS_PARSER_H
+#define NATS_PARSER_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+/*
+ * ═══════════════════════════════════════════════════════════════════════
+ * BLACKROAD NATS PROTOCOL PARSER
+ * ═══════════════════════════════════════════════════════════════════════
+ *
+ * Incremental, allocation-free parser for the server side of the NATS
+ * client protocol: INFO, MSG, HMSG, PING, PONG, +OK, -ERR.
+ * - Feed it whatever bytes the socket has; ops may be split anywhere
+ *   (fragmented) or many may arrive in one read (pipelined)
+ * - Every complete op is handed to the callback straight away, so one
+ *   parse() call can deliver hundreds of messages
+ * - Control lines and payloads go into fixed buffers. An INFO longer than
+ *   the line buffer is delivered truncated; a payload over NATS_PAYLOAD_MAX
+ *   is skipped and delivered with `truncated` set (no data)
+ * - Anything malformed puts the parser in an error state until reset() -
+ *   a byte stream can't be resynced, the caller reconnects. A callback
+ *   that drops the connection calls abort() to stop delivery
+ *
+ * Platform neutral (no Arduino headers), so it can be fed from a host.
+ *
+ * Usage:
+ *   void onOp(const NatsOp& op, void* ctx) {
+ *     if (op.type == NATS_OP_MSG) handle(op.subject, op.payload, op.payloadLen);
+ *   }
+ *   NatsParser parser(onOp, NULL);
+ *   if (!parser.parse(buf, n)) reconnect();
+ *
+ * Used by the NATS firmware (esp32/device1).
+ */
+
+#ifndef NATS_CTRL_MAX
+#define NATS_CTRL_MAX 256            // Longest control line we keep
+#endif
+#ifndef NATS_PAYLOAD_MAX
+#define NATS_PAYLOAD_MAX 1024        // Largest payload we deliver
+#endif
+
+enum NatsOpType {
+  NATS_OP_INFO,
+  NATS_OP_MSG,                       // Also HMSG (headerLen > 0)
+  NATS_OP_PING,
+  NATS_OP_PONG,
+  NATS_OP_OK,
+  NATS_OP_ERR
+};
+
+struct NatsOp {
+  NatsOpType type;
+  const char* args;                  // INFO JSON / -ERR text (NUL-terminated)
+  bool truncated;                    // INFO cut short, or MSG payload dropped
+
+  // MSG / HMSG - all NUL-terminated, valid during the callback only
+  const char* subject;
+  const char* sid;
+  const char* replyTo;               // "" when absent
+  const char* headers;               // HMSG header block ("" for MSG)
+  uint32_t headerLen;
+  const char* payload;               // After the headers
+  uint32_t payloadLen;
+};
+
+struct NatsParserStats {
+  uint32_t ops;
+  uint32_t msgs;
+  uint32_t bytes;
+  uint32_t truncated;
+};
+
+typedef void (*NatsOpHandler)(const NatsOp& op, void* ctx);
+
+class NatsParser {
+public:
+  NatsParser(NatsOpHandler handler, void* ctx) : _handler(handler), _ctx(ctx) {
+    memset(&stats, 0, sizeof(stats));
+    reset();
+  }
+
+  void reset() {
+    _state = ST_LINE;
+    _lineLen = 0;
+    _lineOverflow = false;
+    _error = NULL;
+  }
+
+  // Consume len bytes. Returns false once the stream is malformed.
+  bool parse(const uint8_t* data, size_t len) {
+    if (_error) return false;
+    stats.bytes += len;
+    const uint8_t* p = data;
+    const uint8_t* end = data + len;
+
+    while (p < end) {
+      if (_error) return false;  // A callback called abort()
+      switch (_state) {
+        case ST_LINE: {
+          // Copy up to the newline in one go
+          const uint8_t* nl = (const uint8_t*)memchr(p, '\n', end - p);
+          const uint8_t* stop = nl ? nl : end;
+          appendLine(p, stop - p);
+          p = stop;
+          if (!nl) break;
+          p++;
+          if (!lineDone()) return false;
+          break;
+        }
+
+        case ST_PAYLOAD: {
+          size_t n = end - p;
+          if (n > _remaining) n = _remaining;
+          if (!_msgTruncated) memcpy(_payload + _payloadHave, p, n);
+          _payloadHave += n;
+          _remaining -= n;
+          p += n;
+          if (_remaining == 0) _state = ST_PAYLOAD_CR;
+          break;
+        }
+
+        case ST_PAYLOAD_CR:
+          if (*p++ != '\r') return fail("payload not followed by CRLF");
+          _state = ST_PAYLOAD_LF;
+          break;
+
+        case ST_PAYLOAD_LF:
+          if (*p++ != '\n') return fail("payload not followed by CRLF");
+          deliverMsg();
+          _state = ST_LINE;
+          _lineLen = 0;
+          _lineOverflow = false;
+          break;
+      }
+    }
+    return !_error;
+  }
+
+  // Stop parsing (e.g. from a callback that dropped the connection)
+  void abort(const char* why) { _error = why; }
+
+  const char* error() const { return _error; }  // NULL while healthy
+
+  NatsParserStats stats;
+
+private:
+  enum State {
+    ST_LINE,                         // Control line up to '\n'
+    ST_PAYLOAD,
+    ST_PAYLOAD_CR,
+    ST_PAYLOAD_LF
+  };
+
+  NatsOpHandler _handler;
+  void* _ctx;
+  State _state;
+  const char* _error;
+
+  char _line[NATS_CTRL_MAX + 1];
+  size_t _lineLen;
+  bool _lineOverflow;
+
+  // Current MSG / HMSG (strings point into _line)
+  char _payload[NATS_PAYLOAD_MAX + 1];
+  uint32_t _payloadHave;
+  uint32_t _remaining;
+  uint32_t _headerLen;
+  uint32_t _totalLen;
+  bool _msgTruncated;
+  const char* _subject;
+  const char* _sid;
+  const char* _replyTo;
+
+  bool fail(const char* why) {
+    _error = why;
+    return false;
+  }
+
+  void appendLine(const uint8_t* p, size_t n) {
+    size_t room = NATS_CTRL_MAX - _lineLen;
+    if (n > room) {
+      n = room;
+      _lineOverflow = true;
+    }
+    memcpy(_line + _lineLen, p, n);
+    _lineLen += n;
+  }
+
+  static bool isSpace(char c) { return c == ' ' || c == '\t'; }
+
+  static char upper(char c) { return (c >= 'a' && c <= 'z') ? c - 32 : c; }
+
+  // Verbs are case-insensitive; `word` is upper case
+  bool verbIs(const char* word, size_t n) const {
+    if (_lineLen < n) return false;
+    for (size_t i = 0; i < n; i++) {
+      if (upper(_line[i]) != word[i]) return false;
+    }
+    return _lineLen == n || isSpace(_line[n]);
+  }
+
+  // Arguments after the verb, trimmed
+  char* argsAfter(size_t n) {
+    char* a = _line + n;
+    while (isSpace(*a)) a++;
+    return a;
+  }
+
+  // Split args in place on whitespace. Returns the count, max `max`.
+  static int splitArgs(char* s, char** out, int max) {
+    int count = 0;
+    while (*s) {
+      while (isSpace(*s)) *s++ = '\0';
+      if (!*s) break;
+      if (count == max) return max + 1;
+      out[count++] = s;
+      while (*s && !isSpace(*s)) s++;
+    }
+    return count;
+  }
+
+  static bool parseSize(const char* s, uint32_t* out) {
+    if (!*s) return false;
+    uint32_t v = 0;
+    for (; *s; s++) {
+      if (*s < '0' || *s > '9' || v > 0x0FFFFFFF) return false;
+      v = v * 10 + (*s - '0');
+    }
+    *out = v;
+    return true;
+  }
+
+  void emit(NatsOpType type, const char* args, bool truncated) {
+    NatsOp op;
+    memset(&op, 0, sizeof(op));
+    op.type = type;
+    op.args = args;
+    op.truncated = truncated;
+    op.subject = op.sid = op.replyTo = op.headers = op.payload = "";
+    stats.ops++;
+    _handler(op, _ctx);
+  }
+
+  // A full control line is in _line (without the '\n')
+  bool lineDone() {
+    if (_lineLen > 0 && _line[_lineLen - 1] == '\r') _lineLen--;
+    _line[_lineLen] = '\0';
+    bool overflow = _lineOverflow;
+    _lineOverflow = false;
+    if (_lineLen == 0) return true;  // Stray blank line
+
+    bool ok = true;
+    if (verbIs("INFO", 4)) emit(NATS_OP_INFO, argsAfter(4), overflow);
+    else if (overflow) ok = fail("control line too long");
+    else if (verbIs("MSG", 3)) ok = startMsg(argsAfter(3), false);
+    else if (verbIs("HMSG", 4)) ok = startMsg(argsAfter(4), true);
+    else if (verbIs("PING", 4)) emit(NATS_OP_PING, "", false);
+    else if (verbIs("PONG", 4)) emit(NATS_OP_PONG, "", false);
+    else if (verbIs("+OK", 3)) emit(NATS_OP_OK, "", false);
+    else if (verbIs("-ERR", 4)) emit(NATS_OP_ERR, argsAfter(4), false);
+    else ok = fail("unknown operation");
+    _lineLen = 0;  // MSG fields stay in _line until the payload is delivered
+    return ok;
+  }
+
+  // MSG  <subject> <sid> [reply-to] <#bytes>
+  // HMSG <subject> <sid> [reply-to] <#header bytes> <#total bytes>
+  bool startMsg(char* args, bool headers) {
+    char* argv[5];
+    int argc = splitArgs(args, argv, 5);
+    int sizes = headers ? 2 : 1;
+    if (argc < 2 + sizes || argc > 3 + sizes) return fail("malformed MSG");
+
+    _subject = argv[0];
+    _sid = argv[1];
+    _replyTo = argc == 3 + sizes ? argv[2] : "";
+    _headerLen = 0;
+    if (headers && !parseSize(argv[argc - 2], &_headerLen)) return fail("malformed HMSG size");
+    if (!parseSize(argv[argc - 1], &_totalLen)) return fail("malformed MSG size");
+    if (_headerLen > _totalLen) return fail("HMSG headers larger than message");
+
+    _msgTruncated = _totalLen > NATS_PAYLOAD_MAX;
+    _payloadHave = 0;
+    _remaining = _totalLen;
+    _state = _remaining ? ST_PAYLOAD : ST_PAYLOAD_CR;
+    return true;
+  }
+
+  void deliverMsg() {
+    NatsOp op;
+    memset(&op, 0, sizeof(op));
+    op.type = NATS_OP_MSG;
+    op.args = "";
+    op.subject = _subject;
+    op.sid = _sid;
+    op.replyTo = _replyTo;
+    op.truncated = _msgTruncated;
+
+    if (_msgTruncated) {
+      op.headers = op.payload = "";
+      stats.truncated++;
+    } else {
+      // Both parts NUL-terminated in place: the header block always ends
+      // in "\r\n\r\n", so its last '\n' becomes the terminator
+      _payload[_totalLen] = '\0';
+      op.headers = "";
+      op.headerLen = _headerLen;
+      op.payload = _payload + _headerLen;
+      op.payloadLen = _totalLen - _headerLen;
+      if (_headerLen > 0) {
+        _payload[_headerLen - 1] = '\0';
+        op.headers = _payload;
+      }
+    }
+    stats.ops++;
+    stats.msgs++;
+    _handler(op, _ctx);
+  }
+};
+
+#endif // NATS_PARSER_H
@@ -0,0 +1,186 @@
+#ifndef OFFLINE_RING_H
+#define OFFLINE_RING_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+/*
+ * ═══════════════════════════════════════════════════════════════════════
+ * BLACKROAD OFFLINE RING
+ * ═══════════════════════════════════════════════════════════════════════
+ *
+ * Fixed-memory ring of encoded outbound messages, kept in RAM while the
+ * link is down and drained in order once it's back:
+ * - OFFLINE_RING_SLOTS slots of one message each; no heap
+ * - Every message has a kind (e.g. one per subject) with its own slot
+ *   quota and policy when that quota or the ring is full:
+ *     RING_DROP_OLDEST  evict the kind's oldest message (or the ring's
+ *                       oldest when the ring is full) to make room
+ *     RING_DROP_NEWEST  refuse the new message
+ * - Evicted messages go to an optional spill callback first (e.g. a flash
+ *   journal); only those it refuses count as dropped
+ * - Order is kept per kind; evicting by kind can reorder across kinds
+ *
+ * Platform neutral (no Arduino headers).
+ *
+ * Usage:
+ *   OfflineRing ring;
+ *   ring.setPolicy(KIND_SENSORS, OFFLINE_RING_SLOTS, RING_DROP_OLDEST);
+ *   ring.push(KIND_SENSORS, "sensors", json, len);     // While offline
+ *   const OfflineRing::Entry* e;
+ *   while ((e = ring.peek()) && send(e->topic, e->data, e->dataLen)) ring.pop();
+ *
+ * Used by the NATS firmware (esp32/device1).
+ */
+
+#ifndef OFFLINE_RING_SLOTS
+#define OFFLINE_RING_SLOTS 16
+#endif
+#ifndef OFFLINE_RING_KINDS
+#define OFFLINE_RING_KINDS 4
+#endif
+#ifndef OFFLINE_RING_TOPIC_MAX
+#define OFFLINE_RING_TOPIC_MAX 48
+#endif
+#ifndef OFFLINE_RING_DATA_MAX
+#define OFFLINE_RING_DATA_MAX 384
+#endif
+
+enum RingDropPolicy {
+  RING_DROP_OLDEST,
+  RING_DROP_NEWEST
+};
+
+struct OfflineRingStats {
+  uint32_t pushed;
+  uint32_t drained;          // Popped after sending
+  uint32_t evicted;          // Pushed out to make room
+  uint32_t spilled;          // Evicted and taken by the spill callback
+  uint32_t dropped;          // Lost: refused (DROP_NEWEST) or evicted unspilled
+  uint32_t rejected;         // Too large for a slot
+};
+
+class OfflineRing {
+public:
+  struct Entry {
+    uint8_t kind;
+    uint16_t dataLen;
+    char topic[OFFLINE_RING_TOPIC_MAX + 1];
+    char data[OFFLINE_RING_DATA_MAX + 1];  // NUL-terminated for convenience
+  };
+
+  // Return true if the evicted entry was kept elsewhere
+  typedef bool (*SpillFn)(const Entry& entry, void* ctx);
+
+  OfflineRing() : _spill(NULL), _spillCtx(NULL) {
+    memset(&stats, 0, sizeof(stats));
+    for (int k = 0; k < OFFLINE_RING_KINDS; k++) {
+      _maxSlots[k] = OFFLINE_RING_SLOTS;
+      _policy[k] = RING_DROP_OLDEST;
+    }
+    clear();
+  }
+
+  void setPolicy(uint8_t kind, uint8_t maxSlots, RingDropPolicy policy) {
+    if (kind >= OFFLINE_RING_KINDS) return;
+    _maxSlots[kind] = maxSlots;
+    _policy[kind] = policy;
+  }
+
+  void onSpill(SpillFn fn, void* ctx) {
+    _spill = fn;
+    _spillCtx = ctx;
+  }
+
+  // Store a message. Returns false if it was refused.
+  bool push(uint8_t kind, const char* topic, const char* data, size_t len) {
+    if (kind >= OFFLINE_RING_KINDS) kind = OFFLINE_RING_KINDS - 1;
+    if (len > OFFLINE_RING_DATA_MAX || strlen(topic) > OFFLINE_RING_TOPIC_MAX || _maxSlots[kind] == 0) {
+      stats.rejected++;
+      return false;
+    }
+
+    bool kindFull = _kindCount[kind] >= _maxSlots[kind];
+    if ((kindFull || _count == OFFLINE_RING_SLOTS) && _policy[kind] == RING_DROP_NEWEST) {
+      stats.dropped++;
+      return false;
+    }
+    if (kindFull) evict(findOldest(kind));
+    if (_count == OFFLINE_RING_SLOTS) evict(0);
+
+    uint8_t slot = _free[--_freeCount];
+    Entry* e = &_slots[slot];
+    e->kind = kind;
+    e->dataLen = len;
+    strcpy(e->topic, topic);
+    memcpy(e->data, data, len);
+    e->data[len] = '\0';
+
+    _order[_count++] = slot;
+    _kindCount[kind]++;
+    stats.pushed++;
+    return true;
+  }
+
+  // Oldest message, NULL when empty
+  const Entry* peek() const {
+    return _count ? &_slots[_order[0]] : NULL;
+  }
+
+  // Remove the oldest message once it has been sent
+  void pop() {
+    if (_count == 0) return;
+    remove(0);
+    stats.drained++;
+  }
+
+  void clear() {
+    _count = 0;
+    _freeCount = OFFLINE_RING_SLOTS;
+    for (int i = 0; i < OFFLINE_RING_SLOTS; i++) _free[i] = OFFLINE_RING_SLOTS - 1 - i;
+    memset(_kindCount, 0, sizeof(_kindCount));
+  }
+
+  uint8_t count() const { return _count; }
+  uint8_t count(uint8_t kind) const { return kind < OFFLINE_RING_KINDS ? _kindCount[kind] : 0; }
+
+  OfflineRingStats stats;
+
+private:
+  Entry _slots[OFFLINE_RING_SLOTS];
+  uint8_t _order[OFFLINE_RING_SLOTS];    // Slot indices, oldest first
+  uint8_t _count;
+  uint8_t _free[OFFLINE_RING_SLOTS];     // Stack of unused slots
+  uint8_t _freeCount;
+  uint8_t _kindCount[OFFLINE_RING_KINDS];
+  uint8_t _maxSlots[OFFLINE_RING_KINDS];
+  uint8_t _policy[OFFLINE_RING_KINDS];
+  SpillFn _spill;
+  void* _spillCtx;
+
+  int findOldest(uint8_t kind) const {
+    for (int i = 0; i < _count; i++) {
+      if (_slots[_order[i]].kind == kind) return i;
+    }
+    return 0;
+  }
+
+  void evict(int pos) {
+    const Entry& e = _slots[_order[pos]];
+    stats.evicted++;
+    if (_spill && _spill(e, _spillCtx)) stats.spilled++;
+    else stats.dropped++;
+    remove(pos);
+  }
+
+  void remove(int pos) {
+    uint8_t slot = _order[pos];
+    _kindCount[_slots[slot].kind]--;
+    memmove(_order + pos, _order + pos + 1, _count - pos - 1);
+    _count--;
+    _free[_freeCount++] = slot;
+  }
+};
+
+#endif // OFFLINE_RING_H
@@ -0,0 +1,459 @@
+#ifndef OUTBOUND_JOURNAL_H
+#define OUTBOUND_JOURNAL_H
+
+#include <Arduino.h>
+#include <FS.h>
+
+/*
+ * ═══════════════════════════════════════════════════════════════════════
+ * BLACKROAD OUTBOUND JOURNAL
+ * ═══════════════════════════════════════════════════════════════════════
+ *
+ * Bounded append-only journal in flash for outbound events (alerts,
+ * telemetry, decisions) produced while the link is down:
+ * - Records go into numbered segment files under one directory; the
+ *   journal never holds more than maxSegments x segmentBytes
+ * - When full, the oldest segment is dropped (counted in stats.dropped)
+ * - read() replays in append order, ack(seq) confirms delivery up to seq;
+ *   fully acked segments are deleted, an empty journal is wiped
+ * - Every record carries a CRC, so a write torn by a reset is skipped on
+ *   the next begin() instead of replaying garbage
+ * - Delivery is at-least-once: the ack cursor is persisted every
+ *   JOURNAL_ACK_PERSIST_EVERY acks (and on every compaction), so a reset
+ *   can replay a few already-delivered records
+ *
+ * stats.flashBytes / stats.payloadBytes is the write amplification
+ * (record headers + ack metadata); readUs / appendUs give the replay and
+ * append throughput of the underlying flash.
+ *
+ * Not thread safe - callers sharing a journal hold their own lock.
+ *
+ * Usage:
+ *   OutboundJournal journal(SPIFFS, "/jrnl", 4096, 8);
+ *   journal.begin();
+ *   journal.append(kind, "topic", data, len);        // While offline
+ *   OutboundJournal::Record rec;
+ *   while (journal.read(rec)) send(rec.topic, rec.data, rec.dataLen);
+ *   journal.ack(rec.seq);                             // Once delivered
+ *
+ * Shared by the dashboard (src/) and the NATS firmware (esp32/device1).
+ */
+
+#ifndef JOURNAL_TOPIC_MAX
+#define JOURNAL_TOPIC_MAX 64
+#endif
+#ifndef JOURNAL_DATA_MAX
+#define JOURNAL_DATA_MAX 512
+#endif
+#define JOURNAL_ACK_PERSIST_EVERY 16
+#define JOURNAL_RECORD_MAGIC 0xB10C
+#define JOURNAL_META_MAGIC 0x4A524E4C        // "JRNL"
+
+struct JournalStats {
+  uint32_t appended;
+  uint32_t replayed;         // Records handed out by read()
+  uint32_t acked;
+  uint32_t dropped;          // Unacked records lost to the size bound
+  uint32_t rejected;         // Too large or the write failed
+  uint32_t corrupt;          // Records skipped on a bad CRC
+  uint32_t payloadBytes;     // Topic + data bytes handed to append()
+  uint32_t flashBytes;       // Everything written: headers, data, metadata
+  uint32_t appendUs;         // Time spent in append()
+  uint32_t readUs;           // Time spent in read()
+};
+
+class OutboundJournal {
+public:
+  struct Record {
+    uint32_t seq;
+    uint8_t kind;
+    uint16_t dataLen;
+    char topic[JOURNAL_TOPIC_MAX + 1];
+    char data[JOURNAL_DATA_MAX + 1];  // NUL-terminated for convenience
+  };
+
+  OutboundJournal(fs::FS& fs, const char* dir, uint32_t segmentBytes, uint16_t maxSegments)
+    : _fs(fs), _dir(dir), _segmentBytes(segmentBytes), _maxSegments(maxSegments) {
+    memset(&stats, 0, sizeof(stats));
+    resetState(0, 0);
+  }
+
+  JournalStats stats;
+
+  // Recover the journal left by the previous boot. Returns false if the
+  // filesystem could not be read (the journal then starts empty).
+  bool begin() {
+    _fs.mkdir(_dir);  // LittleFS needs it, SPIFFS ignores it
+
+    uint32_t meta[3] = {0, 0, 0};
+    char path[40];
+    metaPath(path, sizeof(path));
+    File f = _fs.open(path, "r");
+    if (f) {
+      if (f.read((uint8_t*)meta, sizeof(meta)) != sizeof(meta) || meta[0] != JOURNAL_META_MAGIC) {
+        meta[1] = meta[2] = 0;
+      }
+      f.close();
+    }
+    resetState(meta[1], meta[2]);
+
+    // Meta may lag a head segment deleted right before a reset
+    uint32_t seg = _headSeg;
+    for (int probes = 0; !segmentExists(seg) && probes < _maxSegments; probes++) seg++;
+    if (!segmentExists(seg)) return true;  // Empty journal
+
+    _headSeg = seg;
+    _tailSeg = seg;
+    while (segmentExists(_tailSeg + 1)) _tailSeg++;
+
+    // Find the last good record and the first unacked one
+    uint32_t lastSeq = _ackSeq;
+    for (seg = _headSeg; seg <= _tailSeg; seg++) {
+      uint32_t good = scanSegment(seg, &lastSeq);
+      if (seg == _tailSeg) {
+        _tailBytes = good;
+        _tailSealed = good < segmentSize(seg);  // Torn tail - append to a fresh segment
+      }
+    }
+    _nextSeq = lastSeq + 1;
+    rewind();
+    return true;
+  }
+
+  // Returns the record's sequence number, 0 if it was rejected
+  uint32_t append(uint8_t kind, const char* topic, const void* data, size_t len) {
+    unsigned long start = micros();
+    size_t topicLen = topic ? strlen(topic) : 0;
+    size_t recLen = sizeof(Header) + topicLen + len;
+    if (topicLen > JOURNAL_TOPIC_MAX || len > JOURNAL_DATA_MAX || recLen > _segmentBytes) {
+      stats.rejected++;
+      return 0;
+    }
+
+    if (_tailSealed || _tailBytes + recLen > _segmentBytes) {
+      _tailSeg++;
+      _tailBytes = 0;
+      _tailSealed = false;
+      while (_tailSeg - _headSeg + 1 > _maxSegments) dropHead();
+    }
+
+    Header h;
+    h.magic = JOURNAL_RECORD_MAGIC;
+    h.kind = kind;
+    h.topicLen = topicLen;
+    h.dataLen = len;
+    h.seq = _nextSeq;
+    h.crc = crc16(0xFFFF, &h.seq, sizeof(h.seq));
+    h.crc = crc16(h.crc, topic, topicLen);
+    h.crc = crc16(h.crc, data, len);
+
+    char path[40];
+    segmentPath(_tailSeg, path, sizeof(path));
+    File f = _fs.open(path, "a");
+    size_t written = 0;
+    if (f) {
+      written += f.write((const uint8_t*)&h, sizeof(h));
+      if (topicLen) written += f.write((const uint8_t*)topic, topicLen);
+      if (len) written += f.write((const uint8_t*)data, len);
+      f.close();
+    }
+    stats.flashBytes += written;
+
+    if (written != recLen) {
+      _tailSealed = true;  // Partial record - never append after it
+      _tailBytes += written;
+      stats.rejected++;
+      stats.appendUs += micros() - start;
+      return 0;
+    }
+
+    _tailBytes += recLen;
+    stats.appended++;
+    stats.payloadBytes += topicLen + len;
+    stats.appendUs += micros() - start;
+    return _nextSeq++;
+  }
+
+  // Next record after the read cursor. The record stays in the journal
+  // until ack() covers its seq.
+  bool read(Record& rec) {
+    unsigned long start = micros();
+    bool found = false;
+
+    while (!found && _readSeg <= _tailSeg) {
+      char path[40];
+      segmentPath(_readSeg, path, sizeof(path));
+      File f = _fs.open(path, "r");
+      uint32_t size = f ? f.size() : 0;
+      if (_readSeg == _tailSeg && size > _tailBytes) size = _tailBytes;
+
+      if (f && _readOff < size) f.seek(_readOff);
+      while (f && _readOff < size) {
+        Header h;
+        if (!readRecord(f, size - _readOff, h, rec)) {
+          stats.corrupt++;
+          _readOff = size;  // Rest of the segment is unreadable
+          break;
+        }
+        _readOff += sizeof(Header) + h.topicLen + h.dataLen;
+        if (h.seq <= _readSeq) continue;  // Acked before the last reset
+        found = true;
+        break;
+      }
+      if (f) f.close();
+
+      if (found) break;
+      if (_readSeg == _tailSeg) break;  // Caught up
+      _readSeg++;
+      _readOff = 0;
+    }
+
+    if (found) {
+      _readSeq = rec.seq;
+      stats.replayed++;
+    }
+    stats.readUs += micros() - start;
+    return found;
+  }
+
+  // Everything up to and including seq was delivered
+  void ack(uint32_t seq) {
+    if (seq >= _nextSeq) seq = _nextSeq - 1;
+    if (seq <= _ackSeq) return;
+    stats.acked += seq - _ackSeq;
+    _unpersistedAcks += seq - _ackSeq;
+    _ackSeq = seq;
+    if (_readSeq < _ackSeq) _readSeq = _ackSeq;
+
+    if (pending() == 0) {
+      // Nothing left - wipe every segment and start fresh after the tail
+      for (uint32_t seg = _headSeg; seg <= _tailSeg; seg++) removeSegment(seg);
+      _headSeg = _tailSeg = _tailSeg + 1;
+      _tailBytes = 0;
+      _tailSealed = false;
+      _readSeg = _headSeg;
+      _readOff = 0;
+      persistMeta();
+      return;
+    }
+
+    // Drop leading segments whose records are all acked
+    bool compacted = false;
+    while (_headSeg < _tailSeg) {
+      uint32_t nextFirst = firstSeq(_headSeg + 1);
+      if (nextFirst == 0 || nextFirst - 1 > _ackSeq) break;
+      removeSegment(_headSeg);
+      _headSeg++;
+      compacted = true;
+    }
+    if (_readSeg < _headSeg) {
+      _readSeg = _headSeg;
+      _readOff = 0;
+    }
+    if (compacted || _unpersistedAcks >= JOURNAL_ACK_PERSIST_EVERY) persistMeta();
+  }
+
+  // Re-deliver everything not acked yet (e.g. after a reconnect)
+  void rewind() {
+    _readSeg = _headSeg;
+    _readOff = 0;
+    _readSeq = _ackSeq;
+  }
+
+  uint32_t pending() const { return _nextSeq - 1 - _ackSeq; }   // Not acked
+  uint32_t unread() const { return _nextSeq - 1 - _readSeq; }   // Not read yet
+  uint32_t lastSeq() const { return _nextSeq - 1; }
+  uint32_t sizeBytes() const {
+    return (_tailSeg - _headSeg) * _segmentBytes + _tailBytes;  // Upper bound
+  }
+
+  // Flash bytes written per payload byte, x100
+  uint32_t writeAmplificationX100() const {
+    if (stats.payloadBytes == 0) return 0;
+    return (uint32_t)((uint64_t)stats.flashBytes * 100 / stats.payloadBytes);
+  }
+
+  uint32_t replayPerSec() const {
+    if (stats.readUs == 0) return 0;
+    return (uint32_t)((uint64_t)stats.replayed * 1000000 / stats.readUs);
+  }
+
+private:
+  struct Header {
+    uint16_t magic;
+    uint8_t kind;
+    uint8_t topicLen;
+    uint16_t dataLen;
+    uint16_t crc;              // CRC-16/CCITT over seq, topic and data
+    uint32_t seq;
+  };
+
+  fs::FS& _fs;
+  const char* _dir;
+  uint32_t _segmentBytes;
+  uint16_t _maxSegments;
+
+  uint32_t _headSeg;         // Oldest segment on flash
+  uint32_t _tailSeg;         // Segment being appended to
+  uint32_t _tailBytes;
+  bool _tailSealed;          // Tail holds a torn record
+  uint32_t _nextSeq;
+  uint32_t _ackSeq;
+  uint32_t _unpersistedAcks;
+  uint32_t _readSeg;
+  uint32_t _readOff;
+  uint32_t _readSeq;         // Last seq handed out by read()
+
+  void resetState(uint32_t headSeg, uint32_t ackSeq) {
+    _headSeg = _tailSeg = headSeg;
+    _tailBytes = 0;
+    _tailSealed = false;
+    _ackSeq = ackSeq;
+    _nextSeq = ackSeq + 1;
+    _unpersistedAcks = 0;
+    _readSeg = headSeg;
+    _readOff = 0;
+    _readSeq = ackSeq;
+  }
+
+  static uint16_t crc16(uint16_t crc, const void* data, size_t len) {
+    const uint8_t* p = (const uint8_t*)data;
+    while (len--) {
+      crc ^= (uint16_t)(*p++) << 8;
+      for (int i = 0; i < 8; i++) crc = crc & 0x8000 ? (crc << 1) ^ 0x1021 : crc << 1;
+    }
+    return crc;
+  }
+
+  void segmentPath(uint32_t seg, char* path, size_t cap) const {
+    snprintf(path, cap, "%s/%08lx", _dir, (unsigned long)seg);
+  }
+
+  void metaPath(char* path, size_t cap) const {
+    snprintf(path, cap, "%s/meta", _dir);
+  }
+
+  bool segmentExists(uint32_t seg) {
+    char path[40];
+    segmentPath(seg, path, sizeof(path));
+    return _fs.exists(path);
+  }
+
+  uint32_t segmentSize(uint32_t seg) {
+    char path[40];
+    segmentPath(seg, path, sizeof(path));
+    File f = _fs.open(path, "r");
+    if (!f) return 0;
+    uint32_t size = f.size();
+    f.close();
+    return size;
+  }
+
+  void removeSegment(uint32_t seg) {
+    char path[40];
+    segmentPath(seg, path, sizeof(path));
+    _fs.remove(path);
+  }
+
+  // Read and verify one record at the file position. Caller has checked
+  // that `avail` bytes remain in the segment.
+  bool readRecord(File& f, uint32_t avail, Header& h, Record& rec) {
+    if (avail < sizeof(Header)) return false;
+    if (f.read((uint8_t*)&h, sizeof(h)) != sizeof(h)) return false;
+    if (h.magic != JOURNAL_RECORD_MAGIC) return false;
+    if (h.topicLen > JOURNAL_TOPIC_MAX || h.dataLen > JOURNAL_DATA_MAX) return false;
+    if (sizeof(Header) + h.topicLen + h.dataLen > avail) return false;
+
+    if (f.read((uint8_t*)rec.topic, h.topicLen) != h.topicLen) return false;
+    if (f.read((uint8_t*)rec.data, h.dataLen) != h.dataLen) return false;
+
+    uint16_t crc = crc16(0xFFFF, &h.seq, sizeof(h.seq));
+    crc = crc16(crc, rec.topic, h.topicLen);
+    crc = crc16(crc, rec.data, h.dataLen);
+    if (crc != h.crc) return false;
+
+    rec.topic[h.topicLen] = '\0';
+    rec.data[h.dataLen] = '\0';
+    rec.seq = h.seq;
+    rec.kind = h.kind;
+    rec.dataLen = h.dataLen;
+    return true;
+  }
+
+  // Walk a segment. Returns the byte length of its valid prefix and
+  // raises *lastSeq to the highest seq found.
+  uint32_t scanSegment(uint32_t seg, uint32_t* lastSeq) {
+    char path[40];
+    segmentPath(seg, path, sizeof(path));
+    File f = _fs.open(path, "r");
+    if (!f) return 0;
+
+    uint32_t size = f.size();
+    uint32_t off = 0;
+    Header h;
+    Record rec;
+    while (off < size && readRecord(f, size - off, h, rec)) {
+      off += sizeof(Header) + h.topicLen + h.dataLen;
+      if (h.seq > *lastSeq) *lastSeq = h.seq;
+    }
+    if (off < size) stats.corrupt++;
+    f.close();
+    return off;
+  }
+
+  // Seq of the first record in a segment, 0 if unreadable
+  uint32_t firstSeq(uint32_t seg) {
+    char path[40];
+    segmentPath(seg, path, sizeof(path));
+    File f = _fs.open(path, "r");
+    if (!f) return 0;
+    Header h;
+    bool ok = f.read((uint8_t*)&h, sizeof(h)) == sizeof(h) && h.magic == JOURNAL_RECORD_MAGIC;
+    f.close();
+    return ok ? h.seq : 0;
+  }
+
+  // Size bound hit - lose the oldest segment
+  void dropHead() {
+    char path[40];
+    segmentPath(_headSeg, path, sizeof(path));
+    File f = _fs.open(path, "r");
+    if (f) {
+      uint32_t size = f.size();
+      uint32_t off = 0;
+      Header h;
+      while (off + sizeof(Header) <= size && f.read((uint8_t*)&h, sizeof(h)) == sizeof(h) &&
+             h.magic == JOURNAL_RECORD_MAGIC) {
+        off += sizeof(Header) + h.topicLen + h.dataLen;
+        f.seek(off);
+        if (h.seq > _ackSeq) {
+          stats.dropped++;
+          _ackSeq = h.seq;  // Gone - nothing left to deliver up to here
+        }
+      }
+      f.close();
+    }
+    _fs.remove(path);
+    _headSeg++;
+
+    if (_readSeq < _ackSeq) _readSeq = _ackSeq;
+    if (_readSeg < _headSeg) {
+      _readSeg = _headSeg;
+      _readOff = 0;
+    }
+    persistMeta();
+  }
+
+  void persistMeta() {
+    uint32_t meta[3] = {JOURNAL_META_MAGIC, _headSeg, _ackSeq};
+    char path[40];
+    metaPath(path, sizeof(path));
+    File f = _fs.open(path, "w");
+    if (!f) return;
+    stats.flashBytes += f.write((const uint8_t*)meta, sizeof(meta));
+    f.close();
+    _unpersistedAcks = 0;
+  }
+};
+
+#endif // OUTBOUND_JOURNAL_H
@@ -0,0 +1,249 @@
+#ifndef SENSOR_PIPELINE_H
+#define SENSOR_PIPELINE_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <math.h>
+#include <float.h>
+#include <atomic>
+
+/*
+ * ═══════════════════════════════════════════════════════════════════════
+ * BLACKROAD SENSOR PIPELINE
+ * ═══════════════════════════════════════════════════════════════════════
+ *
+ * Fixed-rate sampling with windowed aggregation, so the sample rate and
+ * the publish rate are independent:
+ * - Sources are pluggable (read function + ctx), one channel each.
+ *   SyntheticSource gives deterministic data for mocks and host runs
+ * - sample() (producer, e.g. a timer task at SENSOR_SAMPLE_HZ) reads every
+ *   source into one frame and pushes it into a lock-free single-producer /
+ *   single-consumer ring. No locks, no heap; a full ring drops the frame
+ *   and counts an overrun
+ * - drain() (consumer, e.g. loop()) folds queued frames into the current
+ *   window with sensorAggregate(): min / max / mean / last / count
+ * - takeWindow() hands out the window and starts the next one - one
+ *   publish per window however many samples went into it
+ *
+ * Platform neutral (no Arduino headers).
+ *
+ * Usage:
+ *   SensorPipeline pipe;
+ *   int temp = pipe.addSource("temperature_c", readTemp, NULL);
+ *   pipe.sample(millis());                   // Sampling task
+ *   pipe.drain();                            // loop()
+ *   SensorWindow w[SENSOR_PIPELINE_CHANNELS];
+ *   pipe.takeWindow(w, millis());            // Every publish interval
+ *
+ * Used by the NATS firmware (esp32/device1) and tools/sensor_bench.
+ */
+
+#ifndef SENSOR_PIPELINE_CHANNELS
+#define SENSOR_PIPELINE_CHANNELS 4
+#endif
+#ifndef SENSOR_RING_FRAMES
+#define SENSOR_RING_FRAMES 256               // Power of two
+#endif
+#define SENSOR_DRAIN_BATCH 32
+
+// Return false when there is no reading this time (sensor busy, CRC error)
+typedef bool (*SensorReadFn)(float* value, void* ctx);
+
+struct SensorSource {
+  const char* name;
+  SensorReadFn read;
+  void* ctx;
+};
+
+// One sampling instant, every channel
+struct SensorFrame {
+  uint32_t atMs;
+  uint8_t valid;                             // Bit per channel
+  float v[SENSOR_PIPELINE_CHANNELS];
+};
+
+// Aggregate of one channel over one window
+struct SensorWindow {
+  float min;
+  float max;
+  float last;
+  float sum;
+  uint32_t count;
+
+  void reset() {
+    min = FLT_MAX;
+    max = -FLT_MAX;
+    last = 0;
+    sum = 0;
+    count = 0;
+  }
+
+  float mean() const { return count ? sum / count : 0; }
+};
+
+// The aggregation kernel: fold n frames into per-channel windows
+inline void sensorAggregate(const SensorFrame* frames, size_t n, uint8_t channels, SensorWindow* windows) {
+  for (uint8_t c = 0; c < channels; c++) {
+    SensorWindow& w = windows[c];
+    const uint8_t bit = 1 << c;
+    float lo = w.min, hi = w.max, last = w.last, sum = 0;
+    uint32_t count = 0;
+    for (size_t i = 0; i < n; i++) {
+      if (!(frames[i].valid & bit)) continue;
+      float v = frames[i].v[c];
+      lo = v < lo ? v : lo;
+      hi = v > hi ? v : hi;
+      sum += v;
+      last = v;
+      count++;
+    }
+    w.min = lo;
+    w.max = hi;
+    w.last = last;
+    w.sum += sum;
+    w.count += count;
+  }
+}
+
+// ─────────────────────────────────────────────────────────────────────
+// LOCK-FREE FRAME RING (one producer, one consumer)
+// ─────────────────────────────────────────────────────────────────────
+
+class SensorRing {
+public:
+  SensorRing() : _head(0), _tail(0), _overruns(0) {}
+
+  // Producer side. False (and an overrun) when the consumer fell behind.
+  bool push(const SensorFrame& f) {
+    uint32_t head = _head.load(std::memory_order_relaxed);
+    if (head - _tail.load(std::memory_order_acquire) == SENSOR_RING_FRAMES) {
+      _overruns.fetch_add(1, std::memory_order_relaxed);
+      return false;
+    }
+    _frames[head & (SENSOR_RING_FRAMES - 1)] = f;
+    _head.store(head + 1, std::memory_order_release);
+    return true;
+  }
+
+  // Consumer side. Copies out up to max frames, oldest first.
+  size_t pop(SensorFrame* out, size_t max) {
+    uint32_t tail = _tail.load(std::memory_order_relaxed);
+    uint32_t avail = _head.load(std::memory_order_acquire) - tail;
+    size_t n = avail < max ? avail : max;
+    for (size_t i = 0; i < n; i++) out[i] = _frames[(tail + i) & (SENSOR_RING_FRAMES - 1)];
+    _tail.store(tail + n, std::memory_order_release);
+    return n;
+  }
+
+  uint32_t queued() const {
+    return _head.load(std::memory_order_acquire) - _tail.load(std::memory_order_acquire);
+  }
+
+  uint32_t overruns() const { return _overruns.load(std::memory_order_relaxed); }
+
+private:
+  static_assert((SENSOR_RING_FRAMES & (SENSOR_RING_FRAMES - 1)) == 0, "SENSOR_RING_FRAMES must be a power of two");
+
+  SensorFrame _frames[SENSOR_RING_FRAMES];
+  std::atomic<uint32_t> _head;               // Written by the producer only
+  std::atomic<uint32_t> _tail;               // Written by the consumer only
+  std::atomic<uint32_t> _overruns;
+};
+
+// ─────────────────────────────────────────────────────────────────────
+// PIPELINE
+// ─────────────────────────────────────────────────────────────────────
+
+class SensorPipeline {
+public:
+  SensorPipeline() : _channels(0), _windowStart(0), _frames(0) {
+    for (int c = 0; c < SENSOR_PIPELINE_CHANNELS; c++) _window[c].reset();
+  }
+
+  // Register a source before sampling starts. Returns its channel, -1 if full.
+  int addSource(const char* name, SensorReadFn read, void* ctx) {
+    if (_channels == SENSOR_PIPELINE_CHANNELS) return -1;
+    _sources[_channels].name = name;
+    _sources[_channels].read = read;
+    _sources[_channels].ctx = ctx;
+    return _channels++;
+  }
+
+  // Producer: read every source once. False if the ring was full.
+  bool sample(uint32_t nowMs) {
+    SensorFrame f;
+    f.atMs = nowMs;
+    f.valid = 0;
+    for (uint8_t c = 0; c < _channels; c++) {
+      if (_sources[c].read(&f.v[c], _sources[c].ctx)) f.valid |= 1 << c;
+    }
+    return _ring.push(f);
+  }
+
+  // Consumer: fold everything queued into the current window.
+  // Returns the number of frames taken.
+  size_t drain() {
+    SensorFrame batch[SENSOR_DRAIN_BATCH];
+    size_t total = 0, n;
+    while ((n = _ring.pop(batch, SENSOR_DRAIN_BATCH)) > 0) {
+      sensorAggregate(batch, n, _channels, _window);
+      total += n;
+    }
+    _frames += total;
+    return total;
+  }
+
+  // Copy out the current window (call drain() first) and start the next.
+  // Returns the window length in ms.
+  uint32_t takeWindow(SensorWindow* out, uint32_t nowMs) {
+    memcpy(out, _window, sizeof(SensorWindow) * _channels);
+    for (uint8_t c = 0; c < _channels; c++) _window[c].reset();
+    uint32_t length = nowMs - _windowStart;
+    _windowStart = nowMs;
+    return length;
+  }
+
+  uint8_t channels() const { return _channels; }
+  const char* name(uint8_t channel) const { return channel < _channels ? _sources[channel].name : ""; }
+  uint32_t frames() const { return _frames; }          // Aggregated so far
+  uint32_t queued() const { return _ring.queued(); }   // Sampled, not yet drained
+  uint32_t overruns() const { return _ring.overruns(); }
+
+private:
+  SensorSource _sources[SENSOR_PIPELINE_CHANNELS];
+  uint8_t _channels;
+  SensorRing _ring;
+  SensorWindow _window[SENSOR_PIPELINE_CHANNELS];
+  uint32_t _windowStart;
+  uint32_t _frames;
+};
+
+// ─────────────────────────────────────────────────────────────────────
+// SYNTHETIC SOURCE
+// ─────────────────────────────────────────────────────────────────────
+
+// base + amplitude * sin(2π t / period) + uniform noise in ±noise, with t
+// advancing stepMs per read - deterministic for a given seed, so host
+// runs are repeatable. Stands in for a real sensor on the mock build.
+struct SyntheticSource {
+  float base;
+  float amplitude;
+  float periodMs;
+  float noise;
+  float stepMs;
+  uint32_t seed;
+  float phaseMs;                             // Kept within one period
+
+  static bool read(float* value, void* ctx) {
+    SyntheticSource* s = (SyntheticSource*)ctx;
+    s->seed = s->seed * 1664525u + 1013904223u;  // LCG
+    float jitter = ((s->seed >> 8) * (1.0f / 16777216.0f) * 2 - 1) * s->noise;
+    *value = s->base + s->amplitude * sinf(s->phaseMs * (6.2831853f / s->periodMs)) + jitter;
+    s->phaseMs += s->stepMs;
+    if (s->phaseMs >= s->periodMs) s->phaseMs -= s->periodMs;
+    return true;
+  }
+};
+
+#endif // SENSOR_PIPELINE_H
@@ -0,0 +1,323 @@
+#ifndef SNAPSHOT_PROTOCOL_H
+#define SNAPSHOT_PROTOCOL_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+/*
+ * ═══════════════════════════════════════════════════════════════════════
+ * BLACKROAD SNAPSHOT PROTOCOL (AGGREGATOR -> DEVICES)
+ * ═══════════════════════════════════════════════════════════════════════
+ *
+ * Fixed-schema binary snapshots of the dashboard state, pushed by the
+ * aggregator (tools/aggregator) so devices stop polling every upstream
+ * API themselves:
+ * - One frame = header + sections (nav, CRM, AI, hot leads)
+ * - Every field is 4-byte aligned little-endian, so a device reads the
+ *   receive buffer in place through SnapView pointers - no parse step,
+ *   no allocation
+ * - Sections carry their own length: readers skip unknown ids and accept
+ *   longer sections (fields are only ever appended), so the aggregator
+ *   can gain fields without breaking deployed firmware
+ * - SNAP_VERSION only changes for incompatible layouts
+ * - A frame with no sections is a keepalive
+ *
+ * Wire layout:
+ *   SnapFrameHeader (20 bytes, crc = CRC-32 of everything after it)
+ *   { SnapSectionHeader, body padded to 4 bytes } x sectionCount
+ *
+ * Little-endian hosts only (ESP32, x86, ARM Linux).
+ *
+ * Usage (device):
+ *   SnapView view;
+ *   if (snapParse(frame, len, &view) == SNAP_OK && view.nav) {
+ *     navState.activeNodes = view.nav->activeNodes;
+ *   }
+ *
+ * Shared by the dashboard (src/) and the aggregator (tools/aggregator).
+ */
+
+#define SNAP_MAGIC 0x31535242          // "BRS1"
+#define SNAP_VERSION 1
+#define SNAP_PORT 7420
+#define SNAP_FRAME_MAX 2048
+#define SNAP_MAX_LEADS 5
+
+// ─────────────────────────────────────────────────────────────────────
+// WIRE STRUCTURES
+// ─────────────────────────────────────────────────────────────────────
+
+enum SnapSectionId {
+  SNAP_SECTION_NAV = 1,
+  SNAP_SECTION_CRM = 2,
+  SNAP_SECTION_AI = 3,
+  SNAP_SECTION_LEADS = 4
+};
+
+struct SnapFrameHeader {
+  uint32_t magic;
+  uint16_t version;
+  uint16_t sectionCount;     // 0 = keepalive
+  uint32_t seq;              // Per aggregator run, +1 per frame
+  uint32_t length;           // Bytes after this header
+  uint32_t crc;              // CRC-32 of those bytes
+};
+
+struct SnapSectionHeader {
+  uint16_t id;               // SnapSectionId
+  uint16_t length;           // Body bytes, multiple of 4
+};
+
+struct SnapNav {
+  int32_t activeNodes;
+  int32_t hotLeads;
+  int32_t aiRequests;
+  uint8_t meshHealthy;
+  uint8_t crmHealthy;
+  uint8_t aiHealthy;
+  uint8_t reserved;
+  uint32_t ageMs;            // Since the aggregator last polled upstream
+};
+
+struct SnapCrm {
+  int32_t totalContacts;
+  int32_t hotLeads;
+  int32_t openDeals;
+  float pipelineValue;
+  int32_t activity24h;
+  int32_t topLeadScore;
+  char topLead[32];
+};
+
+struct SnapAi {
+  char modelName[32];
+  char status[16];
+  int32_t requestsToday;
+  float avgLatency;          // ms
+  int32_t tokensGenerated;
+  float gpuUtil;             // %
+  char lastInference[16];
+};
+
+// Mirrors HotLead in dynamic_nav.h
+struct SnapLead {
+  char name[32];
+  char company[32];
+  char email[64];
+  int32_t score;
+  char temperature[16];
+  int32_t opens;
+  int32_t clicks;
+  char lastActivity[32];
+  char stage[24];
+  uint8_t hasReplied;
+  uint8_t reserved[3];
+};
+
+// Followed by count records of `stride` bytes (>= sizeof(SnapLead))
+struct SnapLeads {
+  uint32_t count;
+  uint32_t stride;
+};
+
+static_assert(sizeof(SnapFrameHeader) == 20, "SnapFrameHeader layout");
+static_assert(sizeof(SnapNav) == 20, "SnapNav layout");
+static_assert(sizeof(SnapCrm) == 56, "SnapCrm layout");
+static_assert(sizeof(SnapAi) == 80, "SnapAi layout");
+static_assert(sizeof(SnapLead) == 216, "SnapLead layout");
+
+// ─────────────────────────────────────────────────────────────────────
+// HELPERS
+// ─────────────────────────────────────────────────────────────────────
+
+// CRC-32 (IEEE, as zlib), 4-bit table - 64 bytes of flash
+inline uint32_t snapCrc32(uint32_t crc, const uint8_t* data, size_t len) {
+  static const uint32_t table[16] = {
+    0x00000000, 0x1DB71064, 0x3B6E20C8, 0x26D930AC, 0x76DC4190, 0x6B6B51F4, 0x4DB26158, 0x5005713C,
+    0xEDB88320, 0xF00F9344, 0xD6D6A3E8, 0xCB61B38C, 0x9B64C2B0, 0x86D3D2D4, 0xA00AE278, 0xBDBDF21C
+  };
+  crc = ~crc;
+  while (len--) {
+    crc ^= *data++;
+    crc = (crc >> 4) ^ table[crc & 0x0F];
+    crc = (crc >> 4) ^ table[crc & 0x0F];
+  }
+  return ~crc;
+}
+
+// Fixed-size string field -> C string (fields are NUL padded, but never
+// trust the wire to terminate them)
+inline void snapCopyString(char* dst, size_t dstLen, const char* field, size_t fieldLen) {
+  size_t n = 0;
+  while (n < fieldLen && field[n]) n++;
+  if (n >= dstLen) n = dstLen - 1;
+  memcpy(dst, field, n);
+  dst[n] = '\0';
+}
+
+inline void snapSetString(char* field, size_t fieldLen, const char* src) {
+  memset(field, 0, fieldLen);
+  if (src) memcpy(field, src, strnlen(src, fieldLen - 1));
+}
+
+#define SNAP_COPY(dst, field) snapCopyString(dst, sizeof(dst), field, sizeof(field))
+#define SNAP_SET(field, src) snapSetString(field, sizeof(field), src)
+
+// ─────────────────────────────────────────────────────────────────────
+// WRITER
+// ─────────────────────────────────────────────────────────────────────
+
+class SnapWriter {
+public:
+  // buf must be 4-byte aligned
+  SnapWriter(uint8_t* buf, size_t cap) : _buf(buf), _cap(cap), _len(0), _overflow(false) {}
+
+  void begin(uint32_t seq) {
+    _len = sizeof(SnapFrameHeader);
+    _overflow = _cap < _len;
+    if (_overflow) return;
+    SnapFrameHeader* h = header();
+    h->magic = SNAP_MAGIC;
+    h->version = SNAP_VERSION;
+    h->sectionCount = 0;
+    h->seq = seq;
+    h->length = 0;
+    h->crc = 0;
+  }
+
+  // Reserve a zeroed section body and return it for filling in
+  template <typename T>
+  T* add(SnapSectionId id) {
+    return (T*)addRaw(id, sizeof(T));
+  }
+
+  // Hot leads: header + count records
+  SnapLead* addLeads(uint32_t count) {
+    SnapLeads* leads = (SnapLeads*)addRaw(SNAP_SECTION_LEADS, sizeof(SnapLeads) + count * sizeof(SnapLead));
+    if (!leads) return NULL;
+    leads->count = count;
+    leads->stride = sizeof(SnapLead);
+    return (SnapLead*)(leads + 1);
+  }
+
+  // Seal the frame. Returns its size, 0 on overflow.
+  size_t finish() {
+    if (_overflow) return 0;
+    SnapFrameHeader* h = header();
+    h->length = _len - sizeof(SnapFrameHeader);
+    h->crc = snapCrc32(0, _buf + sizeof(SnapFrameHeader), h->length);
+    return _len;
+  }
+
+  bool overflowed() const { return _overflow; }
+
+private:
+  uint8_t* _buf;
+  size_t _cap;
+  size_t _len;
+  bool _overflow;
+
+  SnapFrameHeader* header() { return (SnapFrameHeader*)_buf; }
+
+  void* addRaw(uint16_t id, size_t bodyLen) {
+    size_t padded = (bodyLen + 3) & ~(size_t)3;
+    if (_overflow || padded > 0xFFFF || _len + sizeof(SnapSectionHeader) + padded > _cap) {
+      _overflow = true;
+      return NULL;
+    }
+    SnapSectionHeader* s = (SnapSectionHeader*)(_buf + _len);
+    s->id = id;
+    s->length = padded;
+    uint8_t* body = _buf + _len + sizeof(SnapSectionHeader);
+    memset(body, 0, padded);
+    _len += sizeof(SnapSectionHeader) + padded;
+    header()->sectionCount++;
+    return body;
+  }
+};
+
+// ─────────────────────────────────────────────────────────────────────
+// READER
+// ─────────────────────────────────────────────────────────────────────
+
+enum SnapResult {
+  SNAP_OK,
+  SNAP_ERR_SHORT,            // Fewer bytes than the header says
+  SNAP_ERR_MAGIC,
+  SNAP_ERR_VERSION,
+  SNAP_ERR_CRC,
+  SNAP_ERR_SECTION           // Section runs past the frame
+};
+
+// Pointers into the frame buffer; NULL = section not in this frame
+struct SnapView {
+  const SnapFrameHeader* header;
+  const SnapNav* nav;
+  const SnapCrm* crm;
+  const SnapAi* ai;
+  const SnapLeads* leads;
+};
+
+// Validate a frame header alone (stream readers call this before
+// reading the body). Returns the full frame size, 0 if invalid.
+inline size_t snapFrameSize(const SnapFrameHeader* h, size_t maxFrame) {
+  if (h->magic != SNAP_MAGIC || h->version != SNAP_VERSION) return 0;
+  size_t total = sizeof(SnapFrameHeader) + (size_t)h->length;
+  return total <= maxFrame ? total : 0;
+}
+
+// frame must be 4-byte aligned and stay alive while the view is used
+inline SnapResult snapParse(const uint8_t* frame, size_t len, SnapView* view) {
+  memset(view, 0, sizeof(SnapView));
+  if (len < sizeof(SnapFrameHeader)) return SNAP_ERR_SHORT;
+
+  const SnapFrameHeader* h = (const SnapFrameHeader*)frame;
+  if (h->magic != SNAP_MAGIC) return SNAP_ERR_MAGIC;
+  if (h->version != SNAP_VERSION) return SNAP_ERR_VERSION;
+  if (len < sizeof(SnapFrameHeader) + (size_t)h->length) return SNAP_ERR_SHORT;
+
+  const uint8_t* p = frame + sizeof(SnapFrameHeader);
+  const uint8_t* end = p + h->length;
+  if (snapCrc32(0, p, h->length) != h->crc) return SNAP_ERR_CRC;
+
+  for (uint16_t i = 0; i < h->sectionCount; i++) {
+    if ((size_t)(end - p) < sizeof(SnapSectionHeader)) return SNAP_ERR_SECTION;
+    const SnapSectionHeader* s = (const SnapSectionHeader*)p;
+    const uint8_t* body = p + sizeof(SnapSectionHeader);
+    if ((s->length & 3) != 0 || (size_t)(end - body) < s->length) return SNAP_ERR_SECTION;
+
+    // Shorter than this firmware's struct = older layout we can't use
+    switch (s->id) {
+      case SNAP_SECTION_NAV:
+        if (s->length >= sizeof(SnapNav)) view->nav = (const SnapNav*)body;
+        break;
+      case SNAP_SECTION_CRM:
+        if (s->length >= sizeof(SnapCrm)) view->crm = (const SnapCrm*)body;
+        break;
+      case SNAP_SECTION_AI:
+        if (s->length >= sizeof(SnapAi)) view->ai = (const SnapAi*)body;
+        break;
+      case SNAP_SECTION_LEADS: {
+        const SnapLeads* leads = (const SnapLeads*)body;
+        if (s->length < sizeof(SnapLeads)) break;
+        if (leads->stride < sizeof(SnapLead) || (leads->stride & 3) != 0) break;
+        if (leads->count > (s->length - sizeof(SnapLeads)) / leads->stride) break;
+        view->leads = leads;
+        break;
+      }
+      default:
+        break;  // Newer aggregator - skip
+    }
+    p = body + s->length;
+  }
+
+  view->header = h;
+  return SNAP_OK;
+}
+
+inline const SnapLead* snapLead(const SnapLeads* leads, uint32_t index) {
+  return (const SnapLead*)((const uint8_t*)(leads + 1) + index * leads->stride);
+}
+
+#endif // SNAPSHOT_PROTOCOL_H
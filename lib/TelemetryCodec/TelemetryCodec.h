@@ -0,0 +1,399 @@
+#ifndef TELEMETRY_CODEC_H
+#define TELEMETRY_CODEC_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <math.h>
+
+/*
+ * ═══════════════════════════════════════════════════════════════════════
+ * BLACKROAD COMPACT TELEMETRY ENCODING (DEVICES -> SERVER)
+ * ═══════════════════════════════════════════════════════════════════════
+ *
+ * Binary alternative to the JSON bodies on the sensors and heartbeat
+ * subjects - same content, no repeated key names, no number formatting:
+ * - One message = header + a batch of records of one kind
+ * - Integers are LEB128 varints; signed values are zigzagged first
+ * - Measurements are fixed point (TEL_FIXED_SCALE per unit). A channel's
+ *   mean is a delta against the same channel in the previous record, and
+ *   min / max / last are deltas against the mean, so a quiet sensor costs
+ *   a byte or two per field
+ * - Timestamps and cumulative counters are deltas against the previous
+ *   record; the first record's are against zero / the header
+ * - Channels are schema ids (TelChannel), not names
+ * - The first byte is never '{', so a subscriber can tell a binary body
+ *   from JSON by looking at it
+ * - TEL_VERSION only changes for incompatible layouts; a decoder refuses
+ *   versions it doesn't know
+ *
+ * Wire layout (v1):
+ *   u8 TEL_MAGIC, u8 version << 4 | kind, varint idLen, id bytes,
+ *   varint baseTimestamp, u8 recordCount, records...
+ *   Sensors record:   varint dt, varint windowMs, varint sampleHz,
+ *                     varint dOverruns, svarint rssi, varint freeHeap,
+ *                     u8 channels, { u8 id, varint count, [svarint dMean,
+ *                     svarint min-mean, svarint max-mean, svarint last-mean]
+ *                     (only when count > 0) } x channels
+ *   Heartbeat record: varint dt, varint uptimeS, varint freeHeap, u8 flags,
+ *                     varint buffered, varint journaled, varint dropped
+ *
+ * Platform neutral (no Arduino headers).
+ *
+ * Usage (device):
+ *   TelemetryEncoder e(buf, sizeof(buf));
+ *   e.begin(TEL_KIND_SENSORS, "esp32-device1", millis());
+ *   e.sensors(record);
+ *   if (e.finish()) send(buf, e.length());
+ *
+ * Usage (server):
+ *   TelemetryDecoder d(data, len);
+ *   TelSensorRecord r;
+ *   if (d.begin() == TEL_OK && d.kind() == TEL_KIND_SENSORS)
+ *     while (d.next(&r) == TEL_OK) store(d.deviceId(), r);
+ *
+ * Shared by the NATS firmware (esp32/device1) and tools/telemetry_decode.
+ */
+
+#define TEL_MAGIC 0xB7
+#define TEL_VERSION 1
+#define TEL_FIXED_SCALE 100          // Hundredths
+#define TEL_MAX_CHANNELS 8
+#define TEL_DEVICE_ID_MAX 32
+#define TEL_MAX_RECORDS 255
+
+enum TelKind {
+  TEL_KIND_SENSORS = 1,
+  TEL_KIND_HEARTBEAT = 2
+};
+
+// Schema channel ids - append only
+enum TelChannel {
+  TEL_CH_TEMPERATURE_C = 1,
+  TEL_CH_HUMIDITY_PCT = 2
+};
+
+enum TelResult {
+  TEL_OK,
+  TEL_END,                   // No more records
+  TEL_ERR_SHORT,             // Message ends mid-field
+  TEL_ERR_MAGIC,
+  TEL_ERR_VERSION,
+  TEL_ERR_KIND,              // Unknown kind, or next() with the wrong record type
+  TEL_ERR_RANGE              // Field out of range (bad id length, too many channels)
+};
+
+// ─────────────────────────────────────────────────────────────────────
+// RECORDS
+// ─────────────────────────────────────────────────────────────────────
+
+struct TelChannelStats {
+  uint8_t id;                // TelChannel
+  uint32_t count;            // 0 = no samples; the values are then 0
+  float min;
+  float max;
+  float mean;
+  float last;
+};
+
+// One aggregation window
+struct TelSensorRecord {
+  uint32_t timestamp;        // ms
+  uint32_t windowMs;
+  uint32_t sampleHz;
+  uint32_t overruns;         // Cumulative
+  int32_t rssi;
+  uint32_t freeHeap;
+  uint8_t channels;
+  TelChannelStats ch[TEL_MAX_CHANNELS];
+};
+
+struct TelHeartbeat {
+  uint32_t timestamp;        // ms
+  uint32_t uptimeS;
+  uint32_t freeHeap;
+  bool connected;
+  uint32_t buffered;
+  uint32_t journaled;
+  uint32_t dropped;
+};
+
+inline const char* telChannelName(uint8_t id) {
+  switch (id) {
+    case TEL_CH_TEMPERATURE_C: return "temperature_c";
+    case TEL_CH_HUMIDITY_PCT: return "humidity_pct";
+    default: return NULL;
+  }
+}
+
+// 0 when the name isn't in the schema
+inline uint8_t telChannelId(const char* name) {
+  for (uint8_t id = 1; telChannelName(id); id++) {
+    if (strcmp(telChannelName(id), name) == 0) return id;
+  }
+  return 0;
+}
+
+inline int32_t telFixed(float v) { return (int32_t)lroundf(v * TEL_FIXED_SCALE); }
+
+// ─────────────────────────────────────────────────────────────────────
+// ENCODER
+// ─────────────────────────────────────────────────────────────────────
+
+class TelemetryEncoder {
+public:
+  TelemetryEncoder(uint8_t* buf, size_t cap) : _buf(buf), _cap(cap) { reset(); }
+
+  void reset() {
+    _len = 0;
+    _overflow = false;
+    _countAt = 0;
+    _count = 0;
+    _prevTimestamp = 0;
+    _prevOverruns = 0;
+    memset(_prevMean, 0, sizeof(_prevMean));
+  }
+
+  void begin(TelKind kind, const char* deviceId, uint32_t baseTimestamp) {
+    reset();
+    size_t idLen = strlen(deviceId);
+    if (idLen > TEL_DEVICE_ID_MAX) idLen = TEL_DEVICE_ID_MAX;
+    put(TEL_MAGIC);
+    put(TEL_VERSION << 4 | kind);
+    putVarint(idLen);
+    putBytes(deviceId, idLen);
+    putVarint(baseTimestamp);
+    _countAt = _len;
+    put(0);                  // Record count, patched by finish()
+    _prevTimestamp = baseTimestamp;
+  }
+
+  void sensors(const TelSensorRecord& r) {
+    if (!record()) return;
+    putVarint(r.timestamp - _prevTimestamp);
+    putVarint(r.windowMs);
+    putVarint(r.sampleHz);
+    putVarint(r.overruns - _prevOverruns);
+    putSigned(r.rssi);
+    putVarint(r.freeHeap);
+    uint8_t channels = r.channels < TEL_MAX_CHANNELS ? r.channels : TEL_MAX_CHANNELS;
+    put(channels);
+    for (uint8_t c = 0; c < channels; c++) {
+      const TelChannelStats& s = r.ch[c];
+      put(s.id);
+      putVarint(s.count);
+      if (s.count == 0) continue;
+      int32_t mean = telFixed(s.mean);
+      putSigned(mean - _prevMean[c]);
+      putSigned(telFixed(s.min) - mean);
+      putSigned(telFixed(s.max) - mean);
+      putSigned(telFixed(s.last) - mean);
+      _prevMean[c] = mean;
+    }
+    _prevTimestamp = r.timestamp;
+    _prevOverruns = r.overruns;
+  }
+
+  void heartbeat(const TelHeartbeat& h) {
+    if (!record()) return;
+    putVarint(h.timestamp - _prevTimestamp);
+    putVarint(h.uptimeS);
+    putVarint(h.freeHeap);
+    put(h.connected ? 1 : 0);
+    putVarint(h.buffered);
+    putVarint(h.journaled);
+    putVarint(h.dropped);
+    _prevTimestamp = h.timestamp;
+  }
+
+  // Patch the record count. False if anything overflowed.
+  bool finish() {
+    if (!_overflow && _countAt < _len) _buf[_countAt] = _count;
+    return !_overflow;
+  }
+
+  size_t length() const { return _len; }
+  uint8_t records() const { return _count; }
+  bool overflowed() const { return _overflow; }
+
+private:
+  uint8_t* _buf;
+  size_t _cap;
+  size_t _len;
+  bool _overflow;
+  size_t _countAt;
+  uint8_t _count;
+  uint32_t _prevTimestamp;
+  uint32_t _prevOverruns;
+  int32_t _prevMean[TEL_MAX_CHANNELS];
+
+  bool record() {
+    if (_count == TEL_MAX_RECORDS) {
+      _overflow = true;
+      return false;
+    }
+    _count++;
+    return true;
+  }
+
+  void put(uint8_t b) {
+    if (_len < _cap) _buf[_len++] = b;
+    else _overflow = true;
+  }
+
+  void putBytes(const char* p, size_t n) {
+    if (_len + n > _cap) {
+      _overflow = true;
+      return;
+    }
+    memcpy(_buf + _len, p, n);
+    _len += n;
+  }
+
+  void putVarint(uint32_t v) {
+    while (v >= 0x80) {
+      put((uint8_t)(v | 0x80));
+      v >>= 7;
+    }
+    put((uint8_t)v);
+  }
+
+  void putSigned(int32_t v) { putVarint(((uint32_t)v << 1) ^ (uint32_t)(v >> 31)); }
+};
+
+// ─────────────────────────────────────────────────────────────────────
+// DECODER
+// ─────────────────────────────────────────────────────────────────────
+
+class TelemetryDecoder {
+public:
+  TelemetryDecoder(const uint8_t* data, size_t len) : _p(data), _end(data + len) {
+    _kind = 0;
+    _version = 0;
+    _deviceId[0] = '\0';
+    _baseTimestamp = 0;
+    _records = 0;
+    _read = 0;
+    _prevTimestamp = 0;
+    _prevOverruns = 0;
+    memset(_prevMean, 0, sizeof(_prevMean));
+  }
+
+  // A binary body? (JSON bodies start with '{')
+  static bool isBinary(const uint8_t* data, size_t len) { return len > 0 && data[0] == TEL_MAGIC; }
+
+  TelResult begin() {
+    uint8_t magic, vk, records;
+    uint32_t idLen;
+    if (!get(&magic) || !get(&vk)) return TEL_ERR_SHORT;
+    if (magic != TEL_MAGIC) return TEL_ERR_MAGIC;
+    _version = vk >> 4;
+    _kind = vk & 0x0F;
+    if (_version != TEL_VERSION) return TEL_ERR_VERSION;
+    if (_kind != TEL_KIND_SENSORS && _kind != TEL_KIND_HEARTBEAT) return TEL_ERR_KIND;
+    if (!getVarint(&idLen)) return TEL_ERR_SHORT;
+    if (idLen > TEL_DEVICE_ID_MAX) return TEL_ERR_RANGE;
+    if ((size_t)(_end - _p) < idLen) return TEL_ERR_SHORT;
+    memcpy(_deviceId, _p, idLen);
+    _deviceId[idLen] = '\0';
+    _p += idLen;
+    if (!getVarint(&_baseTimestamp) || !get(&records)) return TEL_ERR_SHORT;
+    _records = records;
+    _prevTimestamp = _baseTimestamp;
+    return TEL_OK;
+  }
+
+  TelResult next(TelSensorRecord* r) {
+    if (_kind != TEL_KIND_SENSORS) return TEL_ERR_KIND;
+    if (_read == _records) return TEL_END;
+    uint32_t dt, dOverruns, rssi;
+    if (!getVarint(&dt) || !getVarint(&r->windowMs) || !getVarint(&r->sampleHz) ||
+        !getVarint(&dOverruns) || !getVarint(&rssi) || !getVarint(&r->freeHeap) || !get(&r->channels)) {
+      return TEL_ERR_SHORT;
+    }
+    if (r->channels > TEL_MAX_CHANNELS) return TEL_ERR_RANGE;
+    r->timestamp = _prevTimestamp + dt;
+    r->overruns = _prevOverruns + dOverruns;
+    r->rssi = unzigzag(rssi);
+
+    for (uint8_t c = 0; c < r->channels; c++) {
+      TelChannelStats& s = r->ch[c];
+      if (!get(&s.id) || !getVarint(&s.count)) return TEL_ERR_SHORT;
+      s.min = s.max = s.mean = s.last = 0;
+      if (s.count == 0) continue;
+      uint32_t dMean, dMin, dMax, dLast;
+      if (!getVarint(&dMean) || !getVarint(&dMin) || !getVarint(&dMax) || !getVarint(&dLast)) {
+        return TEL_ERR_SHORT;
+      }
+      int32_t mean = _prevMean[c] + unzigzag(dMean);
+      s.mean = (float)mean / TEL_FIXED_SCALE;
+      s.min = (float)(mean + unzigzag(dMin)) / TEL_FIXED_SCALE;
+      s.max = (float)(mean + unzigzag(dMax)) / TEL_FIXED_SCALE;
+      s.last = (float)(mean + unzigzag(dLast)) / TEL_FIXED_SCALE;
+      _prevMean[c] = mean;
+    }
+    _prevTimestamp = r->timestamp;
+    _prevOverruns = r->overruns;
+    _read++;
+    return TEL_OK;
+  }
+
+  TelResult next(TelHeartbeat* h) {
+    if (_kind != TEL_KIND_HEARTBEAT) return TEL_ERR_KIND;
+    if (_read == _records) return TEL_END;
+    uint32_t dt;
+    uint8_t flags;
+    if (!getVarint(&dt) || !getVarint(&h->uptimeS) || !getVarint(&h->freeHeap) || !get(&flags) ||
+        !getVarint(&h->buffered) || !getVarint(&h->journaled) || !getVarint(&h->dropped)) {
+      return TEL_ERR_SHORT;
+    }
+    h->timestamp = _prevTimestamp + dt;
+    h->connected = flags & 1;
+    _prevTimestamp = h->timestamp;
+    _read++;
+    return TEL_OK;
+  }
+
+  uint8_t kind() const { return _kind; }
+  uint8_t version() const { return _version; }
+  const char* deviceId() const { return _deviceId; }
+  uint32_t baseTimestamp() const { return _baseTimestamp; }
+  uint8_t records() const { return _records; }
+
+private:
+  const uint8_t* _p;
+  const uint8_t* _end;
+  uint8_t _kind;
+  uint8_t _version;
+  char _deviceId[TEL_DEVICE_ID_MAX + 1];
+  uint32_t _baseTimestamp;
+  uint8_t _records;
+  uint8_t _read;
+  uint32_t _prevTimestamp;
+  uint32_t _prevOverruns;
+  int32_t _prevMean[TEL_MAX_CHANNELS];
+
+  bool get(uint8_t* out) {
+    if (_p >= _end) return false;
+    *out = *_p++;
+    return true;
+  }
+
+  bool getVarint(uint32_t* out) {
+    uint32_t v = 0;
+    for (int shift = 0; shift < 35; shift += 7) {
+      if (_p >= _end) return false;
+      uint8_t b = *_p++;
+      v |= (uint32_t)(b & 0x7F) << shift;
+      if (!(b & 0x80)) {
+        *out = v;
+        return true;
+      }
+    }
+    return false;            // Longer than a uint32
+  }
+
+  static int32_t unzigzag(uint32_t v) { return (int32_t)(v >> 1) ^ -(int32_t)(v & 1); }
+};
+
+#endif // TELEMETRY_CODEC_H
@@ -3,7 +3,14 @@
 
 #include <HTTPClient.h>
 #include <WiFiClient.h>
+#include <JsonWriter.h>
+#include <OutboundJournal.h>
+#include <SPIFFS.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <freertos/semphr.h>
 #include "secrets.h"
+#include "json_stream.h"
 
 /*
  * ═══════════════════════════════════════════════════════════════════════
@@ -22,6 +29,19 @@
  * - Slack webhook
  * - Email (via Cloudflare worker)
  * - Local buzzer/LED
+ *
+ * sendAlert() never touches the network: alerts go into an outbound
+ * queue drained by a background task, which batches everything pending
+ * for a webhook into one POST and retries with exponential backoff.
+ * A batch that doesn't fit ALERT_PAYLOAD_MAX is split, and one the
+ * webhook rejects (4xx other than 408/429) or that fails
+ * ALERT_RETRY_LIMIT times is given up so it can't block the queue.
+ * Buzzer/LED patterns are stepped by localAlertTick() from loop().
+ *
+ * While offline (or while the RAM queue is full) alerts go to a flash
+ * journal instead. Once back online the dispatcher replays it in order,
+ * rate limited, and acks each record after every webhook accepted it -
+ * alerts now survive an outage and a reboot instead of being lost.
  */
 
 // ─────────────────────────────────────────────────────────────────────
@@ -33,6 +53,19 @@
 #define ALERT_MESH_NODES_THRESHOLD 2        // Alert when active nodes < 2
 #define ALERT_COOLDOWN_MS 300000            // 5 minutes between same alert
 
+#define ALERT_QUEUE_SIZE 16                 // Outbound alerts buffered
+#define ALERT_BATCH_MAX 10                  // Discord allows 10 embeds per message
+#define ALERT_RETRY_BASE_MS 2000
+#define ALERT_RETRY_MAX_MS 60000
+#define ALERT_RETRY_LIMIT 10                // Failed POSTs before a batch is given up
+#define ALERT_TX_STACK 8192
+#define ALERT_PAYLOAD_MAX 4096              // 10 embeds x ~300 bytes escaped
+
+#define ALERT_JOURNAL_DIR "/jrnl_alert"
+#define ALERT_JOURNAL_SEGMENT_BYTES 4096
+#define ALERT_JOURNAL_SEGMENTS 8            // 32KB of flash, ~150 alerts
+#define ALERT_REPLAY_INTERVAL_MS 2000       // One batch per webhook per 2s
+
 // ─────────────────────────────────────────────────────────────────────
 // ALERT TYPES
 // ─────────────────────────────────────────────────────────────────────
@@ -69,113 +102,492 @@ InfraAlert infraAlertHistory[10];
 int infraAlertHistoryCount = 0;
 unsigned long lastAlertTime[10] = {0};  // Cooldown tracker
 
+// ─────────────────────────────────────────────────────────────────────
+// OUTBOUND QUEUE
+// ─────────────────────────────────────────────────────────────────────
+
+struct OutboundAlert {
+  uint32_t seq;              // Monotonic, 1-based
+  AlertLevel level;
+  char title[64];
+  char message[128];
+  int historyIndex;          // infraAlertHistory slot, -1 if not stored
+  unsigned long enqueuedAt;
+  uint32_t journalSeq;       // Journal record to ack once delivered, 0 if none
+};
+
+struct AlertWebhook {
+  const char* name;
+  const char* url;
+  int maxBatch;
+  void (*buildPayload)(OutboundAlert** batch, int count, JsonWriter& w);
+  uint32_t sentSeq;          // Everything up to here was delivered (or given up)
+  unsigned long nextAttemptAt;
+  uint32_t backoffMs;
+  uint8_t attempts;          // Failed POSTs of the current batch
+};
+
+struct AlertDispatchStats {
+  uint32_t queued;
+  uint32_t delivered;        // Alert x webhook deliveries
+  uint32_t posts;            // HTTP POSTs (coalescing makes this < delivered)
+  uint32_t retries;
+  uint32_t dropped;          // Overwritten before every webhook had it
+  uint32_t rejected;         // Given up: 4xx, retry limit, or too big to send
+  uint32_t journaled;        // Parked in flash (offline or queue full)
+  uint32_t replayed;         // Moved from flash back into the queue
+  uint32_t latencyMaxMs;     // Enqueue -> webhook accepted
+  uint32_t latencyTotalMs;
+};
+
+OutboundAlert alertQueue[ALERT_QUEUE_SIZE];
+uint32_t alertQueueNextSeq = 1;
+AlertDispatchStats alertDispatchStats = {0, 0, 0, 0, 0, 0, 0, 0, 0, 0};
+SemaphoreHandle_t alertQueueMutex = NULL;
+SemaphoreHandle_t alertQueueSignal = NULL;
+bool alertDispatcherStarted = false;
+
+OutboundJournal alertJournal(SPIFFS, ALERT_JOURNAL_DIR, ALERT_JOURNAL_SEGMENT_BYTES, ALERT_JOURNAL_SEGMENTS);
+bool alertJournalReady = false;
+unsigned long alertReplayLastAt = 0;
+
+// Oldest sequence number still held in the ring
+uint32_t alertQueueOldestSeq() {
+  return alertQueueNextSeq > ALERT_QUEUE_SIZE ? alertQueueNextSeq - ALERT_QUEUE_SIZE : 1;
+}
+
 // ─────────────────────────────────────────────────────────────────────
 // DISCORD WEBHOOK INTEGRATION
 // ─────────────────────────────────────────────────────────────────────
 
-bool sendDiscordAlert(String title, String message, AlertLevel level) {
-  #ifdef DISCORD_WEBHOOK_URL
-  HTTPClient http;
-  WiFiClient client;
-
-  http.begin(client, String(DISCORD_WEBHOOK_URL));
-  http.addHeader("Content-Type", "application/json");
-  http.setTimeout(5000);
-
-  // Color based on alert level
-  int color = 0x00FF00;  // Green
-  if (level == ALERT_WARNING) color = 0xFFA500;   // Amber
-  if (level == ALERT_CRITICAL) color = 0xFF0000;  // Red
-
-  // Build Discord embed
-  String payload = "{\"embeds\":[{";
-  payload += "\"title\":\"" + title + "\",";
-  payload += "\"description\":\"" + message + "\",";
-  payload += "\"color\":" + String(color) + ",";
-  payload += "\"footer\":{\"text\":\"BlackRoad CEO Hub\"},";
-  payload += "\"timestamp\":\"" + String(millis()) + "\"";
-  payload += "}]}";
-
-  int httpCode = http.POST(payload);
-  bool success = (httpCode == 200 || httpCode == 204);
-
-  http.end();
-  return success;
-  #else
-    return false;  // Not configured
-  #endif
+// One embed per alert, up to 10 per message
+void buildDiscordPayload(OutboundAlert** batch, int count, JsonWriter& w) {
+  w.beginObject();
+  w.arrayField("embeds");
+
+  for (int i = 0; i < count; i++) {
+    // Color based on alert level
+    long color = 0x00FF00;  // Green
+    if (batch[i]->level == ALERT_WARNING) color = 0xFFA500;   // Amber
+    if (batch[i]->level == ALERT_CRITICAL) color = 0xFF0000;  // Red
+
+    w.beginObject();
+    w.field("title", batch[i]->title);
+    w.field("description", batch[i]->message);
+    w.field("color", color);
+    w.objectField("footer");
+    w.field("text", "BlackRoad CEO Hub");
+    w.endObject();
+    w.endObject();
+  }
+
+  w.endArray();
+  w.endObject();
 }
 
 // ─────────────────────────────────────────────────────────────────────
 // SLACK WEBHOOK INTEGRATION
 // ─────────────────────────────────────────────────────────────────────
 
-bool sendSlackAlert(String title, String message, AlertLevel level) {
-  #ifdef SLACK_WEBHOOK_URL
-  HTTPClient http;
-  WiFiClient client;
-
-  http.begin(client, String(SLACK_WEBHOOK_URL));
-  http.addHeader("Content-Type", "application/json");
-  http.setTimeout(5000);
+// Headline for the first alert, one section block per alert
+void buildSlackPayload(OutboundAlert** batch, int count, JsonWriter& w) {
+  AlertLevel worst = ALERT_INFO;
+  for (int i = 0; i < count; i++) {
+    if (batch[i]->level > worst) worst = batch[i]->level;
+  }
 
   // Emoji based on level
-  String emoji = ":information_source:";
-  if (level == ALERT_WARNING) emoji = ":warning:";
-  if (level == ALERT_CRITICAL) emoji = ":rotating_light:";
-
-  String payload = "{";
-  payload += "\"text\":\"" + emoji + " *" + title + "*\",";
-  payload += "\"blocks\":[{";
-  payload += "\"type\":\"section\",";
-  payload += "\"text\":{\"type\":\"mrkdwn\",\"text\":\"" + message + "\"}";
-  payload += "}]";
-  payload += "}";
-
-  int httpCode = http.POST(payload);
-  bool success = (httpCode == 200);
-
-  http.end();
-  return success;
-  #else
-    return false;  // Not configured
+  const char* emoji = ":information_source:";
+  if (worst == ALERT_WARNING) emoji = ":warning:";
+  if (worst == ALERT_CRITICAL) emoji = ":rotating_light:";
+
+  w.beginObject();
+  w.key("text");
+  w.beginString();
+  w.stringPart(emoji);
+  w.stringPart(" *");
+  w.stringPart(batch[0]->title);
+  w.stringPart("*");
+  if (count > 1) {
+    w.stringPart(" (+");
+    w.stringPart((long)(count - 1));
+    w.stringPart(" more)");
+  }
+  w.endString();
+
+  w.arrayField("blocks");
+  for (int i = 0; i < count; i++) {
+    w.beginObject();
+    w.field("type", "section");
+    w.objectField("text");
+    w.field("type", "mrkdwn");
+    w.key("text");
+    w.beginString();
+    w.stringPart("*");
+    w.stringPart(batch[i]->title);
+    w.stringPart("*\n");
+    w.stringPart(batch[i]->message);
+    w.endString();
+    w.endObject();
+    w.endObject();
+  }
+  w.endArray();
+  w.endObject();
+}
+
+// ─────────────────────────────────────────────────────────────────────
+// WEBHOOK TABLE
+// ─────────────────────────────────────────────────────────────────────
+
+AlertWebhook alertWebhooks[] = {
+  #ifdef DISCORD_WEBHOOK_URL
+  {"Discord", DISCORD_WEBHOOK_URL, ALERT_BATCH_MAX, buildDiscordPayload, 0, 0, 0, 0},
+  #endif
+  #ifdef SLACK_WEBHOOK_URL
+  {"Slack", SLACK_WEBHOOK_URL, ALERT_BATCH_MAX, buildSlackPayload, 0, 0, 0, 0},
   #endif
+  {NULL, NULL, 0, NULL, 0, 0, 0, 0}  // Sentinel (keeps the array non-empty)
+};
+#define ALERT_WEBHOOK_COUNT ((int)(sizeof(alertWebhooks) / sizeof(alertWebhooks[0])) - 1)
+
+// Alerts in the ring not yet delivered to every webhook
+int getPendingAlertCount() {
+  uint32_t oldestPending = alertQueueNextSeq;
+  for (int i = 0; i < ALERT_WEBHOOK_COUNT; i++) {
+    if (alertWebhooks[i].sentSeq + 1 < oldestPending) oldestPending = alertWebhooks[i].sentSeq + 1;
+  }
+  uint32_t oldest = alertQueueOldestSeq();
+  if (oldestPending < oldest) oldestPending = oldest;
+  return alertQueueNextSeq - oldestPending;
+}
+
+// ─────────────────────────────────────────────────────────────────────
+// OFFLINE JOURNAL
+// ─────────────────────────────────────────────────────────────────────
+
+// Write the next ring slot. Caller holds alertQueueMutex.
+void alertQueuePush(AlertLevel level, const char* title, const char* message, int historyIndex, uint32_t journalSeq) {
+  OutboundAlert* slot = &alertQueue[alertQueueNextSeq % ALERT_QUEUE_SIZE];
+  slot->seq = alertQueueNextSeq++;
+  slot->level = level;
+  strncpy(slot->title, title, sizeof(slot->title) - 1);
+  slot->title[sizeof(slot->title) - 1] = '\0';
+  strncpy(slot->message, message, sizeof(slot->message) - 1);
+  slot->message[sizeof(slot->message) - 1] = '\0';
+  slot->historyIndex = historyIndex;
+  slot->enqueuedAt = millis();
+  slot->journalSeq = journalSeq;
+}
+
+// Ack the journal up to the newest replayed alert every webhook has
+// delivered. Caller holds alertQueueMutex.
+void alertJournalAckDelivered() {
+  if (!alertJournalReady) return;
+  uint32_t deliveredSeq = alertQueueNextSeq - 1 - getPendingAlertCount();
+  uint32_t journalSeq = 0;
+  for (uint32_t seq = alertQueueOldestSeq(); seq <= deliveredSeq; seq++) {
+    uint32_t j = alertQueue[seq % ALERT_QUEUE_SIZE].journalSeq;
+    if (j > journalSeq) journalSeq = j;
+  }
+  if (journalSeq) alertJournal.ack(journalSeq);
+}
+
+// Move journaled alerts back into the ring, oldest first, one batch per
+// ALERT_REPLAY_INTERVAL_MS so a long outage doesn't hit the webhook rate
+// limits all at once. Returns ms until the next batch is due, 0 if the
+// journal is drained (or we're still offline).
+unsigned long alertJournalReplay() {
+  if (!alertJournalReady || WiFi.status() != WL_CONNECTED) return 0;
+
+  static OutboundJournal::Record rec;  // Only the dispatcher task replays
+  int moved = 0;
+  uint32_t left;
+
+  xSemaphoreTake(alertQueueMutex, portMAX_DELAY);
+  if (alertJournal.unread() == 0) {
+    xSemaphoreGive(alertQueueMutex);
+    return 0;
+  }
+  long due = ALERT_REPLAY_INTERVAL_MS - (long)(millis() - alertReplayLastAt);
+  if (due > 0) {
+    xSemaphoreGive(alertQueueMutex);
+    return due;
+  }
+
+  int room = ALERT_QUEUE_SIZE - getPendingAlertCount();
+  while (moved < ALERT_BATCH_MAX && moved < room && alertJournal.read(rec)) {
+    alertQueuePush((AlertLevel)rec.kind, rec.topic, rec.data, -1, rec.seq);
+    moved++;
+  }
+  left = alertJournal.unread();
+  alertDispatchStats.replayed += moved;
+  xSemaphoreGive(alertQueueMutex);
+
+  alertReplayLastAt = millis();
+  if (moved > 0) {
+    Serial.printf("📼 Replaying %d journaled alert(s), %lu left\n", moved, (unsigned long)left);
+  }
+  return ALERT_REPLAY_INTERVAL_MS;  // Queue full counts as a wait too
+}
+
+void initAlertJournal() {
+  if (!SPIFFS.begin(true) || !alertJournal.begin()) {
+    Serial.println("⚠️  Alert journal unavailable - offline alerts will be lost");
+    return;
+  }
+  alertJournalReady = true;
+  if (alertJournal.pending() > 0) {
+    Serial.printf("📼 Alert journal: %lu alert(s) waiting from before reboot\n",
+                  (unsigned long)alertJournal.pending());
+  }
+}
+
+// ─────────────────────────────────────────────────────────────────────
+// BACKGROUND DISPATCH
+// ─────────────────────────────────────────────────────────────────────
+
+// Move a webhook past the first `count` alerts of its batch, delivered
+// or given up, and ack the journal for whatever every webhook is done with
+void alertHookAdvance(AlertWebhook* hook, const OutboundAlert* snapshot, int count, bool delivered) {
+  unsigned long now = millis();
+  xSemaphoreTake(alertQueueMutex, portMAX_DELAY);
+  hook->sentSeq = snapshot[count - 1].seq;
+  if (delivered) {
+    for (int i = 0; i < count; i++) {
+      uint32_t latency = now - snapshot[i].enqueuedAt;
+      alertDispatchStats.latencyTotalMs += latency;
+      if (latency > alertDispatchStats.latencyMaxMs) alertDispatchStats.latencyMaxMs = latency;
+      if (snapshot[i].historyIndex >= 0) infraAlertHistory[snapshot[i].historyIndex].sent = true;
+    }
+    alertDispatchStats.delivered += count;
+  } else {
+    alertDispatchStats.rejected += count;
+  }
+  alertJournalAckDelivered();
+  xSemaphoreGive(alertQueueMutex);
+
+  hook->attempts = 0;
+  hook->backoffMs = 0;
+  hook->nextAttemptAt = now;
+}
+
+// POST everything pending for one webhook. Returns true if it went out.
+bool dispatchWebhook(AlertWebhook* hook) {
+  OutboundAlert snapshot[ALERT_BATCH_MAX];
+  OutboundAlert* batch[ALERT_BATCH_MAX];
+  int count = 0;
+
+  // Copy the batch out so the POST happens without the lock
+  xSemaphoreTake(alertQueueMutex, portMAX_DELAY);
+  uint32_t oldest = alertQueueOldestSeq();
+  if (hook->sentSeq + 1 < oldest) {
+    alertDispatchStats.dropped += oldest - (hook->sentSeq + 1);
+    hook->sentSeq = oldest - 1;
+  }
+  for (uint32_t seq = hook->sentSeq + 1; seq < alertQueueNextSeq && count < hook->maxBatch; seq++) {
+    snapshot[count] = alertQueue[seq % ALERT_QUEUE_SIZE];
+    batch[count] = &snapshot[count];
+    count++;
+  }
+  xSemaphoreGive(alertQueueMutex);
+
+  if (count == 0) return false;
+
+  // Only this task builds payloads, so one static buffer is enough.
+  // Never send truncated JSON - shrink the batch until it fits, the
+  // rest goes out in the next POST.
+  static char payload[ALERT_PAYLOAD_MAX];
+  JsonWriter w(payload, sizeof(payload));
+  int fits = count;
+  while (fits > 0) {
+    w.reset();
+    hook->buildPayload(batch, fits, w);
+    if (!w.overflowed()) break;
+    fits--;
+  }
+  if (fits == 0) {
+    Serial.printf("   ⚠️  %s: alert #%lu over %d bytes, skipped\n", hook->name,
+                  (unsigned long)snapshot[0].seq, ALERT_PAYLOAD_MAX);
+    alertHookAdvance(hook, snapshot, 1, false);
+    return false;
+  }
+  count = fits;
+
+  JsonHttpRequest req;
+  req.begin(hook->url, 5000);
+  req.http.addHeader("Content-Type", "application/json");
+  int httpCode = req.POST(w.c_str(), w.length());
+  req.end();
+  alertDispatchStats.posts++;
+
+  if (httpCode >= 200 && httpCode < 300) {
+    alertHookAdvance(hook, snapshot, count, true);
+    Serial.printf("   ✓ %s: %d alert(s) in one POST\n", hook->name, count);
+    return true;
+  }
+
+  // Any other 4xx means this payload will never be accepted
+  bool permanent = httpCode >= 400 && httpCode < 500 && httpCode != 408 && httpCode != 429;
+  if (permanent || ++hook->attempts >= ALERT_RETRY_LIMIT) {
+    Serial.printf("   ⚠️  %s: HTTP %d, giving up on %d alert(s)\n", hook->name, httpCode, count);
+    alertHookAdvance(hook, snapshot, count, false);
+    return false;
+  }
+
+  // 408 / 429 / 5xx / transport error - retry later, batch stays queued
+  hook->backoffMs = hook->backoffMs ? hook->backoffMs * 2 : ALERT_RETRY_BASE_MS;
+  if (hook->backoffMs > ALERT_RETRY_MAX_MS) hook->backoffMs = ALERT_RETRY_MAX_MS;
+  hook->nextAttemptAt = millis() + hook->backoffMs;
+  alertDispatchStats.retries++;
+  Serial.printf("   ⚠️  %s: HTTP %d, retry %d/%d in %lums\n", hook->name, httpCode, hook->attempts,
+                ALERT_RETRY_LIMIT, (unsigned long)hook->backoffMs);
+  return false;
+}
+
+void alertDispatchTask(void* param) {
+  (void)param;
+  while (true) {
+    unsigned long now = millis();
+    unsigned long waitMs = 0xFFFFFFFF;
+
+    unsigned long replayWaitMs = alertJournalReplay();
+    if (replayWaitMs > 0) waitMs = replayWaitMs;
+
+    for (int i = 0; i < ALERT_WEBHOOK_COUNT; i++) {
+      AlertWebhook* hook = &alertWebhooks[i];
+      if (hook->sentSeq + 1 >= alertQueueNextSeq) continue;  // Nothing pending
+
+      if (WiFi.status() != WL_CONNECTED) {
+        waitMs = 1000;  // Hold the queue until we're back online
+        continue;
+      }
+
+      long due = (long)(hook->nextAttemptAt - now);
+      if (due > 0) {
+        if ((unsigned long)due < waitMs) waitMs = due;
+        continue;
+      }
+
+      dispatchWebhook(hook);
+      waitMs = 0;  // Re-check immediately (more may be pending)
+    }
+
+    if (waitMs == 0) continue;
+    xSemaphoreTake(alertQueueSignal, waitMs == 0xFFFFFFFF ? portMAX_DELAY : pdMS_TO_TICKS(waitMs));
+  }
+}
+
+void initAlertDispatcher() {
+  if (alertDispatcherStarted) return;
+  alertQueueMutex = xSemaphoreCreateMutex();
+  alertQueueSignal = xSemaphoreCreateBinary();
+  alertDispatcherStarted = true;
+
+  if (ALERT_WEBHOOK_COUNT > 0) {
+    initAlertJournal();
+    xTaskCreate(alertDispatchTask, "alertTx", ALERT_TX_STACK, NULL, 1, NULL);
+  }
+}
+
+// Queue an alert for every webhook. Never blocks on the network.
+void enqueueOutboundAlert(AlertLevel level, const String& title, const String& message, int historyIndex) {
+  initAlertDispatcher();
+
+  xSemaphoreTake(alertQueueMutex, portMAX_DELAY);
+
+  // Park in flash while offline, when the ring would overwrite undelivered
+  // alerts, or behind older journaled alerts (keeps delivery in order).
+  // Journaled alerts lose their history link - the slot may be reused by
+  // the time they replay.
+  if (alertJournalReady && (WiFi.status() != WL_CONNECTED || alertJournal.pending() > 0 ||
+                            getPendingAlertCount() >= ALERT_QUEUE_SIZE)) {
+    if (alertJournal.append(level, title.c_str(), message.c_str(), message.length())) {
+      alertDispatchStats.journaled++;
+      xSemaphoreGive(alertQueueMutex);
+      xSemaphoreGive(alertQueueSignal);
+      return;
+    }
+    // Flash write failed - fall back to the RAM ring
+  }
+
+  alertQueuePush(level, title.c_str(), message.c_str(), historyIndex, 0);
+  alertDispatchStats.queued++;
+  xSemaphoreGive(alertQueueMutex);
+
+  xSemaphoreGive(alertQueueSignal);
+}
+
+uint32_t getAlertAvgLatencyMs() {
+  if (alertDispatchStats.delivered == 0) return 0;
+  return alertDispatchStats.latencyTotalMs / alertDispatchStats.delivered;
 }
 
 // ─────────────────────────────────────────────────────────────────────
 // LOCAL ALERT (BUZZER + LED)
 // ─────────────────────────────────────────────────────────────────────
 
+// A pattern is a list of pulses stepped by localAlertTick(), so the
+// beeps and flashes no longer hold up loop() with delay()
+struct AlertPulse {
+  int8_t pin;
+  uint16_t onMs;
+  uint16_t offMs;
+  uint8_t repeats;
+};
+
+#define LOCAL_ALERT_MAX_PULSES 3
+
+AlertPulse localAlertPattern[LOCAL_ALERT_MAX_PULSES];
+int localAlertPulseCount = 0;
+int localAlertPulse = 0;        // Current pulse in the pattern
+int localAlertRepeat = 0;       // Repeats done of the current pulse
+bool localAlertPinHigh = false;
+unsigned long localAlertNextAt = 0;
+
 void triggerLocalAlert(AlertLevel level) {
+  localAlertPulseCount = 0;
+
   #ifdef BUZZER_PIN
     if (level == ALERT_CRITICAL) {
-      // Critical: 3 long beeps
-      for (int i = 0; i < 3; i++) {
-        digitalWrite(BUZZER_PIN, HIGH);
-        delay(500);
-        digitalWrite(BUZZER_PIN, LOW);
-        delay(200);
-      }
+      localAlertPattern[localAlertPulseCount++] = {BUZZER_PIN, 500, 200, 3};  // 3 long beeps
     } else if (level == ALERT_WARNING) {
-      // Warning: 2 short beeps
-      for (int i = 0; i < 2; i++) {
-        digitalWrite(BUZZER_PIN, HIGH);
-        delay(200);
-        digitalWrite(BUZZER_PIN, LOW);
-        delay(100);
-      }
+      localAlertPattern[localAlertPulseCount++] = {BUZZER_PIN, 200, 100, 2};  // 2 short beeps
     }
+  #else
+    (void)level;  // Only the buzzer pattern depends on it
   #endif
 
   #ifdef LED_PIN
-    // Flash LED
-    for (int i = 0; i < 5; i++) {
-      digitalWrite(LED_PIN, HIGH);
-      delay(100);
-      digitalWrite(LED_PIN, LOW);
-      delay(100);
-    }
+    localAlertPattern[localAlertPulseCount++] = {LED_PIN, 100, 100, 5};       // Flash LED
   #endif
+
+  localAlertPulse = 0;
+  localAlertRepeat = 0;
+  localAlertPinHigh = false;
+  localAlertNextAt = millis();
+}
+
+// Call every loop()
+void localAlertTick() {
+  if (localAlertPulse >= localAlertPulseCount) return;
+  if ((long)(millis() - localAlertNextAt) < 0) return;
+
+  AlertPulse& pulse = localAlertPattern[localAlertPulse];
+  if (!localAlertPinHigh) {
+    digitalWrite(pulse.pin, HIGH);
+    localAlertPinHigh = true;
+    localAlertNextAt = millis() + pulse.onMs;
+    return;
+  }
+
+  digitalWrite(pulse.pin, LOW);
+  localAlertPinHigh = false;
+  localAlertNextAt = millis() + pulse.offMs;
+
+  if (++localAlertRepeat >= pulse.repeats) {
+    localAlertRepeat = 0;
+    localAlertPulse++;
+  }
 }
 
 // ─────────────────────────────────────────────────────────────────────
@@ -192,35 +604,28 @@ void sendAlert(AlertType type, AlertLevel level, String title, String message) {
   Serial.println("   " + message);
 
   // Store in history
+  int historyIndex = -1;
   if (infraAlertHistoryCount < 10) {
-    infraAlertHistory[infraAlertHistoryCount].type = type;
-    infraAlertHistory[infraAlertHistoryCount].level = level;
-    strncpy(infraAlertHistory[infraAlertHistoryCount].title, title.c_str(), 63);
-    infraAlertHistory[infraAlertHistoryCount].title[63] = '\0';
-    strncpy(infraAlertHistory[infraAlertHistoryCount].message, message.c_str(), 127);
-    infraAlertHistory[infraAlertHistoryCount].message[127] = '\0';
-    infraAlertHistory[infraAlertHistoryCount].timestamp = millis();
-    infraAlertHistory[infraAlertHistoryCount].sent = false;
+    historyIndex = infraAlertHistoryCount;
+    infraAlertHistory[historyIndex].type = type;
+    infraAlertHistory[historyIndex].level = level;
+    strncpy(infraAlertHistory[historyIndex].title, title.c_str(), 63);
+    infraAlertHistory[historyIndex].title[63] = '\0';
+    strncpy(infraAlertHistory[historyIndex].message, message.c_str(), 127);
+    infraAlertHistory[historyIndex].message[127] = '\0';
+    infraAlertHistory[historyIndex].timestamp = millis();
+    infraAlertHistory[historyIndex].sent = false;  // Set by the dispatcher
     infraAlertHistoryCount++;
   }
 
-  // Send to external services
-  bool discordSent = sendDiscordAlert(title, message, level);
-  bool slackSent = sendSlackAlert(title, message, level);
+  // Hand off to the background dispatcher (Discord / Slack)
+  enqueueOutboundAlert(level, title, message, historyIndex);
 
-  if (discordSent) Serial.println("   ✓ Discord notification sent");
-  if (slackSent) Serial.println("   ✓ Slack notification sent");
-
-  // Trigger local alert
+  // Start local buzzer/LED pattern
   triggerLocalAlert(level);
 
   // Update cooldown
   lastAlertTime[type] = millis();
-
-  // Mark as sent
-  if (infraAlertHistoryCount > 0) {
-    infraAlertHistory[infraAlertHistoryCount - 1].sent = true;
-  }
 }
 
 // ─────────────────────────────────────────────────────────────────────
@@ -325,11 +730,8 @@ void checkPipelineMilestoneAlert() {
 // MASTER ALERT CHECK
 // ─────────────────────────────────────────────────────────────────────
 
+// Runs offline too - alerts raised then wait in the journal
 void checkAllAlerts() {
-  if (WiFi.status() != WL_CONNECTED) {
-    return;  // Don't alert if offline
-  }
-
   Serial.println("\n🔍 Checking alert conditions...");
 
   checkHotLeadsAlert();
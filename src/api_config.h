@@ -158,53 +158,55 @@ struct APIEndpoint {
   const char* url;
   const char* method;  // GET, POST, etc.
   bool requiresAuth;
+  unsigned long intervalMs;  // How often the health scheduler probes it
 };
 
+#define HEALTH_INTERVAL_CLOUD 120000   // Cloud APIs rarely flap
+#define HEALTH_INTERVAL_LOCAL 30000    // LAN services restart often
+
 // Primary health check endpoints (UPDATED WITH REAL DISCOVERED SERVICES)
 const APIEndpoint HEALTH_CHECKS[] = {
   // Cloud APIs
-  {"GitHub API", "https://api.github.com", "GET", false},
-  {"Cloudflare API", "https://api.cloudflare.com/client/v4", "GET", true},
-  {"Railway", "https://backboard.railway.app/healthz", "GET", false},
-  {"DigitalOcean", "https://api.digitalocean.com/v2", "GET", true},
+  {"GitHub API", "https://api.github.com", "GET", false, HEALTH_INTERVAL_CLOUD},
+  {"Cloudflare API", "https://api.cloudflare.com/client/v4", "GET", true, HEALTH_INTERVAL_CLOUD},
+  {"Railway", "https://backboard.railway.app/healthz", "GET", false, HEALTH_INTERVAL_CLOUD},
+  {"DigitalOcean", "https://api.digitalocean.com/v2", "GET", true, HEALTH_INTERVAL_CLOUD},
 
   // AI/LLM APIs
-  {"OpenAI", "https://api.openai.com/v1/models", "GET", true},
-  {"Anthropic", "https://api.anthropic.com/v1/messages", "POST", true},
+  {"OpenAI", "https://api.openai.com/v1/models", "GET", true, HEALTH_INTERVAL_CLOUD},
+  {"Anthropic", "https://api.anthropic.com/v1/messages", "POST", true, HEALTH_INTERVAL_CLOUD},
 
   // Business APIs
-  {"Linear", "https://api.linear.app/graphql", "POST", true},
-  {"Stripe", "https://api.stripe.com/v1", "GET", true},
+  {"Linear", "https://api.linear.app/graphql", "POST", true, HEALTH_INTERVAL_CLOUD},
+  {"Stripe", "https://api.stripe.com/v1", "GET", true, HEALTH_INTERVAL_CLOUD},
 
   // Local Infrastructure - OCTAVIA (✅ ONLINE - 6 services)
-  {"Octavia Dashboard", "http://192.168.4.38:3000", "GET", false},      // BlackRoad OS Next.js
-  {"Octavia Service 1", "http://192.168.4.38:3002", "GET", false},      // Unknown service
-  {"Octavia vLLM", "http://192.168.4.38:8000", "GET", false},          // Possible vLLM server
-  {"Octavia API 1", "http://192.168.4.38:8080", "GET", false},         // HTTP service
-  {"Octavia API 2", "http://192.168.4.38:8081", "GET", false},         // HTTP service
+  {"Octavia Dashboard", "http://192.168.4.38:3000", "GET", false, HEALTH_INTERVAL_LOCAL},      // BlackRoad OS Next.js
+  {"Octavia Service 1", "http://192.168.4.38:3002", "GET", false, HEALTH_INTERVAL_LOCAL},      // Unknown service
+  {"Octavia vLLM", "http://192.168.4.38:8000", "GET", false, HEALTH_INTERVAL_LOCAL},          // Possible vLLM server
+  {"Octavia API 1", "http://192.168.4.38:8080", "GET", false, HEALTH_INTERVAL_LOCAL},         // HTTP service
+  {"Octavia API 2", "http://192.168.4.38:8081", "GET", false, HEALTH_INTERVAL_LOCAL},         // HTTP service
 
   // Local Infrastructure - ARIA (✅ ONLINE)
-  {"Aria Service", "http://192.168.4.27:5000", "GET", false},          // Service port 5000
+  {"Aria Service", "http://192.168.4.27:5000", "GET", false, HEALTH_INTERVAL_LOCAL},          // Service port 5000
 
   // Local Infrastructure - ALICE (✅ ONLINE - SSH only)
   // Note: Alice only has SSH (port 22), no HTTP services discovered
 
   // Local Infrastructure - OFFLINE
-  // {"Lucidia", "http://192.168.4.99:3000", "GET", false},           // ❌ OFFLINE
-  // {"BlackRoad Pi", "http://192.168.4.64:3000", "GET", false},      // ❌ OFFLINE
+  // {"Lucidia", "http://192.168.4.99:3000", "GET", false, HEALTH_INTERVAL_LOCAL},           // ❌ OFFLINE
+  // {"BlackRoad Pi", "http://192.168.4.64:3000", "GET", false, HEALTH_INTERVAL_LOCAL},      // ❌ OFFLINE
 
   // iPhone (not scanned)
-  {"iPhone Koder", "http://192.168.4.68:8080", "GET", false}
+  {"iPhone Koder", "http://192.168.4.68:8080", "GET", false, HEALTH_INTERVAL_LOCAL}
 };
-#define HEALTH_CHECK_COUNT 16
+#define HEALTH_CHECK_COUNT ((int)(sizeof(HEALTH_CHECKS) / sizeof(HEALTH_CHECKS[0])))
 
 // ═══════════════════════════════════════════════════════════
 // REAL-TIME ENDPOINTS (WebSockets, SSE)
 // ═══════════════════════════════════════════════════════════
 
-#define WS_OCTAVIA "ws://192.168.4.38:8080/ws"
-#define WS_LUCIDIA "ws://192.168.4.99:3000/ws"
-#define SSE_RAILWAY "https://backboard.railway.app/sse"
+#include "realtime_config.h"  // WS_OCTAVIA, WS_LUCIDIA, SSE_RAILWAY
 
 // ═══════════════════════════════════════════════════════════
 // UTILITY FUNCTIONS
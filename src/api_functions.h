@@ -2,7 +2,14 @@
 #define API_FUNCTIONS_H
 
 #include <HTTPClient.h>
+#include <JsonWriter.h>
 #include "api_config.h"
+#include "http_pool.h"
+#include "json_stream.h"
+#include "fetch_engine.h"
+#include "rate_limiter.h"
+#include "data_cache.h"
+#include "lan_sweep.h"
 
 /*
  * API Health Check & Connection Functions
@@ -22,6 +29,8 @@ struct APIStatus {
 APIStatus apiStatuses[HEALTH_CHECK_COUNT];
 unsigned long lastHealthCheck = 0;
 #define HEALTH_CHECK_INTERVAL 60000  // Check every 60 seconds
+#define HEALTH_MAX_CONCURRENT 3      // Probes in flight at once
+#define HEALTH_STAGGER_MS 500        // Spread first probes after boot
 
 // Initialize API status tracking
 void initAPIStatus() {
@@ -31,7 +40,7 @@ void initAPIStatus() {
     apiStatuses[i].online = false;
     apiStatuses[i].responseTime = 0;
     apiStatuses[i].httpCode = 0;
-    apiStatuses[i].lastError = "";
+    apiStatuses[i].lastError = HEALTH_CHECKS[i].requiresAuth ? "Auth required" : "";
   }
 }
 
@@ -45,19 +54,18 @@ APIStatus checkAPIEndpoint(const char* name, const char* url, const char* method
   status.httpCode = 0;
   status.lastError = "";
 
-  HTTPClient http;
+  JsonHttpRequest req;
   unsigned long startTime = millis();
 
   Serial.printf("🔍 Checking API: %s (%s)\n", name, url);
 
-  http.begin(url);
-  http.setTimeout(5000);  // 5 second timeout
+  req.begin(url, 5000);  // 5 second ceiling, adaptive below that
 
   int httpCode = -1;
   if (strcmp(method, "GET") == 0) {
-    httpCode = http.GET();
+    httpCode = req.GET();
   } else if (strcmp(method, "POST") == 0) {
-    httpCode = http.POST("");
+    httpCode = req.POST("");
   }
 
   unsigned long responseTime = millis() - startTime;
@@ -68,53 +76,193 @@ APIStatus checkAPIEndpoint(const char* name, const char* url, const char* method
   if (httpCode > 0) {
     status.online = (httpCode >= 200 && httpCode < 400);
     Serial.printf("   ✅ %s: %d (%dms)\n", name, httpCode, responseTime);
+  } else if (req.circuitOpen()) {
+    status.online = false;
+    status.lastError = "Circuit open";
+    Serial.printf("   🔌 %s: skipped (circuit open)\n", name);
   } else {
     status.online = false;
-    status.lastError = http.errorToString(httpCode);
+    status.lastError = req.http.errorToString(httpCode);
     Serial.printf("   ❌ %s: %s\n", name, status.lastError.c_str());
   }
 
-  http.end();
+  req.end();
   return status;
 }
 
-// Check all API endpoints (health check)
-void checkAllAPIs() {
-  Serial.println("\n🔍 Running API Health Checks...");
-  Serial.println("━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━");
+/*
+ * ───────────────────────────────────────────────────────────────────────
+ * LAN SERVICES (TCP handshake sweep)
+ * ───────────────────────────────────────────────────────────────────────
+ *
+ * The Pis are checked with parallel TCP connects (lan_sweep.h) instead
+ * of HTTP GETs. Sweep results own the matching HEALTH_CHECKS rows, so the
+ * HTTP scheduler skips them.
+ */
+
+int lanHealthIndex[LAN_SWEEP_MAX_TARGETS];       // LAN target -> HEALTH_CHECKS row, -1 if none
+bool healthLanCovered[HEALTH_CHECK_COUNT];
+uint32_t healthLanGeneration = 0;                // Last sweep folded into apiStatuses
+bool lanTargetsReady = false;
+
+void addLanHealthTarget(const char* node, const char* label, const char* ip, uint16_t port) {
+  if (!lanSweepAddTarget(node, label, ip, port)) return;
 
+  char prefix[32];
+  snprintf(prefix, sizeof(prefix), "http://%s:%u", ip, port);
+  int target = lanTargetCount - 1;
+  lanHealthIndex[target] = -1;
   for (int i = 0; i < HEALTH_CHECK_COUNT; i++) {
-    // Skip APIs that require auth for now (will add auth tokens later)
-    if (HEALTH_CHECKS[i].requiresAuth) {
-      Serial.printf("⏭  Skipping %s (requires auth)\n", HEALTH_CHECKS[i].name);
-      apiStatuses[i].name = String(HEALTH_CHECKS[i].name);
-      apiStatuses[i].url = String(HEALTH_CHECKS[i].url);
-      apiStatuses[i].online = false;
-      apiStatuses[i].responseTime = 0;
-      apiStatuses[i].httpCode = 0;
-      apiStatuses[i].lastError = "Auth required";
-      continue;
+    if (strcmp(HEALTH_CHECKS[i].url, prefix) == 0) {
+      lanHealthIndex[target] = i;
+      healthLanCovered[i] = true;
+      break;
     }
+  }
+}
+
+// The only place LAN targets are registered - setup() and the health
+// scheduler both call this, the first call wins
+void initLanTargets() {
+  if (lanTargetsReady) return;
+  lanTargetsReady = true;
+  for (int t = 0; t < LAN_SWEEP_MAX_TARGETS; t++) lanHealthIndex[t] = -1;
+
+  addLanHealthTarget("alice", "SSH", ALICE_IP, SSH_ALICE_PORT);
+  addLanHealthTarget("octavia", "Dashboard", OCTAVIA_IP, OCTAVIA_DASHBOARD_PORT);
+  addLanHealthTarget("octavia", "Service 1", OCTAVIA_IP, OCTAVIA_SERVICE_1_PORT);
+  addLanHealthTarget("octavia", "vLLM", OCTAVIA_IP, OCTAVIA_SERVICE_2_PORT);
+  addLanHealthTarget("octavia", "API 1", OCTAVIA_IP, OCTAVIA_SERVICE_3_PORT);
+  addLanHealthTarget("octavia", "API 2", OCTAVIA_IP, OCTAVIA_SERVICE_4_PORT);
+  addLanHealthTarget("aria", "Service", ARIA_IP, ARIA_SERVICE_PORT);
+  addLanHealthTarget("iphone", "Koder", IPHONE_KODER_IP, IPHONE_API_PORT);
+}
 
-    apiStatuses[i] = checkAPIEndpoint(
-      HEALTH_CHECKS[i].name,
-      HEALTH_CHECKS[i].url,
-      HEALTH_CHECKS[i].method
-    );
+const char* lanProbeStateLabel(uint8_t state) {
+  switch (state) {
+    case LAN_OPEN: return "";
+    case LAN_REFUSED: return "Connection refused";
+    case LAN_TIMEOUT: return "Timeout";
+    case LAN_ERROR: return "Unreachable";
+    default: return "Not checked";
+  }
+}
 
-    delay(500);  // Rate limiting - don't hammer APIs
+// Copy landed sweep results into the matching apiStatuses rows
+void applyLanSweepToAPIStatus() {
+  for (int t = 0; t < lanTargetCount; t++) {
+    int i = lanHealthIndex[t];
+    if (i < 0 || lanTargets[t].checkedAt == 0) continue;
+
+    const LanProbe& probe = lanTargets[t].probe;
+    apiStatuses[i].online = probe.state == LAN_OPEN;
+    apiStatuses[i].responseTime = probe.rttMs;
+    apiStatuses[i].httpCode = 0;  // Handshake only, no HTTP exchange
+    apiStatuses[i].lastError = lanProbeStateLabel(probe.state);
   }
+  healthLanGeneration = lanSweepGeneration;
+  lastHealthCheck = millis();
+}
 
-  // Summary
-  int onlineCount = 0;
+/*
+ * ───────────────────────────────────────────────────────────────────────
+ * HEALTH CHECK SCHEDULER
+ * ───────────────────────────────────────────────────────────────────────
+ *
+ * Probes run on fetch engine tasks, at most HEALTH_MAX_CONCURRENT at
+ * once, each endpoint on its own interval (HEALTH_CHECKS[].intervalMs).
+ * healthSchedulerTick() only harvests results and starts due probes, so
+ * loop() never waits on the network.
+ */
+
+struct HealthProbe {
+  FetchJob job;
+  int index;                 // Into HEALTH_CHECKS / apiStatuses
+  unsigned long nextDue;
+  APIStatus result;          // Written by the probe task, copied on harvest
+};
+
+HealthProbe healthProbes[HEALTH_CHECK_COUNT];
+bool healthSchedulerReady = false;
+
+bool healthProbeJob(void* arg) {
+  HealthProbe* probe = (HealthProbe*)arg;
+  const APIEndpoint& ep = HEALTH_CHECKS[probe->index];
+  probe->result = checkAPIEndpoint(ep.name, ep.url, ep.method);
+  return probe->result.online;
+}
+
+void initHealthScheduler() {
+  initLanTargets();
+
+  unsigned long now = millis();
   for (int i = 0; i < HEALTH_CHECK_COUNT; i++) {
-    if (apiStatuses[i].online) onlineCount++;
+    HealthProbe* probe = &healthProbes[i];
+    probe->job.name = HEALTH_CHECKS[i].name;
+    probe->job.fn = healthProbeJob;
+    probe->job.arg = probe;
+    probe->job.state = FETCH_IDLE;
+    probe->job.result = false;
+    probe->index = i;
+    probe->nextDue = now + i * HEALTH_STAGGER_MS;
   }
+  healthSchedulerReady = true;
+}
 
-  Serial.println("━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━");
-  Serial.printf("✅ Health Check Complete: %d/%d online\n", onlineCount, HEALTH_CHECK_COUNT);
+// Call every loop(), after lanSweepTick(). Never blocks on the network.
+void healthSchedulerTick() {
+  if (!healthSchedulerReady) initHealthScheduler();
 
-  lastHealthCheck = millis();
+  // LAN rows come from the TCP sweep
+  if (healthLanGeneration != lanSweepGeneration) applyLanSweepToAPIStatus();
+
+  unsigned long now = millis();
+  int running = 0;
+
+  // Harvest finished probes into apiStatuses
+  for (int i = 0; i < HEALTH_CHECK_COUNT; i++) {
+    HealthProbe* probe = &healthProbes[i];
+    if (probe->job.state == FETCH_DONE) {
+      apiStatuses[i] = probe->result;
+      probe->job.state = FETCH_IDLE;
+      lastHealthCheck = now;
+    } else if (probe->job.state == FETCH_RUNNING) {
+      running++;
+    }
+  }
+
+  // Start due probes up to the concurrency cap
+  if (WiFi.status() != WL_CONNECTED) return;
+  for (int i = 0; i < HEALTH_CHECK_COUNT && running < HEALTH_MAX_CONCURRENT; i++) {
+    HealthProbe* probe = &healthProbes[i];
+    if (HEALTH_CHECKS[i].requiresAuth) continue;  // No auth tokens yet
+    if (healthLanCovered[i]) continue;            // Owned by the LAN sweep
+    if (probe->job.state != FETCH_IDLE) continue;
+    if ((long)(now - probe->nextDue) < 0) continue;
+
+    probe->nextDue = now + HEALTH_CHECKS[i].intervalMs;
+    if (startFetchJob(&probe->job)) running++;
+  }
+}
+
+// Make every endpoint due now (results land over the next few ticks)
+void checkAllAPIs() {
+  if (!healthSchedulerReady) initHealthScheduler();
+
+  Serial.println("\n🔍 Scheduling API Health Checks...");
+  unsigned long now = millis();
+  for (int i = 0; i < HEALTH_CHECK_COUNT; i++) {
+    healthProbes[i].nextDue = now;
+  }
+  lanSweepStart();
+}
+
+int getHealthProbesInFlight() {
+  int running = 0;
+  for (int i = 0; i < HEALTH_CHECK_COUNT; i++) {
+    if (healthProbes[i].job.state == FETCH_RUNNING) running++;
+  }
+  return running;
 }
 
 // Get API status for display
@@ -142,51 +290,42 @@ bool shouldRunHealthCheck() {
   return (millis() - lastHealthCheck > HEALTH_CHECK_INTERVAL);
 }
 
-// Quick ping test to local Raspberry Pis
+// Quick TCP handshake test to a local Raspberry Pi
 bool pingLocalServer(const char* ip, int port) {
-  HTTPClient http;
-  String url = "http://" + String(ip) + ":" + String(port) + "/health";
-
-  http.begin(url);
-  http.setTimeout(2000);  // 2 second timeout
-
-  int httpCode = http.GET();
-  http.end();
-
-  return (httpCode == 200 || httpCode == 404);  // 404 means server is up but no health endpoint
+  IPAddress addr;
+  if (!addr.fromString(ip)) return false;
+  return lanPortOpen(addr, port);
 }
 
-// Test all local infrastructure
+// Test all local infrastructure - every service at once, ~one LAN RTT
 void testLocalInfrastructure() {
+  initLanTargets();
   Serial.println("\n🏠 Testing Local Infrastructure...");
 
-  Serial.print("Octavia (192.168.4.38): ");
-  if (pingLocalServer(OCTAVIA_IP, OCTAVIA_API_PORT)) {
-    Serial.println("✅ ONLINE");
-  } else {
-    Serial.println("❌ OFFLINE");
-  }
+  LanProbe probes[LAN_SWEEP_MAX_TARGETS];
+  for (int i = 0; i < lanTargetCount; i++) probes[i] = lanTargets[i].probe;
 
-  Serial.print("Lucidia (192.168.4.99): ");
-  if (pingLocalServer(LUCIDIA_IP, LUCIDIA_API_PORT)) {
-    Serial.println("✅ ONLINE");
-  } else {
-    Serial.println("❌ OFFLINE");
-  }
+  unsigned long start = millis();
+  int up = lanProbeBatch(probes, lanTargetCount, LAN_SWEEP_TIMEOUT_MS);
+  unsigned long elapsed = millis() - start;
 
-  Serial.print("BlackRoad Pi (192.168.4.64): ");
-  if (pingLocalServer(BLACKROAD_PI_IP, 3000)) {
-    Serial.println("✅ ONLINE");
-  } else {
-    Serial.println("❌ OFFLINE");
+  unsigned long now = millis();
+  for (int i = 0; i < lanTargetCount; i++) {
+    LanTarget* t = &lanTargets[i];
+    t->probe = probes[i];
+    t->checkedAt = now;
+
+    IPAddress ip(t->probe.ip);
+    Serial.printf("%-8s %-10s %s:%u  ", t->node, t->label, ip.toString().c_str(), t->probe.port);
+    if (t->probe.state == LAN_OPEN) {
+      Serial.printf("✅ ONLINE (%ums)\n", t->probe.rttMs);
+    } else {
+      Serial.printf("❌ %s\n", lanProbeStateLabel(t->probe.state));
+    }
   }
+  applyLanSweepToAPIStatus();
 
-  Serial.print("iPhone Koder (192.168.4.68): ");
-  if (pingLocalServer(IPHONE_KODER_IP, IPHONE_API_PORT)) {
-    Serial.println("✅ ONLINE");
-  } else {
-    Serial.println("❌ OFFLINE");
-  }
+  Serial.printf("%d/%d answering, swept in %lums\n", up, lanTargetCount, elapsed);
 }
 
 /*
@@ -207,35 +346,6 @@ struct APIResponse {
   unsigned long timestamp;
 };
 
-// Rate limiting tracker
-struct RateLimitTracker {
-  unsigned long lastRequest;
-  int requestCount;
-  unsigned long windowStart;
-};
-
-RateLimitTracker rateLimits[10];  // Track up to 10 different APIs
-
-// Check if API request is within rate limit
-bool checkRateLimit(int apiIndex, int maxRequests, unsigned long windowMs) {
-  unsigned long now = millis();
-
-  // Reset window if expired
-  if (now - rateLimits[apiIndex].windowStart > windowMs) {
-    rateLimits[apiIndex].windowStart = now;
-    rateLimits[apiIndex].requestCount = 0;
-  }
-
-  // Check if under limit
-  if (rateLimits[apiIndex].requestCount < maxRequests) {
-    rateLimits[apiIndex].requestCount++;
-    rateLimits[apiIndex].lastRequest = now;
-    return true;
-  }
-
-  return false;
-}
-
 // Generic GET request with authentication
 APIResponse apiGet(const char* url, const char* authHeader = nullptr, const char* authValue = nullptr) {
   APIResponse response;
@@ -243,29 +353,30 @@ APIResponse apiGet(const char* url, const char* authHeader = nullptr, const char
   response.statusCode = 0;
   response.timestamp = millis();
 
-  HTTPClient http;
-  http.begin(url);
-  http.setTimeout(10000);  // 10 second timeout
+  JsonHttpRequest req;
+  req.begin(url, 10000);  // 10 second ceiling
 
   if (authHeader && authValue) {
-    http.addHeader(authHeader, authValue);
+    req.http.addHeader(authHeader, authValue);
   }
 
-  int httpCode = http.GET();
+  int httpCode = req.GET();
   response.statusCode = httpCode;
 
   if (httpCode > 0) {
     response.success = (httpCode == 200 || httpCode == 201);
-    response.data = http.getString();
+    response.data = req.body().readString();
 
     if (!response.success) {
       response.error = "HTTP " + String(httpCode);
     }
+  } else if (req.circuitOpen()) {
+    response.error = "Circuit open";
   } else {
-    response.error = "Connection failed: " + http.errorToString(httpCode);
+    response.error = "Connection failed: " + req.http.errorToString(httpCode);
   }
 
-  http.end();
+  req.end();
   return response;
 }
 
@@ -289,9 +400,10 @@ struct GitHubStats {
 
 GitHubStats githubData;
 
-bool fetchGitHubStats(const char* token, const char* username) {
-  if (!checkRateLimit(0, 60, 3600000)) {  // 60 requests per hour
-    Serial.println("⏱️  GitHub API rate limit reached");
+bool fetchGitHubStats(const char* token, const char* username,
+                      RequestPriority priority = PRIORITY_BACKGROUND) {
+  if (!rateLimitAcquire("github", priority)) {
+    Serial.printf("⏱️  GitHub API rate limited (next in %lus)\n", rateLimitWaitMs("github", priority) / 1000);
     return false;
   }
 
@@ -300,58 +412,114 @@ bool fetchGitHubStats(const char* token, const char* username) {
   String url = "https://api.github.com/users/" + String(username) + "/repos?per_page=100&sort=updated";
   String authValue = "Bearer " + String(token);
 
-  APIResponse response = apiGet(url.c_str(), "Authorization", authValue.c_str());
-
-  if (!response.success) {
-    Serial.printf("❌ GitHub API error: %s\n", response.error.c_str());
-    return false;
+  JsonHttpRequest req;
+  req.begin(url.c_str(), 10000, true);
+  req.http.addHeader("Authorization", authValue);
+  req.acceptCompressed();  // 100 repos is ~500KB of JSON uncompressed
+
+  int httpCode = req.GET();
+  if (httpCode == HTTP_CODE_NOT_MODIFIED) {
+    // Nothing changed - keep current stats, and GitHub doesn't bill 304s
+    rateLimitRefund("github");
+    githubData.lastUpdate = millis();
+    Serial.println("✅ GitHub: not modified");
+    return true;
   }
-
-  // Parse JSON response
-  DynamicJsonDocument doc(16384);
-  DeserializationError error = deserializeJson(doc, response.data);
-
-  if (error) {
-    Serial.printf("❌ JSON parse error: %s\n", error.c_str());
+  if (httpCode != 200) {
+    Serial.printf("❌ GitHub API error: HTTP %d\n", httpCode);
     return false;
   }
 
-  // Reset counters
-  githubData.totalRepos = 0;
-  githubData.starsTotal = 0;
-  githubData.forksTotal = 0;
-
-  // Process repositories
-  JsonArray repos = doc.as<JsonArray>();
-  for (JsonObject repo : repos) {
-    githubData.totalRepos++;
-    githubData.starsTotal += repo["stargazers_count"].as<int>();
-    githubData.forksTotal += repo["forks_count"].as<int>();
-
-    // Get most recent commit from first repo
-    if (githubData.totalRepos == 1) {
-      const char* repoName = repo["name"];
-      strncpy(githubData.lastCommitRepo, repoName, 49);
-
-      // Fetch latest commit for this repo
-      String commitUrl = "https://api.github.com/repos/" + String(username) + "/" + String(repoName) + "/commits?per_page=1";
-      APIResponse commitResponse = apiGet(commitUrl.c_str(), "Authorization", authValue.c_str());
+  // Stream the repo array one element at a time - only 3 fields per repo
+  // are ever materialized, no matter how large the response is
+  StaticJsonDocument<128> filter;
+  filter["name"] = true;
+  filter["stargazers_count"] = true;
+  filter["forks_count"] = true;
+
+  // Totals land in githubData only after the whole array parsed cleanly -
+  // a response cut off mid-stream must not publish a partial count
+  int repos = 0;
+  int stars = 0;
+  int forks = 0;
+  char newestRepo[50] = "";
+
+  Stream& body = req.body();
+  bool parsed = jsonPeekToken(body) == '[';
+  if (parsed) {
+    body.read();
+    if (jsonPeekToken(body) == ']') {
+      body.read();  // No repos is a valid answer
+    } else {
+      StaticJsonDocument<256> repo;
+      while (true) {
+        DeserializationError error = deserializeJson(repo, body, DeserializationOption::Filter(filter));
+        if (error) {
+          Serial.printf("❌ JSON parse error: %s\n", error.c_str());
+          parsed = false;
+          break;
+        }
 
-      if (commitResponse.success) {
-        DynamicJsonDocument commitDoc(4096);
-        deserializeJson(commitDoc, commitResponse.data);
-        JsonArray commits = commitDoc.as<JsonArray>();
+        repos++;
+        stars += repo["stargazers_count"].as<int>();
+        forks += repo["forks_count"].as<int>();
 
-        if (commits.size() > 0) {
-          JsonObject commit = commits[0];
-          const char* message = commit["commit"]["message"];
-          const char* author = commit["commit"]["author"]["name"];
+        // Most recently updated repo comes first
+        if (repos == 1) {
+          strncpy(newestRepo, repo["name"] | "", sizeof(newestRepo) - 1);
+        }
 
-          strncpy(githubData.lastCommitMsg, message, 149);
-          strncpy(githubData.lastCommitAuthor, author, 49);
+        int next = jsonPeekToken(body);
+        body.read();
+        if (next == ']') break;
+        if (next != ',') {
+          Serial.println("❌ JSON parse error: repo list cut short");
+          parsed = false;
+          break;
         }
       }
     }
+  } else {
+    Serial.println("❌ JSON parse error: expected a repo array");
+  }
+
+  if (!parsed) {
+    req.end();
+    return false;
+  }
+  req.commitCache();
+  req.end();
+
+  githubData.totalRepos = repos;
+  githubData.starsTotal = stars;
+  githubData.forksTotal = forks;
+  strncpy(githubData.lastCommitRepo, newestRepo, sizeof(githubData.lastCommitRepo) - 1);
+  githubData.lastCommitRepo[sizeof(githubData.lastCommitRepo) - 1] = '\0';
+
+  // Fetch latest commit for the most recent repo (after the repo list is
+  // done, so the pooled socket is free again)
+  if (repos > 0) {
+    String commitUrl = "https://api.github.com/repos/" + String(username) + "/" + String(newestRepo) + "/commits?per_page=1";
+
+    req.begin(commitUrl.c_str(), 10000, true);
+    req.http.addHeader("Authorization", authValue);
+
+    // 304 keeps the commit we already have
+    if (req.GET() == 200) {
+      StaticJsonDocument<128> commitFilter;
+      commitFilter[0]["commit"]["message"] = true;
+      commitFilter[0]["commit"]["author"]["name"] = true;
+
+      DynamicJsonDocument commitDoc(1536);
+      if (!req.parse(commitDoc, commitFilter)) {
+        JsonObject commit = commitDoc[0]["commit"];
+        strncpy(githubData.lastCommitMsg, commit["message"] | "", 149);
+        githubData.lastCommitMsg[149] = '\0';
+        strncpy(githubData.lastCommitAuthor, commit["author"]["name"] | "", 49);
+        githubData.lastCommitAuthor[49] = '\0';
+      }
+    }
+    req.end();
   }
 
   // Fetch open PRs and issues count (simplified - would need to check each repo)
@@ -393,9 +561,9 @@ struct CryptoPrice {
 
 CryptoPrice cryptoData = {0, 0, 0, 0, 0, 0, 0};
 
-bool fetchCryptoPrice() {
-  if (!checkRateLimit(2, 50, 60000)) {  // 50 requests per minute (CoinGecko free tier)
-    Serial.println("⏱️  Crypto API rate limit reached");
+bool fetchCryptoPrice(RequestPriority priority = PRIORITY_BACKGROUND) {
+  if (!rateLimitAcquire("crypto", priority)) {
+    Serial.printf("⏱️  Crypto API rate limited (next in %lus)\n", rateLimitWaitMs("crypto", priority) / 1000);
     return false;
   }
 
@@ -404,11 +572,19 @@ bool fetchCryptoPrice() {
   // CoinGecko free API - no key needed!
   String url = "https://api.coingecko.com/api/v3/simple/price?ids=bitcoin,ethereum,solana&vs_currencies=usd&include_24hr_change=true";
 
-  APIResponse response = apiGet(url.c_str(), "", "");
+  JsonHttpRequest req;
+  req.begin(url.c_str(), 10000);
+  int httpCode = req.GET();
 
-  if (response.statusCode == 200) {
-    DynamicJsonDocument doc(2048);
-    DeserializationError error = deserializeJson(doc, response.data);
+  if (httpCode == 200) {
+    StaticJsonDocument<128> filter;
+    filter["bitcoin"] = true;
+    filter["ethereum"] = true;
+    filter["solana"] = true;
+
+    StaticJsonDocument<384> doc;
+    DeserializationError error = req.parse(doc, filter);
+    req.end();
 
     if (error) {
       Serial.printf("❌ Crypto JSON parse error: %s\n", error.c_str());
@@ -437,7 +613,7 @@ bool fetchCryptoPrice() {
     return true;
   }
 
-  Serial.printf("❌ Crypto API error: HTTP %d\n", response.statusCode);
+  Serial.printf("❌ Crypto API error: HTTP %d\n", httpCode);
   trackAPIFetch(2, false);
   return false;
 }
@@ -462,9 +638,10 @@ struct WeatherData {
 
 WeatherData weatherData;
 
-bool fetchWeather(const char* apiKey, const char* city) {
-  if (!checkRateLimit(1, 100, 3600000)) {  // 100 requests per hour
-    Serial.println("⏱️  Weather API rate limit reached");
+bool fetchWeather(const char* apiKey, const char* city,
+                  RequestPriority priority = PRIORITY_BACKGROUND) {
+  if (!rateLimitAcquire("weather", priority)) {
+    Serial.printf("⏱️  Weather API rate limited (next in %lus)\n", rateLimitWaitMs("weather", priority) / 1000);
     return false;
   }
 
@@ -473,15 +650,32 @@ bool fetchWeather(const char* apiKey, const char* city) {
   String url = "https://api.openweathermap.org/data/2.5/weather?q=" +
                String(city) + "&appid=" + String(apiKey) + "&units=imperial";
 
-  APIResponse response = apiGet(url.c_str());
+  JsonHttpRequest req;
+  req.begin(url.c_str(), 10000, true);
+  int httpCode = req.GET();
+
+  if (httpCode == HTTP_CODE_NOT_MODIFIED) {
+    weatherData.lastUpdate = millis();
+    Serial.println("✅ Weather: not modified");
+    return true;
+  }
 
-  if (!response.success) {
-    Serial.printf("❌ Weather API error: %s\n", response.error.c_str());
+  if (httpCode != 200) {
+    Serial.printf("❌ Weather API error: HTTP %d\n", httpCode);
     return false;
   }
 
-  DynamicJsonDocument doc(4096);
-  DeserializationError error = deserializeJson(doc, response.data);
+  StaticJsonDocument<192> filter;
+  filter["main"]["temp"] = true;
+  filter["main"]["feels_like"] = true;
+  filter["main"]["humidity"] = true;
+  filter["wind"]["speed"] = true;
+  filter["weather"][0]["main"] = true;
+  filter["weather"][0]["icon"] = true;
+
+  StaticJsonDocument<512> doc;
+  DeserializationError error = req.parse(doc, filter);
+  req.end();
 
   if (error) {
     Serial.printf("❌ JSON parse error: %s\n", error.c_str());
@@ -493,8 +687,8 @@ bool fetchWeather(const char* apiKey, const char* city) {
   weatherData.humidity = doc["main"]["humidity"];
   weatherData.windSpeed = doc["wind"]["speed"];
 
-  const char* condition = doc["weather"][0]["main"];
-  const char* icon = doc["weather"][0]["icon"];
+  const char* condition = doc["weather"][0]["main"] | "";
+  const char* icon = doc["weather"][0]["icon"] | "";
 
   strncpy(weatherData.condition, condition, 49);
   strncpy(weatherData.icon, icon, 9);
@@ -526,8 +720,8 @@ struct StripeMetrics {
 
 StripeMetrics stripeData;
 
-bool fetchStripeMetrics(const char* apiKey) {
-  if (!checkRateLimit(2, 100, 3600000)) {  // 100 requests per hour
+bool fetchStripeMetrics(const char* apiKey, RequestPriority priority = PRIORITY_BACKGROUND) {
+  if (!rateLimitAcquire("stripe", priority)) {
     Serial.println("⏱️  Stripe API rate limit reached");
     return false;
   }
@@ -537,15 +731,26 @@ bool fetchStripeMetrics(const char* apiKey) {
   String url = "https://api.stripe.com/v1/charges?limit=10";
   String authValue = "Bearer " + String(apiKey);
 
-  APIResponse response = apiGet(url.c_str(), "Authorization", authValue.c_str());
+  JsonHttpRequest req;
+  req.begin(url.c_str(), 10000);
+  req.http.addHeader("Authorization", authValue);
+  req.acceptCompressed();
+  int httpCode = req.GET();
 
-  if (!response.success) {
-    Serial.printf("❌ Stripe API error: %s\n", response.error.c_str());
+  if (httpCode != 200) {
+    Serial.printf("❌ Stripe API error: HTTP %d\n", httpCode);
     return false;
   }
 
-  DynamicJsonDocument doc(8192);
-  DeserializationError error = deserializeJson(doc, response.data);
+  // Stripe charge objects are ~3KB each - keep only what we display
+  StaticJsonDocument<128> filter;
+  filter["data"][0]["status"] = true;
+  filter["data"][0]["amount"] = true;
+  filter["data"][0]["description"] = true;
+
+  DynamicJsonDocument doc(2048);
+  DeserializationError error = req.parse(doc, filter);
+  req.end();
 
   if (error) {
     Serial.printf("❌ JSON parse error: %s\n", error.c_str());
@@ -566,8 +771,8 @@ bool fetchStripeMetrics(const char* apiKey) {
 
       // Store first 3 recent charges
       if (stripeData.chargesCount <= 3) {
-        String chargeInfo = "$" + String(amount, 2) + " - " + String(charge["description"].as<const char*>());
-        strncpy(stripeData.recentCharges[stripeData.chargesCount - 1], chargeInfo.c_str(), 99);
+        snprintf(stripeData.recentCharges[stripeData.chargesCount - 1], 100, "$%.2f - %s",
+                 amount, charge["description"] | "");
       }
     }
   }
@@ -596,36 +801,54 @@ struct LinearTask {
 LinearTask linearTasks[10];
 int linearTaskCount = 0;
 
-bool fetchLinearTasks(const char* apiKey, const char* userEmail) {
-  if (!checkRateLimit(3, 100, 3600000)) {  // 100 requests per hour
+bool fetchLinearTasks(const char* apiKey, const char* userEmail,
+                      RequestPriority priority = PRIORITY_BACKGROUND) {
+  if (!rateLimitAcquire("linear", priority)) {
     Serial.println("⏱️  Linear API rate limit reached");
     return false;
   }
 
   Serial.println("📋 Fetching Linear tasks...");
 
-  HTTPClient http;
-  http.begin("https://api.linear.app/graphql");
-  http.setTimeout(10000);
-  http.addHeader("Authorization", apiKey);
-  http.addHeader("Content-Type", "application/json");
-
-  String query = "{\"query\":\"{ issues(filter: { assignee: { email: { eq: \\\"" +
-                 String(userEmail) + "\\\" }}}) { nodes { id title state { name } priority }}}\"}";
+  JsonHttpRequest req;
+  req.begin(LINEAR_API, 10000);
+  req.http.addHeader("Authorization", apiKey);
+  req.http.addHeader("Content-Type", "application/json");
+  req.acceptCompressed();
+
+  // The email goes in as a GraphQL variable, escaped by JsonWriter -
+  // never spliced into the query text
+  char body[320];
+  JsonWriter w(body, sizeof(body));
+  w.beginObject();
+  w.field("query", "query($email: String!) { issues(filter: { assignee: { email: { eq: $email }}}) "
+                   "{ nodes { id title state { name } priority }}}");
+  w.objectField("variables");
+  w.field("email", userEmail);
+  w.endObject();
+  w.endObject();
+  if (w.overflowed()) {
+    Serial.println("❌ Linear query too large");
+    return false;
+  }
 
-  int httpCode = http.POST(query);
+  int httpCode = req.POST(w.c_str(), w.length());
 
   if (httpCode != 200) {
     Serial.printf("❌ Linear API error: HTTP %d\n", httpCode);
-    http.end();
     return false;
   }
 
-  String payload = http.getString();
-  http.end();
+  StaticJsonDocument<192> filter;
+  JsonObject node = filter["data"]["issues"]["nodes"][0].to<JsonObject>();
+  node["id"] = true;
+  node["title"] = true;
+  node["state"]["name"] = true;
+  node["priority"] = true;
 
-  DynamicJsonDocument doc(8192);
-  DeserializationError error = deserializeJson(doc, payload);
+  DynamicJsonDocument doc(3072);
+  DeserializationError error = req.parse(doc, filter);
+  req.end();
 
   if (error) {
     Serial.printf("❌ JSON parse error: %s\n", error.c_str());
@@ -638,9 +861,9 @@ bool fetchLinearTasks(const char* apiKey, const char* userEmail) {
   for (JsonObject issue : issues) {
     if (linearTaskCount >= 10) break;
 
-    strncpy(linearTasks[linearTaskCount].id, issue["id"], 49);
-    strncpy(linearTasks[linearTaskCount].title, issue["title"], 99);
-    strncpy(linearTasks[linearTaskCount].state, issue["state"]["name"], 19);
+    strncpy(linearTasks[linearTaskCount].id, issue["id"] | "", 49);
+    strncpy(linearTasks[linearTaskCount].title, issue["title"] | "", 99);
+    strncpy(linearTasks[linearTaskCount].state, issue["state"]["name"] | "", 19);
     linearTasks[linearTaskCount].priority = issue["priority"].as<int>();
 
     linearTaskCount++;
@@ -926,4 +1149,64 @@ bool loadIntegrationStats() {
   return true;
 }
 
+/*
+ * ───────────────────────────────────────────────────────────────────────
+ * DASHBOARD DATA CACHE - crypto, weather, Stripe, Linear
+ * ───────────────────────────────────────────────────────────────────────
+ *
+ * Screens read snapshots via dataCacheRead<T>() and never wait on the
+ * network; stale entries refresh in the background (data_cache.h).
+ */
+
+// Linear is two globals - snapshot them together
+struct LinearBoard {
+  LinearTask tasks[10];
+  int count;
+};
+
+struct DashboardCredentials {
+  const char* weatherKey;
+  const char* weatherCity;
+  const char* stripeKey;
+  const char* linearKey;
+  const char* linearEmail;
+};
+
+DashboardCredentials dashboardCreds = {NULL, NULL, NULL, NULL, NULL};
+
+bool refreshCryptoCache(void* arg) { return fetchCryptoPrice(); }
+bool refreshWeatherCache(void* arg) { return fetchWeather(dashboardCreds.weatherKey, dashboardCreds.weatherCity); }
+bool refreshStripeCache(void* arg) { return fetchStripeMetrics(dashboardCreds.stripeKey); }
+bool refreshLinearCache(void* arg) { return fetchLinearTasks(dashboardCreds.linearKey, dashboardCreds.linearEmail); }
+
+void captureCrypto(void* dst) { memcpy(dst, &cryptoData, sizeof(CryptoPrice)); }
+void captureWeather(void* dst) { memcpy(dst, &weatherData, sizeof(WeatherData)); }
+void captureStripe(void* dst) { memcpy(dst, &stripeData, sizeof(StripeMetrics)); }
+void captureLinear(void* dst) {
+  LinearBoard* board = (LinearBoard*)dst;
+  memcpy(board->tasks, linearTasks, sizeof(linearTasks));
+  board->count = linearTaskCount;
+}
+
+// TTLs follow each source's rate budget (rate_limiter.h). Sources
+// without credentials aren't registered - their screens show demo data
+void initDashboardCache(const DashboardCredentials& creds) {
+  dashboardCreds = creds;
+
+  //                name       snapshot               ttl      max stale
+  dataCacheRegister("crypto",  sizeof(CryptoPrice),   60000,   600000,   refreshCryptoCache,  captureCrypto);
+  if (creds.weatherKey && creds.weatherCity) {
+    dataCacheRegister("weather", sizeof(WeatherData), 600000,  3600000,  refreshWeatherCache, captureWeather);
+  }
+  if (creds.stripeKey) {
+    dataCacheRegister("stripe",  sizeof(StripeMetrics), 300000, 3600000, refreshStripeCache,  captureStripe);
+  }
+  if (creds.linearKey && creds.linearEmail) {
+    dataCacheRegister("linear",  sizeof(LinearBoard), 300000,  3600000,  refreshLinearCache,  captureLinear);
+  }
+
+  Serial.printf("✅ Dashboard cache: %d sources, %d/%d bytes\n",
+                dataCacheSourceCount, (int)dataCacheArenaUsed, DATA_CACHE_ARENA_BYTES);
+}
+
 #endif // API_FUNCTIONS_H
@@ -0,0 +1,224 @@
+#ifndef DATA_CACHE_H
+#define DATA_CACHE_H
+
+#include <Arduino.h>
+#include "fetch_engine.h"
+#include "rate_limiter.h"
+
+/*
+ * ═══════════════════════════════════════════════════════════════════════
+ * BLACKROAD DASHBOARD DATA CACHE (TTL + STALE-WHILE-REVALIDATE)
+ * ═══════════════════════════════════════════════════════════════════════
+ *
+ * Screens read a snapshot, never the globals a fetcher is writing:
+ * - age < ttl               FRESH    served, no network
+ * - ttl <= age < maxStale   STALE    served, refresh kicked off in the
+ *                                    background (fetch engine task)
+ * - age >= maxStale         EXPIRED  served if we have it, counted as a
+ *                                    miss, refresh kicked off
+ * - never fetched           EMPTY    NULL, refresh kicked off
+ *
+ * dataCacheTick() (from loop) copies finished refreshes into their
+ * snapshot, so a screen never sees a half-written struct. Snapshots
+ * live in one fixed arena - memory is bounded at DATA_CACHE_ARENA_BYTES.
+ *
+ * A source named after a rate limiter bucket is paced by it: after each
+ * refresh the next one waits rateLimitPollIntervalMs() (longer if the
+ * bucket is dry), so a screen redrawing an expired source doesn't start
+ * a fetch per frame.
+ *
+ * Usage:
+ *   unsigned long age;
+ *   const WeatherData* wx = dataCacheRead<WeatherData>("weather", &age);
+ *   if (wx) { draw it, then formatCacheAge(age, buf, sizeof(buf)) }
+ */
+
+// ─────────────────────────────────────────────────────────────────────
+// CACHE CONFIGURATION
+// ─────────────────────────────────────────────────────────────────────
+
+#define DATA_CACHE_MAX_SOURCES 8
+#define DATA_CACHE_ARENA_BYTES 4096
+
+// ─────────────────────────────────────────────────────────────────────
+// DATA STRUCTURES
+// ─────────────────────────────────────────────────────────────────────
+
+enum CacheState {
+  CACHE_EMPTY,
+  CACHE_FRESH,
+  CACHE_STALE,
+  CACHE_EXPIRED
+};
+
+struct DataCacheSource {
+  const char* name;
+  size_t size;                   // sizeof the snapshot type
+  unsigned long ttlMs;           // Served as fresh this long
+  unsigned long maxStaleMs;      // Served stale (revalidating) until this age
+  bool (*refresh)(void* arg);    // Fetcher - writes its globals
+  void (*capture)(void* dst);    // Copies those globals into the snapshot
+  void* arg;
+  uint8_t* snapshot;             // Inside dataCacheArena
+  unsigned long updatedAt;       // 0 = never filled
+  unsigned long nextRefreshAt;   // Bucket pacing - no revalidation before this
+  FetchJob job;
+};
+
+struct DataCacheStats {
+  uint32_t hits;                 // Fresh reads
+  uint32_t stale;                // Stale reads (served + revalidated)
+  uint32_t misses;               // Empty or expired reads
+  uint32_t refreshes;
+  uint32_t refreshFailures;
+};
+
+uint8_t dataCacheArena[DATA_CACHE_ARENA_BYTES];
+size_t dataCacheArenaUsed = 0;
+DataCacheSource dataCacheSources[DATA_CACHE_MAX_SOURCES];
+int dataCacheSourceCount = 0;
+DataCacheStats dataCacheStats = {0, 0, 0, 0, 0};
+
+// ─────────────────────────────────────────────────────────────────────
+// REGISTRATION
+// ─────────────────────────────────────────────────────────────────────
+
+// Returns NULL if the source table or arena is full
+DataCacheSource* dataCacheRegister(const char* name, size_t size,
+                                   unsigned long ttlMs, unsigned long maxStaleMs,
+                                   bool (*refresh)(void*), void (*capture)(void*),
+                                   void* arg = NULL) {
+  size_t aligned = (size + 3) & ~(size_t)3;
+  if (dataCacheSourceCount >= DATA_CACHE_MAX_SOURCES ||
+      dataCacheArenaUsed + aligned > DATA_CACHE_ARENA_BYTES) {
+    Serial.printf("❌ Data cache full, %s not cached\n", name);
+    return NULL;
+  }
+
+  DataCacheSource* src = &dataCacheSources[dataCacheSourceCount++];
+  src->name = name;
+  src->size = size;
+  src->ttlMs = ttlMs;
+  src->maxStaleMs = maxStaleMs;
+  src->refresh = refresh;
+  src->capture = capture;
+  src->arg = arg;
+  src->snapshot = &dataCacheArena[dataCacheArenaUsed];
+  src->updatedAt = 0;
+  src->nextRefreshAt = 0;
+  src->job.name = name;
+  src->job.fn = refresh;
+  src->job.arg = arg;
+  src->job.state = FETCH_IDLE;
+  src->job.result = false;
+
+  dataCacheArenaUsed += aligned;
+  return src;
+}
+
+DataCacheSource* dataCacheFind(const char* name) {
+  for (int i = 0; i < dataCacheSourceCount; i++) {
+    if (strcmp(dataCacheSources[i].name, name) == 0) return &dataCacheSources[i];
+  }
+  return NULL;
+}
+
+// ─────────────────────────────────────────────────────────────────────
+// FRESHNESS + REVALIDATION
+// ─────────────────────────────────────────────────────────────────────
+
+CacheState dataCacheState(const DataCacheSource* src) {
+  if (src->updatedAt == 0) return CACHE_EMPTY;
+  unsigned long age = millis() - src->updatedAt;
+  if (age < src->ttlMs) return CACHE_FRESH;
+  if (age < src->maxStaleMs) return CACHE_STALE;
+  return CACHE_EXPIRED;
+}
+
+// Start a background refresh unless one is already in flight
+void dataCacheRevalidate(DataCacheSource* src) {
+  if (src->job.state != FETCH_IDLE) return;  // Running, or done and not harvested
+  if ((long)(millis() - src->nextRefreshAt) < 0) return;
+  startFetchJob(&src->job);
+}
+
+// Call from loop(): land finished refreshes into their snapshots.
+// Returns true if any snapshot changed (redraw the screen showing it)
+bool dataCacheTick() {
+  bool landed = false;
+  for (int i = 0; i < dataCacheSourceCount; i++) {
+    DataCacheSource* src = &dataCacheSources[i];
+    if (src->job.state != FETCH_DONE) continue;
+
+    if (src->job.result) {
+      src->capture(src->snapshot);
+      src->updatedAt = millis();
+      dataCacheStats.refreshes++;
+      landed = true;
+    } else {
+      dataCacheStats.refreshFailures++;  // Keep serving the old snapshot
+    }
+
+    // Unknown buckets pace at 0 - revalidate on the next stale read
+    unsigned long paceMs = rateLimitPollIntervalMs(src->name);
+    unsigned long waitMs = rateLimitWaitMs(src->name, PRIORITY_BACKGROUND);
+    src->nextRefreshAt = millis() + (waitMs > paceMs ? waitMs : paceMs);
+    src->job.state = FETCH_IDLE;
+  }
+  return landed;
+}
+
+// ─────────────────────────────────────────────────────────────────────
+// READS
+// ─────────────────────────────────────────────────────────────────────
+
+const void* dataCacheReadRaw(const char* name, size_t size, unsigned long* ageMs) {
+  DataCacheSource* src = dataCacheFind(name);
+  if (!src || src->size != size) return NULL;
+
+  CacheState state = dataCacheState(src);
+  switch (state) {
+    case CACHE_FRESH:
+      dataCacheStats.hits++;
+      break;
+    case CACHE_STALE:
+      dataCacheStats.stale++;
+      dataCacheRevalidate(src);
+      break;
+    default:
+      dataCacheStats.misses++;
+      dataCacheRevalidate(src);
+      break;
+  }
+
+  if (state == CACHE_EMPTY) return NULL;
+  if (ageMs) *ageMs = millis() - src->updatedAt;
+  return src->snapshot;
+}
+
+// Typed read - NULL if the source is unknown, empty, or T doesn't match
+template <typename T>
+const T* dataCacheRead(const char* name, unsigned long* ageMs = NULL) {
+  return (const T*)dataCacheReadRaw(name, sizeof(T), ageMs);
+}
+
+// "just now" / "42s ago" / "5m ago" / "3h ago"
+void formatCacheAge(unsigned long ageMs, char* out, size_t len) {
+  unsigned long s = ageMs / 1000;
+  if (s < 5) snprintf(out, len, "just now");
+  else if (s < 60) snprintf(out, len, "%lus ago", s);
+  else if (s < 3600) snprintf(out, len, "%lum ago", s / 60);
+  else snprintf(out, len, "%luh ago", s / 3600);
+}
+
+// ─────────────────────────────────────────────────────────────────────
+// METRICS
+// ─────────────────────────────────────────────────────────────────────
+
+uint8_t getDataCacheHitRate() {
+  uint32_t total = dataCacheStats.hits + dataCacheStats.stale + dataCacheStats.misses;
+  if (total == 0) return 0;
+  return (dataCacheStats.hits * 100) / total;
+}
+
+#endif // DATA_CACHE_H
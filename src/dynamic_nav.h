@@ -5,6 +5,11 @@
 #include <HTTPClient.h>
 #include <WiFiClient.h>
 #include "secrets.h"
+#include "fetch_engine.h"
+#include "json_stream.h"
+#include "rate_limiter.h"
+#include "lan_sweep.h"
+#include "rtt_sampler.h"
 
 // Forward declaration for sovereign_stack.h function
 void updateStackHealth();
@@ -103,6 +108,41 @@ CRMMetrics crmMetrics;
 AIMetrics aiMetrics;
 NavigationState navState;
 
+// ─────────────────────────────────────────────────────────────────────
+// FETCH RESULTS
+// ─────────────────────────────────────────────────────────────────────
+// Fetch jobs run on their own tasks and can land after the refresh
+// deadline, while loop() is drawing and patching the globals above. A job
+// only fills its own result; navFetchTick() (loop) copies it over.
+
+enum NavFetchOutcome {
+  NAV_FETCH_LIVE,        // Fresh data in the result
+  NAV_FETCH_UNCHANGED,   // 304 - what we show is still current
+  NAV_FETCH_SKIPPED,     // Rate limited - keep what we show
+  NAV_FETCH_FAILED       // Fall back to static data
+};
+
+struct NavMeshResult {
+  NavFetchOutcome outcome;
+  MeshNode nodes[4];
+  int count;
+};
+
+struct NavCRMResult {
+  NavFetchOutcome outcome;
+  CRMMetrics metrics;    // Counters only, topLead is not fetched
+  bool wasHealthy;       // navState.crmHealthy, copied by loop() before the job starts
+};
+
+struct NavAIResult {
+  NavFetchOutcome outcome;
+  AIMetrics metrics;
+};
+
+NavMeshResult navMeshResult;
+NavCRMResult navCRMResult;
+NavAIResult navAIResult;
+
 // ─────────────────────────────────────────────────────────────────────
 // STATIC DATA FALLBACKS (must be declared before fetch functions)
 // ─────────────────────────────────────────────────────────────────────
@@ -121,6 +161,10 @@ bool initStaticMeshData() {
 }
 
 bool initStaticCRMData() {
+  // Static data replaces both CRM views - a later 304 must not keep it
+  httpCacheForget(httpCacheHash(CRM_API_URL "/stats"));
+  httpCacheForget(httpCacheHash(CRM_API_URL "/views/hot-leads"));
+
   crmMetrics.totalContacts = 150;
   crmMetrics.hotLeads = 12;
   crmMetrics.openDeals = 8;
@@ -210,130 +254,246 @@ bool initStaticAIData() {
 // TAILSCALE MESH INTEGRATION
 // ─────────────────────────────────────────────────────────────────────
 
-bool fetchMeshStatus() {
-  HTTPClient http;
-  WiFiClient client;
+bool fetchMeshStatus(NavMeshResult* out) {
+  JsonHttpRequest req;
 
   Serial.println("\n🌐 Fetching Tailscale mesh status...");
 
   // Try local Tailscale API first
-  http.begin(client, MESH_STATUS_URL);
-  http.setTimeout(3000);
+  req.begin(MESH_STATUS_URL, 3000);
 
-  int httpCode = http.GET();
+  int httpCode = req.GET();
 
   if (httpCode == HTTP_CODE_OK) {
-    String payload = http.getString();
+    // Parse straight off the socket, keeping only the fields we display
+    StaticJsonDocument<192> filter;
+    JsonObject nodeFilter = filter["nodes"][0].to<JsonObject>();
+    nodeFilter["name"] = true;
+    nodeFilter["ip"] = true;
+    nodeFilter["hostname"] = true;
+    nodeFilter["online"] = true;
+    nodeFilter["latency"] = true;
+    nodeFilter["bandwidth"] = true;
+    nodeFilter["status"] = true;
 
-    // Parse JSON response
-    DynamicJsonDocument doc(4096);
-    DeserializationError error = deserializeJson(doc, payload);
+    DynamicJsonDocument doc(2048);
+    DeserializationError error = req.parse(doc, filter);
 
     if (!error) {
       JsonArray nodes = doc["nodes"];
-      meshNodeCount = 0;
+      out->count = 0;
 
       for (JsonObject node : nodes) {
-        if (meshNodeCount >= 4) break;
-
-        meshNodes[meshNodeCount].name = node["name"].as<String>();
-        meshNodes[meshNodeCount].ip = node["ip"].as<String>();
-        meshNodes[meshNodeCount].hostname = node["hostname"].as<String>();
-        meshNodes[meshNodeCount].online = node["online"].as<bool>();
-        meshNodes[meshNodeCount].latency = node["latency"].as<int>();
-        meshNodes[meshNodeCount].bandwidth = node["bandwidth"].as<float>();
-        meshNodes[meshNodeCount].status = node["status"].as<String>();
-        meshNodes[meshNodeCount].lastSeen = millis();
-
-        Serial.printf("  ✓ %s: %s (%dms)\n",
-          meshNodes[meshNodeCount].name.c_str(),
-          meshNodes[meshNodeCount].online ? "online" : "offline",
-          meshNodes[meshNodeCount].latency
-        );
-
-        meshNodeCount++;
+        if (out->count >= 4) break;
+
+        MeshNode& n = out->nodes[out->count];
+        n.name = node["name"].as<String>();
+        n.ip = node["ip"].as<String>();
+        n.hostname = node["hostname"].as<String>();
+        n.online = node["online"].as<bool>();
+        n.latency = node["latency"].as<int>();
+        n.bandwidth = node["bandwidth"].as<float>();
+        n.status = node["status"].as<String>();
+        n.lastSeen = millis();
+
+        Serial.printf("  ✓ %s: %s (%dms)\n", n.name.c_str(), n.online ? "online" : "offline", n.latency);
+
+        out->count++;
       }
 
-      navState.activeNodes = meshNodeCount;
-      navState.meshHealthy = true;
-      http.end();
+      out->outcome = NAV_FETCH_LIVE;
+      req.end();
       return true;
     }
   }
 
-  http.end();
+  req.end();
+  out->outcome = NAV_FETCH_FAILED;
+  return false;
+}
+
+void applyMeshResult() {
+  if (navMeshResult.outcome == NAV_FETCH_FAILED) {
+    Serial.println("  ⚠️  Using static mesh data");
+    initStaticMeshData();
+    return;
+  }
 
-  // Fallback: Use static mesh data
-  Serial.println("  ⚠️  Using static mesh data");
-  return initStaticMeshData();
+  for (int i = 0; i < navMeshResult.count; i++) meshNodes[i] = navMeshResult.nodes[i];
+  meshNodeCount = navMeshResult.count;
+  navState.activeNodes = meshNodeCount;
+  navState.meshHealthy = true;
+}
+
+// Fold the latest LAN sweep into meshNodes (call when lanSweepTick() lands).
+// A node is online if any of its services completed a handshake.
+void applyLanSweepToMesh() {
+  for (int i = 0; i < meshNodeCount; i++) {
+    MeshNode& node = meshNodes[i];
+    bool swept = false;
+    bool up = false;
+
+    for (int t = 0; t < lanTargetCount; t++) {
+      const LanTarget& target = lanTargets[t];
+      if (target.checkedAt == 0 || !node.name.equalsIgnoreCase(target.node)) continue;
+      swept = true;
+      if (lanTargetUp(&target)) up = true;
+    }
+    if (!swept) continue;
+
+    node.online = up;
+    if (up) {
+      node.lastSeen = millis();
+      if (node.status == "offline") node.status = "active";
+    } else {
+      node.status = "offline";
+    }
+  }
+
+  int active = 0;
+  for (int i = 0; i < meshNodeCount; i++) {
+    if (meshNodes[i].online) active++;
+  }
+  navState.activeNodes = active;
+}
+
+// Measured latency beats reported latency (call when rttSamplerTick() lands)
+void applyRttToMesh() {
+  for (int i = 0; i < meshNodeCount; i++) {
+    const RttPeer* peer = rttPeerFind(meshNodes[i].name.c_str());
+    if (!peer || !rttPeerHasSamples(peer)) continue;
+    meshNodes[i].latency = (int)(peer->srttMs + 0.5f);
+  }
 }
 
 // ─────────────────────────────────────────────────────────────────────
 // CRM API INTEGRATION
 // ─────────────────────────────────────────────────────────────────────
 
-bool fetchCRMMetrics() {
-  HTTPClient http;
-  WiFiClient client;
+bool fetchCRMMetrics(NavCRMResult* out, RequestPriority priority = PRIORITY_BACKGROUND) {
+  JsonHttpRequest req;
 
   Serial.println("\n💼 Fetching CRM metrics...");
 
-  http.begin(client, String(CRM_API_URL) + "/stats");
-  http.addHeader("Authorization", "Bearer " + String(CRM_SECRET));
-  http.setTimeout(5000);
+  if (!rateLimitAcquire("crm", priority)) {
+    // Keep whatever we're showing - it's only throttled, not broken
+    Serial.printf("  ⏱️  CRM rate limited (next in %lus)\n", rateLimitWaitMs("crm", priority) / 1000);
+    out->outcome = NAV_FETCH_SKIPPED;
+    return out->wasHealthy;
+  }
+
+  req.begin(CRM_API_URL "/stats", 5000, true);
+  req.http.addHeader("Authorization", "Bearer " + String(CRM_SECRET));
+
+  int httpCode = req.GET();
 
-  int httpCode = http.GET();
+  if (httpCode == HTTP_CODE_NOT_MODIFIED) {
+    Serial.println("  ✓ CRM metrics not modified");
+    out->outcome = NAV_FETCH_UNCHANGED;
+    req.end();
+    return true;
+  }
 
   if (httpCode == HTTP_CODE_OK) {
-    String payload = http.getString();
+    StaticJsonDocument<128> filter;
+    filter["total_contacts"] = true;
+    filter["hot_leads"] = true;
+    filter["open_deals"] = true;
+    filter["pipeline_value"] = true;
+    filter["activity_24h"] = true;
 
-    DynamicJsonDocument doc(2048);
-    DeserializationError error = deserializeJson(doc, payload);
+    StaticJsonDocument<256> doc;
+    DeserializationError error = req.parse(doc, filter);
 
     if (!error) {
-      crmMetrics.totalContacts = doc["total_contacts"] | 0;
-      crmMetrics.hotLeads = doc["hot_leads"] | 0;
-      crmMetrics.openDeals = doc["open_deals"] | 0;
-      crmMetrics.pipelineValue = doc["pipeline_value"] | 0.0;
-      crmMetrics.activity24h = doc["activity_24h"] | 0;
+      CRMMetrics& m = out->metrics;
+      m.totalContacts = doc["total_contacts"] | 0;
+      m.hotLeads = doc["hot_leads"] | 0;
+      m.openDeals = doc["open_deals"] | 0;
+      m.pipelineValue = doc["pipeline_value"] | 0.0;
+      m.activity24h = doc["activity_24h"] | 0;
 
       Serial.printf("  ✓ Contacts: %d | Hot Leads: %d | Pipeline: $%.0fK\n",
-        crmMetrics.totalContacts,
-        crmMetrics.hotLeads,
-        crmMetrics.pipelineValue / 1000.0
+        m.totalContacts,
+        m.hotLeads,
+        m.pipelineValue / 1000.0
       );
 
-      navState.hotLeads = crmMetrics.hotLeads;
-      navState.crmHealthy = true;
-      http.end();
+      out->outcome = NAV_FETCH_LIVE;
+      req.end();
       return true;
     }
   }
 
-  http.end();
+  req.end();
+  out->outcome = NAV_FETCH_FAILED;
+  return false;
+}
 
-  // Fallback: Use static CRM data
-  Serial.println("  ⚠️  Using static CRM data");
-  return initStaticCRMData();
+void applyCRMResult() {
+  switch (navCRMResult.outcome) {
+    case NAV_FETCH_FAILED:
+      Serial.println("  ⚠️  Using static CRM data");
+      initStaticCRMData();
+      return;
+    case NAV_FETCH_SKIPPED:
+      return;
+    case NAV_FETCH_UNCHANGED:
+      navState.crmHealthy = true;
+      return;
+    default:
+      break;
+  }
+
+  const CRMMetrics& m = navCRMResult.metrics;
+  crmMetrics.totalContacts = m.totalContacts;
+  crmMetrics.hotLeads = m.hotLeads;
+  crmMetrics.openDeals = m.openDeals;
+  crmMetrics.pipelineValue = m.pipelineValue;
+  crmMetrics.activity24h = m.activity24h;
+  navState.hotLeads = crmMetrics.hotLeads;
+  navState.crmHealthy = true;
 }
 
-bool fetchHotLeads() {
-  HTTPClient http;
-  WiFiClient client;
+bool fetchHotLeads(RequestPriority priority = PRIORITY_BACKGROUND) {
+  JsonHttpRequest req;
 
   Serial.println("\n🔥 Fetching hot leads from CRM...");
 
-  http.begin(client, String(CRM_API_URL) + "/views/hot-leads");
-  http.addHeader("Authorization", "Bearer " + String(CRM_SECRET));
-  http.setTimeout(5000);
+  if (!rateLimitAcquire("crm", priority)) {
+    Serial.printf("  ⏱️  CRM rate limited (next in %lus)\n", rateLimitWaitMs("crm", priority) / 1000);
+    return navState.crmHealthy;
+  }
+
+  req.begin(CRM_API_URL "/views/hot-leads", 5000, true);
+  req.http.addHeader("Authorization", "Bearer " + String(CRM_SECRET));
 
-  int httpCode = http.GET();
+  int httpCode = req.GET();
 
-  if (httpCode == HTTP_CODE_OK) {
-    String payload = http.getString();
+  if (httpCode == HTTP_CODE_NOT_MODIFIED) {
+    Serial.println("  ✓ Hot leads not modified");
+    navState.crmHealthy = true;
+    req.end();
+    return true;
+  }
 
-    DynamicJsonDocument doc(4096);
-    DeserializationError error = deserializeJson(doc, payload);
+  if (httpCode == HTTP_CODE_OK) {
+    StaticJsonDocument<320> filter;
+    JsonObject contactFilter = filter["contacts"][0].to<JsonObject>();
+    contactFilter["first_name"] = true;
+    contactFilter["last_name"] = true;
+    contactFilter["company"] = true;
+    contactFilter["email"] = true;
+    contactFilter["lead_score"] = true;
+    contactFilter["temperature"] = true;
+    contactFilter["email_opens"] = true;
+    contactFilter["email_clicks"] = true;
+    contactFilter["stage"] = true;
+    contactFilter["has_replied"] = true;
+    contactFilter["updated_at"] = true;
+
+    DynamicJsonDocument doc(3072);
+    DeserializationError error = req.parse(doc, filter);
 
     if (!error && doc.containsKey("contacts")) {
       JsonArray contacts = doc["contacts"];
@@ -380,12 +540,12 @@ bool fetchHotLeads() {
 
       Serial.printf("  ✓ Loaded %d hot leads from API\n", hotLeadCount);
       navState.crmHealthy = true;
-      http.end();
+      req.end();
       return true;
     }
   }
 
-  http.end();
+  req.end();
 
   // Fallback: Use static hot leads data
   Serial.println("  ⚠️  Using static hot leads data");
@@ -396,55 +556,108 @@ bool fetchHotLeads() {
 // HUGGINGFACE AI INTEGRATION
 // ─────────────────────────────────────────────────────────────────────
 
-bool fetchAIMetrics() {
-  HTTPClient http;
-  WiFiClient client;
+bool fetchAIMetrics(NavAIResult* out) {
+  JsonHttpRequest req;
 
   Serial.println("\n🤖 Fetching AI metrics...");
 
-  http.begin(client, String(HF_API_URL) + "/health");
-  http.setTimeout(3000);
+  req.begin(HF_API_URL "/health", 3000);
 
-  int httpCode = http.GET();
+  int httpCode = req.GET();
 
   if (httpCode == HTTP_CODE_OK) {
-    String payload = http.getString();
+    StaticJsonDocument<128> filter;
+    filter["model"] = true;
+    filter["status"] = true;
+    filter["requests_today"] = true;
+    filter["avg_latency"] = true;
+    filter["tokens_generated"] = true;
+    filter["gpu_util"] = true;
 
-    DynamicJsonDocument doc(1024);
-    DeserializationError error = deserializeJson(doc, payload);
+    StaticJsonDocument<384> doc;
+    DeserializationError error = req.parse(doc, filter);
 
     if (!error) {
-      aiMetrics.modelName = doc["model"].as<String>();
-      aiMetrics.status = doc["status"].as<String>();
-      aiMetrics.requestsToday = doc["requests_today"] | 0;
-      aiMetrics.avgLatency = doc["avg_latency"] | 0.0;
-      aiMetrics.tokensGenerated = doc["tokens_generated"] | 0;
-      aiMetrics.gpuUtil = doc["gpu_util"] | 0.0;
+      AIMetrics& m = out->metrics;
+      m.modelName = doc["model"].as<String>();
+      m.status = doc["status"].as<String>();
+      m.requestsToday = doc["requests_today"] | 0;
+      m.avgLatency = doc["avg_latency"] | 0.0;
+      m.tokensGenerated = doc["tokens_generated"] | 0;
+      m.gpuUtil = doc["gpu_util"] | 0.0;
 
       Serial.printf("  ✓ Model: %s | Status: %s | Requests: %d\n",
-        aiMetrics.modelName.c_str(),
-        aiMetrics.status.c_str(),
-        aiMetrics.requestsToday
+        m.modelName.c_str(),
+        m.status.c_str(),
+        m.requestsToday
       );
 
-      navState.aiRequests = aiMetrics.requestsToday;
-      navState.aiHealthy = true;
-      http.end();
+      out->outcome = NAV_FETCH_LIVE;
+      req.end();
       return true;
     }
   }
 
-  http.end();
+  req.end();
+  out->outcome = NAV_FETCH_FAILED;
+  return false;
+}
+
+void applyAIResult() {
+  if (navAIResult.outcome == NAV_FETCH_FAILED) {
+    Serial.println("  ⚠️  Using static AI data");
+    initStaticAIData();
+    return;
+  }
 
-  // Fallback: Use static AI data
-  Serial.println("  ⚠️  Using static AI data");
-  return initStaticAIData();
+  const AIMetrics& m = navAIResult.metrics;
+  aiMetrics.modelName = m.modelName;
+  aiMetrics.status = m.status;
+  aiMetrics.requestsToday = m.requestsToday;
+  aiMetrics.avgLatency = m.avgLatency;
+  aiMetrics.tokensGenerated = m.tokensGenerated;
+  aiMetrics.gpuUtil = m.gpuUtil;
+  navState.aiRequests = aiMetrics.requestsToday;
+  navState.aiHealthy = true;
 }
 
 // ─────────────────────────────────────────────────────────────────────
 // MASTER UPDATE FUNCTION
 // ─────────────────────────────────────────────────────────────────────
 
+#define NAV_REFRESH_DEADLINE_MS 6000  // Per-refresh budget for all sources
+
+bool fetchMeshStatusJob(void* arg) { return fetchMeshStatus((NavMeshResult*)arg); }
+bool fetchCRMMetricsJob(void* arg) { return fetchCRMMetrics((NavCRMResult*)arg); }
+bool fetchAIMetricsJob(void* arg) { return fetchAIMetrics((NavAIResult*)arg); }
+
+FetchJob navFetchJobs[] = {
+  {"Mesh", fetchMeshStatusJob, &navMeshResult, FETCH_IDLE, false, 0, 0},
+  {"CRM", fetchCRMMetricsJob, &navCRMResult, FETCH_IDLE, false, 0, 0},
+  {"AI", fetchAIMetricsJob, &navAIResult, FETCH_IDLE, false, 0, 0},
+};
+void (*const navFetchApply[])() = {applyMeshResult, applyCRMResult, applyAIResult};
+#define NAV_FETCH_JOB_COUNT 3
+
+const char* getNavSourceLabel(const FetchJob* job) {
+  if (job->state == FETCH_RUNNING) return "⏳ PENDING";
+  return job->result ? "✅ LIVE" : "⚠️  STATIC";
+}
+
+// Call from loop(): copy finished fetch results into the globals, on
+// this task, then free the job for the next refresh. Returns true if
+// anything landed.
+bool navFetchTick() {
+  bool landed = false;
+  for (int i = 0; i < NAV_FETCH_JOB_COUNT; i++) {
+    if (navFetchJobs[i].state != FETCH_DONE) continue;
+    navFetchApply[i]();
+    navFetchJobs[i].state = FETCH_IDLE;
+    landed = true;
+  }
+  return landed;
+}
+
 void updateDynamicNavigation() {
   Serial.println("\n━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━");
   Serial.println("🔄 UPDATING DYNAMIC NAVIGATION");
@@ -452,10 +665,14 @@ void updateDynamicNavigation() {
 
   unsigned long startTime = millis();
 
-  // Fetch all data sources in parallel (sequentially for now)
-  bool meshOk = fetchMeshStatus();
-  bool crmOk = fetchCRMMetrics();
-  bool aiOk = fetchAIMetrics();
+  // Fetch all data sources in parallel - sources that miss the deadline
+  // keep running, and navFetchTick() lands them later from loop()
+  navFetchTick();
+  if (navFetchJobs[1].state != FETCH_RUNNING) {
+    navCRMResult.wasHealthy = navState.crmHealthy;  // Jobs never read navState
+  }
+  int finished = runFetchJobs(navFetchJobs, NAV_FETCH_JOB_COUNT, NAV_REFRESH_DEADLINE_MS);
+  navFetchTick();
 
   // Update sovereign stack health based on navigation state
   updateStackHealth();
@@ -464,13 +681,17 @@ void updateDynamicNavigation() {
 
   unsigned long elapsed = millis() - startTime;
 
+  FetchJob* meshJob = &navFetchJobs[0];
+  FetchJob* crmJob = &navFetchJobs[1];
+  FetchJob* aiJob = &navFetchJobs[2];
+
   Serial.println("\n━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━");
   Serial.println("📊 NAVIGATION STATE SUMMARY");
   Serial.println("━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━");
-  Serial.printf("Mesh:   %s (%d nodes)\n", meshOk ? "✅ LIVE" : "⚠️  STATIC", navState.activeNodes);
-  Serial.printf("CRM:    %s (%d hot leads)\n", crmOk ? "✅ LIVE" : "⚠️  STATIC", navState.hotLeads);
-  Serial.printf("AI:     %s (%d requests)\n", aiOk ? "✅ LIVE" : "⚠️  STATIC", navState.aiRequests);
-  Serial.printf("Update: %lu ms\n", elapsed);
+  Serial.printf("Mesh:   %s (%d nodes, %lu ms)\n", getNavSourceLabel(meshJob), navState.activeNodes, getFetchJobDuration(meshJob));
+  Serial.printf("CRM:    %s (%d hot leads, %lu ms)\n", getNavSourceLabel(crmJob), navState.hotLeads, getFetchJobDuration(crmJob));
+  Serial.printf("AI:     %s (%d requests, %lu ms)\n", getNavSourceLabel(aiJob), navState.aiRequests, getFetchJobDuration(aiJob));
+  Serial.printf("Update: %lu ms (%d/%d sources in time)\n", elapsed, finished, NAV_FETCH_JOB_COUNT);
   Serial.println("━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━\n");
 }
 
@@ -0,0 +1,295 @@
+#ifndef ENDPOINT_GUARD_H
+#define ENDPOINT_GUARD_H
+
+#include <Arduino.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+
+/*
+ * ═══════════════════════════════════════════════════════════════════════
+ * BLACKROAD ENDPOINT GUARD - ADAPTIVE TIMEOUTS + CIRCUIT BREAKERS
+ * ═══════════════════════════════════════════════════════════════════════
+ *
+ * Per host:port latency tracking and failure isolation:
+ * - Timeout = 2x observed p99 RTT (+ slack), never above the call
+ *   site's own timeout, so a healthy LAN service gets ~300ms not 5s
+ * - After EP_BREAKER_THRESHOLD consecutive transport failures the
+ *   breaker opens and requests fail instantly
+ * - An open breaker lets one probe through after a backoff that
+ *   doubles on every failed probe (5s -> 10s -> ... -> 5min)
+ * - One successful probe closes the breaker again
+ *
+ * Only transport failures (connect refused, timeout) count - a 404 or
+ * 500 still proves the host is alive.
+ *
+ * A request that runs into its adaptive timeout is sampled at that
+ * timeout, so the next one gets roughly twice as long - after a latency
+ * shift the timeout widens instead of failing every call. Half-open
+ * probes always run with the call site's full timeout.
+ *
+ * Each endpoint also counts body bytes on the wire vs after inflate, to
+ * show the airtime saved by compressed responses (inflate_stream.h).
+ */
+
+// ─────────────────────────────────────────────────────────────────────
+// GUARD CONFIGURATION
+// ─────────────────────────────────────────────────────────────────────
+
+#define EP_GUARD_SIZE 16                // host:port pairs tracked
+#define EP_RTT_WINDOW 32                // Recent RTT samples per endpoint
+#define EP_RTT_MIN_SAMPLES 8            // Use call-site timeout until then
+#define EP_TIMEOUT_MIN_MS 300
+#define EP_TIMEOUT_SLACK_MS 200
+#define EP_BREAKER_THRESHOLD 3          // Consecutive failures to trip
+#define EP_BACKOFF_BASE_MS 5000
+#define EP_BACKOFF_MAX_MS 300000
+#define EP_PROBE_LOST_MS 30000          // Half-open probe never reported
+
+#define HTTPC_ERROR_CIRCUIT_OPEN (-20)  // Request skipped, breaker open
+
+// ─────────────────────────────────────────────────────────────────────
+// DATA STRUCTURES
+// ─────────────────────────────────────────────────────────────────────
+
+enum BreakerState {
+  BREAKER_CLOSED,      // Normal operation
+  BREAKER_OPEN,        // Failing fast until retryAt
+  BREAKER_HALF_OPEN    // One probe in flight
+};
+
+struct EndpointGuard {
+  char host[64];
+  uint16_t port;
+  bool used;
+
+  // Latency
+  uint16_t rtt[EP_RTT_WINDOW];
+  uint8_t rttCount;
+  uint8_t rttNext;
+
+  // Breaker
+  BreakerState state;
+  uint8_t failures;          // Consecutive transport failures
+  uint32_t backoffMs;
+  unsigned long retryAt;
+  unsigned long lastUsed;
+
+  // Stats
+  uint32_t trips;
+  uint32_t shortCircuits;
+  uint32_t wireBytes;        // Response bodies as received
+  uint32_t bodyBytes;        // Response bodies after inflate
+  uint16_t compressed;       // Responses that arrived compressed
+};
+
+EndpointGuard endpointGuards[EP_GUARD_SIZE];
+SemaphoreHandle_t endpointGuardMutex = NULL;
+
+// ─────────────────────────────────────────────────────────────────────
+// INTERNAL HELPERS
+// ─────────────────────────────────────────────────────────────────────
+
+void endpointGuardLock() {
+  if (endpointGuardMutex == NULL) {
+    endpointGuardMutex = xSemaphoreCreateMutex();
+  }
+  xSemaphoreTake(endpointGuardMutex, portMAX_DELAY);
+}
+
+void endpointGuardUnlock() {
+  xSemaphoreGive(endpointGuardMutex);
+}
+
+// p-th percentile of the RTT window. Caller holds the lock.
+uint16_t endpointPercentile(const EndpointGuard* guard, uint8_t pct) {
+  if (guard->rttCount == 0) return 0;
+
+  uint16_t sorted[EP_RTT_WINDOW];
+  uint8_t n = guard->rttCount;
+  memcpy(sorted, guard->rtt, n * sizeof(uint16_t));
+
+  // Insertion sort - 32 samples at most
+  for (uint8_t i = 1; i < n; i++) {
+    uint16_t v = sorted[i];
+    int j = i - 1;
+    while (j >= 0 && sorted[j] > v) {
+      sorted[j + 1] = sorted[j];
+      j--;
+    }
+    sorted[j + 1] = v;
+  }
+
+  uint8_t idx = (uint8_t)(((uint16_t)pct * (n - 1) + 99) / 100);
+  return sorted[idx];
+}
+
+// ─────────────────────────────────────────────────────────────────────
+// PUBLIC API
+// ─────────────────────────────────────────────────────────────────────
+
+// Find or create the guard for host:port (evicts the least recently
+// used closed breaker when the table is full)
+EndpointGuard* endpointGuardFor(const char* host, uint16_t port) {
+  endpointGuardLock();
+
+  EndpointGuard* empty = NULL;
+  EndpointGuard* oldest = NULL;
+  for (int i = 0; i < EP_GUARD_SIZE; i++) {
+    EndpointGuard* g = &endpointGuards[i];
+    if (!g->used) {
+      if (!empty) empty = g;
+      continue;
+    }
+    if (g->port == port && strcmp(g->host, host) == 0) {
+      g->lastUsed = millis();
+      endpointGuardUnlock();
+      return g;
+    }
+    if (g->state == BREAKER_CLOSED && (!oldest || g->lastUsed < oldest->lastUsed)) oldest = g;
+  }
+
+  EndpointGuard* g = empty ? empty : oldest;
+  if (g) {
+    memset(g, 0, sizeof(EndpointGuard));
+    strncpy(g->host, host, sizeof(g->host) - 1);
+    g->port = port;
+    g->used = true;
+    g->state = BREAKER_CLOSED;
+    g->lastUsed = millis();
+  }
+
+  endpointGuardUnlock();
+  return g;  // NULL only if every slot holds an open breaker
+}
+
+// Should a request go out? False = fail fast (breaker open)
+bool endpointAllow(EndpointGuard* guard) {
+  if (!guard) return true;
+
+  endpointGuardLock();
+  bool allow = true;
+  unsigned long now = millis();
+  if (guard->state == BREAKER_OPEN) {
+    if ((long)(now - guard->retryAt) >= 0) {
+      guard->state = BREAKER_HALF_OPEN;  // This request is the probe
+      guard->retryAt = now;
+    } else {
+      allow = false;
+    }
+  } else if (guard->state == BREAKER_HALF_OPEN) {
+    // One probe at a time, unless the last one never reported back
+    if (now - guard->retryAt > EP_PROBE_LOST_MS) {
+      guard->retryAt = now;
+    } else {
+      allow = false;
+    }
+  }
+  if (!allow) guard->shortCircuits++;
+  endpointGuardUnlock();
+
+  return allow;
+}
+
+// Timeout for the next request, derived from p99 RTT. A half-open probe
+// gets the caller's ceiling - the old p99 is what it's testing.
+uint16_t endpointTimeout(EndpointGuard* guard, uint16_t callerMs) {
+  if (!guard) return callerMs;
+
+  endpointGuardLock();
+  uint32_t timeout = callerMs;
+  if (guard->state == BREAKER_CLOSED && guard->rttCount >= EP_RTT_MIN_SAMPLES) {
+    timeout = (uint32_t)endpointPercentile(guard, 99) * 2 + EP_TIMEOUT_SLACK_MS;
+    if (timeout < EP_TIMEOUT_MIN_MS) timeout = EP_TIMEOUT_MIN_MS;
+    if (timeout > callerMs) timeout = callerMs;
+  }
+  endpointGuardUnlock();
+
+  return (uint16_t)timeout;
+}
+
+// Append an RTT sample. Caller holds the lock.
+void endpointSample(EndpointGuard* guard, uint32_t rttMs) {
+  guard->rtt[guard->rttNext] = rttMs > 0xFFFF ? 0xFFFF : rttMs;
+  guard->rttNext = (guard->rttNext + 1) % EP_RTT_WINDOW;
+  if (guard->rttCount < EP_RTT_WINDOW) guard->rttCount++;
+}
+
+// Record the outcome of a request that was allowed through.
+// timedOut = the request hit its timeout; rttMs is then sampled as a
+// lower bound so the adaptive timeout grows instead of staying too short
+void endpointRecord(EndpointGuard* guard, bool reachable, uint32_t rttMs, bool timedOut = false) {
+  if (!guard) return;
+
+  endpointGuardLock();
+  if (reachable) {
+    endpointSample(guard, rttMs);
+
+    if (guard->state != BREAKER_CLOSED) {
+      Serial.printf("🔌 Breaker closed: %s:%d\n", guard->host, guard->port);
+    }
+    guard->state = BREAKER_CLOSED;
+    guard->failures = 0;
+    guard->backoffMs = 0;
+  } else {
+    if (timedOut) endpointSample(guard, rttMs);
+    if (guard->failures < 255) guard->failures++;
+
+    if (guard->state == BREAKER_HALF_OPEN) {
+      // Probe failed - back off further
+      guard->backoffMs = guard->backoffMs * 2;
+      if (guard->backoffMs > EP_BACKOFF_MAX_MS) guard->backoffMs = EP_BACKOFF_MAX_MS;
+      guard->state = BREAKER_OPEN;
+      guard->retryAt = millis() + guard->backoffMs;
+    } else if (guard->state == BREAKER_CLOSED && guard->failures >= EP_BREAKER_THRESHOLD) {
+      guard->backoffMs = EP_BACKOFF_BASE_MS;
+      guard->state = BREAKER_OPEN;
+      guard->retryAt = millis() + guard->backoffMs;
+      guard->trips++;
+      Serial.printf("🔌 Breaker open: %s:%d (%d failures)\n", guard->host, guard->port, guard->failures);
+    }
+  }
+  endpointGuardUnlock();
+}
+
+// Body size of a finished response, before and after inflate
+void endpointRecordBody(EndpointGuard* guard, uint32_t wireBytes, uint32_t bodyBytes, bool compressed) {
+  if (!guard) return;
+
+  endpointGuardLock();
+  guard->wireBytes += wireBytes;
+  guard->bodyBytes += bodyBytes;
+  if (compressed) guard->compressed++;
+  endpointGuardUnlock();
+}
+
+// ─────────────────────────────────────────────────────────────────────
+// METRICS
+// ─────────────────────────────────────────────────────────────────────
+
+int getOpenBreakerCount() {
+  int open = 0;
+  for (int i = 0; i < EP_GUARD_SIZE; i++) {
+    if (endpointGuards[i].used && endpointGuards[i].state != BREAKER_CLOSED) open++;
+  }
+  return open;
+}
+
+uint32_t getShortCircuitCount() {
+  uint32_t total = 0;
+  for (int i = 0; i < EP_GUARD_SIZE; i++) {
+    total += endpointGuards[i].shortCircuits;
+  }
+  return total;
+}
+
+// Body bytes compression kept off the air, all endpoints
+uint32_t getCompressionSavedBytes() {
+  uint32_t saved = 0;
+  for (int i = 0; i < EP_GUARD_SIZE; i++) {
+    const EndpointGuard* g = &endpointGuards[i];
+    if (g->used && g->bodyBytes > g->wireBytes) saved += g->bodyBytes - g->wireBytes;
+  }
+  return saved;
+}
+
+#endif // ENDPOINT_GUARD_H
@@ -0,0 +1,137 @@
+#ifndef FETCH_ENGINE_H
+#define FETCH_ENGINE_H
+
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <freertos/semphr.h>
+
+/*
+ * ═══════════════════════════════════════════════════════════════════════
+ * BLACKROAD PARALLEL FETCH ENGINE
+ * ═══════════════════════════════════════════════════════════════════════
+ *
+ * Runs independent data-source fetchers concurrently on FreeRTOS tasks:
+ * - One short-lived task per job, all started at once
+ * - Caller waits until every job finishes OR the deadline expires
+ * - Jobs that miss the deadline keep running and land late (partial results)
+ * - A job still in flight is never started twice
+ * - A job writes only through its arg. The caller copies that into shared
+ *   state once the job is FETCH_DONE, from its own task, and sets it back
+ *   to FETCH_IDLE - a late job never races loop() on live globals
+ *
+ * Refresh latency becomes the slowest source, not the sum of all sources.
+ */
+
+// ─────────────────────────────────────────────────────────────────────
+// ENGINE CONFIGURATION
+// ─────────────────────────────────────────────────────────────────────
+
+#define FETCH_TASK_STACK 10240       // HTTP + TLS handshake + JSON parse
+#define FETCH_TASK_PRIORITY 1        // Same as loop() task
+
+// ─────────────────────────────────────────────────────────────────────
+// DATA STRUCTURES
+// ─────────────────────────────────────────────────────────────────────
+
+enum FetchJobState {
+  FETCH_IDLE,      // Never started
+  FETCH_RUNNING,   // Task in flight
+  FETCH_DONE       // Finished, result valid
+};
+
+struct FetchJob {
+  const char* name;            // "Mesh", "CRM", "AI"
+  bool (*fn)(void* arg);       // Fetcher, returns true on live data
+  void* arg;
+  volatile FetchJobState state;
+  volatile bool result;
+  unsigned long startedAt;
+  volatile unsigned long finishedAt;
+};
+
+SemaphoreHandle_t fetchDoneSignal = NULL;
+
+// ─────────────────────────────────────────────────────────────────────
+// JOB LIFECYCLE
+// ─────────────────────────────────────────────────────────────────────
+
+void fetchJobTask(void* param) {
+  FetchJob* job = (FetchJob*)param;
+
+  bool ok = job->fn(job->arg);
+
+  job->result = ok;
+  job->finishedAt = millis();
+  job->state = FETCH_DONE;
+  xSemaphoreGive(fetchDoneSignal);
+
+  vTaskDelete(NULL);
+}
+
+// Start a job on its own task. Returns false if it is still in flight.
+bool startFetchJob(FetchJob* job) {
+  if (fetchDoneSignal == NULL) {
+    fetchDoneSignal = xSemaphoreCreateCounting(16, 0);
+  }
+
+  if (job->state == FETCH_RUNNING) {
+    return false;  // Previous run missed its deadline and hasn't landed yet
+  }
+
+  job->state = FETCH_RUNNING;
+  job->result = false;
+  job->startedAt = millis();
+  job->finishedAt = 0;
+
+  if (xTaskCreate(fetchJobTask, job->name, FETCH_TASK_STACK, job,
+                  FETCH_TASK_PRIORITY, NULL) != pdPASS) {
+    // Not enough heap for another task - run inline instead
+    Serial.printf("  ⚠️  No task for %s, fetching inline\n", job->name);
+    job->result = job->fn(job->arg);
+    job->finishedAt = millis();
+    job->state = FETCH_DONE;
+  }
+
+  return true;
+}
+
+bool isFetchJobDone(const FetchJob* job) {
+  return job->state == FETCH_DONE;
+}
+
+unsigned long getFetchJobDuration(const FetchJob* job) {
+  if (job->state == FETCH_RUNNING) return millis() - job->startedAt;
+  return job->finishedAt - job->startedAt;
+}
+
+// ─────────────────────────────────────────────────────────────────────
+// PARALLEL RUN WITH DEADLINE
+// ─────────────────────────────────────────────────────────────────────
+
+// Start every job, then wait until all are done or deadlineMs elapses.
+// Returns the number of jobs that finished in time.
+int runFetchJobs(FetchJob* jobs, int count, unsigned long deadlineMs) {
+  unsigned long start = millis();
+
+  for (int i = 0; i < count; i++) {
+    if (!startFetchJob(&jobs[i])) {
+      Serial.printf("  ⏳ %s still in flight, skipping this round\n", jobs[i].name);
+    }
+  }
+
+  while (true) {
+    int done = 0;
+    for (int i = 0; i < count; i++) {
+      if (jobs[i].state == FETCH_DONE) done++;
+    }
+    if (done == count) return done;
+
+    unsigned long elapsed = millis() - start;
+    if (elapsed >= deadlineMs) return done;
+
+    // Sleep until any job signals completion (or the deadline)
+    xSemaphoreTake(fetchDoneSignal, pdMS_TO_TICKS(deadlineMs - elapsed));
+  }
+}
+
+#endif // FETCH_ENGINE_H
@@ -4,6 +4,7 @@
 #include <SPIFFS.h>
 #include <FS.h>
 #include <HTTPClient.h>
+#include <JsonWriter.h>
 
 /*
  * BlackRoad OS - Operator Device File System
@@ -223,33 +224,39 @@ bool syncProjectFiles() {
 }
 
 // Export file system contents as JSON
-String exportFileSystemJSON() {
-  String json = "{\"files\":[";
+// Stream the file list + stats as JSON to any Print (Serial, WiFiClient,
+// File) through a small stack buffer - no heap, any number of files.
+// Returns the document size in bytes.
+size_t exportFileSystemJSON(Print& out) {
+  char scratch[128];
+  JsonWriter w(out, scratch, sizeof(scratch));
+
+  w.beginObject();
+  w.arrayField("files");
 
   File root = SPIFFS.open("/");
   File file = root.openNextFile();
-  bool first = true;
 
   while (file) {
     if (!file.isDirectory()) {
-      if (!first) json += ",";
-      json += "{";
-      json += "\"name\":\"" + String(file.name()) + "\",";
-      json += "\"size\":" + String(file.size());
-      json += "}";
-      first = false;
+      w.beginObject();
+      w.field("name", file.name());
+      w.field("size", (unsigned long)file.size());
+      w.endObject();
     }
     file = root.openNextFile();
   }
 
-  json += "],";
-  json += "\"stats\":{";
-  json += "\"total\":" + String(fsStats.totalBytes) + ",";
-  json += "\"used\":" + String(fsStats.usedBytes) + ",";
-  json += "\"free\":" + String(fsStats.freeBytes);
-  json += "}}";
+  w.endArray();
+  w.objectField("stats");
+  w.field("total", (unsigned long)fsStats.totalBytes);
+  w.field("used", (unsigned long)fsStats.usedBytes);
+  w.field("free", (unsigned long)fsStats.freeBytes);
+  w.endObject();
+  w.endObject();
+  w.flush();
 
-  return json;
+  return w.bytesWritten();
 }
 
 #endif // FILESYSTEM_H
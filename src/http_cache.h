@@ -0,0 +1,184 @@
+#ifndef HTTP_CACHE_H
+#define HTTP_CACHE_H
+
+#include <HTTPClient.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+
+/*
+ * ═══════════════════════════════════════════════════════════════════════
+ * BLACKROAD CONDITIONAL REQUEST CACHE
+ * ═══════════════════════════════════════════════════════════════════════
+ *
+ * Remembers ETag / Last-Modified per polled URL so unchanged data
+ * isn't downloaded again:
+ * - Sends If-None-Match / If-Modified-Since on the next poll
+ * - 304 Not Modified means "keep current state" - nothing is parsed
+ * - Only metadata is stored (no bodies), keyed by URL hash so API keys
+ *   in query strings never sit in RAM twice
+ * - GitHub doesn't count 304s against the hourly rate limit
+ *
+ * Entries are committed only after a 200 body parsed cleanly, and
+ * dropped when a fetch fails, so a 304 never pins static fallback data.
+ */
+
+// ─────────────────────────────────────────────────────────────────────
+// CACHE CONFIGURATION
+// ─────────────────────────────────────────────────────────────────────
+
+#define HTTP_CACHE_SIZE 12              // Polled URLs tracked
+#define HTTP_CACHE_ETAG_LEN 72          // GitHub weak ETags are ~68 chars
+#define HTTP_CACHE_DATE_LEN 32          // "Wed, 21 Oct 2015 07:28:00 GMT"
+
+// ─────────────────────────────────────────────────────────────────────
+// DATA STRUCTURES
+// ─────────────────────────────────────────────────────────────────────
+
+struct HttpCacheEntry {
+  uint32_t urlHash;          // 0 = empty
+  char etag[HTTP_CACHE_ETAG_LEN];
+  char lastModified[HTTP_CACHE_DATE_LEN];
+  unsigned long storedAt;
+  unsigned long lastUsed;
+  uint32_t bodySize;         // Size of the 200 body, for bytes-saved stats
+};
+
+struct HttpCacheStats {
+  uint32_t conditionalSent;  // Requests that carried a validator
+  uint32_t notModified;      // 304s (body skipped)
+  uint32_t refreshed;        // 200s stored with a new validator
+  uint32_t bytesSaved;       // Body bytes not downloaded thanks to 304s
+};
+
+HttpCacheEntry httpCache[HTTP_CACHE_SIZE];
+HttpCacheStats httpCacheStats = {0, 0, 0, 0};
+SemaphoreHandle_t httpCacheMutex = NULL;
+
+// ─────────────────────────────────────────────────────────────────────
+// INTERNAL HELPERS
+// ─────────────────────────────────────────────────────────────────────
+
+void httpCacheLock() {
+  if (httpCacheMutex == NULL) {
+    httpCacheMutex = xSemaphoreCreateMutex();
+  }
+  xSemaphoreTake(httpCacheMutex, portMAX_DELAY);
+}
+
+void httpCacheUnlock() {
+  xSemaphoreGive(httpCacheMutex);
+}
+
+// FNV-1a, never returns 0 (0 marks an empty entry)
+uint32_t httpCacheHash(const char* url) {
+  uint32_t hash = 2166136261UL;
+  while (*url) {
+    hash ^= (uint8_t)*url++;
+    hash *= 16777619UL;
+  }
+  return hash ? hash : 1;
+}
+
+// Caller holds the lock
+int httpCacheIndex(uint32_t urlHash) {
+  for (int i = 0; i < HTTP_CACHE_SIZE; i++) {
+    if (httpCache[i].urlHash == urlHash) return i;
+  }
+  return -1;
+}
+
+// ─────────────────────────────────────────────────────────────────────
+// PUBLIC API
+// ─────────────────────────────────────────────────────────────────────
+
+// Add If-None-Match / If-Modified-Since for a URL we've seen before.
+// Call after http.begin(). Returns true if a validator was sent.
+bool httpCacheApply(HTTPClient& http, uint32_t urlHash) {
+  char etag[HTTP_CACHE_ETAG_LEN] = "";
+  char lastModified[HTTP_CACHE_DATE_LEN] = "";
+
+  httpCacheLock();
+  int i = httpCacheIndex(urlHash);
+  if (i >= 0) {
+    strcpy(etag, httpCache[i].etag);
+    strcpy(lastModified, httpCache[i].lastModified);
+    httpCache[i].lastUsed = millis();
+  }
+  httpCacheUnlock();
+
+  if (etag[0]) http.addHeader("If-None-Match", etag);
+  if (lastModified[0]) http.addHeader("If-Modified-Since", lastModified);
+
+  bool sent = etag[0] || lastModified[0];
+  if (sent) httpCacheStats.conditionalSent++;
+  return sent;
+}
+
+// Remember the validators of a 200 response that was applied to state
+void httpCacheStore(uint32_t urlHash, const String& etag, const String& lastModified, int bodySize) {
+  if (etag.length() == 0 && lastModified.length() == 0) return;
+  if (etag.length() >= HTTP_CACHE_ETAG_LEN || lastModified.length() >= HTTP_CACHE_DATE_LEN) return;
+
+  httpCacheLock();
+  int i = httpCacheIndex(urlHash);
+  if (i < 0) {
+    // Take an empty entry, else the least recently used one
+    i = 0;
+    for (int j = 0; j < HTTP_CACHE_SIZE; j++) {
+      if (httpCache[j].urlHash == 0) { i = j; break; }
+      if (httpCache[j].lastUsed < httpCache[i].lastUsed) i = j;
+    }
+  }
+
+  HttpCacheEntry* entry = &httpCache[i];
+  entry->urlHash = urlHash;
+  strcpy(entry->etag, etag.c_str());
+  strcpy(entry->lastModified, lastModified.c_str());
+  entry->storedAt = millis();
+  entry->lastUsed = entry->storedAt;
+  entry->bodySize = bodySize > 0 ? bodySize : 0;
+  httpCacheStats.refreshed++;
+  httpCacheUnlock();
+}
+
+// Count a 304 against the entry it validated
+void httpCacheNoteNotModified(uint32_t urlHash) {
+  httpCacheLock();
+  int i = httpCacheIndex(urlHash);
+  if (i >= 0) {
+    httpCache[i].lastUsed = millis();
+    httpCacheStats.bytesSaved += httpCache[i].bodySize;
+  }
+  httpCacheStats.notModified++;
+  httpCacheUnlock();
+}
+
+// Drop a URL's validators (fetch failed / state replaced by fallback)
+void httpCacheForget(uint32_t urlHash) {
+  httpCacheLock();
+  int i = httpCacheIndex(urlHash);
+  if (i >= 0) {
+    httpCache[i].urlHash = 0;
+    httpCache[i].etag[0] = '\0';
+    httpCache[i].lastModified[0] = '\0';
+  }
+  httpCacheUnlock();
+}
+
+void httpCacheClear() {
+  httpCacheLock();
+  memset(httpCache, 0, sizeof(httpCache));
+  httpCacheUnlock();
+}
+
+// ─────────────────────────────────────────────────────────────────────
+// METRICS
+// ─────────────────────────────────────────────────────────────────────
+
+// Share of conditional requests answered with 304
+uint8_t getHttpCacheHitRate() {
+  if (httpCacheStats.conditionalSent == 0) return 0;
+  return (httpCacheStats.notModified * 100) / httpCacheStats.conditionalSent;
+}
+
+#endif // HTTP_CACHE_H
@@ -0,0 +1,333 @@
+#ifndef HTTP_POOL_H
+#define HTTP_POOL_H
+
+#include <HTTPClient.h>
+#include <WiFiClient.h>
+#include <WiFiClientSecure.h>
+#include "tls_session_cache.h"
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+
+/*
+ * ═══════════════════════════════════════════════════════════════════════
+ * BLACKROAD HTTP CONNECTION POOL
+ * ═══════════════════════════════════════════════════════════════════════
+ *
+ * Keep-alive sockets shared across requests, keyed by host:port:
+ * - Octavia alone serves 5 health checks per cycle on 192.168.4.38
+ * - Idle sockets are evicted after HTTP_POOL_IDLE_MS
+ * - TLS slots are capped separately (~40KB heap each on ESP32)
+ * - TLS reconnects resume cached sessions (tls_session_cache.h)
+ * - Every slot busy: the request gets a temporary socket of the same
+ *   kind, closed and freed by httpPoolEnd()
+ * - Safe to use from fetch engine tasks (mutex protected, stats too)
+ *
+ * Usage:
+ *   HTTPClient http;
+ *   HttpPoolSlot* slot;
+ *   httpPoolBegin(http, url, &slot);
+ *   int code = http.GET();
+ *   ...
+ *   httpPoolEnd(http, slot);
+ */
+
+// ─────────────────────────────────────────────────────────────────────
+// POOL CONFIGURATION
+// ─────────────────────────────────────────────────────────────────────
+
+#define HTTP_POOL_SIZE 8                  // Total sockets kept open
+#define HTTP_POOL_MAX_SECURE 2            // TLS sockets (heap heavy)
+#define HTTP_POOL_IDLE_MS 20000           // Close sockets idle this long
+#define HTTP_POOL_CONNECT_TIMEOUT_MS 3000
+
+// ─────────────────────────────────────────────────────────────────────
+// DATA STRUCTURES
+// ─────────────────────────────────────────────────────────────────────
+
+struct HttpPoolSlot {
+  char host[64];
+  uint16_t port;
+  bool secure;
+  bool inUse;
+  WiFiClient* client;        // WiFiClient or ResumableClientSecure
+  unsigned long lastUsed;
+  uint32_t requests;         // Requests served on this socket
+  bool temporary;            // Overflow socket outside httpPool[] - freed by httpPoolEnd()
+};
+
+struct HttpPoolStats {
+  uint32_t hits;             // Request reused an open socket
+  uint32_t misses;           // Request had to open a new socket
+  uint32_t evictions;        // Sockets closed to make room / idle
+  uint32_t overflows;        // Requests on a temporary socket (pool busy)
+  uint32_t connectFailures;
+  uint32_t connectTimeTotalMs;
+  uint32_t lastConnectMs;
+};
+
+HttpPoolSlot httpPool[HTTP_POOL_SIZE];
+HttpPoolStats httpPoolStats = {0, 0, 0, 0, 0, 0, 0};
+SemaphoreHandle_t httpPoolMutex = NULL;
+
+// ─────────────────────────────────────────────────────────────────────
+// INTERNAL HELPERS
+// ─────────────────────────────────────────────────────────────────────
+
+void initHttpPool() {
+  if (httpPoolMutex == NULL) {
+    httpPoolMutex = xSemaphoreCreateMutex();
+  }
+}
+
+void httpPoolLock() {
+  initHttpPool();
+  xSemaphoreTake(httpPoolMutex, portMAX_DELAY);
+}
+
+void httpPoolUnlock() {
+  xSemaphoreGive(httpPoolMutex);
+}
+
+// Split "https://host:port/path" into host, port and scheme
+bool parseHttpUrl(const char* url, char* host, size_t hostLen, uint16_t* port, bool* secure) {
+  const char* p;
+  if (strncmp(url, "https://", 8) == 0) {
+    *secure = true;
+    *port = 443;
+    p = url + 8;
+  } else if (strncmp(url, "http://", 7) == 0) {
+    *secure = false;
+    *port = 80;
+    p = url + 7;
+  } else {
+    return false;
+  }
+
+  size_t n = 0;
+  while (p[n] && p[n] != ':' && p[n] != '/' && p[n] != '?') n++;
+  if (n == 0 || n >= hostLen) return false;
+
+  memcpy(host, p, n);
+  host[n] = '\0';
+
+  if (p[n] == ':') {
+    *port = (uint16_t)atoi(p + n + 1);
+  }
+  return true;
+}
+
+void httpPoolCloseSlot(HttpPoolSlot* slot) {
+  if (slot->client) {
+    slot->client->stop();
+    delete slot->client;
+    slot->client = NULL;
+  }
+  slot->host[0] = '\0';
+  slot->requests = 0;
+  httpPoolStats.evictions++;
+}
+
+// Pick a slot for host:port. Caller holds the lock.
+HttpPoolSlot* httpPoolFindSlot(const char* host, uint16_t port, bool secure) {
+  unsigned long now = millis();
+  HttpPoolSlot* empty = NULL;
+  HttpPoolSlot* oldest = NULL;
+  HttpPoolSlot* oldestSecure = NULL;
+  int secureOpen = 0;
+
+  for (int i = 0; i < HTTP_POOL_SIZE; i++) {
+    HttpPoolSlot* slot = &httpPool[i];
+
+    // Evict idle sockets while we're here
+    if (slot->client && !slot->inUse && now - slot->lastUsed > HTTP_POOL_IDLE_MS) {
+      httpPoolCloseSlot(slot);
+    }
+
+    if (!slot->client) {
+      if (!empty) empty = slot;
+      continue;
+    }
+
+    if (slot->secure) secureOpen++;
+    if (slot->inUse) continue;
+
+    if (slot->port == port && slot->secure == secure && strcmp(slot->host, host) == 0) {
+      return slot;
+    }
+
+    if (!oldest || slot->lastUsed < oldest->lastUsed) oldest = slot;
+    if (slot->secure && (!oldestSecure || slot->lastUsed < oldestSecure->lastUsed)) oldestSecure = slot;
+  }
+
+  // TLS sockets are capped - recycle the least recently used one
+  if (secure && secureOpen >= HTTP_POOL_MAX_SECURE) {
+    if (!oldestSecure) return NULL;
+    httpPoolCloseSlot(oldestSecure);
+    return oldestSecure;
+  }
+
+  if (empty) return empty;
+
+  if (oldest) {
+    httpPoolCloseSlot(oldest);
+    return oldest;
+  }
+
+  return NULL;  // Every socket busy
+}
+
+// ─────────────────────────────────────────────────────────────────────
+// PUBLIC API
+// ─────────────────────────────────────────────────────────────────────
+
+// Give a slot a fresh client of the kind the pool uses for host:port
+// (TLS resumes cached sessions)
+void httpPoolAssign(HttpPoolSlot* slot, const char* host, uint16_t port, bool secure) {
+  if (secure) {
+    slot->client = new ResumableClientSecure();
+  } else {
+    slot->client = new WiFiClient();
+  }
+  strncpy(slot->host, host, sizeof(slot->host) - 1);
+  slot->host[sizeof(slot->host) - 1] = '\0';
+  slot->port = port;
+  slot->secure = secure;
+}
+
+void httpPoolFreeTemporary(HttpPoolSlot* slot) {
+  slot->client->stop();
+  delete slot->client;
+  delete slot;
+}
+
+// Begin a request on a pooled socket. When every slot is busy the
+// request gets a temporary socket of the same kind (the TLS cap can be
+// exceeded by one per waiting task until httpPoolEnd() frees it).
+// Returns false if the host could not be reached.
+bool httpPoolBegin(HTTPClient& http, const char* url, HttpPoolSlot** slotOut,
+                   uint16_t connectTimeoutMs = HTTP_POOL_CONNECT_TIMEOUT_MS) {
+  *slotOut = NULL;
+
+  char host[64];
+  uint16_t port;
+  bool secure;
+  if (!parseHttpUrl(url, host, sizeof(host), &port, &secure)) {
+    return http.begin(url);
+  }
+
+  httpPoolLock();
+  HttpPoolSlot* slot = httpPoolFindSlot(host, port, secure);
+  if (slot) {
+    slot->inUse = true;
+    slot->temporary = false;
+    if (!slot->client) httpPoolAssign(slot, host, port, secure);
+  } else {
+    httpPoolStats.overflows++;
+  }
+  httpPoolUnlock();
+
+  if (!slot) {
+    slot = new HttpPoolSlot();
+    httpPoolAssign(slot, host, port, secure);
+    slot->inUse = true;
+    slot->temporary = true;
+  }
+
+  bool reused = slot->client->connected();
+  unsigned long start = millis();
+  if (!reused) {
+    // Connect outside the lock so other tasks aren't stalled
+    slot->client->stop();
+    if (!slot->client->connect(host, port, connectTimeoutMs)) {
+      httpPoolLock();
+      httpPoolStats.connectFailures++;
+      if (!slot->temporary) {
+        slot->inUse = false;
+        slot->lastUsed = millis();
+      }
+      httpPoolUnlock();
+      if (slot->temporary) httpPoolFreeTemporary(slot);
+      return false;
+    }
+  }
+
+  httpPoolLock();
+  if (reused) {
+    httpPoolStats.hits++;
+  } else {
+    httpPoolStats.misses++;
+    httpPoolStats.lastConnectMs = millis() - start;
+    httpPoolStats.connectTimeTotalMs += httpPoolStats.lastConnectMs;
+  }
+  httpPoolUnlock();
+
+  slot->requests++;
+  *slotOut = slot;
+
+  http.setReuse(!slot->temporary);
+  return http.begin(*slot->client, url);
+}
+
+// Finish a request. HTTPClient leaves the socket open when the server
+// allows keep-alive; pass reusable=false if the body wasn't fully read.
+void httpPoolEnd(HTTPClient& http, HttpPoolSlot* slot, bool reusable = true) {
+  http.end();
+  if (!slot) return;
+
+  if (slot->temporary) {
+    httpPoolFreeTemporary(slot);
+    return;
+  }
+
+  httpPoolLock();
+  if (!reusable) {
+    slot->client->stop();
+  }
+  slot->inUse = false;
+  slot->lastUsed = millis();
+  httpPoolUnlock();
+}
+
+// Close every idle socket (e.g. after WiFi drops)
+void httpPoolFlush() {
+  httpPoolLock();
+  for (int i = 0; i < HTTP_POOL_SIZE; i++) {
+    if (httpPool[i].client && !httpPool[i].inUse) {
+      httpPoolCloseSlot(&httpPool[i]);
+    }
+  }
+  httpPoolUnlock();
+}
+
+// ─────────────────────────────────────────────────────────────────────
+// METRICS
+// ─────────────────────────────────────────────────────────────────────
+
+uint8_t getHttpPoolHitRate() {
+  httpPoolLock();
+  uint32_t hits = httpPoolStats.hits;
+  uint32_t total = hits + httpPoolStats.misses;
+  httpPoolUnlock();
+  if (total == 0) return 0;
+  return (hits * 100) / total;
+}
+
+// Average connect cost per request (hits count as 0 ms)
+uint32_t getHttpPoolAvgConnectMs() {
+  httpPoolLock();
+  uint32_t total = httpPoolStats.hits + httpPoolStats.misses;
+  uint32_t connectMs = httpPoolStats.connectTimeTotalMs;
+  httpPoolUnlock();
+  if (total == 0) return 0;
+  return connectMs / total;
+}
+
+int getHttpPoolOpenCount() {
+  int open = 0;
+  for (int i = 0; i < HTTP_POOL_SIZE; i++) {
+    if (httpPool[i].client && httpPool[i].client->connected()) open++;
+  }
+  return open;
+}
+
+#endif // HTTP_POOL_H
@@ -0,0 +1,477 @@
+#ifndef INFLATE_STREAM_H
+#define INFLATE_STREAM_H
+
+#include <Arduino.h>
+
+/*
+ * ═══════════════════════════════════════════════════════════════════════
+ * BLACKROAD STREAMING INFLATE (gzip / deflate)
+ * ═══════════════════════════════════════════════════════════════════════
+ *
+ * Decompresses a response body byte by byte as the JSON parser pulls
+ * it, so compressed bodies never exist in RAM in full:
+ * - Handles gzip (RFC 1952), zlib (RFC 1950) and raw deflate (RFC 1951),
+ *   since some servers send raw deflate for "Content-Encoding: deflate"
+ * - Output goes through a sliding window ring (the only big buffer).
+ *   Deflate can reference up to 32KB back, so that is the default; a
+ *   smaller INFLATE_WINDOW_SIZE works for servers with small windows, and
+ *   a reference beyond it fails cleanly instead of corrupting output
+ * - Huffman tables + window are heap allocated only for the lifetime of
+ *   one compressed response (~33KB), nothing is held between requests
+ * - Canonical Huffman decoding as in zlib's puff.c - no lookup tables,
+ *   plenty fast for a 2.4GHz link
+ *
+ * The gzip ISIZE trailer is checked; CRC32 / Adler-32 are not (TCP and
+ * the JSON parser already reject a damaged body).
+ *
+ * Usage:
+ *   InflateStream inflater;
+ *   if (inflater.allocWindow()) { ask for gzip }
+ *   inflater.begin(&rawBody);
+ *   deserializeJson(doc, inflater);
+ *   inflater.freeWindow();
+ */
+
+// ─────────────────────────────────────────────────────────────────────
+// INFLATE CONFIGURATION
+// ─────────────────────────────────────────────────────────────────────
+
+#define INFLATE_WINDOW_SIZE 32768        // Power of two, max deflate distance
+#define INFLATE_HEAP_RESERVE 24576       // Don't advertise gzip below this much spare heap
+
+enum InflateError {
+  INFLATE_OK,
+  INFLATE_ERR_NO_WINDOW,     // allocWindow() failed or wasn't called
+  INFLATE_ERR_HEADER,        // Bad gzip / zlib header
+  INFLATE_ERR_DATA,          // Invalid deflate data
+  INFLATE_ERR_DISTANCE,      // Back-reference beyond the window
+  INFLATE_ERR_TRUNCATED,     // Body ended mid-stream
+  INFLATE_ERR_LENGTH         // gzip ISIZE mismatch
+};
+
+// ─────────────────────────────────────────────────────────────────────
+// DATA STRUCTURES
+// ─────────────────────────────────────────────────────────────────────
+
+struct InflateHuffman {
+  uint16_t count[16];        // Codes per bit length
+  uint16_t symbol[288];      // Symbols ordered by code
+};
+
+struct InflateState {
+  InflateHuffman lenCode;
+  InflateHuffman distCode;
+  uint8_t window[1];         // INFLATE_WINDOW_SIZE bytes follow
+};
+
+// ─────────────────────────────────────────────────────────────────────
+// INFLATE STREAM
+// ─────────────────────────────────────────────────────────────────────
+
+class InflateStream : public Stream {
+public:
+  InflateStream() : _state(NULL), _src(NULL), _mode(INF_DONE), _error(INFLATE_OK), _peeked(-1) {}
+  ~InflateStream() { freeWindow(); }
+
+  // Reserve tables + window. False if the heap can't spare it - the
+  // caller should then not ask the server for compression.
+  bool allocWindow() {
+    if (_state) return true;
+    if (ESP.getMaxAllocHeap() < sizeof(InflateState) + INFLATE_WINDOW_SIZE + INFLATE_HEAP_RESERVE) return false;
+    _state = (InflateState*)malloc(sizeof(InflateState) + INFLATE_WINDOW_SIZE);
+    return _state != NULL;
+  }
+
+  void freeWindow() {
+    free(_state);
+    _state = NULL;
+    _mode = INF_DONE;
+  }
+
+  bool hasWindow() const { return _state != NULL; }
+
+  // gzip = Content-Encoding: gzip, otherwise zlib or raw deflate
+  void begin(Stream* src, bool gzip) {
+    _src = src;
+    _gzip = gzip;
+    _mode = INF_START;
+    _error = _state ? INFLATE_OK : INFLATE_ERR_NO_WINDOW;
+    if (!_state) _mode = INF_DONE;
+    _mask = INFLATE_WINDOW_SIZE - 1;
+    _bitBuf = 0;
+    _bitCnt = 0;
+    _lastBlock = false;
+    _copyLen = 0;
+    _copyDist = 0;
+    _storedLeft = 0;
+    _out = 0;
+    _peeked = -1;
+    setTimeout(0);  // read() already blocks on the source
+  }
+
+  int available() override {
+    if (_peeked >= 0 || _copyLen > 0) return 1;
+    if (_mode == INF_DONE || _mode == INF_ERROR) return 0;
+    return _src->available() > 0 || _bitCnt > 0 ? 1 : 0;
+  }
+
+  int read() override {
+    if (_peeked >= 0) {
+      int c = _peeked;
+      _peeked = -1;
+      return c;
+    }
+    return nextByte();
+  }
+
+  int peek() override {
+    if (_peeked < 0) _peeked = nextByte();
+    return _peeked;
+  }
+
+  size_t write(uint8_t) override { return 0; }
+
+  uint32_t bytesOut() const { return _out; }
+  InflateError error() const { return _error; }
+  bool finished() const { return _mode == INF_DONE && _peeked < 0; }
+
+private:
+  enum Mode { INF_START, INF_BLOCK, INF_STORED, INF_CODES, INF_DONE, INF_ERROR };
+
+  InflateState* _state;
+  Stream* _src;
+  Mode _mode;
+  InflateError _error;
+  int _peeked;
+  bool _gzip;
+  uint32_t _mask;            // Window size - 1
+  uint32_t _bitBuf;
+  uint8_t _bitCnt;
+  bool _lastBlock;
+  uint16_t _copyLen;         // Pending back-reference
+  uint16_t _copyDist;
+  uint16_t _storedLeft;      // Bytes left in a stored block
+  uint32_t _out;             // Bytes produced (also the window position)
+
+  int fail(InflateError error) {
+    if (_mode != INF_ERROR) _error = error;
+    _mode = INF_ERROR;
+    _copyLen = 0;
+    return -1;
+  }
+
+  int rawByte() {
+    int c = _src->read();
+    if (c < 0) fail(INFLATE_ERR_TRUNCATED);
+    return c;
+  }
+
+  // Next `need` bits, LSB first. 0 (and INF_ERROR) if the body ran out.
+  uint32_t bits(uint8_t need) {
+    uint32_t val = _bitBuf;
+    while (_bitCnt < need) {
+      int c = rawByte();
+      if (c < 0) return 0;
+      val |= (uint32_t)c << _bitCnt;
+      _bitCnt += 8;
+    }
+    _bitBuf = val >> need;
+    _bitCnt -= need;
+    return val & ((1UL << need) - 1);
+  }
+
+  int emit(uint8_t c) {
+    _state->window[_out & _mask] = c;
+    _out++;
+    return c;
+  }
+
+  // Canonical code tables from code lengths. Returns 0 for a complete
+  // code, > 0 for an incomplete one, < 0 for an over-subscribed one.
+  static int construct(InflateHuffman* h, const uint8_t* length, int n) {
+    memset(h->count, 0, sizeof(h->count));
+    for (int sym = 0; sym < n; sym++) h->count[length[sym]]++;
+    if (h->count[0] == n) return 0;
+
+    int left = 1;
+    for (int len = 1; len < 16; len++) {
+      left <<= 1;
+      left -= h->count[len];
+      if (left < 0) return left;
+    }
+
+    uint16_t offs[16];
+    offs[1] = 0;
+    for (int len = 1; len < 15; len++) offs[len + 1] = offs[len] + h->count[len];
+    for (int sym = 0; sym < n; sym++) {
+      if (length[sym] != 0) h->symbol[offs[length[sym]]++] = sym;
+    }
+    return left;
+  }
+
+  int decode(const InflateHuffman* h) {
+    int code = 0, first = 0, index = 0;
+    for (int len = 1; len < 16; len++) {
+      code |= bits(1);
+      if (_mode == INF_ERROR) return -1;
+      int count = h->count[len];
+      if (code - count < first) return h->symbol[index + (code - first)];
+      index += count;
+      first += count;
+      first <<= 1;
+      code <<= 1;
+    }
+    return -1;
+  }
+
+  // ───────────────────────────────────────────────────────────────────
+  // STREAM HEADERS
+  // ───────────────────────────────────────────────────────────────────
+
+  bool skipZeroTerminated() {
+    int c;
+    while ((c = rawByte()) > 0) {}
+    return c == 0;
+  }
+
+  bool readGzipHeader() {
+    uint8_t h[10];
+    for (int i = 0; i < 10; i++) {
+      int c = rawByte();
+      if (c < 0) return false;
+      h[i] = c;
+    }
+    if (h[0] != 0x1F || h[1] != 0x8B || h[2] != 8) return false;
+
+    uint8_t flags = h[3];
+    if (flags & 0x04) {  // FEXTRA
+      int lo = rawByte();
+      int hi = rawByte();
+      if (hi < 0) return false;
+      for (int n = lo | (hi << 8); n > 0; n--) {
+        if (rawByte() < 0) return false;
+      }
+    }
+    if ((flags & 0x08) && !skipZeroTerminated()) return false;  // FNAME
+    if ((flags & 0x10) && !skipZeroTerminated()) return false;  // FCOMMENT
+    if (flags & 0x02) {  // FHCRC
+      rawByte();
+      if (rawByte() < 0) return false;
+    }
+    return true;
+  }
+
+  // "deflate" should be zlib-wrapped, but raw deflate is common in the
+  // wild - sniff the two-byte zlib header and fall back to raw
+  bool readDeflateHeader() {
+    int b0 = rawByte();
+    if (b0 < 0) return false;
+    if ((b0 & 0x0F) == 8 && (b0 >> 4) <= 7) {
+      int b1 = rawByte();
+      if (b1 < 0) return false;
+      if (((b0 << 8) | b1) % 31 == 0) {
+        return (b1 & 0x20) == 0;  // Preset dictionary - never used by HTTP
+      }
+      _bitBuf = b0 | (b1 << 8);
+      _bitCnt = 16;
+      return true;
+    }
+    _bitBuf = b0;
+    _bitCnt = 8;
+    return true;
+  }
+
+  // gzip: CRC32 + ISIZE, zlib: Adler-32, raw: nothing
+  void readTrailer() {
+    _bitBuf = 0;
+    _bitCnt = 0;  // Trailer is byte aligned
+    if (_gzip) {
+      uint32_t isize = 0;
+      for (int i = 0; i < 8; i++) {
+        int c = rawByte();
+        if (c < 0) return;
+        if (i >= 4) isize |= (uint32_t)c << (8 * (i - 4));
+      }
+      if (isize != _out) fail(INFLATE_ERR_LENGTH);
+    }
+    // zlib's Adler-32 is left for HttpBodyStream::drain()
+  }
+
+  // ───────────────────────────────────────────────────────────────────
+  // BLOCKS
+  // ───────────────────────────────────────────────────────────────────
+
+  bool readStoredHeader() {
+    _bitBuf = 0;
+    _bitCnt = 0;  // Stored blocks start on a byte boundary
+    int b[4];
+    for (int i = 0; i < 4; i++) {
+      b[i] = rawByte();
+      if (b[i] < 0) return false;
+    }
+    uint16_t len = b[0] | (b[1] << 8);
+    uint16_t nlen = b[2] | (b[3] << 8);
+    if (len != (uint16_t)~nlen) return false;
+    _storedLeft = len;
+    return true;
+  }
+
+  void buildFixed() {
+    uint8_t lengths[288];
+    int sym = 0;
+    for (; sym < 144; sym++) lengths[sym] = 8;
+    for (; sym < 256; sym++) lengths[sym] = 9;
+    for (; sym < 280; sym++) lengths[sym] = 7;
+    for (; sym < 288; sym++) lengths[sym] = 8;
+    construct(&_state->lenCode, lengths, 288);
+    for (sym = 0; sym < 30; sym++) lengths[sym] = 5;
+    construct(&_state->distCode, lengths, 30);
+  }
+
+  bool buildDynamic() {
+    static const uint8_t order[19] = {16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15};
+    uint8_t lengths[320];
+
+    int nlen = bits(5) + 257;
+    int ndist = bits(5) + 1;
+    int ncode = bits(4) + 4;
+    if (_mode == INF_ERROR || nlen > 286 || ndist > 30) return false;
+
+    // Code length code, temporarily in distCode
+    int index = 0;
+    for (; index < ncode; index++) lengths[order[index]] = bits(3);
+    for (; index < 19; index++) lengths[order[index]] = 0;
+    if (_mode == INF_ERROR || construct(&_state->distCode, lengths, 19) != 0) return false;
+
+    index = 0;
+    while (index < nlen + ndist) {
+      int sym = decode(&_state->distCode);
+      if (sym < 0) return false;
+      if (sym < 16) {
+        lengths[index++] = sym;
+        continue;
+      }
+
+      uint8_t len = 0;
+      if (sym == 16) {
+        if (index == 0) return false;
+        len = lengths[index - 1];
+        sym = 3 + bits(2);
+      } else if (sym == 17) {
+        sym = 3 + bits(3);
+      } else {
+        sym = 11 + bits(7);
+      }
+      if (_mode == INF_ERROR || index + sym > nlen + ndist) return false;
+      while (sym--) lengths[index++] = len;
+    }
+    if (lengths[256] == 0) return false;  // No end-of-block code
+
+    // Incomplete codes are only allowed for a single length
+    int err = construct(&_state->lenCode, lengths, nlen);
+    if (err < 0 || (err > 0 && nlen - _state->lenCode.count[0] != 1)) return false;
+    err = construct(&_state->distCode, lengths + nlen, ndist);
+    if (err < 0 || (err > 0 && ndist - _state->distCode.count[0] != 1)) return false;
+    return true;
+  }
+
+  bool readBlockHeader() {
+    _lastBlock = bits(1);
+    uint8_t type = bits(2);
+    if (_mode == INF_ERROR) return false;
+
+    switch (type) {
+      case 0:
+        if (!readStoredHeader()) return false;
+        _mode = INF_STORED;
+        return true;
+      case 1:
+        buildFixed();
+        _mode = INF_CODES;
+        return true;
+      case 2:
+        if (!buildDynamic()) return false;
+        _mode = INF_CODES;
+        return true;
+      default:
+        return false;
+    }
+  }
+
+  // ───────────────────────────────────────────────────────────────────
+  // DECODER
+  // ───────────────────────────────────────────────────────────────────
+
+  int nextByte() {
+    static const uint16_t lenBase[29] = {3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+                                         35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258};
+    static const uint8_t lenExtra[29] = {0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+                                         3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0};
+    static const uint16_t distBase[30] = {1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+                                          257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145,
+                                          8193, 12289, 16385, 24577};
+    static const uint8_t distExtra[30] = {0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6,
+                                          7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13};
+
+    while (true) {
+      if (_copyLen > 0) {
+        _copyLen--;
+        return emit(_state->window[(_out - _copyDist) & _mask]);
+      }
+
+      switch (_mode) {
+        case INF_START:
+          if (!(_gzip ? readGzipHeader() : readDeflateHeader())) return fail(INFLATE_ERR_HEADER);
+          _mode = INF_BLOCK;
+          break;
+
+        case INF_BLOCK:
+          if (_lastBlock) {
+            _mode = INF_DONE;
+            readTrailer();
+            return -1;
+          }
+          if (!readBlockHeader()) return fail(INFLATE_ERR_DATA);
+          break;
+
+        case INF_STORED: {
+          if (_storedLeft == 0) {
+            _mode = INF_BLOCK;
+            break;
+          }
+          int c = rawByte();
+          if (c < 0) return -1;
+          _storedLeft--;
+          return emit(c);
+        }
+
+        case INF_CODES: {
+          int sym = decode(&_state->lenCode);
+          if (sym < 0) return fail(INFLATE_ERR_DATA);
+          if (sym < 256) return emit(sym);
+          if (sym == 256) {
+            _mode = INF_BLOCK;
+            break;
+          }
+
+          sym -= 257;
+          if (sym >= 29) return fail(INFLATE_ERR_DATA);
+          uint16_t len = lenBase[sym] + bits(lenExtra[sym]);
+          int dsym = decode(&_state->distCode);
+          if (dsym < 0 || dsym >= 30) return fail(INFLATE_ERR_DATA);
+          uint32_t dist = distBase[dsym] + bits(distExtra[dsym]);
+          if (_mode == INF_ERROR) return -1;
+          if (dist > _out || dist > _mask + 1) return fail(INFLATE_ERR_DISTANCE);
+          _copyLen = len;
+          _copyDist = dist;
+          break;
+        }
+
+        default:
+          return -1;
+      }
+    }
+  }
+};
+
+#endif // INFLATE_STREAM_H
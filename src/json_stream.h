@@ -0,0 +1,411 @@
+#ifndef JSON_STREAM_H
+#define JSON_STREAM_H
+
+#include <ArduinoJson.h>
+#include <HTTPClient.h>
+#include <WiFiClient.h>
+#include "http_pool.h"
+#include "http_cache.h"
+#include "endpoint_guard.h"
+#include "inflate_stream.h"
+
+/*
+ * ═══════════════════════════════════════════════════════════════════════
+ * BLACKROAD STREAMING JSON INGESTION
+ * ═══════════════════════════════════════════════════════════════════════
+ *
+ * Parses API responses straight off the socket instead of
+ * http.getString() + DynamicJsonDocument (body held in RAM twice):
+ * - HttpBodyStream de-chunks the body and stops at its end, so pooled
+ *   keep-alive sockets stay usable
+ * - ArduinoJson filters keep only the fields a fetcher declares
+ * - Large arrays can be walked one element at a time (jsonPeekToken)
+ * - Polled URLs can revalidate with ETag / Last-Modified (http_cache.h)
+ * - Timeouts adapt to observed RTT and dead hosts fail fast
+ *   (endpoint_guard.h)
+ * - Large responses can be requested gzip'd and are inflated on the fly
+ *   (inflate_stream.h); wire vs inflated bytes land in the endpoint stats
+ *
+ * Usage:
+ *   JsonHttpRequest req;
+ *   req.begin(url);
+ *   req.http.addHeader("Authorization", token);
+ *   if (req.GET() == 200) {
+ *     req.parse(doc, filter);
+ *   }
+ *   req.end();
+ *
+ * Conditional polling:
+ *   req.begin(url, 5000, true);
+ *   int code = req.GET();
+ *   if (code == HTTP_CODE_NOT_MODIFIED) { keep current state }
+ *   if (code == 200 && !req.parse(doc, filter)) { apply doc }
+ *
+ * Compressed responses (after begin(), before GET/POST):
+ *   req.acceptCompressed();
+ *   ... body() / parse() now see the inflated bytes
+ */
+
+#define HTTP_BODY_DRAIN_LIMIT 2048   // Bytes we'll skip to keep a socket reusable
+
+// ─────────────────────────────────────────────────────────────────────
+// HTTP BODY STREAM (Content-Length / chunked / until-close)
+// ─────────────────────────────────────────────────────────────────────
+
+class HttpBodyStream : public Stream {
+public:
+  HttpBodyStream() : _src(NULL), _remaining(0), _chunked(false), _inChunk(false),
+                     _done(true), _broken(false), _peeked(-1), _bytes(0), _timeoutMs(5000) {}
+
+  // contentLength < 0 means unknown (chunked or read until close)
+  void begin(WiFiClient* src, long contentLength, bool chunked, unsigned long timeoutMs) {
+    _src = src;
+    _remaining = chunked ? 0 : contentLength;
+    _chunked = chunked;
+    _inChunk = false;
+    _done = (src == NULL || (!chunked && contentLength == 0));
+    _broken = false;
+    _peeked = -1;
+    _bytes = 0;
+    _timeoutMs = timeoutMs;
+    setTimeout(timeoutMs);
+  }
+
+  int available() override {
+    if (_peeked >= 0) return 1;
+    if (_done || !_src) return 0;
+    int raw = _src->available();
+    if (!_chunked && _remaining >= 0 && raw > _remaining) return _remaining;
+    return raw;
+  }
+
+  int read() override {
+    if (_peeked >= 0) {
+      int c = _peeked;
+      _peeked = -1;
+      return c;
+    }
+    return nextByte();
+  }
+
+  int peek() override {
+    if (_peeked < 0) _peeked = nextByte();
+    return _peeked;
+  }
+
+  size_t write(uint8_t) override { return 0; }
+
+  size_t bytesRead() const { return _bytes; }
+  bool finished() const { return _done && _peeked < 0; }
+
+  // Skip what's left of the body. Returns true if the socket is left at a
+  // clean message boundary (safe to reuse for the next request).
+  bool drain(size_t maxBytes) {
+    _peeked = -1;
+    size_t skipped = 0;
+    while (!_done && skipped < maxBytes) {
+      if (nextByte() < 0) break;
+      skipped++;
+    }
+    return _done && !_broken;
+  }
+
+private:
+  WiFiClient* _src;
+  long _remaining;        // Bytes left in body (identity) or current chunk
+  bool _chunked;
+  bool _inChunk;          // Consumed at least one chunk (CRLF pending)
+  bool _done;
+  bool _broken;           // Timed out / closed mid-body
+  int _peeked;
+  size_t _bytes;
+  unsigned long _timeoutMs;
+
+  int readRaw() {
+    unsigned long start = millis();
+    do {
+      int c = _src->read();
+      if (c >= 0) return c;
+      if (!_src->connected() && _src->available() == 0) break;
+      delay(1);
+    } while (millis() - start < _timeoutMs);
+    return -1;
+  }
+
+  // Read "<hex>[;ext]\r\n" - returns chunk size or -1
+  long readChunkSize() {
+    long size = 0;
+    bool digits = false;
+    bool ext = false;
+    while (true) {
+      int c = readRaw();
+      if (c < 0) return -1;
+      if (c == '\n') break;
+      if (c == '\r' || ext) continue;
+      if (c == ';') { ext = true; continue; }
+      int v;
+      if (c >= '0' && c <= '9') v = c - '0';
+      else if (c >= 'a' && c <= 'f') v = c - 'a' + 10;
+      else if (c >= 'A' && c <= 'F') v = c - 'A' + 10;
+      else continue;
+      size = (size << 4) | v;
+      digits = true;
+    }
+    return digits ? size : -1;
+  }
+
+  int nextByte() {
+    if (_done) return -1;
+
+    if (_chunked && _remaining == 0) {
+      if (_inChunk) {
+        readRaw();  // '\r'
+        readRaw();  // '\n'
+      }
+      long size = readChunkSize();
+      if (size < 0) {
+        _broken = true;
+        _done = true;
+        return -1;
+      }
+      if (size == 0) {
+        // Skip trailers up to the blank line
+        int c, prev = -1;
+        while ((c = readRaw()) >= 0) {
+          if (c == '\n' && (prev == '\n' || prev == -1)) break;
+          if (c != '\r') prev = c;
+        }
+        if (c < 0) _broken = true;
+        _done = true;
+        return -1;
+      }
+      _remaining = size;
+      _inChunk = true;
+    }
+
+    if (!_chunked && _remaining == 0) {
+      _done = true;
+      return -1;
+    }
+
+    int c = readRaw();
+    if (c < 0) {
+      // Close-delimited bodies end here; anything else was cut short
+      if (_chunked || _remaining > 0) _broken = true;
+      _done = true;
+      return -1;
+    }
+
+    if (_remaining > 0) _remaining--;
+    _bytes++;
+    return c;
+  }
+};
+
+// Peek the next non-whitespace byte of a JSON body (-1 at the end).
+// For walking arrays element by element: '[' / ',' / ']' between the
+// values deserializeJson() reads.
+int jsonPeekToken(Stream& s) {
+  int c;
+  while ((c = s.peek()) == ' ' || c == '\n' || c == '\r' || c == '\t') s.read();
+  return c;
+}
+
+// ─────────────────────────────────────────────────────────────────────
+// POOLED JSON REQUEST
+// ─────────────────────────────────────────────────────────────────────
+
+class JsonHttpRequest {
+public:
+  HTTPClient http;
+
+  JsonHttpRequest() : _slot(NULL), _code(0), _began(false), _timeoutMs(5000),
+                      _urlHash(0), _cacheCommitted(false), _guard(NULL), _shortCircuit(false),
+                      _compressed(false) {}
+  ~JsonHttpRequest() { end(); }
+
+  // timeoutMs is an upper bound - the endpoint guard shortens it once
+  // it has seen enough RTT samples.
+  // conditional = revalidate with the cached ETag / Last-Modified
+  bool begin(const char* url, uint16_t timeoutMs = 5000, bool conditional = false) {
+    end();
+    _began = true;
+    _code = 0;
+    _urlHash = conditional ? httpCacheHash(url) : 0;
+    _cacheCommitted = false;
+
+    char host[64];
+    uint16_t port;
+    bool secure;
+    _guard = parseHttpUrl(url, host, sizeof(host), &port, &secure) ? endpointGuardFor(host, port) : NULL;
+    _shortCircuit = !endpointAllow(_guard);
+    if (_shortCircuit) return false;
+
+    _timeoutMs = endpointTimeout(_guard, timeoutMs);
+    uint16_t connectMs = _timeoutMs < HTTP_POOL_CONNECT_TIMEOUT_MS ? _timeoutMs : HTTP_POOL_CONNECT_TIMEOUT_MS;
+    bool ok = httpPoolBegin(http, url, &_slot, connectMs);
+    static const char* headerKeys[] = {"Transfer-Encoding", "ETag", "Last-Modified", "Content-Encoding"};
+    http.collectHeaders(headerKeys, 4);
+    http.setTimeout(_timeoutMs);
+    return ok;
+  }
+
+  int GET() {
+    if (_shortCircuit) return failFast();
+    if (_urlHash) httpCacheApply(http, _urlHash);
+    unsigned long start = millis();
+    _code = http.GET();
+    recordOutcome(start);
+    if (_urlHash && _code == HTTP_CODE_NOT_MODIFIED) httpCacheNoteNotModified(_urlHash);
+    openBody();
+    return _code;
+  }
+
+  int POST(const String& payload) {
+    if (_shortCircuit) return failFast();
+    unsigned long start = millis();
+    _code = http.POST(payload);
+    recordOutcome(start);
+    openBody();
+    return _code;
+  }
+
+  // Body from a fixed buffer (e.g. JsonWriter) - no String copy
+  int POST(const char* payload, size_t len) {
+    if (_shortCircuit) return failFast();
+    unsigned long start = millis();
+    _code = http.POST((uint8_t*)payload, len);
+    recordOutcome(start);
+    openBody();
+    return _code;
+  }
+
+  // Ask for a gzip / deflate body. Skipped (identity body) when the
+  // heap can't spare the inflate window. Core 3.x lets us replace
+  // HTTPClient's built-in "identity;q=1,chunked;q=0.1,*;q=0". On 2.x that
+  // line is hard-coded (addHeader's replace only covers our own headers),
+  // so ours goes out next to it and compression is best effort - servers
+  // that honour the q=1 identity send plain bodies, which body() handles.
+  bool acceptCompressed() {
+    if (_shortCircuit || !_inflate.allocWindow()) return false;
+#if defined(ESP_ARDUINO_VERSION_MAJOR) && ESP_ARDUINO_VERSION_MAJOR >= 3
+    http.setAcceptEncoding("gzip, deflate, identity;q=0.5");
+#else
+    http.addHeader("Accept-Encoding", "gzip, deflate");
+#endif
+    return true;
+  }
+
+  // Response body - inflated when the server compressed it
+  Stream& body() {
+    if (_compressed) return _inflate;
+    return _body;
+  }
+
+  int statusCode() const { return _code; }
+  bool circuitOpen() const { return _shortCircuit; }
+  bool notModified() const { return _code == HTTP_CODE_NOT_MODIFIED; }
+
+  // A clean parse of a 200 commits the response validators
+  DeserializationError parse(JsonDocument& doc, JsonDocument& filter) {
+    DeserializationError error = deserializeJson(doc, body(), DeserializationOption::Filter(filter));
+    if (!error) commitCache();
+    return error;
+  }
+
+  DeserializationError parse(JsonDocument& doc) {
+    DeserializationError error = deserializeJson(doc, body());
+    if (!error) commitCache();
+    return error;
+  }
+
+  // For callers that walk body() themselves: the response was applied
+  void commitCache() {
+    if (!_urlHash || _code != HTTP_CODE_OK || _cacheCommitted) return;
+    int size = http.getSize();
+    httpCacheStore(_urlHash, http.header("ETag"), http.header("Last-Modified"),
+                   size > 0 ? size : (int)_body.bytesRead());
+    _cacheCommitted = true;
+  }
+
+  // Return the socket to the pool (only reusable if the body was consumed)
+  void end() {
+    if (!_began) return;
+    // Fetch failed or wasn't applied - don't let a later 304 pin stale state
+    if (_urlHash && !_cacheCommitted && _code != HTTP_CODE_NOT_MODIFIED) {
+      httpCacheForget(_urlHash);
+    }
+    if (!_shortCircuit) {
+      recordBodySize();
+      bool reusable = _code > 0 && _body.drain(HTTP_BODY_DRAIN_LIMIT);
+      httpPoolEnd(http, _slot, reusable);
+    }
+    _inflate.freeWindow();
+    _compressed = false;
+    _slot = NULL;
+    _guard = NULL;
+    _shortCircuit = false;
+    _began = false;
+  }
+
+private:
+  HttpPoolSlot* _slot;
+  HttpBodyStream _body;
+  int _code;
+  bool _began;
+  uint16_t _timeoutMs;
+  uint32_t _urlHash;         // 0 = not a conditional request
+  bool _cacheCommitted;
+  EndpointGuard* _guard;
+  bool _shortCircuit;        // Breaker open - no request was sent
+  InflateStream _inflate;    // Window only allocated by acceptCompressed()
+  bool _compressed;          // body() goes through _inflate
+
+  int failFast() {
+    _code = HTTPC_ERROR_CIRCUIT_OPEN;
+    openBody();
+    return _code;
+  }
+
+  // Feed the endpoint guard. A read timeout, or a failure that took the
+  // whole timeout (connect timeout), is sampled so the next one widens
+  void recordOutcome(unsigned long start) {
+    uint32_t elapsed = millis() - start;
+    bool timedOut = _code == HTTPC_ERROR_READ_TIMEOUT || (_code <= 0 && elapsed >= _timeoutMs);
+    endpointRecord(_guard, _code > 0, elapsed, timedOut);
+  }
+
+  void openBody() {
+    if (_code <= 0) {
+      _body.begin(NULL, 0, false, _timeoutMs);
+      return;
+    }
+
+    // No body on 1xx / 204 / 304
+    bool noBody = (_code < 200 || _code == 204 || _code == 304);
+    bool chunked = http.header("Transfer-Encoding").equalsIgnoreCase("chunked");
+    long size = noBody ? 0 : http.getSize();
+
+    _body.begin(http.getStreamPtr(), size, chunked && !noBody, _timeoutMs);
+
+    String encoding = http.header("Content-Encoding");
+    bool gzip = encoding.equalsIgnoreCase("gzip");
+    _compressed = !noBody && (gzip || encoding.equalsIgnoreCase("deflate"));
+    if (_compressed) _inflate.begin(&_body, gzip);
+  }
+
+  void recordBodySize() {
+    if (_code <= 0) return;
+    if (!_compressed) {
+      endpointRecordBody(_guard, _body.bytesRead(), _body.bytesRead(), false);
+      return;
+    }
+    if (_inflate.error() != INFLATE_OK) {
+      Serial.printf("⚠️  Inflate failed (error %d) after %lu bytes\n", _inflate.error(),
+                    (unsigned long)_inflate.bytesOut());
+    }
+    endpointRecordBody(_guard, _body.bytesRead(), _inflate.bytesOut(), true);
+  }
+};
+
+#endif // JSON_STREAM_H
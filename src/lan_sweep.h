@@ -0,0 +1,367 @@
+#ifndef LAN_SWEEP_H
+#define LAN_SWEEP_H
+
+#include <Arduino.h>
+#include <WiFi.h>
+#include <lwip/sockets.h>
+#include "fetch_engine.h"
+
+/*
+ * ═══════════════════════════════════════════════════════════════════════
+ * BLACKROAD PARALLEL LAN SWEEP
+ * ═══════════════════════════════════════════════════════════════════════
+ *
+ * Finds out which Pis and services are up with bare TCP handshakes:
+ * - Up to LAN_SWEEP_MAX_SOCKETS non-blocking connects in flight at once,
+ *   one select() waits on all of them; a finished slot is refilled
+ *   immediately, so a full target list costs ~one RTT, not N x timeout
+ * - SYN-ACK = service up; RST (ECONNREFUSED) = host up, port closed
+ * - No HTTP, no TLS, no heap beyond the socket itself
+ * - lanSubnetSweepStart() walks the whole local /24 to discover nodes
+ *
+ * Targets are registered once (lanSweepAddTarget), swept periodically on
+ * a fetch engine task, and landed by lanSweepTick() from loop(), which
+ * returns true when fresh results are ready for the mesh / API tables.
+ */
+
+// ─────────────────────────────────────────────────────────────────────
+// SWEEP CONFIGURATION
+// ─────────────────────────────────────────────────────────────────────
+
+#define LAN_SWEEP_MAX_TARGETS 16
+#define LAN_SWEEP_MAX_SOCKETS 6          // lwIP default is 10, the HTTP pool needs some
+#define LAN_SWEEP_TIMEOUT_MS 400         // LAN RTT is single-digit ms
+#define LAN_SWEEP_INTERVAL_MS 30000
+#define LAN_DISCOVERY_PORT 22            // Every Pi runs sshd; a RST still proves the host
+#define LAN_DISCOVERY_TIMEOUT_MS 250
+
+// ─────────────────────────────────────────────────────────────────────
+// DATA STRUCTURES
+// ─────────────────────────────────────────────────────────────────────
+
+enum LanProbeState {
+  LAN_PENDING,
+  LAN_OPEN,        // Handshake completed
+  LAN_REFUSED,     // RST - host up, nothing listening
+  LAN_TIMEOUT,     // No answer (host down or filtered)
+  LAN_ERROR        // Socket / route failure
+};
+
+struct LanProbe {
+  uint32_t ip;             // IPAddress cast (network byte order)
+  uint16_t port;
+  uint8_t state;           // LanProbeState
+  uint16_t rttMs;
+  uint32_t rttUs;          // Same, at micros() resolution (RTT sampler)
+};
+
+struct LanTarget {
+  const char* node;        // Mesh node name, e.g. "octavia"
+  const char* label;       // "SSH", "Dashboard"
+  LanProbe probe;          // Last landed result
+  unsigned long checkedAt; // 0 = never swept
+};
+
+LanTarget lanTargets[LAN_SWEEP_MAX_TARGETS];
+int lanTargetCount = 0;
+
+LanProbe lanSweepScratch[LAN_SWEEP_MAX_TARGETS];  // Written by the sweep task
+FetchJob lanSweepJob = {"LanSweep", NULL, NULL, FETCH_IDLE, false, 0, 0};
+unsigned long lanSweepLastStart = 0;
+unsigned long lanSweepLastMs = 0;                 // Duration of the last sweep
+uint32_t lanSweepGeneration = 0;                  // Bumped on every landed sweep
+
+// Discovery (/24) - one bit per host octet
+uint8_t lanSubnetScratch[32];
+uint8_t lanSubnetAlive[32];
+uint32_t lanSubnetBase = 0;                       // a.b.c.0 of the last sweep
+int lanSubnetAliveCount = 0;
+FetchJob lanSubnetJob = {"LanDiscover", NULL, NULL, FETCH_IDLE, false, 0, 0};
+
+// ─────────────────────────────────────────────────────────────────────
+// CONNECT ENGINE
+// ─────────────────────────────────────────────────────────────────────
+
+struct LanSlot {
+  int sock;                // -1 = free
+  int probe;               // Index into the batch
+  unsigned long startedAt;
+  unsigned long startedUs;
+};
+
+// Non-blocking connect. Returns the socket, or -1 with probe->state set.
+int lanProbeOpen(LanProbe* probe) {
+  int sock = lwip_socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+  if (sock < 0) {
+    probe->state = LAN_ERROR;
+    return -1;
+  }
+
+  struct sockaddr_in addr;
+  memset(&addr, 0, sizeof(addr));
+  addr.sin_family = AF_INET;
+  addr.sin_addr.s_addr = probe->ip;
+  addr.sin_port = htons(probe->port);
+
+  int flags = fcntl(sock, F_GETFL, 0);
+  fcntl(sock, F_SETFL, flags | O_NONBLOCK);
+
+  int res = lwip_connect(sock, (struct sockaddr*)&addr, sizeof(addr));
+  if (res < 0 && errno != EINPROGRESS) {
+    probe->state = (errno == ECONNREFUSED) ? LAN_REFUSED : LAN_ERROR;
+    lwip_close(sock);
+    return -1;
+  }
+  return sock;
+}
+
+// Probe every entry concurrently (bounded by LAN_SWEEP_MAX_SOCKETS).
+// Blocks for at most ~timeoutMs per window; returns the number of hosts up.
+int lanProbeBatch(LanProbe* probes, int count, uint32_t timeoutMs) {
+  LanSlot slots[LAN_SWEEP_MAX_SOCKETS];
+  for (int s = 0; s < LAN_SWEEP_MAX_SOCKETS; s++) slots[s].sock = -1;
+
+  int next = 0;
+  int inFlight = 0;
+  int up = 0;
+
+  while (next < count || inFlight > 0) {
+    // Refill free slots
+    for (int s = 0; s < LAN_SWEEP_MAX_SOCKETS && next < count; s++) {
+      if (slots[s].sock >= 0) continue;
+      LanProbe* probe = &probes[next];
+      probe->state = LAN_PENDING;
+      probe->rttMs = 0;
+      probe->rttUs = 0;
+      unsigned long started = millis();
+      unsigned long startedUs = micros();
+      int sock = lanProbeOpen(probe);
+      if (sock >= 0) {
+        slots[s].sock = sock;
+        slots[s].probe = next;
+        slots[s].startedAt = started;
+        slots[s].startedUs = startedUs;
+        inFlight++;
+      } else if (probe->state == LAN_REFUSED) {
+        up++;  // Refused synchronously - still an answer
+      }
+      next++;
+    }
+    if (inFlight == 0) continue;
+
+    // Wait for the first handshake to finish or the oldest slot to expire
+    fd_set writeSet, errorSet;
+    FD_ZERO(&writeSet);
+    FD_ZERO(&errorSet);
+    int maxFd = -1;
+    unsigned long now = millis();
+    unsigned long waitMs = timeoutMs;
+    for (int s = 0; s < LAN_SWEEP_MAX_SOCKETS; s++) {
+      if (slots[s].sock < 0) continue;
+      FD_SET(slots[s].sock, &writeSet);
+      FD_SET(slots[s].sock, &errorSet);
+      if (slots[s].sock > maxFd) maxFd = slots[s].sock;
+      unsigned long age = now - slots[s].startedAt;
+      unsigned long left = age >= timeoutMs ? 0 : timeoutMs - age;
+      if (left < waitMs) waitMs = left;
+    }
+
+    struct timeval tv;
+    tv.tv_sec = waitMs / 1000;
+    tv.tv_usec = (waitMs % 1000) * 1000;
+    int ready = select(maxFd + 1, NULL, &writeSet, &errorSet, &tv);
+
+    now = millis();
+    for (int s = 0; s < LAN_SWEEP_MAX_SOCKETS; s++) {
+      LanSlot* slot = &slots[s];
+      if (slot->sock < 0) continue;
+      LanProbe* probe = &probes[slot->probe];
+
+      bool done = false;
+      if (ready > 0 && (FD_ISSET(slot->sock, &writeSet) || FD_ISSET(slot->sock, &errorSet))) {
+        int sockErr = 0;
+        socklen_t errLen = sizeof(sockErr);
+        getsockopt(slot->sock, SOL_SOCKET, SO_ERROR, &sockErr, &errLen);
+        if (sockErr == 0) probe->state = LAN_OPEN;
+        else if (sockErr == ECONNREFUSED) probe->state = LAN_REFUSED;
+        else probe->state = LAN_ERROR;
+        done = true;
+      } else if (now - slot->startedAt >= timeoutMs) {
+        probe->state = LAN_TIMEOUT;
+        done = true;
+      }
+
+      if (done) {
+        probe->rttMs = (uint16_t)min(now - slot->startedAt, 65535UL);
+        probe->rttUs = micros() - slot->startedUs;
+        if (probe->state == LAN_OPEN || probe->state == LAN_REFUSED) up++;
+        lwip_close(slot->sock);
+        slot->sock = -1;
+        inFlight--;
+      }
+    }
+  }
+
+  return up;
+}
+
+// Single blocking check, e.g. before opening an SSH session
+bool lanPortOpen(IPAddress ip, uint16_t port, uint32_t timeoutMs = LAN_SWEEP_TIMEOUT_MS) {
+  LanProbe probe = {(uint32_t)ip, port, LAN_PENDING, 0, 0};
+  lanProbeBatch(&probe, 1, timeoutMs);
+  return probe.state == LAN_OPEN;
+}
+
+// ─────────────────────────────────────────────────────────────────────
+// TARGETS
+// ─────────────────────────────────────────────────────────────────────
+
+bool lanSweepAddTarget(const char* node, const char* label, const char* ip, uint16_t port) {
+  IPAddress addr;
+  if (lanTargetCount >= LAN_SWEEP_MAX_TARGETS || !addr.fromString(ip)) {
+    Serial.printf("❌ LAN target %s %s:%u not added\n", node, ip, port);
+    return false;
+  }
+
+  LanTarget* t = &lanTargets[lanTargetCount++];
+  t->node = node;
+  t->label = label;
+  t->probe.ip = (uint32_t)addr;
+  t->probe.port = port;
+  t->probe.state = LAN_PENDING;
+  t->probe.rttMs = 0;
+  t->probe.rttUs = 0;
+  t->checkedAt = 0;
+  return true;
+}
+
+int lanSweepFindTarget(uint32_t ip, uint16_t port) {
+  for (int i = 0; i < lanTargetCount; i++) {
+    if (lanTargets[i].probe.ip == ip && lanTargets[i].probe.port == port) return i;
+  }
+  return -1;
+}
+
+bool lanTargetUp(const LanTarget* t) {
+  return t->probe.state == LAN_OPEN;
+}
+
+// ─────────────────────────────────────────────────────────────────────
+// PERIODIC SWEEP
+// ─────────────────────────────────────────────────────────────────────
+
+bool lanSweepRun(void* arg) {
+  return lanProbeBatch(lanSweepScratch, lanTargetCount, LAN_SWEEP_TIMEOUT_MS) > 0;
+}
+
+// Kick off a sweep now (no-op if one is in flight)
+bool lanSweepStart() {
+  if (lanTargetCount == 0 || lanSweepJob.state != FETCH_IDLE) return false;
+
+  for (int i = 0; i < lanTargetCount; i++) {
+    lanSweepScratch[i] = lanTargets[i].probe;
+  }
+  lanSweepJob.fn = lanSweepRun;
+  lanSweepLastStart = millis();
+  return startFetchJob(&lanSweepJob);
+}
+
+// Call from loop(). Returns true when a sweep just landed in lanTargets.
+bool lanSweepTick() {
+  if (lanSweepJob.state == FETCH_DONE) {
+    unsigned long now = millis();
+    for (int i = 0; i < lanTargetCount; i++) {
+      lanTargets[i].probe = lanSweepScratch[i];
+      lanTargets[i].checkedAt = now;
+    }
+    lanSweepLastMs = getFetchJobDuration(&lanSweepJob);
+    lanSweepJob.state = FETCH_IDLE;
+    lanSweepGeneration++;
+    return true;
+  }
+
+  if (WiFi.status() == WL_CONNECTED &&
+      (lanSweepLastStart == 0 || millis() - lanSweepLastStart > LAN_SWEEP_INTERVAL_MS)) {
+    lanSweepStart();
+  }
+  return false;
+}
+
+// ─────────────────────────────────────────────────────────────────────
+// /24 DISCOVERY
+// ─────────────────────────────────────────────────────────────────────
+
+bool lanSubnetRun(void* arg) {
+  IPAddress base(lanSubnetBase);
+  LanProbe batch[LAN_SWEEP_MAX_SOCKETS * 4];
+  const int batchSize = sizeof(batch) / sizeof(batch[0]);
+
+  memset(lanSubnetScratch, 0, sizeof(lanSubnetScratch));
+  for (int host = 1; host < 255; host += batchSize) {
+    int n = 0;
+    for (int h = host; h < 255 && n < batchSize; h++, n++) {
+      batch[n].ip = (uint32_t)IPAddress(base[0], base[1], base[2], h);
+      batch[n].port = LAN_DISCOVERY_PORT;
+    }
+    lanProbeBatch(batch, n, LAN_DISCOVERY_TIMEOUT_MS);
+    for (int i = 0; i < n; i++) {
+      if (batch[i].state == LAN_OPEN || batch[i].state == LAN_REFUSED) {
+        int h = host + i;
+        lanSubnetScratch[h >> 3] |= (1 << (h & 7));
+      }
+    }
+  }
+  return true;
+}
+
+// Sweep the /24 we're on in the background; results land in lanSubnetTick()
+bool lanSubnetSweepStart() {
+  if (WiFi.status() != WL_CONNECTED || lanSubnetJob.state != FETCH_IDLE) return false;
+
+  IPAddress local = WiFi.localIP();
+  lanSubnetBase = (uint32_t)IPAddress(local[0], local[1], local[2], 0);
+  lanSubnetJob.fn = lanSubnetRun;
+  Serial.printf("🔎 Sweeping %u.%u.%u.0/24 (port %d)...\n",
+    local[0], local[1], local[2], LAN_DISCOVERY_PORT);
+  return startFetchJob(&lanSubnetJob);
+}
+
+bool lanSubnetHostAlive(uint8_t host) {
+  return lanSubnetAlive[host >> 3] & (1 << (host & 7));
+}
+
+// Call from loop(). Returns true when a discovery sweep just landed.
+bool lanSubnetTick() {
+  if (lanSubnetJob.state != FETCH_DONE) return false;
+
+  IPAddress base(lanSubnetBase);
+  lanSubnetAliveCount = 0;
+  for (int h = 1; h < 255; h++) {
+    bool alive = lanSubnetScratch[h >> 3] & (1 << (h & 7));
+    if (!alive) continue;
+    lanSubnetAliveCount++;
+    if (!lanSubnetHostAlive(h)) {
+      Serial.printf("  🆕 %u.%u.%u.%d is up\n", base[0], base[1], base[2], h);
+    }
+  }
+  memcpy(lanSubnetAlive, lanSubnetScratch, sizeof(lanSubnetAlive));
+
+  Serial.printf("✅ LAN discovery: %d hosts in %lums\n",
+    lanSubnetAliveCount, getFetchJobDuration(&lanSubnetJob));
+  lanSubnetJob.state = FETCH_IDLE;
+  return true;
+}
+
+// ─────────────────────────────────────────────────────────────────────
+// METRICS
+// ─────────────────────────────────────────────────────────────────────
+
+int getLanTargetsUp() {
+  int up = 0;
+  for (int i = 0; i < lanTargetCount; i++) {
+    if (lanTargetUp(&lanTargets[i])) up++;
+  }
+  return up;
+}
+
+#endif // LAN_SWEEP_H
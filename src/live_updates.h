@@ -0,0 +1,677 @@
+#ifndef LIVE_UPDATES_H
+#define LIVE_UPDATES_H
+
+#include <Arduino.h>
+#include <WiFi.h>
+#include <WiFiClient.h>
+#include <ArduinoJson.h>
+#include <base64.h>
+#include "realtime_config.h"
+#include "tls_session_cache.h"
+#include "fetch_engine.h"
+#include "dynamic_nav.h"
+
+/*
+ * ═══════════════════════════════════════════════════════════════════════
+ * BLACKROAD LIVE UPDATES (WEBSOCKET + SSE PUSH)
+ * ═══════════════════════════════════════════════════════════════════════
+ *
+ * Keeps long-lived streams to WS_OCTAVIA, WS_LUCIDIA and SSE_RAILWAY and
+ * patches navState / crmMetrics / meshNodes in place as deltas arrive,
+ * so the 5-minute full reload becomes a slow safety net.
+ *
+ * - WebSocket: minimal RFC 6455 client (text, ping/pong, close,
+ *   fragmentation); we ping every LIVE_PING_MS
+ * - SSE: text/event-stream with chunked decoding, id / Last-Event-ID
+ * - Connects run on fetch engine tasks; loop() only reads what has
+ *   already arrived (liveUpdatesTick), never waits on the network
+ * - Reconnect with exponential backoff + jitter, silent streams dropped
+ *   after LIVE_IDLE_TIMEOUT_MS
+ *
+ * Delta protocol - one JSON object per WS text message / SSE event:
+ *   {"seq":42,"type":"nav","data":{"hotLeads":7,"crmHealthy":true}}
+ *   {"seq":43,"type":"crm","data":{"pipelineValue":125000.0,"topLead":"Ada"}}
+ *   {"seq":44,"type":"mesh","data":{"name":"octavia","online":true,"latency":8}}
+ *   {"seq":45,"type":"resync"}
+ * Only keys present in "data" are written. "mesh" matches on name and
+ * appends unknown nodes while there's room. A gap in seq, a reconnect or
+ * "resync" asks loop() for one full reload (liveTakeResync).
+ *
+ * tools/live_standin.py serves both protocols on Linux for bench testing.
+ */
+
+// ─────────────────────────────────────────────────────────────────────
+// LIVE CONFIGURATION
+// ─────────────────────────────────────────────────────────────────────
+
+#define LIVE_MAX_STREAMS 3
+#define LIVE_MSG_MAX 768                 // Largest delta we accept
+#define LIVE_CONNECT_TIMEOUT_MS 3000
+#define LIVE_PING_MS 30000
+#define LIVE_IDLE_TIMEOUT_MS 75000       // 2.5 missed pings / SSE heartbeats
+#define LIVE_BACKOFF_MIN_MS 1000
+#define LIVE_BACKOFF_MAX_MS 60000
+#define LIVE_BYTES_PER_TICK 1024         // Bound the time spent in loop()
+
+// ─────────────────────────────────────────────────────────────────────
+// DATA STRUCTURES
+// ─────────────────────────────────────────────────────────────────────
+
+enum LiveKind {
+  LIVE_WS,
+  LIVE_SSE
+};
+
+enum LiveState {
+  LIVE_DISCONNECTED,
+  LIVE_CONNECTING,     // Connect job in flight
+  LIVE_OPEN
+};
+
+enum LiveWsPhase {
+  WS_HEADER,
+  WS_PAYLOAD
+};
+
+enum LiveChunkPhase {
+  CHUNK_SIZE,
+  CHUNK_DATA,
+  CHUNK_CRLF
+};
+
+struct LiveStream {
+  const char* name;
+  const char* url;
+  LiveKind kind;
+  char host[48];
+  char path[64];
+  uint16_t port;
+  bool secure;
+
+  WiFiClient* client;            // WiFiClient or ResumableClientSecure
+  volatile LiveState state;
+  FetchJob connectJob;
+  unsigned long backoffMs;
+  unsigned long nextAttemptAt;
+  unsigned long lastRxAt;
+  unsigned long lastPingAt;
+
+  // Message being assembled
+  char msg[LIVE_MSG_MAX];
+  size_t msgLen;
+  bool msgOverflow;
+
+  // WebSocket frame parser
+  uint8_t wsPhase;
+  uint8_t wsHdr[14];
+  uint8_t wsHdrLen;
+  uint8_t wsHdrNeed;
+  uint8_t wsOpcode;              // Of the frame being read
+  bool wsFin;
+  uint32_t wsRemaining;
+  uint8_t wsMask[4];
+  bool wsMasked;
+  uint32_t wsMaskPos;
+  uint8_t ctrl[125];             // Ping / close payload
+  uint8_t ctrlLen;
+
+  // SSE parser
+  bool sseChunked;
+  uint8_t chunkPhase;
+  uint32_t chunkRemaining;
+  bool chunkExt;                 // Inside a ";ext" on the size line
+  char sseField[8];
+  uint8_t sseFieldLen;
+  bool sseInValue;               // Past the ':' of this line
+  bool sseSkipSpace;
+  bool sseDataLine;              // Current line is "data:"
+  bool sseIdLine;
+  char lastEventId[24];
+  char pendingId[24];
+  uint8_t pendingIdLen;
+
+  // Ordering + stats
+  bool haveSeq;
+  uint32_t lastSeq;
+  uint32_t messages;
+  uint32_t connects;
+  uint32_t gaps;
+};
+
+LiveStream liveStreams[LIVE_MAX_STREAMS];
+int liveStreamCount = 0;
+volatile bool liveResyncRequested = false;
+unsigned long liveLastDeltaAt = 0;
+
+// ─────────────────────────────────────────────────────────────────────
+// URL + CONNECTION
+// ─────────────────────────────────────────────────────────────────────
+
+// ws://, wss://, http://, https:// -> host, port, path
+bool liveParseUrl(LiveStream* s) {
+  const char* p = s->url;
+  if (strncmp(p, "wss://", 6) == 0)        { s->secure = true;  s->port = 443; p += 6; }
+  else if (strncmp(p, "ws://", 5) == 0)    { s->secure = false; s->port = 80;  p += 5; }
+  else if (strncmp(p, "https://", 8) == 0) { s->secure = true;  s->port = 443; p += 8; }
+  else if (strncmp(p, "http://", 7) == 0)  { s->secure = false; s->port = 80;  p += 7; }
+  else return false;
+
+  size_t n = 0;
+  while (p[n] && p[n] != ':' && p[n] != '/') n++;
+  if (n == 0 || n >= sizeof(s->host)) return false;
+  memcpy(s->host, p, n);
+  s->host[n] = '\0';
+  p += n;
+
+  if (*p == ':') {
+    s->port = (uint16_t)atoi(p + 1);
+    while (*p && *p != '/') p++;
+  }
+  strncpy(s->path, *p ? p : "/", sizeof(s->path) - 1);
+  s->path[sizeof(s->path) - 1] = '\0';
+  return true;
+}
+
+// Read one header line (without CRLF). Returns its length, -1 on timeout.
+int liveReadLine(WiFiClient* c, char* line, size_t len) {
+  size_t n = c->readBytesUntil('\n', line, len - 1);
+  if (n == 0 && !c->connected()) return -1;
+  if (n > 0 && line[n - 1] == '\r') n--;
+  line[n] = '\0';
+  return (int)n;
+}
+
+void liveWsSend(LiveStream* s, uint8_t opcode, const uint8_t* data, size_t len) {
+  // Client frames are always masked (RFC 6455 5.3); we only send small ones
+  uint8_t frame[6 + 125];
+  if (len > 125) len = 125;
+  uint8_t mask[4];
+  for (int i = 0; i < 4; i++) mask[i] = (uint8_t)random(256);
+
+  frame[0] = 0x80 | opcode;
+  frame[1] = 0x80 | (uint8_t)len;
+  memcpy(frame + 2, mask, 4);
+  for (size_t i = 0; i < len; i++) frame[6 + i] = data[i] ^ mask[i & 3];
+  s->client->write(frame, 6 + len);
+}
+
+bool liveHandshake(LiveStream* s) {
+  WiFiClient* c = s->client;
+  char line[160];
+
+  if (s->kind == LIVE_WS) {
+    uint8_t nonce[16];
+    for (int i = 0; i < 16; i++) nonce[i] = (uint8_t)random(256);
+    String key = base64::encode(nonce, sizeof(nonce));
+
+    c->printf("GET %s HTTP/1.1\r\nHost: %s:%u\r\n"
+              "Upgrade: websocket\r\nConnection: Upgrade\r\n"
+              "Sec-WebSocket-Key: %s\r\nSec-WebSocket-Version: 13\r\n"
+              "User-Agent: BlackRoad-OS/1.0\r\n\r\n",
+              s->path, s->host, s->port, key.c_str());
+  } else {
+    c->printf("GET %s HTTP/1.1\r\nHost: %s\r\n"
+              "Accept: text/event-stream\r\nCache-Control: no-cache\r\n"
+              "User-Agent: BlackRoad-OS/1.0\r\n",
+              s->path, s->host);
+    if (s->lastEventId[0]) c->printf("Last-Event-ID: %s\r\n", s->lastEventId);
+    c->print("\r\n");
+  }
+
+  // Status line
+  if (liveReadLine(c, line, sizeof(line)) < 12) return false;
+  int status = atoi(line + 9);  // "HTTP/1.1 101 ..."
+  if (status != (s->kind == LIVE_WS ? 101 : 200)) {
+    Serial.printf("  ⚠️  %s handshake: HTTP %d\n", s->name, status);
+    return false;
+  }
+
+  // Headers up to the blank line
+  s->sseChunked = false;
+  while (true) {
+    int n = liveReadLine(c, line, sizeof(line));
+    if (n < 0) return false;
+    if (n == 0) break;
+    if (strncasecmp(line, "Transfer-Encoding:", 18) == 0 && strstr(line + 18, "chunked")) {
+      s->sseChunked = true;
+    }
+  }
+  return true;
+}
+
+bool liveConnectJob(void* arg) {
+  LiveStream* s = (LiveStream*)arg;
+
+  if (!s->client) {
+    if (s->secure) {
+      s->client = new ResumableClientSecure();
+    } else {
+      s->client = new WiFiClient();
+    }
+  }
+  s->client->stop();
+  s->client->setTimeout(LIVE_CONNECT_TIMEOUT_MS / 1000);  // Seconds on ESP32 WiFiClient
+
+  if (!s->client->connect(s->host, s->port, LIVE_CONNECT_TIMEOUT_MS)) return false;
+  if (!liveHandshake(s)) {
+    s->client->stop();
+    return false;
+  }
+  return true;
+}
+
+void liveResetParser(LiveStream* s) {
+  s->msgLen = 0;
+  s->msgOverflow = false;
+  s->wsPhase = WS_HEADER;
+  s->wsHdrLen = 0;
+  s->wsHdrNeed = 2;
+  s->chunkPhase = CHUNK_SIZE;
+  s->chunkRemaining = 0;
+  s->chunkExt = false;
+  s->sseFieldLen = 0;
+  s->sseInValue = false;
+  s->sseDataLine = false;
+  s->sseIdLine = false;
+  s->pendingIdLen = 0;
+  s->haveSeq = false;
+}
+
+void liveDisconnect(LiveStream* s, const char* why) {
+  if (s->client) s->client->stop();
+  s->state = LIVE_DISCONNECTED;
+
+  // Exponential backoff with up to 25% jitter so streams don't sync up
+  unsigned long jitter = random(s->backoffMs / 4 + 1);
+  s->nextAttemptAt = millis() + s->backoffMs + jitter;
+  s->backoffMs = min(s->backoffMs * 2, (unsigned long)LIVE_BACKOFF_MAX_MS);
+
+  Serial.printf("🔌 %s: %s, retry in %lus\n", s->name, why,
+    (s->nextAttemptAt - millis()) / 1000);
+}
+
+// ─────────────────────────────────────────────────────────────────────
+// DELTA PROTOCOL
+// ─────────────────────────────────────────────────────────────────────
+
+template <typename T>
+void livePatch(JsonObject data, const char* key, T& field) {
+  JsonVariant v = data[key];
+  if (!v.isNull()) field = v.as<T>();
+}
+
+void livePatchMesh(JsonObject data) {
+  const char* name = data["name"];
+  if (!name) return;
+
+  int i = 0;
+  while (i < meshNodeCount && !meshNodes[i].name.equalsIgnoreCase(name)) i++;
+  if (i == meshNodeCount) {
+    if (meshNodeCount >= (int)(sizeof(meshNodes) / sizeof(meshNodes[0]))) return;
+    meshNodes[i].name = name;
+    meshNodes[i].online = false;
+    meshNodes[i].latency = 0;
+    meshNodes[i].bandwidth = 0;
+    meshNodes[i].status = "idle";
+    meshNodeCount++;
+  }
+
+  MeshNode& node = meshNodes[i];
+  livePatch(data, "ip", node.ip);
+  livePatch(data, "hostname", node.hostname);
+  livePatch(data, "online", node.online);
+  livePatch(data, "latency", node.latency);
+  livePatch(data, "bandwidth", node.bandwidth);
+  livePatch(data, "status", node.status);
+  node.lastSeen = millis();
+
+  int active = 0;
+  for (int n = 0; n < meshNodeCount; n++) {
+    if (meshNodes[n].online) active++;
+  }
+  navState.activeNodes = active;
+}
+
+void liveApplyDelta(LiveStream* s, const char* json, size_t len) {
+  StaticJsonDocument<1024> doc;
+  DeserializationError error = deserializeJson(doc, json, len);
+  if (error) {
+    Serial.printf("  ⚠️  %s: bad delta (%s)\n", s->name, error.c_str());
+    return;
+  }
+
+  // Ordering - any hole means we missed something, reload once
+  JsonVariant seqVar = doc["seq"];
+  if (!seqVar.isNull()) {
+    uint32_t seq = seqVar.as<uint32_t>();
+    if (s->haveSeq && seq != s->lastSeq + 1) {
+      s->gaps++;
+      liveResyncRequested = true;
+    }
+    s->haveSeq = true;
+    s->lastSeq = seq;
+  }
+
+  const char* type = doc["type"] | "";
+  JsonObject data = doc["data"];
+
+  if (strcmp(type, "nav") == 0) {
+    livePatch(data, "activeNodes", navState.activeNodes);
+    livePatch(data, "hotLeads", navState.hotLeads);
+    livePatch(data, "aiRequests", navState.aiRequests);
+    livePatch(data, "meshHealthy", navState.meshHealthy);
+    livePatch(data, "crmHealthy", navState.crmHealthy);
+    livePatch(data, "aiHealthy", navState.aiHealthy);
+  } else if (strcmp(type, "crm") == 0) {
+    livePatch(data, "totalContacts", crmMetrics.totalContacts);
+    livePatch(data, "hotLeads", crmMetrics.hotLeads);
+    livePatch(data, "openDeals", crmMetrics.openDeals);
+    livePatch(data, "pipelineValue", crmMetrics.pipelineValue);
+    livePatch(data, "activity24h", crmMetrics.activity24h);
+    livePatch(data, "topLead", crmMetrics.topLead);
+    livePatch(data, "topLeadScore", crmMetrics.topLeadScore);
+    livePatch(data, "hotLeads", navState.hotLeads);
+  } else if (strcmp(type, "mesh") == 0) {
+    livePatchMesh(data);
+  } else if (strcmp(type, "resync") == 0) {
+    liveResyncRequested = true;
+  } else {
+    return;  // Unknown type - newer server, ignore
+  }
+
+  s->messages++;
+  navState.lastUpdate = millis();
+  liveLastDeltaAt = millis();
+}
+
+// ─────────────────────────────────────────────────────────────────────
+// WEBSOCKET FRAMES
+// ─────────────────────────────────────────────────────────────────────
+
+void liveWsFrameEnd(LiveStream* s) {
+  switch (s->wsOpcode) {
+    case 0x0:  // Continuation
+    case 0x1:  // Text
+    case 0x2:  // Binary (accepted as text)
+      if (s->wsFin) {
+        if (!s->msgOverflow && s->msgLen > 0) liveApplyDelta(s, s->msg, s->msgLen);
+        s->msgLen = 0;
+        s->msgOverflow = false;
+      }
+      break;
+    case 0x8:  // Close - echo it, then reconnect
+      liveWsSend(s, 0x8, s->ctrl, s->ctrlLen >= 2 ? 2 : 0);
+      liveDisconnect(s, "closed by server");
+      break;
+    case 0x9:  // Ping
+      liveWsSend(s, 0xA, s->ctrl, s->ctrlLen);
+      break;
+    default:   // Pong / reserved
+      break;
+  }
+}
+
+void liveWsByte(LiveStream* s, uint8_t b) {
+  if (s->wsPhase == WS_HEADER) {
+    s->wsHdr[s->wsHdrLen++] = b;
+    if (s->wsHdrLen == 2) {
+      uint8_t len7 = s->wsHdr[1] & 0x7F;
+      s->wsMasked = s->wsHdr[1] & 0x80;
+      s->wsHdrNeed = 2 + (len7 == 126 ? 2 : len7 == 127 ? 8 : 0) + (s->wsMasked ? 4 : 0);
+    }
+    if (s->wsHdrLen < s->wsHdrNeed) return;
+
+    s->wsFin = s->wsHdr[0] & 0x80;
+    s->wsOpcode = s->wsHdr[0] & 0x0F;
+    uint8_t len7 = s->wsHdr[1] & 0x7F;
+    int pos = 2;
+    if (len7 == 126) {
+      s->wsRemaining = ((uint32_t)s->wsHdr[2] << 8) | s->wsHdr[3];
+      pos = 4;
+    } else if (len7 == 127) {
+      // 64-bit length; anything past 4 GB is nonsense on this link
+      s->wsRemaining = ((uint32_t)s->wsHdr[6] << 24) | ((uint32_t)s->wsHdr[7] << 16) |
+                       ((uint32_t)s->wsHdr[8] << 8) | s->wsHdr[9];
+      pos = 10;
+    } else {
+      s->wsRemaining = len7;
+    }
+    if (s->wsMasked) memcpy(s->wsMask, s->wsHdr + pos, 4);
+    s->wsMaskPos = 0;
+    s->wsHdrLen = 0;
+    s->wsHdrNeed = 2;
+    s->ctrlLen = 0;
+
+    if (s->wsOpcode == 0x1 || s->wsOpcode == 0x2) {
+      s->msgLen = 0;  // New data message
+      s->msgOverflow = false;
+    }
+    if (s->wsRemaining == 0) {
+      liveWsFrameEnd(s);
+    } else {
+      s->wsPhase = WS_PAYLOAD;
+    }
+    return;
+  }
+
+  // Payload
+  if (s->wsMasked) b ^= s->wsMask[s->wsMaskPos++ & 3];
+  if (s->wsOpcode >= 0x8) {
+    if (s->ctrlLen < sizeof(s->ctrl)) s->ctrl[s->ctrlLen++] = b;
+  } else if (s->msgLen < LIVE_MSG_MAX) {
+    s->msg[s->msgLen++] = (char)b;
+  } else {
+    s->msgOverflow = true;
+  }
+
+  if (--s->wsRemaining == 0) {
+    s->wsPhase = WS_HEADER;
+    liveWsFrameEnd(s);
+  }
+}
+
+// ─────────────────────────────────────────────────────────────────────
+// SERVER-SENT EVENTS
+// ─────────────────────────────────────────────────────────────────────
+
+void liveSseLineEnd(LiveStream* s) {
+  if (s->sseFieldLen == 0 && !s->sseInValue) {
+    // Blank line - dispatch the event
+    if (!s->msgOverflow && s->msgLen > 0) liveApplyDelta(s, s->msg, s->msgLen);
+    s->msgLen = 0;
+    s->msgOverflow = false;
+    if (s->pendingIdLen > 0) {
+      memcpy(s->lastEventId, s->pendingId, s->pendingIdLen);
+      s->lastEventId[s->pendingIdLen] = '\0';
+      s->pendingIdLen = 0;
+    }
+  }
+  s->sseFieldLen = 0;
+  s->sseInValue = false;
+  s->sseDataLine = false;
+  s->sseIdLine = false;
+}
+
+void liveSseByte(LiveStream* s, char c) {
+  if (c == '\r') return;
+  if (c == '\n') {
+    liveSseLineEnd(s);
+    return;
+  }
+
+  if (!s->sseInValue) {
+    if (c == ':') {
+      // ":" at column 0 is a comment / heartbeat - swallow the line
+      s->sseInValue = true;
+      s->sseSkipSpace = true;
+      s->sseField[s->sseFieldLen] = '\0';
+      s->sseDataLine = s->sseFieldLen == 4 && strcmp(s->sseField, "data") == 0;
+      s->sseIdLine = s->sseFieldLen == 2 && strcmp(s->sseField, "id") == 0;
+      if (s->sseDataLine && s->msgLen > 0) {
+        // Multiple data: lines join with '\n'
+        if (s->msgLen < LIVE_MSG_MAX) s->msg[s->msgLen++] = '\n';
+        else s->msgOverflow = true;
+      }
+      if (s->sseIdLine) s->pendingIdLen = 0;
+    } else if (s->sseFieldLen < sizeof(s->sseField) - 1) {
+      s->sseField[s->sseFieldLen++] = c;
+    }
+    return;
+  }
+
+  if (s->sseSkipSpace) {
+    s->sseSkipSpace = false;
+    if (c == ' ') return;
+  }
+
+  if (s->sseDataLine) {
+    if (s->msgLen < LIVE_MSG_MAX) s->msg[s->msgLen++] = c;
+    else s->msgOverflow = true;
+  } else if (s->sseIdLine && s->pendingIdLen < sizeof(s->pendingId) - 1) {
+    s->pendingId[s->pendingIdLen++] = c;
+  }
+}
+
+// Chunked transfer decoding in front of the SSE parser
+void liveSseRaw(LiveStream* s, uint8_t b) {
+  if (!s->sseChunked) {
+    liveSseByte(s, (char)b);
+    return;
+  }
+
+  switch (s->chunkPhase) {
+    case CHUNK_SIZE:
+      if (b == '\n') {
+        s->chunkPhase = s->chunkRemaining > 0 ? CHUNK_DATA : CHUNK_CRLF;
+        s->chunkExt = false;
+      } else if (s->chunkExt || b == '\r') {
+        // Skip
+      } else if (b == ';') {
+        s->chunkExt = true;
+      } else if (b >= '0' && b <= '9') {
+        s->chunkRemaining = (s->chunkRemaining << 4) | (b - '0');
+      } else if ((b | 0x20) >= 'a' && (b | 0x20) <= 'f') {
+        s->chunkRemaining = (s->chunkRemaining << 4) | ((b | 0x20) - 'a' + 10);
+      }
+      break;
+    case CHUNK_DATA:
+      liveSseByte(s, (char)b);
+      if (--s->chunkRemaining == 0) {
+        s->chunkPhase = CHUNK_CRLF;
+      }
+      break;
+    case CHUNK_CRLF:
+      if (b == '\n') {
+        s->chunkPhase = CHUNK_SIZE;
+        s->chunkRemaining = 0;
+      }
+      break;
+  }
+}
+
+// ─────────────────────────────────────────────────────────────────────
+// PUBLIC API
+// ─────────────────────────────────────────────────────────────────────
+
+bool liveUpdatesAdd(const char* name, const char* url, LiveKind kind) {
+  if (liveStreamCount >= LIVE_MAX_STREAMS) return false;
+
+  LiveStream* s = &liveStreams[liveStreamCount];
+  memset(s, 0, sizeof(LiveStream));
+  s->name = name;
+  s->url = url;
+  s->kind = kind;
+  if (!liveParseUrl(s)) {
+    Serial.printf("❌ Live stream %s: bad URL %s\n", name, url);
+    return false;
+  }
+
+  s->state = LIVE_DISCONNECTED;
+  s->backoffMs = LIVE_BACKOFF_MIN_MS;
+  s->connectJob.name = name;
+  s->connectJob.fn = liveConnectJob;
+  s->connectJob.arg = s;
+  s->connectJob.state = FETCH_IDLE;
+  liveStreamCount++;
+  return true;
+}
+
+void initLiveUpdates() {
+  liveUpdatesAdd("WS Octavia", WS_OCTAVIA, LIVE_WS);
+  liveUpdatesAdd("WS Lucidia", WS_LUCIDIA, LIVE_WS);
+  liveUpdatesAdd("SSE Railway", SSE_RAILWAY, LIVE_SSE);
+}
+
+// Call every loop(). Reads only what has already arrived.
+void liveUpdatesTick() {
+  unsigned long now = millis();
+
+  for (int i = 0; i < liveStreamCount; i++) {
+    LiveStream* s = &liveStreams[i];
+
+    switch (s->state) {
+      case LIVE_DISCONNECTED:
+        if (WiFi.status() != WL_CONNECTED) break;
+        if ((long)(now - s->nextAttemptAt) < 0) break;
+        if (s->connectJob.state != FETCH_IDLE) break;
+        s->state = LIVE_CONNECTING;
+        startFetchJob(&s->connectJob);
+        break;
+
+      case LIVE_CONNECTING:
+        if (s->connectJob.state != FETCH_DONE) break;
+        s->connectJob.state = FETCH_IDLE;
+        if (!s->connectJob.result) {
+          liveDisconnect(s, "connect failed");
+          break;
+        }
+        liveResetParser(s);
+        s->state = LIVE_OPEN;
+        s->backoffMs = LIVE_BACKOFF_MIN_MS;
+        s->lastRxAt = now;
+        s->lastPingAt = now;
+        if (s->connects++ > 0) liveResyncRequested = true;  // Missed deltas while away
+        Serial.printf("⚡ %s live (%s)\n", s->name, s->url);
+        break;
+
+      case LIVE_OPEN: {
+        int budget = LIVE_BYTES_PER_TICK;
+        while (budget-- > 0 && s->state == LIVE_OPEN && s->client->available() > 0) {
+          int b = s->client->read();
+          if (b < 0) break;
+          s->lastRxAt = now;
+          if (s->kind == LIVE_WS) liveWsByte(s, (uint8_t)b);
+          else liveSseRaw(s, (uint8_t)b);
+        }
+        if (s->state != LIVE_OPEN) break;  // Closed by a frame
+
+        if (!s->client->connected() && s->client->available() == 0) {
+          liveDisconnect(s, "connection lost");
+        } else if (now - s->lastRxAt > LIVE_IDLE_TIMEOUT_MS) {
+          liveDisconnect(s, "idle timeout");
+        } else if (s->kind == LIVE_WS && now - s->lastPingAt > LIVE_PING_MS) {
+          liveWsSend(s, 0x9, NULL, 0);
+          s->lastPingAt = now;
+        }
+        break;
+      }
+    }
+  }
+}
+
+// True while at least one stream is delivering deltas
+bool liveUpdatesActive() {
+  for (int i = 0; i < liveStreamCount; i++) {
+    if (liveStreams[i].state == LIVE_OPEN) return true;
+  }
+  return false;
+}
+
+// A full reload is needed (gap, reconnect, server asked). Clears the flag.
+bool liveTakeResync() {
+  if (!liveResyncRequested) return false;
+  liveResyncRequested = false;
+  return true;
+}
+
+#endif // LIVE_UPDATES_H
@@ -11,11 +11,8 @@
 
 // BlackRoad OS Fortune 500 Infrastructure - 30,000 AI Employees
 // Real SSH connections to production servers via Tailscale mesh
+// Pi node IPs (OCTAVIA_IP, ARIA_IP, ...) live in api_config.h
 #define TAILSCALE_IP "100.95.120.67"  // alexa-louise.taile5d081.ts.net
-#define LUCIDIA_IP "192.168.4.38"      // Tailscale: 100.66.235.47
-#define ALICE_IP "192.168.4.49"
-#define ARIA_IP "192.168.4.64"
-#define OCTAVIA_IP "192.168.4.74"
 #define SHELLFISH_IP "174.138.44.45"  // DigitalOcean
 
 TFT_eSPI tft = TFT_eSPI();
@@ -43,9 +40,12 @@ BlackRoadFont brFont(&tft);  // BlackRoad Mono font system
 
 // Include dynamic navigation and sovereign stack AFTER color definitions
 #include "dynamic_nav.h"       // Dynamic Navigation System
+#include "live_updates.h"      // WebSocket/SSE push deltas
+#include "snapshot_client.h"   // Binary snapshots from the aggregator
 #include "sovereign_stack.h"   // Sovereign Stack Monitor
 #include "alerts.h"            // Real-time Alert System
 #include "performance.h"       // Performance Monitor
+#include "api_functions.h"     // Weather / Linear / Stripe / crypto via the data cache
 
 // Golden Ratio Spacing System (φ = 1.618)
 #define SPACE_XS   8   // Base
@@ -1167,9 +1167,17 @@ void drawMeshVPN() {
     if (displayIP.length() > 13) displayIP = displayIP.substring(displayIP.length() - 13);
     tft.drawString(displayIP, 80, y+6, 1);
 
-    // Latency
+    // Latency - measured EWMA / p95 when the sampler has it
     tft.setTextColor(COLOR_SUNRISE);
-    tft.drawString(String(meshNodes[i].latency) + "ms", 170, y+6, 1);
+    char latency[16];
+    const RttPeer* peer = rttPeerFind(meshNodes[i].name.c_str());
+    float p95 = peer ? rttPeerPercentile(peer, 95) : -1;
+    if (p95 >= 0) {
+      snprintf(latency, sizeof(latency), "%d/%.0fms", meshNodes[i].latency, p95);
+    } else {
+      snprintf(latency, sizeof(latency), "%dms", meshNodes[i].latency);
+    }
+    tft.drawString(latency, 170, y+6, 1);
 
     // Bandwidth
     tft.setTextColor(COLOR_CYBER_BLUE);
@@ -2486,6 +2494,27 @@ void drawMeta() {
 
   y += 20;
 
+  // ═══════════════════════════════════════════════════════════════
+  // MESH RTT CARD (on-device samples)
+  // ═══════════════════════════════════════════════════════════════
+  tft.fillRoundRect(8, y, 304, 34, 4, COLOR_DARK_GRAY);
+  brFont.drawTechnicalLabel("MESH RTT", 14, y + 5, COLOR_CYBER_BLUE);
+
+  RttSummary rtt = getRttSummary();
+  char rttPeersStr[20];
+  sprintf(rttPeersStr, "%d/%d peers", rtt.peers, rttPeerCount);
+  brFont.drawMonoText(rttPeersStr, 200, y + 5, 1, rtt.lossPct > 10 ? COLOR_HOT_PINK : COLOR_WHITE);
+
+  y += 18;
+  tft.setTextDatum(TL_DATUM);
+  tft.setTextColor(COLOR_WHITE);
+  char rttStats[50];
+  sprintf(rttStats, "p50:%.1fms p95:%.1fms Jit:%.1fms Loss:%.0f%%",
+          rtt.p50Ms, rtt.p95Ms, rtt.jitterMs, rtt.lossPct);
+  tft.drawString(rttStats, 14, y, 1);
+
+  y += 20;
+
   // ═══════════════════════════════════════════════════════════════
   // SYSTEM UPTIME & BOOT REASON
   // ═══════════════════════════════════════════════════════════════
@@ -2856,6 +2885,41 @@ void drawAlertHistory() {
   tft.drawString(statsStr, 160, 215, 1);
 }
 
+// ═══════════════════════════════════════════════════════════════════
+// DASHBOARD DATA SOURCES - keys from secrets.h (ENABLE_*_API flags)
+// ═══════════════════════════════════════════════════════════════════
+
+DashboardCredentials dashboardCredentials() {
+  DashboardCredentials creds = {NULL, NULL, NULL, NULL, NULL};
+  #if defined(OPENWEATHER_API_KEY) && defined(WEATHER_CITY) && (!defined(ENABLE_WEATHER_API) || ENABLE_WEATHER_API)
+    creds.weatherKey = OPENWEATHER_API_KEY;
+    creds.weatherCity = WEATHER_CITY;
+  #endif
+  #if defined(STRIPE_API_KEY) && (!defined(ENABLE_STRIPE_API) || ENABLE_STRIPE_API)
+    creds.stripeKey = STRIPE_API_KEY;
+  #endif
+  #if defined(LINEAR_API_KEY) && defined(LINEAR_USER_EMAIL) && (!defined(ENABLE_LINEAR_API) || ENABLE_LINEAR_API)
+    creds.linearKey = LINEAR_API_KEY;
+    creds.linearEmail = LINEAR_USER_EMAIL;
+  #endif
+  return creds;
+}
+
+// "Updated: 3m ago" under a cached screen, or a demo-data note
+void drawCacheFooter(bool live, unsigned long ageMs, int y) {
+  char footer[40];
+  if (live) {
+    char age[16];
+    formatCacheAge(ageMs, age, sizeof(age));
+    snprintf(footer, sizeof(footer), "Updated: %s", age);
+  } else {
+    snprintf(footer, sizeof(footer), "Demo data - waiting for API");
+  }
+  tft.setTextColor(COLOR_DARK_GRAY);
+  tft.setTextDatum(TC_DATUM);
+  brFont.drawMonoText(footer, 160, y, 1, COLOR_WHITE);
+}
+
 // ═══════════════════════════════════════════════════════════════════
 // WEATHER APP - OpenWeatherMap 5-Day Forecast
 // ═══════════════════════════════════════════════════════════════════
@@ -2870,26 +2934,33 @@ void drawWeather() {
   tft.setTextDatum(TC_DATUM);
   brFont.drawMonoText("WEATHER", 160, 28, BR_MONO_MEDIUM, COLOR_CYBER_BLUE);
 
-  // Current weather card
+  // Current weather card - cached snapshot, demo values until the first fetch
+  unsigned long age = 0;
+  const WeatherData* wx = dataCacheRead<WeatherData>("weather", &age);
+
   drawCard(10, 50, 300, 80);
 
-  // Location & temp
+  char line[32];
   tft.setTextColor(COLOR_WHITE);
   tft.setTextDatum(TL_DATUM);
-  brFont.drawMonoText("San Francisco, CA", 20, 58, 2, COLOR_WHITE);
+  brFont.drawMonoText(wx ? dashboardCreds.weatherCity : "San Francisco, CA", 20, 58, 2, COLOR_WHITE);
 
   tft.setTextColor(COLOR_CYBER_BLUE);
-  brFont.drawMonoText("72°F", 20, 78, 4, COLOR_WHITE);
+  snprintf(line, sizeof(line), "%d°F", wx ? (int)lroundf(wx->temp) : 72);
+  brFont.drawMonoText(line, 20, 78, 4, COLOR_WHITE);
 
   tft.setTextColor(COLOR_WHITE);
-  brFont.drawMonoText("Partly Cloudy", 20, 108, 2, COLOR_WHITE);
+  brFont.drawMonoText(wx ? wx->condition : "Partly Cloudy", 20, 108, 2, COLOR_WHITE);
 
   // Weather details
   tft.setTextColor(COLOR_DARK_GRAY);
-  brFont.drawMonoText("Humidity: 65%", 180, 68, 1, COLOR_WHITE);
-  brFont.drawMonoText("Wind: 12 mph NW", 180, 83, 1, COLOR_WHITE);
-  brFont.drawMonoText("UV Index: 6", 180, 98, 1, COLOR_WHITE);
-  brFont.drawMonoText("Feels: 70°F", 180, 113, 1, COLOR_WHITE);
+  snprintf(line, sizeof(line), "Humidity: %d%%", wx ? wx->humidity : 65);
+  brFont.drawMonoText(line, 180, 68, 1, COLOR_WHITE);
+  snprintf(line, sizeof(line), "Wind: %d mph", wx ? (int)lroundf(wx->windSpeed) : 12);
+  brFont.drawMonoText(line, 180, 83, 1, COLOR_WHITE);
+  if (!wx) brFont.drawMonoText("UV Index: 6", 180, 98, 1, COLOR_WHITE);  // Not in the current-weather API
+  snprintf(line, sizeof(line), "Feels: %d°F", wx ? (int)lroundf(wx->feelsLike) : 70);
+  brFont.drawMonoText(line, 180, 113, 1, COLOR_WHITE);
 
   // 5-day forecast
   tft.setTextColor(COLOR_CYBER_BLUE);
@@ -2929,9 +3000,7 @@ void drawWeather() {
   }
 
   // Last updated
-  tft.setTextColor(COLOR_DARK_GRAY);
-  tft.setTextDatum(TC_DATUM);
-  brFont.drawMonoText("Updated: 2 min ago", 160, 302, 1, COLOR_WHITE);
+  drawCacheFooter(wx != NULL, age, 302);
 
   drawBottomNav();
 }
@@ -3040,42 +3109,49 @@ void drawLinear() {
   tft.setTextDatum(TC_DATUM);
   brFont.drawMonoText("LINEAR", 160, 28, 3, COLOR_WHITE);
 
+  // Cached snapshot of the assigned issues, demo board until the first fetch
+  unsigned long age = 0;
+  const LinearBoard* board = dataCacheRead<LinearBoard>("linear", &age);
+
   // Team info
+  char line[40];
   tft.setTextColor(COLOR_WHITE);
   tft.setTextDatum(TL_DATUM);
   brFont.drawMonoText("BlackRoad Engineering", 15, 55, 2, COLOR_WHITE);
 
   tft.setTextColor(COLOR_DARK_GRAY);
-  brFont.drawMonoText("Sprint 23 • 12 tasks", 15, 73, 1, COLOR_WHITE);
+  if (board) snprintf(line, sizeof(line), "Assigned to you • %d tasks", board->count);
+  else snprintf(line, sizeof(line), "Sprint 23 • 12 tasks");
+  brFont.drawMonoText(line, 15, 73, 1, COLOR_WHITE);
+
+  // Task breakdown by workflow state
+  int todo = 4, doing = 3, done = 5, blocked = 2;
+  if (board) {
+    todo = doing = done = blocked = 0;
+    for (int i = 0; i < board->count; i++) {
+      const char* state = board->tasks[i].state;
+      if (strstr(state, "Block")) blocked++;
+      else if (strcmp(state, "Done") == 0 || strcmp(state, "Canceled") == 0) done++;
+      else if (strstr(state, "Progress") || strstr(state, "Review")) doing++;
+      else todo++;
+    }
+  }
 
-  // Task breakdown
   int cardY = 92;
   int cardW = 72;
+  const char* labels[] = {"TODO", "DOING", "DONE", "BLOCK"};
+  const int counts[] = {todo, doing, done, blocked};
+  const uint16_t colors[] = {COLOR_DARK_GRAY, COLOR_SUNRISE, COLOR_CYBER_BLUE, COLOR_HOT_PINK};
 
-  // Todo
-  drawCard(10, cardY, cardW, 45, COLOR_DARK_GRAY);
-  tft.setTextColor(COLOR_WHITE);
-  tft.setTextDatum(TC_DATUM);
-  brFont.drawMonoText("TODO", 46, cardY + 8, 1, COLOR_WHITE);
-  brFont.drawMonoText("4", 46, cardY + 23, 3, COLOR_WHITE);
-
-  // In Progress
-  drawCard(89, cardY, cardW, 45, COLOR_SUNRISE);
-  tft.setTextColor(COLOR_WHITE);
-  brFont.drawMonoText("DOING", 125, cardY + 8, 1, COLOR_WHITE);
-  brFont.drawMonoText("3", 125, cardY + 23, 3, COLOR_WHITE);
-
-  // Done
-  drawCard(168, cardY, cardW, 45, COLOR_CYBER_BLUE);
-  tft.setTextColor(COLOR_WHITE);
-  brFont.drawMonoText("DONE", 204, cardY + 8, 1, COLOR_WHITE);
-  brFont.drawMonoText("5", 204, cardY + 23, 3, COLOR_WHITE);
-
-  // Blocked
-  drawCard(247, cardY, cardW, 45, COLOR_HOT_PINK);
-  tft.setTextColor(COLOR_WHITE);
-  brFont.drawMonoText("BLOCK", 283, cardY + 8, 1, COLOR_WHITE);
-  brFont.drawMonoText("2", 283, cardY + 23, 3, COLOR_WHITE);
+  for (int i = 0; i < 4; i++) {
+    int x = 10 + i * 79;
+    drawCard(x, cardY, cardW, 45, colors[i]);
+    tft.setTextColor(COLOR_WHITE);
+    tft.setTextDatum(TC_DATUM);
+    brFont.drawMonoText(labels[i], x + 36, cardY + 8, 1, COLOR_WHITE);
+    snprintf(line, sizeof(line), "%d", counts[i]);
+    brFont.drawMonoText(line, x + 36, cardY + 23, 3, COLOR_WHITE);
+  }
 
   // Active tasks
   tft.setTextColor(COLOR_HOT_PINK);
@@ -3085,25 +3161,38 @@ void drawLinear() {
   struct Task {
     const char* id;
     const char* title;
-    const char* priority;
-    uint16_t color;
+    int priority;  // Linear: 1 urgent .. 4 low, 0 none
   };
 
-  Task tasks[] = {
-    {"BR-142", "Fix ESP32 memory leak", "P1", COLOR_HOT_PINK},
-    {"BR-143", "Add GitHub integration", "P2", COLOR_SUNRISE},
-    {"BR-144", "Update documentation", "P3", COLOR_CYBER_BLUE}
+  Task tasks[3] = {
+    {"BR-142", "Fix ESP32 memory leak", 1},
+    {"BR-143", "Add GitHub integration", 2},
+    {"BR-144", "Update documentation", 3}
   };
+  int taskCount = 3;
+  if (board) {
+    // Open tasks only - the GraphQL ids are UUIDs, so show the state
+    taskCount = 0;
+    for (int i = 0; i < board->count && taskCount < 3; i++) {
+      const LinearTask* t = &board->tasks[i];
+      if (strcmp(t->state, "Done") == 0 || strcmp(t->state, "Canceled") == 0) continue;
+      tasks[taskCount++] = {t->state, t->title, t->priority};
+    }
+  }
 
   int y = 172;
-  for(int i = 0; i < 3; i++) {
+  for(int i = 0; i < taskCount; i++) {
+    uint16_t color = tasks[i].priority == 1 ? COLOR_HOT_PINK :
+                     tasks[i].priority == 2 ? COLOR_SUNRISE : COLOR_CYBER_BLUE;
+
     // Task card
     drawCard(10, y, 300, 35);
 
     // ID + Priority
-    tft.setTextColor(tasks[i].color);
+    tft.setTextColor(color);
     brFont.drawMonoText(tasks[i].id, 18, y + 8, 2, COLOR_WHITE);
-    brFont.drawMonoText(tasks[i].priority, 265, y + 8, 1, COLOR_WHITE);
+    snprintf(line, sizeof(line), "P%d", tasks[i].priority);
+    brFont.drawMonoText(line, 265, y + 8, 1, COLOR_WHITE);
 
     // Title
     tft.setTextColor(COLOR_WHITE);
@@ -3112,10 +3201,7 @@ void drawLinear() {
     y += 42;
   }
 
-  // Velocity
-  tft.setTextColor(COLOR_SUNRISE);
-  tft.setTextDatum(TC_DATUM);
-  brFont.drawMonoText("Velocity: 18 pts/week", 160, 302, 1, COLOR_WHITE);
+  drawCacheFooter(board != NULL, age, 302);
 
   drawBottomNav();
 }
@@ -3925,8 +4011,8 @@ void handleTouch() {
         tft.setTextDatum(TC_DATUM);
         brFont.drawMonoText("...", 281, 288, 1, COLOR_BLACK);
 
-        // Fetch live CRM data
-        bool success = fetchHotLeads();
+        // Fetch live CRM data (user priority - may spend the reserved tokens)
+        bool success = fetchHotLeads(PRIORITY_USER);
 
         // Visual feedback
         if (success) {
@@ -4228,6 +4314,7 @@ void connectWiFi() {
     // Initialize dynamic navigation system
     Serial.println("\n🔄 Initializing dynamic navigation...");
     initPerformanceMonitor();  // Initialize performance monitor
+    initHttpPool();            // Keep-alive sockets for API fetchers
     initGenesisVerification();
     initSovereignStack();  // Initialize sovereign stack monitor
     initStaticMeshData();  // Start with static data
@@ -4653,6 +4740,10 @@ void handleSerialCommand() {
       }
       Serial.println("━━━━━━━━━━━━━━━━━━━━━━━━━━━━\n");
     }
+    else if (cmd == "SNAPBENCH") {
+      // Binary snapshot vs JSON decode on this device
+      snapshotLoopbackBenchmark(200);
+    }
     else if (cmd == "UPTIME") {
       // Quick uptime
       Serial.printf("\nUptime: %s\n", getUptimeString().c_str());
@@ -4673,6 +4764,7 @@ void handleSerialCommand() {
       Serial.println("   HEAP         - Quick heap memory snapshot");
       Serial.println("   WIFI         - Quick WiFi status");
       Serial.println("   UPTIME       - Show uptime and boot reason");
+      Serial.println("   SNAPBENCH    - Snapshot vs JSON decode benchmark");
       Serial.println("   RESET        - Reboot device");
       Serial.println("   HELP         - Show this help message");
       Serial.println("━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━\n");
@@ -4755,6 +4847,15 @@ void setup() {
   // Connect to WiFi
   connectWiFi();
 
+  // LAN services behind the mesh view - swept with parallel TCP handshakes
+  initLanTargets();
+  initAPIStatus();          // HTTP health probes start from loop()
+  lanSubnetSweepStart();  // Discover anything else on the /24
+  initDashboardCache(dashboardCredentials());  // Screens refresh these on read
+  rttSamplerAddLanNodes();  // RTT/jitter/loss per node
+  initLiveUpdates();        // WS/SSE push streams (connect in the background)
+  initSnapshotClient();     // Aggregator snapshot feed (same)
+
   // Start AI API Server (for Claude/ChatGPT)
   Serial.println("\n🤖 Starting AI API Server...");
   // setupAIAPI();  // Commented out - Emergency Pager doesn't need AI API server
@@ -4779,11 +4880,33 @@ void loop() {
   handleSerialCommand();  // Check for emergency pager commands
   handleTouch();
 
-  // Auto-refresh dynamic navigation every 5 minutes
+  if (dataCacheTick() && (currentScreen == SCREEN_WEATHER || currentScreen == SCREEN_LINEAR)) {
+    drawCurrentScreen();  // Fresh snapshot for the screen on display
+  }
+  if (navFetchTick()) updateStackHealth();  // Nav sources that missed the deadline
+
+  if (lanSweepTick()) applyLanSweepToMesh();  // Parallel TCP sweep of the Pis
+  healthSchedulerTick();  // Cloud API probes on fetch tasks, LAN rows from the sweep
+  if (lanSubnetTick()) rttSamplerAddSubnetHosts();
+  if (rttSamplerTick()) applyRttToMesh();
+
+  #if ENABLE_ALERTS
+    localAlertTick();  // Step buzzer/LED alert patterns
+  #endif
+
+  liveUpdatesTick();  // Apply pushed deltas as they arrive
+  snapshotClientTick();  // Apply aggregator snapshots as they arrive
+
+  // Auto-refresh dynamic navigation every 5 minutes - only a safety net
+  // while a live stream or the aggregator is pushing
   static unsigned long lastNavUpdate = 0;
   const unsigned long NAV_REFRESH_INTERVAL = 300000; // 5 minutes
+  const unsigned long NAV_REFRESH_LIVE_INTERVAL = 1800000; // 30 minutes
+  unsigned long navInterval = (liveUpdatesActive() || snapshotFeedActive()) ? NAV_REFRESH_LIVE_INTERVAL : NAV_REFRESH_INTERVAL;
+  navInterval = max(navInterval, rateLimitPollIntervalMs("crm"));  // Never outpace the CRM quota
+  bool resync = liveTakeResync();  // Missed deltas - reload once
 
-  if (WiFi.status() == WL_CONNECTED && millis() - lastNavUpdate > NAV_REFRESH_INTERVAL) {
+  if (WiFi.status() == WL_CONNECTED && (resync || millis() - lastNavUpdate > navInterval)) {
     updateDynamicNavigation();
 
     // Check alert conditions after navigation update
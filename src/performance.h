@@ -11,12 +11,21 @@
  * - CPU usage and loop timing
  * - WiFi signal strength
  * - API response times
+ * - HTTP connection pool reuse
+ * - Conditional request (304) savings
+ * - Circuit breakers on dead endpoints
+ * - Dashboard data cache hit / stale / miss
  * - Screen refresh rate
  * - Touch responsiveness
  */
 
 #include <esp_system.h>
 #include <esp_heap_caps.h>
+#include "http_pool.h"
+#include "http_cache.h"
+#include "endpoint_guard.h"
+#include "data_cache.h"
+#include "rtt_sampler.h"
 
 // ─────────────────────────────────────────────────────────────────────
 // PERFORMANCE METRICS
@@ -42,6 +51,9 @@ struct PerformanceMetrics {
   // API Performance
   uint32_t lastNavUpdateMs;
   uint32_t avgApiResponseMs;
+  uint8_t httpPoolHitRate;  // % of requests on a reused socket
+  uint32_t avgConnectMs;    // Connect cost per request
+  uint8_t tlsResumeRate;    // % of TLS handshakes resumed
 
   // Uptime
   uint32_t uptimeSeconds;
@@ -70,6 +82,9 @@ void initPerformanceMonitor() {
   perfMetrics.wifiQuality = 0;
   perfMetrics.lastNavUpdateMs = 0;
   perfMetrics.avgApiResponseMs = 0;
+  perfMetrics.httpPoolHitRate = 0;
+  perfMetrics.avgConnectMs = 0;
+  perfMetrics.tlsResumeRate = 0;
   perfMetrics.uptimeSeconds = 0;
   perfMetrics.lastRebootReason = esp_reset_reason();
 
@@ -138,6 +153,11 @@ void updatePerformanceMetrics() {
     perfMetrics.wifiQuality = 0;
   }
 
+  // HTTP connection pool
+  perfMetrics.httpPoolHitRate = getHttpPoolHitRate();
+  perfMetrics.avgConnectMs = getHttpPoolAvgConnectMs();
+  perfMetrics.tlsResumeRate = getTlsResumeRate();
+
   // Uptime
   perfMetrics.uptimeSeconds = millis() / 1000;
 }
@@ -279,6 +299,42 @@ void printDiagnosticReport() {
     getWiFiQualityString().c_str(),
     9 - getWiFiQualityString().length(), "");
 
+  // Network
+  Serial.println("║ HTTP POOL                              ║");
+  Serial.printf("║   Hit Rate:   %6d%%                  ║\n", perfMetrics.httpPoolHitRate);
+  Serial.printf("║   Connect:    %6lu ms/req            ║\n", perfMetrics.avgConnectMs);
+  Serial.printf("║   Open:       %6d sockets           ║\n", getHttpPoolOpenCount());
+  TlsHandshakeStats tls = getTlsStats();
+  Serial.printf("║   TLS Full:   %6lu (%4lu ms avg)     ║\n", tls.fullHandshakes, getTlsAvgFullHandshakeMs());
+  Serial.printf("║   TLS Resume: %6lu (%4lu ms avg)     ║\n", tls.resumedHandshakes, getTlsAvgResumedHandshakeMs());
+  Serial.printf("║   304s:       %6lu (%3d%% hit)        ║\n", httpCacheStats.notModified, getHttpCacheHitRate());
+  Serial.printf("║   Saved:      %6lu KB                ║\n", httpCacheStats.bytesSaved / 1024);
+  Serial.printf("║   Breakers:   %6d open (%5lu skip) ║\n", getOpenBreakerCount(), getShortCircuitCount());
+
+  // Compressed responses (wire / inflated, per endpoint)
+  Serial.println("║ COMPRESSION                            ║");
+  Serial.printf("║   Saved:      %6lu KB                ║\n", getCompressionSavedBytes() / 1024);
+  for (int i = 0; i < EP_GUARD_SIZE; i++) {
+    const EndpointGuard* g = &endpointGuards[i];
+    if (!g->used || g->compressed == 0) continue;
+    Serial.printf("║   %-18.18s %6lu/%-6lu KB  ║\n", g->host, g->wireBytes / 1024, g->bodyBytes / 1024);
+  }
+
+  // Dashboard cache
+  Serial.println("║ DATA CACHE                             ║");
+  Serial.printf("║   Hit Rate:   %6d%%                  ║\n", getDataCacheHitRate());
+  Serial.printf("║   Hit/Stale:  %6lu / %-6lu          ║\n", dataCacheStats.hits, dataCacheStats.stale);
+  Serial.printf("║   Miss:       %6lu                   ║\n", dataCacheStats.misses);
+  Serial.printf("║   Memory:     %6d / %-6d bytes    ║\n", (int)dataCacheArenaUsed, DATA_CACHE_ARENA_BYTES);
+
+  // Mesh latency (on-device samples)
+  RttSummary rtt = getRttSummary();
+  Serial.println("║ MESH RTT                               ║");
+  Serial.printf("║   Peers:      %6d / %-6d          ║\n", rtt.peers, rttPeerCount);
+  Serial.printf("║   p50/p95:    %6.1f / %-6.1f ms       ║\n", rtt.p50Ms, rtt.p95Ms);
+  Serial.printf("║   Jitter:     %6.1f ms                ║\n", rtt.jitterMs);
+  Serial.printf("║   Loss:       %6.1f%%                  ║\n", rtt.lossPct);
+
   // System
   Serial.println("║ SYSTEM                                 ║");
   Serial.printf("║   Uptime:     %s%*s║\n",
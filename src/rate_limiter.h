@@ -0,0 +1,160 @@
+#ifndef RATE_LIMITER_H
+#define RATE_LIMITER_H
+
+#include <Arduino.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+
+/*
+ * ═══════════════════════════════════════════════════════════════════════
+ * BLACKROAD TOKEN-BUCKET RATE LIMITER
+ * ═══════════════════════════════════════════════════════════════════════
+ *
+ * One named bucket per upstream quota:
+ * - Tokens refill continuously (60/hour = one per minute), so polls
+ *   spread across the hour instead of bursting at window edges
+ * - Small burst capacity covers a cold start or a manual refresh
+ * - Background polls must leave `reserve` tokens untouched - those are
+ *   kept for user-triggered fetches (e.g. the SYNC CRM button)
+ * - rateLimitWaitMs() tells a poller when its next token lands, and
+ *   rateLimitPollIntervalMs() is the steady pace - data_cache.h spaces
+ *   each source's refreshes by them, the nav refresh by the crm bucket
+ *
+ * Usage:
+ *   if (!rateLimitAcquire("github", PRIORITY_BACKGROUND)) return false;
+ */
+
+// ─────────────────────────────────────────────────────────────────────
+// DATA STRUCTURES
+// ─────────────────────────────────────────────────────────────────────
+
+enum RequestPriority {
+  PRIORITY_BACKGROUND,   // Timer-driven polls
+  PRIORITY_USER          // Someone tapped a button and is waiting
+};
+
+struct TokenBucket {
+  const char* name;
+  float capacity;        // Max burst
+  float refillPerSec;
+  float reserve;         // Tokens only PRIORITY_USER may spend
+  float tokens;
+  unsigned long lastRefill;
+  uint32_t granted;
+  uint32_t denied;
+};
+
+#define RATE_PER_HOUR(n) ((n) / 3600.0f)
+#define RATE_PER_MINUTE(n) ((n) / 60.0f)
+
+// ─────────────────────────────────────────────────────────────────────
+// BUCKET TABLE (upstream quotas)
+// ─────────────────────────────────────────────────────────────────────
+
+TokenBucket rateBuckets[] = {
+  // name       burst  refill               reserve
+  {"github",    10,    RATE_PER_HOUR(500),  3, 0, 0, 0, 0},  // Token: 5000/h core limit, a tenth here
+  {"weather",   5,     RATE_PER_HOUR(100),  1, 0, 0, 0, 0},
+  {"crypto",    10,    RATE_PER_MINUTE(50), 2, 0, 0, 0, 0},  // CoinGecko free tier
+  {"stripe",    5,     RATE_PER_HOUR(100),  1, 0, 0, 0, 0},
+  {"linear",    5,     RATE_PER_HOUR(100),  1, 0, 0, 0, 0},
+  {"crm",       10,    RATE_PER_HOUR(120),  3, 0, 0, 0, 0},
+};
+#define RATE_BUCKET_COUNT (int)(sizeof(rateBuckets) / sizeof(rateBuckets[0]))
+
+SemaphoreHandle_t rateLimitMutex = NULL;
+
+// ─────────────────────────────────────────────────────────────────────
+// INTERNAL HELPERS
+// ─────────────────────────────────────────────────────────────────────
+
+void rateLimitLock() {
+  if (rateLimitMutex == NULL) {
+    rateLimitMutex = xSemaphoreCreateMutex();
+  }
+  xSemaphoreTake(rateLimitMutex, portMAX_DELAY);
+}
+
+void rateLimitUnlock() {
+  xSemaphoreGive(rateLimitMutex);
+}
+
+TokenBucket* rateBucket(const char* name) {
+  for (int i = 0; i < RATE_BUCKET_COUNT; i++) {
+    if (strcmp(rateBuckets[i].name, name) == 0) return &rateBuckets[i];
+  }
+  return NULL;
+}
+
+// Add tokens earned since the last refill. Caller holds the lock.
+void rateBucketRefill(TokenBucket* bucket) {
+  unsigned long now = millis();
+  if (bucket->lastRefill == 0) {
+    bucket->tokens = bucket->capacity;  // Start full
+  } else {
+    bucket->tokens += (now - bucket->lastRefill) / 1000.0f * bucket->refillPerSec;
+    if (bucket->tokens > bucket->capacity) bucket->tokens = bucket->capacity;
+  }
+  bucket->lastRefill = now ? now : 1;
+}
+
+float rateBucketNeeded(const TokenBucket* bucket, RequestPriority priority) {
+  return priority == PRIORITY_USER ? 1.0f : 1.0f + bucket->reserve;
+}
+
+// ─────────────────────────────────────────────────────────────────────
+// PUBLIC API
+// ─────────────────────────────────────────────────────────────────────
+
+// Take one token. Unknown buckets are never limited.
+bool rateLimitAcquire(const char* name, RequestPriority priority) {
+  TokenBucket* bucket = rateBucket(name);
+  if (!bucket) return true;
+
+  rateLimitLock();
+  rateBucketRefill(bucket);
+  bool ok = bucket->tokens >= rateBucketNeeded(bucket, priority);
+  if (ok) {
+    bucket->tokens -= 1.0f;
+    bucket->granted++;
+  } else {
+    bucket->denied++;
+  }
+  rateLimitUnlock();
+
+  return ok;
+}
+
+// Give a token back (request wasn't billed, e.g. GitHub 304)
+void rateLimitRefund(const char* name) {
+  TokenBucket* bucket = rateBucket(name);
+  if (!bucket) return;
+
+  rateLimitLock();
+  bucket->tokens += 1.0f;
+  if (bucket->tokens > bucket->capacity) bucket->tokens = bucket->capacity;
+  rateLimitUnlock();
+}
+
+// Milliseconds until a request at this priority would be granted
+unsigned long rateLimitWaitMs(const char* name, RequestPriority priority) {
+  TokenBucket* bucket = rateBucket(name);
+  if (!bucket) return 0;
+
+  rateLimitLock();
+  rateBucketRefill(bucket);
+  float deficit = rateBucketNeeded(bucket, priority) - bucket->tokens;
+  rateLimitUnlock();
+
+  if (deficit <= 0) return 0;
+  return (unsigned long)(deficit / bucket->refillPerSec * 1000.0f);
+}
+
+// Steady-state interval that keeps a background poller inside its quota
+unsigned long rateLimitPollIntervalMs(const char* name) {
+  TokenBucket* bucket = rateBucket(name);
+  if (!bucket) return 0;
+  return (unsigned long)(1000.0f / bucket->refillPerSec);
+}
+
+#endif // RATE_LIMITER_H
@@ -0,0 +1,40 @@
+#ifndef REALTIME_CONFIG_H
+#define REALTIME_CONFIG_H
+
+/*
+ * BlackRoad OS - Real-time (push) endpoints
+ * Split out of api_config.h so live_updates.h can use them from main.cpp.
+ * Each one can be overridden with a build flag, e.g. to point the device
+ * at tools/live_standin.py:
+ *   build_flags = -DWS_OCTAVIA=\"ws://192.168.4.20:8765/ws\"
+ */
+
+// ═══════════════════════════════════════════════════════════
+// REAL-TIME ENDPOINTS (WebSockets, SSE)
+// ═══════════════════════════════════════════════════════════
+
+#ifndef WS_OCTAVIA
+#define WS_OCTAVIA "ws://192.168.4.38:8080/ws"
+#endif
+
+#ifndef WS_LUCIDIA
+#define WS_LUCIDIA "ws://192.168.4.99:3000/ws"
+#endif
+
+#ifndef SSE_RAILWAY
+#define SSE_RAILWAY "https://backboard.railway.app/sse"
+#endif
+
+// ═══════════════════════════════════════════════════════════
+// SNAPSHOT AGGREGATOR (tools/aggregator on Octavia)
+// ═══════════════════════════════════════════════════════════
+
+#ifndef SNAP_AGGREGATOR_HOST
+#define SNAP_AGGREGATOR_HOST "192.168.4.38"
+#endif
+
+#ifndef SNAP_AGGREGATOR_PORT
+#define SNAP_AGGREGATOR_PORT 7420
+#endif
+
+#endif // REALTIME_CONFIG_H
@@ -0,0 +1,270 @@
+#ifndef RTT_SAMPLER_H
+#define RTT_SAMPLER_H
+
+#include <Arduino.h>
+#include <WiFi.h>
+#include <math.h>
+#include "fetch_engine.h"
+#include "lan_sweep.h"
+
+/*
+ * ═══════════════════════════════════════════════════════════════════════
+ * BLACKROAD RTT / JITTER / LOSS SAMPLER
+ * ═══════════════════════════════════════════════════════════════════════
+ *
+ * Measures the mesh from the device itself instead of trusting whatever
+ * the mesh status JSON claims:
+ * - Every RTT_SAMPLE_INTERVAL_MS all peers get one TCP handshake, in
+ *   parallel (lan_sweep.h engine). SYN-ACK and RST are both a round trip;
+ *   no answer within RTT_LOSS_TIMEOUT_MS is a lost sample
+ * - Per peer: smoothed RTT (EWMA, alpha 1/8 as in RFC 6298), jitter
+ *   (RFC 3550 interarrival estimator, gain 1/16) and a loss EWMA
+ * - The last RTT_RING_SIZE samples sit in a uint16_t ring (0.1 ms units)
+ *   for percentiles - no String, no heap, ~90 bytes per peer
+ *
+ * Peers come from the LAN targets (one per node) and from /24 discovery.
+ *
+ * Usage:
+ *   const RttPeer* peer = rttPeerFind("octavia");
+ *   if (peer && rttPeerHasSamples(peer)) p95 = rttPeerPercentile(peer, 95);
+ */
+
+// ─────────────────────────────────────────────────────────────────────
+// SAMPLER CONFIGURATION
+// ─────────────────────────────────────────────────────────────────────
+
+#define RTT_MAX_PEERS 32
+#define RTT_RING_SIZE 16
+#define RTT_SAMPLE_INTERVAL_MS 5000
+#define RTT_LOSS_TIMEOUT_MS 1000
+#define RTT_LOST 0xFFFF                  // Ring marker for a lost sample
+#define RTT_NAME_LEN 16                  // Fits "192.168.100.200"
+
+// ─────────────────────────────────────────────────────────────────────
+// DATA STRUCTURES
+// ─────────────────────────────────────────────────────────────────────
+
+struct RttPeer {
+  char name[RTT_NAME_LEN];       // Mesh node name or dotted IP
+  uint32_t ip;                   // IPAddress cast (network byte order)
+  uint16_t port;
+  uint16_t ring[RTT_RING_SIZE];  // RTT in 0.1 ms units, RTT_LOST = no answer
+  uint8_t head;                  // Next slot to write
+  uint8_t count;                 // Valid slots (<= RTT_RING_SIZE)
+  uint16_t lastRtt;              // Previous answered sample (jitter input)
+  float srttMs;                  // Smoothed RTT
+  float jitterMs;
+  float lossPct;                 // Smoothed loss, 0-100
+  uint32_t sent;
+  uint32_t lost;
+};
+
+RttPeer rttPeers[RTT_MAX_PEERS];
+int rttPeerCount = 0;
+
+LanProbe rttScratch[RTT_MAX_PEERS];     // Written by the sampler task
+int rttScratchCount = 0;
+FetchJob rttJob = {"RttSampler", NULL, NULL, FETCH_IDLE, false, 0, 0};
+unsigned long rttLastStart = 0;
+
+// ─────────────────────────────────────────────────────────────────────
+// PEERS
+// ─────────────────────────────────────────────────────────────────────
+
+RttPeer* rttPeerFind(const char* name) {
+  for (int i = 0; i < rttPeerCount; i++) {
+    if (strcasecmp(rttPeers[i].name, name) == 0) return &rttPeers[i];
+  }
+  return NULL;
+}
+
+RttPeer* rttPeerFindIp(uint32_t ip) {
+  for (int i = 0; i < rttPeerCount; i++) {
+    if (rttPeers[i].ip == ip) return &rttPeers[i];
+  }
+  return NULL;
+}
+
+// Returns the existing peer if this IP is already tracked
+RttPeer* rttSamplerAddPeer(const char* name, uint32_t ip, uint16_t port) {
+  RttPeer* peer = rttPeerFindIp(ip);
+  if (peer) return peer;
+  if (rttPeerCount >= RTT_MAX_PEERS) return NULL;
+
+  peer = &rttPeers[rttPeerCount++];
+  memset(peer, 0, sizeof(RttPeer));
+  strncpy(peer->name, name, RTT_NAME_LEN - 1);
+  peer->ip = ip;
+  peer->port = port;
+  return peer;
+}
+
+// One peer per mesh node, probed on its first registered service
+void rttSamplerAddLanNodes() {
+  for (int i = 0; i < lanTargetCount; i++) {
+    const LanTarget& t = lanTargets[i];
+    if (!rttPeerFind(t.node)) rttSamplerAddPeer(t.node, t.probe.ip, t.probe.port);
+  }
+}
+
+// Track every host the /24 discovery found (call when lanSubnetTick() lands)
+void rttSamplerAddSubnetHosts() {
+  IPAddress base(lanSubnetBase);
+  for (int h = 1; h < 255; h++) {
+    if (!lanSubnetHostAlive(h)) continue;
+    uint32_t ip = (uint32_t)IPAddress(base[0], base[1], base[2], h);
+    if (rttPeerFindIp(ip)) continue;
+
+    char name[RTT_NAME_LEN];
+    snprintf(name, sizeof(name), "%u.%u.%u.%d", base[0], base[1], base[2], h);
+    if (!rttSamplerAddPeer(name, ip, LAN_DISCOVERY_PORT)) break;  // Table full
+  }
+}
+
+// ─────────────────────────────────────────────────────────────────────
+// STATISTICS
+// ─────────────────────────────────────────────────────────────────────
+
+void rttPeerRecord(RttPeer* peer, const LanProbe& probe) {
+  bool answered = probe.state == LAN_OPEN || probe.state == LAN_REFUSED;
+  peer->sent++;
+
+  uint16_t sample = RTT_LOST;
+  if (answered) {
+    uint32_t tenths = (probe.rttUs + 50) / 100;
+    sample = tenths >= RTT_LOST ? RTT_LOST - 1 : tenths;
+    float rttMs = sample / 10.0f;
+
+    if (peer->sent - peer->lost == 1) {
+      peer->srttMs = rttMs;  // First answer seeds the average
+    } else {
+      peer->srttMs += (rttMs - peer->srttMs) / 8.0f;
+      float delta = fabsf(rttMs - peer->lastRtt / 10.0f);
+      peer->jitterMs += (delta - peer->jitterMs) / 16.0f;
+    }
+    peer->lastRtt = sample;
+    peer->lossPct += (0.0f - peer->lossPct) / 8.0f;
+  } else {
+    peer->lost++;
+    peer->lossPct += (100.0f - peer->lossPct) / 8.0f;
+  }
+
+  peer->ring[peer->head] = sample;
+  peer->head = (peer->head + 1) % RTT_RING_SIZE;
+  if (peer->count < RTT_RING_SIZE) peer->count++;
+}
+
+bool rttPeerHasSamples(const RttPeer* peer) {
+  return peer->sent > peer->lost;
+}
+
+// Nearest-rank percentile over the answered samples in the ring, in ms.
+// Returns -1 if the ring holds no answered sample.
+float rttPeerPercentile(const RttPeer* peer, uint8_t pct) {
+  uint16_t sorted[RTT_RING_SIZE];
+  int n = 0;
+  for (int i = 0; i < peer->count; i++) {
+    uint16_t v = peer->ring[i];
+    if (v == RTT_LOST) continue;
+    int j = n++;
+    while (j > 0 && sorted[j - 1] > v) {  // Insertion sort, 16 entries max
+      sorted[j] = sorted[j - 1];
+      j--;
+    }
+    sorted[j] = v;
+  }
+  if (n == 0) return -1;
+
+  int rank = (pct * n + 99) / 100;  // ceil(pct/100 * n)
+  if (rank < 1) rank = 1;
+  return sorted[rank - 1] / 10.0f;
+}
+
+// Loss over the ring window (exact, unlike the EWMA)
+uint8_t rttPeerWindowLoss(const RttPeer* peer) {
+  if (peer->count == 0) return 0;
+  int lost = 0;
+  for (int i = 0; i < peer->count; i++) {
+    if (peer->ring[i] == RTT_LOST) lost++;
+  }
+  return (lost * 100) / peer->count;
+}
+
+// ─────────────────────────────────────────────────────────────────────
+// SAMPLING
+// ─────────────────────────────────────────────────────────────────────
+
+bool rttSampleRun(void* arg) {
+  return lanProbeBatch(rttScratch, rttScratchCount, RTT_LOSS_TIMEOUT_MS) > 0;
+}
+
+// Call from loop(). Returns true when a round of samples just landed.
+bool rttSamplerTick() {
+  if (rttJob.state == FETCH_DONE) {
+    for (int i = 0; i < rttScratchCount; i++) {
+      rttPeerRecord(&rttPeers[i], rttScratch[i]);
+    }
+    rttJob.state = FETCH_IDLE;
+    return true;
+  }
+
+  if (rttPeerCount == 0 || rttJob.state != FETCH_IDLE) return false;
+  if (WiFi.status() != WL_CONNECTED) return false;
+  if (rttLastStart != 0 && millis() - rttLastStart < RTT_SAMPLE_INTERVAL_MS) return false;
+
+  // Snapshot targets - peers added mid-round join the next one
+  rttScratchCount = rttPeerCount;
+  for (int i = 0; i < rttScratchCount; i++) {
+    rttScratch[i].ip = rttPeers[i].ip;
+    rttScratch[i].port = rttPeers[i].port;
+  }
+  rttJob.fn = rttSampleRun;
+  rttLastStart = millis();
+  startFetchJob(&rttJob);
+  return false;
+}
+
+// ─────────────────────────────────────────────────────────────────────
+// METRICS
+// ─────────────────────────────────────────────────────────────────────
+
+struct RttSummary {
+  int peers;           // Peers with at least one answer
+  float p50Ms;         // Median of the per-peer medians
+  float p95Ms;         // Worst per-peer p95
+  float jitterMs;      // Mean jitter
+  float lossPct;       // Mean smoothed loss
+};
+
+RttSummary getRttSummary() {
+  RttSummary sum = {0, 0, 0, 0, 0};
+  float medians[RTT_MAX_PEERS];
+
+  for (int i = 0; i < rttPeerCount; i++) {
+    const RttPeer* peer = &rttPeers[i];
+    if (!rttPeerHasSamples(peer)) continue;
+
+    float p50 = rttPeerPercentile(peer, 50);
+    float p95 = rttPeerPercentile(peer, 95);
+    if (p50 < 0) continue;  // Only losses left in the window
+    if (p95 > sum.p95Ms) sum.p95Ms = p95;
+
+    int j = sum.peers++;
+    while (j > 0 && medians[j - 1] > p50) {
+      medians[j] = medians[j - 1];
+      j--;
+    }
+    medians[j] = p50;
+    sum.jitterMs += peer->jitterMs;
+    sum.lossPct += peer->lossPct;
+  }
+
+  if (sum.peers > 0) {
+    sum.p50Ms = medians[sum.peers / 2];
+    sum.jitterMs /= sum.peers;
+    sum.lossPct /= sum.peers;
+  }
+  return sum;
+}
+
+#endif // RTT_SAMPLER_H
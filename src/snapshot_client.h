@@ -0,0 +1,433 @@
+#ifndef SNAPSHOT_CLIENT_H
+#define SNAPSHOT_CLIENT_H
+
+#include <Arduino.h>
+#include <WiFi.h>
+#include <WiFiClient.h>
+#include <ArduinoJson.h>
+#include <JsonWriter.h>
+#include <SnapshotProtocol.h>
+#include "realtime_config.h"
+#include "fetch_engine.h"
+#include "dynamic_nav.h"
+
+/*
+ * ═══════════════════════════════════════════════════════════════════════
+ * BLACKROAD SNAPSHOT FEED (AGGREGATOR PUSH)
+ * ═══════════════════════════════════════════════════════════════════════
+ *
+ * Holds one TCP stream to the aggregator on Octavia (tools/aggregator),
+ * which polls mesh / CRM / HF once for every device and pushes binary
+ * snapshots (lib/SnapshotProtocol) whenever something changes.
+ *
+ * - Frames are read into an aligned buffer and applied in place: no JSON
+ *   parse, no DynamicJsonDocument, no String churn per field
+ * - Only the sections in a frame are applied; a fresh connection always
+ *   starts with a full snapshot, so nothing is missed across drops
+ * - While the feed is up, the 5-minute full reload becomes a safety net
+ *   (snapshotFeedActive), same as with the live WS/SSE streams
+ * - Connect runs on a fetch engine task; loop() only reads bytes that
+ *   have already arrived (snapshotClientTick)
+ *
+ * Serial "SNAPBENCH" compares decode+apply against JsonWriter +
+ * ArduinoJson on the same data (snapshotLoopbackBenchmark).
+ */
+
+// ─────────────────────────────────────────────────────────────────────
+// SNAPSHOT CONFIGURATION
+// ─────────────────────────────────────────────────────────────────────
+
+#define SNAP_CONNECT_TIMEOUT_MS 3000
+#define SNAP_IDLE_TIMEOUT_MS 45000       // 3 missed aggregator keepalives
+#define SNAP_BACKOFF_MIN_MS 2000
+#define SNAP_BACKOFF_MAX_MS 60000
+#define SNAP_BYTES_PER_TICK 1024         // Bound the time spent in loop()
+
+// ─────────────────────────────────────────────────────────────────────
+// STATE
+// ─────────────────────────────────────────────────────────────────────
+
+enum SnapFeedState {
+  SNAP_FEED_DISCONNECTED,
+  SNAP_FEED_CONNECTING,  // Connect job in flight
+  SNAP_FEED_OPEN
+};
+
+struct SnapFeed {
+  WiFiClient client;
+  volatile SnapFeedState state;
+  FetchJob connectJob;
+  unsigned long backoffMs;
+  unsigned long nextAttemptAt;
+  unsigned long lastRxAt;
+
+  // Frame being assembled
+  size_t have;
+  size_t need;                   // Header size, then the full frame size
+
+  // Stats
+  bool haveSeq;
+  uint32_t lastSeq;
+  uint32_t frames;
+  uint32_t rejected;
+  uint32_t gaps;
+  uint32_t connects;
+  uint32_t bytes;
+  uint32_t applyUs;              // Last frame
+};
+
+SnapFeed snapFeed;
+alignas(4) uint8_t snapFrameBuf[SNAP_FRAME_MAX];
+
+// ─────────────────────────────────────────────────────────────────────
+// APPLY
+// ─────────────────────────────────────────────────────────────────────
+
+// Copy the sections present in the frame into the dashboard globals
+void snapshotApply(const SnapView& view) {
+  char text[33];
+
+  if (view.nav) {
+    navState.activeNodes = view.nav->activeNodes;
+    navState.hotLeads = view.nav->hotLeads;
+    navState.aiRequests = view.nav->aiRequests;
+    navState.meshHealthy = view.nav->meshHealthy;
+    navState.crmHealthy = view.nav->crmHealthy;
+    navState.aiHealthy = view.nav->aiHealthy;
+    navState.lastUpdate = millis() - view.nav->ageMs;
+  }
+
+  if (view.crm) {
+    crmMetrics.totalContacts = view.crm->totalContacts;
+    crmMetrics.hotLeads = view.crm->hotLeads;
+    crmMetrics.openDeals = view.crm->openDeals;
+    crmMetrics.pipelineValue = view.crm->pipelineValue;
+    crmMetrics.activity24h = view.crm->activity24h;
+    crmMetrics.topLeadScore = view.crm->topLeadScore;
+    SNAP_COPY(text, view.crm->topLead);
+    if (crmMetrics.topLead != text) crmMetrics.topLead = text;
+  }
+
+  if (view.ai) {
+    SNAP_COPY(text, view.ai->modelName);
+    if (aiMetrics.modelName != text) aiMetrics.modelName = text;
+    SNAP_COPY(text, view.ai->status);
+    if (aiMetrics.status != text) aiMetrics.status = text;
+    SNAP_COPY(text, view.ai->lastInference);
+    if (aiMetrics.lastInference != text) aiMetrics.lastInference = text;
+    aiMetrics.requestsToday = view.ai->requestsToday;
+    aiMetrics.avgLatency = view.ai->avgLatency;
+    aiMetrics.tokensGenerated = view.ai->tokensGenerated;
+    aiMetrics.gpuUtil = view.ai->gpuUtil;
+  }
+
+  if (view.leads) {
+    hotLeadCount = min((int)view.leads->count, SNAP_MAX_LEADS);
+    for (int i = 0; i < hotLeadCount; i++) {
+      const SnapLead* src = snapLead(view.leads, i);
+      HotLead* dst = &hotLeads[i];
+      SNAP_COPY(dst->name, src->name);
+      SNAP_COPY(dst->company, src->company);
+      SNAP_COPY(dst->email, src->email);
+      SNAP_COPY(dst->temperature, src->temperature);
+      SNAP_COPY(dst->lastActivity, src->lastActivity);
+      SNAP_COPY(dst->stage, src->stage);
+      dst->score = src->score;
+      dst->opens = src->opens;
+      dst->clicks = src->clicks;
+      dst->hasReplied = src->hasReplied;
+    }
+  }
+
+  if (view.nav) updateStackHealth();
+}
+
+// ─────────────────────────────────────────────────────────────────────
+// CONNECTION
+// ─────────────────────────────────────────────────────────────────────
+
+bool snapConnectJob(void* arg) {
+  SnapFeed* f = (SnapFeed*)arg;
+  f->client.stop();
+  if (!f->client.connect(SNAP_AGGREGATOR_HOST, SNAP_AGGREGATOR_PORT, SNAP_CONNECT_TIMEOUT_MS)) return false;
+  f->client.setNoDelay(true);
+  return true;
+}
+
+void snapDisconnect(SnapFeed* f, const char* why) {
+  f->client.stop();
+  f->state = SNAP_FEED_DISCONNECTED;
+
+  unsigned long jitter = random(f->backoffMs / 4 + 1);
+  f->nextAttemptAt = millis() + f->backoffMs + jitter;
+  f->backoffMs = min(f->backoffMs * 2, (unsigned long)SNAP_BACKOFF_MAX_MS);
+
+  Serial.printf("🔌 Snapshot feed: %s, retry in %lus\n", why, (f->nextAttemptAt - millis()) / 1000);
+}
+
+// A whole frame is in snapFrameBuf
+void snapFrameComplete(SnapFeed* f) {
+  unsigned long startUs = micros();
+  SnapView view;
+  SnapResult res = snapParse(snapFrameBuf, f->have, &view);
+  if (res != SNAP_OK) {
+    f->rejected++;
+    Serial.printf("⚠️  Snapshot frame rejected (%d)\n", res);
+    return;
+  }
+
+  uint32_t seq = view.header->seq;
+  if (f->haveSeq && seq != f->lastSeq + 1) f->gaps++;  // Aggregator restarted
+  f->haveSeq = true;
+  f->lastSeq = seq;
+  f->frames++;
+
+  if (view.header->sectionCount > 0) snapshotApply(view);
+  f->applyUs = micros() - startUs;
+}
+
+// ─────────────────────────────────────────────────────────────────────
+// PUBLIC API
+// ─────────────────────────────────────────────────────────────────────
+
+void initSnapshotClient() {
+  SnapFeed* f = &snapFeed;
+  f->state = SNAP_FEED_DISCONNECTED;
+  f->backoffMs = SNAP_BACKOFF_MIN_MS;
+  f->nextAttemptAt = 0;
+  f->connectJob.name = "Snapshot";
+  f->connectJob.fn = snapConnectJob;
+  f->connectJob.arg = f;
+  f->connectJob.state = FETCH_IDLE;
+}
+
+// Call every loop(). Reads only what has already arrived.
+void snapshotClientTick() {
+  SnapFeed* f = &snapFeed;
+  unsigned long now = millis();
+
+  switch (f->state) {
+    case SNAP_FEED_DISCONNECTED:
+      if (WiFi.status() != WL_CONNECTED) break;
+      if ((long)(now - f->nextAttemptAt) < 0) break;
+      if (f->connectJob.state != FETCH_IDLE) break;
+      f->state = SNAP_FEED_CONNECTING;
+      startFetchJob(&f->connectJob);
+      break;
+
+    case SNAP_FEED_CONNECTING:
+      if (f->connectJob.state != FETCH_DONE) break;
+      f->connectJob.state = FETCH_IDLE;
+      if (!f->connectJob.result) {
+        snapDisconnect(f, "connect failed");
+        break;
+      }
+      f->state = SNAP_FEED_OPEN;
+      f->backoffMs = SNAP_BACKOFF_MIN_MS;
+      f->lastRxAt = now;
+      f->have = 0;
+      f->need = sizeof(SnapFrameHeader);
+      f->haveSeq = false;
+      f->connects++;
+      Serial.printf("⚡ Snapshot feed live (%s:%d)\n", SNAP_AGGREGATOR_HOST, SNAP_AGGREGATOR_PORT);
+      break;
+
+    case SNAP_FEED_OPEN: {
+      int budget = SNAP_BYTES_PER_TICK;
+      while (budget > 0 && f->client.available() > 0) {
+        int n = f->client.read(snapFrameBuf + f->have, min((size_t)budget, f->need - f->have));
+        if (n <= 0) break;
+        budget -= n;
+        f->have += n;
+        f->bytes += n;
+        f->lastRxAt = now;
+        if (f->have < f->need) continue;
+
+        if (f->need == sizeof(SnapFrameHeader)) {
+          // Header in - now we know the frame size
+          f->need = snapFrameSize((const SnapFrameHeader*)snapFrameBuf, sizeof(snapFrameBuf));
+          if (f->need == 0) {
+            f->rejected++;
+            snapDisconnect(f, "bad frame header");  // Can't resync a byte stream
+            return;
+          }
+          if (f->need > f->have) continue;
+        }
+        snapFrameComplete(f);
+        f->have = 0;
+        f->need = sizeof(SnapFrameHeader);
+      }
+
+      if (!f->client.connected() && f->client.available() == 0) {
+        snapDisconnect(f, "connection lost");
+      } else if (now - f->lastRxAt > SNAP_IDLE_TIMEOUT_MS) {
+        snapDisconnect(f, "idle timeout");
+      }
+      break;
+    }
+  }
+}
+
+// True while the aggregator is pushing snapshots
+bool snapshotFeedActive() {
+  return snapFeed.state == SNAP_FEED_OPEN && snapFeed.frames > 0;
+}
+
+// ─────────────────────────────────────────────────────────────────────
+// BENCHMARK
+// ─────────────────────────────────────────────────────────────────────
+
+// Encode the current dashboard state as a full snapshot
+size_t snapshotEncodeCurrent(uint8_t* buf, size_t cap, uint32_t seq) {
+  SnapWriter w(buf, cap);
+  w.begin(seq);
+
+  SnapNav* nav = w.add<SnapNav>(SNAP_SECTION_NAV);
+  if (nav) {
+    nav->activeNodes = navState.activeNodes;
+    nav->hotLeads = navState.hotLeads;
+    nav->aiRequests = navState.aiRequests;
+    nav->meshHealthy = navState.meshHealthy;
+    nav->crmHealthy = navState.crmHealthy;
+    nav->aiHealthy = navState.aiHealthy;
+    nav->ageMs = millis() - navState.lastUpdate;
+  }
+
+  SnapCrm* crm = w.add<SnapCrm>(SNAP_SECTION_CRM);
+  if (crm) {
+    crm->totalContacts = crmMetrics.totalContacts;
+    crm->hotLeads = crmMetrics.hotLeads;
+    crm->openDeals = crmMetrics.openDeals;
+    crm->pipelineValue = crmMetrics.pipelineValue;
+    crm->activity24h = crmMetrics.activity24h;
+    crm->topLeadScore = crmMetrics.topLeadScore;
+    SNAP_SET(crm->topLead, crmMetrics.topLead.c_str());
+  }
+
+  SnapAi* ai = w.add<SnapAi>(SNAP_SECTION_AI);
+  if (ai) {
+    SNAP_SET(ai->modelName, aiMetrics.modelName.c_str());
+    SNAP_SET(ai->status, aiMetrics.status.c_str());
+    SNAP_SET(ai->lastInference, aiMetrics.lastInference.c_str());
+    ai->requestsToday = aiMetrics.requestsToday;
+    ai->avgLatency = aiMetrics.avgLatency;
+    ai->tokensGenerated = aiMetrics.tokensGenerated;
+    ai->gpuUtil = aiMetrics.gpuUtil;
+  }
+
+  SnapLead* leads = w.addLeads(hotLeadCount);
+  for (int i = 0; leads && i < hotLeadCount; i++) {
+    memcpy(leads[i].name, hotLeads[i].name, sizeof(leads[i].name));
+    memcpy(leads[i].company, hotLeads[i].company, sizeof(leads[i].company));
+    memcpy(leads[i].email, hotLeads[i].email, sizeof(leads[i].email));
+    memcpy(leads[i].temperature, hotLeads[i].temperature, sizeof(leads[i].temperature));
+    memcpy(leads[i].lastActivity, hotLeads[i].lastActivity, sizeof(leads[i].lastActivity));
+    memcpy(leads[i].stage, hotLeads[i].stage, sizeof(leads[i].stage));
+    leads[i].score = hotLeads[i].score;
+    leads[i].opens = hotLeads[i].opens;
+    leads[i].clicks = hotLeads[i].clicks;
+    leads[i].hasReplied = hotLeads[i].hasReplied;
+  }
+  return w.finish();
+}
+
+// The same state as JSON, shaped like the upstream responses
+size_t snapshotEncodeJson(char* buf, size_t cap) {
+  JsonWriter w(buf, cap);
+  w.beginObject();
+  w.objectField("nav");
+  w.field("activeNodes", navState.activeNodes);
+  w.field("hotLeads", navState.hotLeads);
+  w.field("aiRequests", navState.aiRequests);
+  w.field("meshHealthy", navState.meshHealthy);
+  w.field("crmHealthy", navState.crmHealthy);
+  w.field("aiHealthy", navState.aiHealthy);
+  w.endObject();
+  w.objectField("crm");
+  w.field("total_contacts", crmMetrics.totalContacts);
+  w.field("hot_leads", crmMetrics.hotLeads);
+  w.field("open_deals", crmMetrics.openDeals);
+  w.field("pipeline_value", (double)crmMetrics.pipelineValue, 2);
+  w.field("activity_24h", crmMetrics.activity24h);
+  w.field("top_lead", crmMetrics.topLead.c_str());
+  w.endObject();
+  w.objectField("ai");
+  w.field("model", aiMetrics.modelName.c_str());
+  w.field("status", aiMetrics.status.c_str());
+  w.field("requests_today", aiMetrics.requestsToday);
+  w.field("avg_latency", (double)aiMetrics.avgLatency, 1);
+  w.field("tokens_generated", aiMetrics.tokensGenerated);
+  w.field("gpu_util", (double)aiMetrics.gpuUtil, 1);
+  w.field("last_inference", aiMetrics.lastInference.c_str());
+  w.endObject();
+  w.arrayField("contacts");
+  for (int i = 0; i < hotLeadCount; i++) {
+    w.beginObject();
+    w.field("name", hotLeads[i].name);
+    w.field("company", hotLeads[i].company);
+    w.field("email", hotLeads[i].email);
+    w.field("lead_score", hotLeads[i].score);
+    w.field("temperature", hotLeads[i].temperature);
+    w.field("email_opens", hotLeads[i].opens);
+    w.field("email_clicks", hotLeads[i].clicks);
+    w.field("stage", hotLeads[i].stage);
+    w.field("has_replied", hotLeads[i].hasReplied);
+    w.endObject();
+  }
+  w.endArray();
+  w.endObject();
+  return w.complete() ? w.length() : 0;
+}
+
+// Encode -> decode -> apply the current state in memory, binary vs JSON
+void snapshotLoopbackBenchmark(int iterations) {
+  alignas(4) static uint8_t frame[SNAP_FRAME_MAX];
+  static char json[2048];
+
+  Serial.println("\n━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━");
+  Serial.printf("⏱️  SNAPSHOT BENCHMARK (%d iterations)\n", iterations);
+  Serial.println("━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━");
+
+  // Binary
+  size_t frameLen = 0;
+  unsigned long startUs = micros();
+  for (int i = 0; i < iterations; i++) frameLen = snapshotEncodeCurrent(frame, sizeof(frame), i);
+  unsigned long encodeUs = micros() - startUs;
+
+  int bad = 0;
+  startUs = micros();
+  for (int i = 0; i < iterations; i++) {
+    SnapView view;
+    if (snapParse(frame, frameLen, &view) != SNAP_OK) bad++;
+    else snapshotApply(view);
+  }
+  unsigned long decodeUs = micros() - startUs;
+
+  // JSON with the same content, parsed the way dynamic_nav.h does
+  size_t jsonLen = 0;
+  startUs = micros();
+  for (int i = 0; i < iterations; i++) jsonLen = snapshotEncodeJson(json, sizeof(json));
+  unsigned long jsonEncodeUs = micros() - startUs;
+
+  uint32_t heapBefore = ESP.getFreeHeap();
+  uint32_t heapLow = heapBefore;
+  startUs = micros();
+  for (int i = 0; i < iterations; i++) {
+    DynamicJsonDocument doc(4096);
+    if (deserializeJson(doc, json, jsonLen)) bad++;
+    heapLow = min(heapLow, ESP.getFreeHeap());
+  }
+  unsigned long jsonDecodeUs = micros() - startUs;
+
+  Serial.printf("Size:     %u bytes binary, %u bytes JSON\n", (unsigned)frameLen, (unsigned)jsonLen);
+  Serial.printf("Encode:   %lu us binary, %lu us JSON\n", encodeUs / iterations, jsonEncodeUs / iterations);
+  Serial.printf("Decode:   %lu us binary (+apply), %lu us JSON (parse only)\n",
+    decodeUs / iterations, jsonDecodeUs / iterations);
+  Serial.printf("Heap:     0 bytes binary, %u bytes JSON\n", heapBefore - heapLow);
+  Serial.printf("Feed:     %s, %u frames, %u rejected, %u gaps, last apply %u us\n",
+    snapshotFeedActive() ? "LIVE" : "off", snapFeed.frames, snapFeed.rejected, snapFeed.gaps, snapFeed.applyUs);
+  if (bad) Serial.printf("⚠️  %d iterations failed\n", bad);
+  Serial.println("━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━\n");
+}
+
+#endif // SNAPSHOT_CLIENT_H
@@ -0,0 +1,363 @@
+#ifndef TLS_SESSION_CACHE_H
+#define TLS_SESSION_CACHE_H
+
+#include <WiFi.h>
+#include <WiFiClientSecure.h>
+#include <lwip/sockets.h>
+#include <mbedtls/version.h>
+#include <mbedtls/ssl.h>
+#include <mbedtls/platform.h>
+#include <mbedtls/net_sockets.h>
+#include <mbedtls/entropy.h>
+#include <mbedtls/ctr_drbg.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+
+/*
+ * ═══════════════════════════════════════════════════════════════════════
+ * BLACKROAD TLS SESSION RESUMPTION CACHE
+ * ═══════════════════════════════════════════════════════════════════════
+ *
+ * Caches one TLS session (ID or ticket) per host:port so reconnects to
+ * crm.blackroad.io, HF, GitHub, Stripe, Linear and CoinGecko can skip the
+ * full handshake (ECDHE + certificate parse = hundreds of ms of CPU and a
+ * large transient heap spike).
+ *
+ * ResumableClientSecure is a drop-in WiFiClientSecure whose connect()
+ * offers the cached session before the handshake. The stock client has no
+ * hook between mbedtls_ssl_setup() and mbedtls_ssl_handshake(), so the
+ * handshake is driven here. Like the rest of the firmware it does not
+ * verify certificates (no CA bundle on device).
+ *
+ * Builds against mbedTLS 2.x (arduino-esp32 2.x) and 3.x (3.x cores),
+ * where the session fields read here became private.
+ */
+
+// ─────────────────────────────────────────────────────────────────────
+// CACHE CONFIGURATION
+// ─────────────────────────────────────────────────────────────────────
+
+#define TLS_SESSION_CACHE_SIZE 6         // CRM, HF, GitHub, Stripe, Linear, CoinGecko
+#define TLS_SESSION_TTL_MS 3600000       // Servers rarely honor tickets past 1h
+#define TLS_HANDSHAKE_TIMEOUT_MS 10000
+
+// mbedtls_ssl_session members (master, peer_cert) are private from 3.0
+#if MBEDTLS_VERSION_NUMBER >= 0x03000000
+#define TLS_SESSION_FIELD(s, f) ((s).MBEDTLS_PRIVATE(f))
+#else
+#define TLS_SESSION_FIELD(s, f) ((s).f)
+#endif
+#define TLS_MASTER_LEN 48
+
+// ─────────────────────────────────────────────────────────────────────
+// DATA STRUCTURES
+// ─────────────────────────────────────────────────────────────────────
+
+struct TlsSessionEntry {
+  char host[64];
+  uint16_t port;
+  bool valid;
+  mbedtls_ssl_session session;
+  unsigned long savedAt;
+};
+
+struct TlsHandshakeStats {
+  uint32_t fullHandshakes;
+  uint32_t resumedHandshakes;
+  uint32_t failedHandshakes;
+  uint32_t fullTimeTotalMs;
+  uint32_t resumedTimeTotalMs;
+};
+
+TlsSessionEntry tlsSessionCache[TLS_SESSION_CACHE_SIZE];
+TlsHandshakeStats tlsStats = {0, 0, 0, 0, 0};
+SemaphoreHandle_t tlsCacheMutex = NULL;
+
+// ─────────────────────────────────────────────────────────────────────
+// CACHE OPERATIONS
+// ─────────────────────────────────────────────────────────────────────
+
+void tlsCacheLock() {
+  if (tlsCacheMutex == NULL) {
+    tlsCacheMutex = xSemaphoreCreateMutex();
+  }
+  xSemaphoreTake(tlsCacheMutex, portMAX_DELAY);
+}
+
+void tlsCacheUnlock() {
+  xSemaphoreGive(tlsCacheMutex);
+}
+
+// Caller holds the lock
+TlsSessionEntry* tlsCacheFind(const char* host, uint16_t port) {
+  for (int i = 0; i < TLS_SESSION_CACHE_SIZE; i++) {
+    TlsSessionEntry* e = &tlsSessionCache[i];
+    if (e->valid && e->port == port && strcmp(e->host, host) == 0) {
+      if (millis() - e->savedAt > TLS_SESSION_TTL_MS) {
+        mbedtls_ssl_session_free(&e->session);
+        e->valid = false;
+        return NULL;
+      }
+      return e;
+    }
+  }
+  return NULL;
+}
+
+// Offer the cached session for host:port. Copies the master secret out so
+// the caller can tell afterwards whether the server accepted it.
+bool tlsCacheOffer(const char* host, uint16_t port, mbedtls_ssl_context* ssl, unsigned char* masterOut) {
+  bool offered = false;
+
+  tlsCacheLock();
+  TlsSessionEntry* e = tlsCacheFind(host, port);
+  if (e && mbedtls_ssl_set_session(ssl, &e->session) == 0) {
+    memcpy(masterOut, TLS_SESSION_FIELD(e->session, master), TLS_MASTER_LEN);
+    offered = true;
+  }
+  tlsCacheUnlock();
+
+  return offered;
+}
+
+void tlsCacheForget(const char* host, uint16_t port) {
+  tlsCacheLock();
+  TlsSessionEntry* e = tlsCacheFind(host, port);
+  if (e) {
+    mbedtls_ssl_session_free(&e->session);
+    e->valid = false;
+  }
+  tlsCacheUnlock();
+}
+
+// Save the session negotiated on ssl for the next connect to host:port.
+// True when it carries offeredMaster (NULL: nothing offered) - the server
+// resumed instead of running a full handshake.
+bool tlsCacheStore(const char* host, uint16_t port, const mbedtls_ssl_context* ssl,
+                   const unsigned char* offeredMaster) {
+  bool resumed = false;
+  tlsCacheLock();
+
+  TlsSessionEntry* e = tlsCacheFind(host, port);
+  if (!e) {
+    // Free slot, else replace the oldest entry
+    for (int i = 0; i < TLS_SESSION_CACHE_SIZE; i++) {
+      if (!tlsSessionCache[i].valid) { e = &tlsSessionCache[i]; break; }
+      if (!e || tlsSessionCache[i].savedAt < e->savedAt) e = &tlsSessionCache[i];
+    }
+  }
+
+  if (e->valid) {
+    mbedtls_ssl_session_free(&e->session);
+    e->valid = false;
+  }
+
+  mbedtls_ssl_session_init(&e->session);
+  if (mbedtls_ssl_get_session(ssl, &e->session) == 0) {
+    resumed = offeredMaster &&
+              memcmp(TLS_SESSION_FIELD(e->session, master), offeredMaster, TLS_MASTER_LEN) == 0;
+  #if defined(MBEDTLS_X509_CRT_PARSE_C) && defined(MBEDTLS_SSL_KEEP_PEER_CERTIFICATE)
+    // Resumption only needs the master secret / ticket - drop the
+    // multi-KB peer certificate copy to keep the cache small
+    mbedtls_x509_crt*& peerCert = TLS_SESSION_FIELD(e->session, peer_cert);
+    if (peerCert) {
+      mbedtls_x509_crt_free(peerCert);
+      mbedtls_free(peerCert);
+      peerCert = NULL;
+    }
+  #endif
+    strncpy(e->host, host, sizeof(e->host) - 1);
+    e->host[sizeof(e->host) - 1] = '\0';
+    e->port = port;
+    e->savedAt = millis();
+    e->valid = true;
+  } else {
+    mbedtls_ssl_session_free(&e->session);
+  }
+
+  tlsCacheUnlock();
+  return resumed;
+}
+
+void tlsCacheClear() {
+  tlsCacheLock();
+  for (int i = 0; i < TLS_SESSION_CACHE_SIZE; i++) {
+    if (tlsSessionCache[i].valid) {
+      mbedtls_ssl_session_free(&tlsSessionCache[i].session);
+      tlsSessionCache[i].valid = false;
+    }
+  }
+  tlsCacheUnlock();
+}
+
+// ─────────────────────────────────────────────────────────────────────
+// NON-BLOCKING TCP CONNECT
+// ─────────────────────────────────────────────────────────────────────
+
+// Returns a connected blocking socket, or -1
+int tcpConnectWithTimeout(IPAddress ip, uint16_t port, int32_t timeoutMs) {
+  int sock = lwip_socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+  if (sock < 0) return -1;
+
+  struct sockaddr_in addr;
+  memset(&addr, 0, sizeof(addr));
+  addr.sin_family = AF_INET;
+  addr.sin_addr.s_addr = (uint32_t)ip;
+  addr.sin_port = htons(port);
+
+  int flags = fcntl(sock, F_GETFL, 0);
+  fcntl(sock, F_SETFL, flags | O_NONBLOCK);
+
+  int res = lwip_connect(sock, (struct sockaddr*)&addr, sizeof(addr));
+  if (res < 0 && errno != EINPROGRESS) {
+    lwip_close(sock);
+    return -1;
+  }
+
+  fd_set writeSet;
+  FD_ZERO(&writeSet);
+  FD_SET(sock, &writeSet);
+  struct timeval tv;
+  tv.tv_sec = timeoutMs / 1000;
+  tv.tv_usec = (timeoutMs % 1000) * 1000;
+
+  res = select(sock + 1, NULL, &writeSet, NULL, &tv);
+  int sockErr = 0;
+  socklen_t errLen = sizeof(sockErr);
+  if (res <= 0 || getsockopt(sock, SOL_SOCKET, SO_ERROR, &sockErr, &errLen) < 0 || sockErr != 0) {
+    lwip_close(sock);
+    return -1;
+  }
+
+  fcntl(sock, F_SETFL, flags & ~O_NONBLOCK);
+
+  tv.tv_sec = timeoutMs / 1000;
+  tv.tv_usec = (timeoutMs % 1000) * 1000;
+  setsockopt(sock, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+  setsockopt(sock, SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof(tv));
+
+  return sock;
+}
+
+// ─────────────────────────────────────────────────────────────────────
+// RESUMABLE TLS CLIENT
+// ─────────────────────────────────────────────────────────────────────
+
+class ResumableClientSecure : public WiFiClientSecure {
+public:
+  using WiFiClientSecure::connect;
+
+  int connect(const char* host, uint16_t port) override {
+    return connect(host, port, TLS_HANDSHAKE_TIMEOUT_MS);
+  }
+
+  int connect(const char* host, uint16_t port, int32_t timeout) override {
+    IPAddress ip;
+    if (!WiFi.hostByName(host, ip)) return 0;
+
+    unsigned long start = millis();
+
+    stop();               // Release any previous socket + mbedtls state
+    ssl_init(sslclient);  // Fresh mbedtls contexts
+    sslclient->socket = tcpConnectWithTimeout(ip, port, timeout);
+    if (sslclient->socket < 0) {
+      stop();
+      return 0;
+    }
+
+    unsigned char offeredMaster[TLS_MASTER_LEN];
+    bool offered = false;
+
+    const char* pers = "blackroad-tls";
+    mbedtls_entropy_init(&sslclient->entropy_ctx);
+    int ret = mbedtls_ctr_drbg_seed(&sslclient->drbg_ctx, mbedtls_entropy_func,
+                                    &sslclient->entropy_ctx,
+                                    (const unsigned char*)pers, strlen(pers));
+    if (ret == 0) {
+      ret = mbedtls_ssl_config_defaults(&sslclient->ssl_conf, MBEDTLS_SSL_IS_CLIENT,
+                                        MBEDTLS_SSL_TRANSPORT_STREAM, MBEDTLS_SSL_PRESET_DEFAULT);
+    }
+    if (ret == 0) {
+      mbedtls_ssl_conf_authmode(&sslclient->ssl_conf, MBEDTLS_SSL_VERIFY_NONE);
+      mbedtls_ssl_conf_rng(&sslclient->ssl_conf, mbedtls_ctr_drbg_random, &sslclient->drbg_ctx);
+    #if defined(MBEDTLS_SSL_SESSION_TICKETS)
+      mbedtls_ssl_conf_session_tickets(&sslclient->ssl_conf, MBEDTLS_SSL_SESSION_TICKETS_ENABLED);
+    #endif
+      ret = mbedtls_ssl_setup(&sslclient->ssl_ctx, &sslclient->ssl_conf);
+    }
+    if (ret == 0) {
+      ret = mbedtls_ssl_set_hostname(&sslclient->ssl_ctx, host);
+    }
+    if (ret == 0) {
+      offered = tlsCacheOffer(host, port, &sslclient->ssl_ctx, offeredMaster);
+      mbedtls_ssl_set_bio(&sslclient->ssl_ctx, &sslclient->socket,
+                          mbedtls_net_send, mbedtls_net_recv, NULL);
+
+      while ((ret = mbedtls_ssl_handshake(&sslclient->ssl_ctx)) != 0) {
+        if (ret != MBEDTLS_ERR_SSL_WANT_READ && ret != MBEDTLS_ERR_SSL_WANT_WRITE) break;
+        if (millis() - start > TLS_HANDSHAKE_TIMEOUT_MS) break;
+        vTaskDelay(2);
+      }
+    }
+
+    if (ret != 0) {
+      tlsCacheLock();
+      tlsStats.failedHandshakes++;
+      tlsCacheUnlock();
+      if (offered) tlsCacheForget(host, port);  // Bad ticket - start over next time
+      stop();
+      return 0;
+    }
+    uint32_t elapsed = millis() - start;
+
+    // Always re-save: servers may rotate the ticket on resumption. Same
+    // master secret as the offered session = abbreviated handshake.
+    bool resumed = tlsCacheStore(host, port, &sslclient->ssl_ctx, offered ? offeredMaster : NULL);
+
+    tlsCacheLock();
+    if (resumed) {
+      tlsStats.resumedHandshakes++;
+      tlsStats.resumedTimeTotalMs += elapsed;
+    } else {
+      tlsStats.fullHandshakes++;
+      tlsStats.fullTimeTotalMs += elapsed;
+    }
+    tlsCacheUnlock();
+
+    _connected = true;
+    return 1;
+  }
+};
+
+// ─────────────────────────────────────────────────────────────────────
+// METRICS
+// ─────────────────────────────────────────────────────────────────────
+
+// Counters are bumped from several fetch tasks - read a consistent copy
+TlsHandshakeStats getTlsStats() {
+  tlsCacheLock();
+  TlsHandshakeStats stats = tlsStats;
+  tlsCacheUnlock();
+  return stats;
+}
+
+uint8_t getTlsResumeRate() {
+  TlsHandshakeStats stats = getTlsStats();
+  uint32_t total = stats.fullHandshakes + stats.resumedHandshakes;
+  if (total == 0) return 0;
+  return (stats.resumedHandshakes * 100) / total;
+}
+
+uint32_t getTlsAvgFullHandshakeMs() {
+  TlsHandshakeStats stats = getTlsStats();
+  if (stats.fullHandshakes == 0) return 0;
+  return stats.fullTimeTotalMs / stats.fullHandshakes;
+}
+
+uint32_t getTlsAvgResumedHandshakeMs() {
+  TlsHandshakeStats stats = getTlsStats();
+  if (stats.resumedHandshakes == 0) return 0;
+  return stats.resumedTimeTotalMs / stats.resumedHandshakes;
+}
+
+#endif // TLS_SESSION_CACHE_H
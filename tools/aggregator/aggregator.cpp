@@ -0,0 +1,769 @@
+/*
+ * ═══════════════════════════════════════════════════════════════════════
+ * BLACKROAD SNAPSHOT AGGREGATOR
+ * ═══════════════════════════════════════════════════════════════════════
+ *
+ * Polls the upstream APIs once (mesh status, CRM stats + hot leads, HF
+ * health) and pushes binary snapshots (lib/SnapshotProtocol) to every
+ * connected device, instead of N devices each polling and parsing JSON.
+ *
+ * - Devices connect over TCP (default port 7420) and get a full snapshot
+ *   right away, then only the sections that changed after each poll
+ * - An empty frame every KEEPALIVE_SEC keeps idle links honest
+ * - An upstream that fails keeps its last values, with its health flag
+ *   cleared - the same thing a device shows when its own fetch fails
+ *
+ * Build:   make            (needs libcurl)
+ * Run:     CRM_SECRET=... ./aggregator [--port 7420] [--interval 30]
+ *            [--mesh URL] [--crm URL] [--hf URL]
+ * Once:    ./aggregator --once      poll, print the snapshot, exit
+ * Bench:   ./aggregator --bench [N] encode / decode / JSON / loopback TCP
+ */
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <signal.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <curl/curl.h>
+
+#include "SnapshotProtocol.h"
+#include "json_lite.h"
+
+// ─────────────────────────────────────────────────────────────────────
+// CONFIGURATION
+// ─────────────────────────────────────────────────────────────────────
+
+#define DEFAULT_MESH_URL "http://lucidia.blackroad.network:8080/mesh/status"
+#define DEFAULT_CRM_URL "https://crm.blackroad.io/api"
+#define DEFAULT_HF_URL "https://hf.blackroad.io"
+
+#define POLL_INTERVAL_SEC 30
+#define KEEPALIVE_SEC 15
+#define UPSTREAM_TIMEOUT_MS 5000
+#define SEND_TIMEOUT_SEC 2
+
+struct Config {
+  int port = SNAP_PORT;
+  int intervalSec = POLL_INTERVAL_SEC;
+  std::string meshUrl = DEFAULT_MESH_URL;
+  std::string crmUrl = DEFAULT_CRM_URL;
+  std::string hfUrl = DEFAULT_HF_URL;
+  std::string crmSecret;
+};
+
+using Clock = std::chrono::steady_clock;
+
+static uint64_t nowUs() {
+  return std::chrono::duration_cast<std::chrono::microseconds>(Clock::now().time_since_epoch()).count();
+}
+
+// ─────────────────────────────────────────────────────────────────────
+// SNAPSHOT STATE
+// ─────────────────────────────────────────────────────────────────────
+
+struct Snapshot {
+  SnapNav nav;
+  SnapCrm crm;
+  SnapAi ai;
+  std::vector<SnapLead> leads;
+  uint64_t polledAtUs = 0;
+
+  Snapshot() {
+    memset(&nav, 0, sizeof(nav));
+    memset(&crm, 0, sizeof(crm));
+    memset(&ai, 0, sizeof(ai));
+  }
+};
+
+enum SectionMask {
+  MASK_NAV = 1 << 0,
+  MASK_CRM = 1 << 1,
+  MASK_AI = 1 << 2,
+  MASK_LEADS = 1 << 3,
+  MASK_ALL = 0x0F
+};
+
+// Encode the sections in `mask`. Returns the frame size (0 on overflow).
+static size_t encodeSnapshot(const Snapshot& snap, unsigned mask, uint32_t seq, uint8_t* buf, size_t cap) {
+  SnapWriter w(buf, cap);
+  w.begin(seq);
+  if (mask & MASK_NAV) {
+    SnapNav* nav = w.add<SnapNav>(SNAP_SECTION_NAV);
+    if (nav) {
+      *nav = snap.nav;
+      nav->ageMs = snap.polledAtUs ? (uint32_t)((nowUs() - snap.polledAtUs) / 1000) : 0;
+    }
+  }
+  if (mask & MASK_CRM) {
+    SnapCrm* crm = w.add<SnapCrm>(SNAP_SECTION_CRM);
+    if (crm) *crm = snap.crm;
+  }
+  if (mask & MASK_AI) {
+    SnapAi* ai = w.add<SnapAi>(SNAP_SECTION_AI);
+    if (ai) *ai = snap.ai;
+  }
+  if (mask & MASK_LEADS) {
+    SnapLead* leads = w.addLeads(snap.leads.size());
+    if (leads && !snap.leads.empty()) memcpy(leads, snap.leads.data(), snap.leads.size() * sizeof(SnapLead));
+  }
+  return w.finish();
+}
+
+// Sections whose content differs (nav age doesn't count as a change)
+static unsigned diffSnapshots(const Snapshot& a, const Snapshot& b) {
+  unsigned mask = 0;
+  SnapNav na = a.nav, nb = b.nav;
+  na.ageMs = nb.ageMs = 0;
+  if (memcmp(&na, &nb, sizeof(SnapNav)) != 0) mask |= MASK_NAV;
+  if (memcmp(&a.crm, &b.crm, sizeof(SnapCrm)) != 0) mask |= MASK_CRM;
+  if (memcmp(&a.ai, &b.ai, sizeof(SnapAi)) != 0) mask |= MASK_AI;
+  if (a.leads.size() != b.leads.size() ||
+      (!a.leads.empty() && memcmp(a.leads.data(), b.leads.data(), a.leads.size() * sizeof(SnapLead)) != 0)) {
+    mask |= MASK_LEADS;
+  }
+  return mask;
+}
+
+// ─────────────────────────────────────────────────────────────────────
+// UPSTREAM POLLING
+// ─────────────────────────────────────────────────────────────────────
+
+static size_t curlWrite(char* data, size_t size, size_t n, void* user) {
+  ((std::string*)user)->append(data, size * n);
+  return size * n;
+}
+
+// One keep-alive handle per upstream host; gzip accepted
+class Upstream {
+public:
+  explicit Upstream(const char* name) : _name(name), _curl(curl_easy_init()) {}
+  ~Upstream() { curl_easy_cleanup(_curl); }
+
+  bool getJson(const std::string& url, const std::string& bearer, JsonLite::Value& doc) {
+    std::string body;
+    struct curl_slist* headers = NULL;
+    if (!bearer.empty()) headers = curl_slist_append(headers, ("Authorization: Bearer " + bearer).c_str());
+    headers = curl_slist_append(headers, "User-Agent: BlackRoad-Aggregator/1.0");
+
+    curl_easy_setopt(_curl, CURLOPT_URL, url.c_str());
+    curl_easy_setopt(_curl, CURLOPT_HTTPHEADER, headers);
+    curl_easy_setopt(_curl, CURLOPT_ACCEPT_ENCODING, "");
+    curl_easy_setopt(_curl, CURLOPT_TIMEOUT_MS, (long)UPSTREAM_TIMEOUT_MS);
+    curl_easy_setopt(_curl, CURLOPT_NOSIGNAL, 1L);
+    curl_easy_setopt(_curl, CURLOPT_WRITEFUNCTION, curlWrite);
+    curl_easy_setopt(_curl, CURLOPT_WRITEDATA, &body);
+
+    CURLcode res = curl_easy_perform(_curl);
+    long code = 0;
+    curl_easy_getinfo(_curl, CURLINFO_RESPONSE_CODE, &code);
+    curl_slist_free_all(headers);
+
+    if (res != CURLE_OK || code != 200) {
+      printf("  ⚠️  %s: %s\n", _name, res != CURLE_OK ? curl_easy_strerror(res) : ("HTTP " + std::to_string(code)).c_str());
+      return false;
+    }
+    if (!JsonLite::parse(body, doc)) {
+      printf("  ⚠️  %s: bad JSON (%zu bytes)\n", _name, body.size());
+      return false;
+    }
+    return true;
+  }
+
+private:
+  const char* _name;
+  CURL* _curl;
+};
+
+struct Poller {
+  Config cfg;
+  Upstream mesh{"Mesh"};
+  Upstream crm{"CRM"};
+  Upstream hf{"HF"};
+
+  // Same fields and fallbacks as fetchMeshStatus() in dynamic_nav.h
+  void pollMesh(Snapshot& s) {
+    JsonLite::Value doc;
+    if (!mesh.getJson(cfg.meshUrl, "", doc)) {
+      s.nav.meshHealthy = 0;
+      return;
+    }
+    const JsonLite::Value& nodes = doc["nodes"];
+    s.nav.activeNodes = std::min<int>(nodes.items.size(), 4);  // Device keeps 4 nodes
+    s.nav.meshHealthy = 1;
+  }
+
+  void pollCrm(Snapshot& s) {
+    JsonLite::Value doc;
+    if (!crm.getJson(cfg.crmUrl + "/stats", cfg.crmSecret, doc)) {
+      s.nav.crmHealthy = 0;
+    } else {
+      s.crm.totalContacts = doc["total_contacts"].asInt();
+      s.crm.hotLeads = doc["hot_leads"].asInt();
+      s.crm.openDeals = doc["open_deals"].asInt();
+      s.crm.pipelineValue = (float)doc["pipeline_value"].asDouble();
+      s.crm.activity24h = doc["activity_24h"].asInt();
+      s.nav.hotLeads = s.crm.hotLeads;
+      s.nav.crmHealthy = 1;
+    }
+
+    JsonLite::Value leadsDoc;
+    if (!crm.getJson(cfg.crmUrl + "/views/hot-leads", cfg.crmSecret, leadsDoc)) return;
+
+    s.leads.clear();
+    for (const auto& contact : leadsDoc["contacts"].items) {
+      if (s.leads.size() >= SNAP_MAX_LEADS) break;
+      SnapLead lead;
+      memset(&lead, 0, sizeof(lead));
+      std::string name = std::string(contact["first_name"].asString()) + " " + contact["last_name"].asString();
+      SNAP_SET(lead.name, name.c_str());
+      SNAP_SET(lead.company, contact["company"].asString("Unknown"));
+      SNAP_SET(lead.email, contact["email"].asString());
+      lead.score = contact["lead_score"].asInt();
+      SNAP_SET(lead.temperature, contact["temperature"].asString("warm"));
+      lead.opens = contact["email_opens"].asInt();
+      lead.clicks = contact["email_clicks"].asInt();
+      SNAP_SET(lead.lastActivity, "Recent");
+      SNAP_SET(lead.stage, contact["stage"].asString("Aware"));
+      lead.hasReplied = contact["has_replied"].asBool();
+      s.leads.push_back(lead);
+    }
+
+    // Top lead = best score
+    const SnapLead* top = NULL;
+    for (const auto& lead : s.leads) {
+      if (!top || lead.score > top->score) top = &lead;
+    }
+    if (top) {
+      SNAP_SET(s.crm.topLead, top->name);
+      s.crm.topLeadScore = top->score;
+    }
+  }
+
+  // Same fields as fetchAIMetrics()
+  void pollAi(Snapshot& s) {
+    JsonLite::Value doc;
+    if (!hf.getJson(cfg.hfUrl + "/health", "", doc)) {
+      s.nav.aiHealthy = 0;
+      return;
+    }
+    SNAP_SET(s.ai.modelName, doc["model"].asString());
+    SNAP_SET(s.ai.status, doc["status"].asString());
+    s.ai.requestsToday = doc["requests_today"].asInt();
+    s.ai.avgLatency = (float)doc["avg_latency"].asDouble();
+    s.ai.tokensGenerated = doc["tokens_generated"].asInt();
+    s.ai.gpuUtil = (float)doc["gpu_util"].asDouble();
+    SNAP_SET(s.ai.lastInference, doc["last_inference"].asString());
+    s.nav.aiRequests = s.ai.requestsToday;
+    s.nav.aiHealthy = 1;
+  }
+
+  void poll(Snapshot& s) {
+    uint64_t start = nowUs();
+    pollMesh(s);
+    pollCrm(s);
+    pollAi(s);
+    s.polledAtUs = nowUs();
+    printf("🔄 Polled upstream in %llu ms (mesh %s, crm %s, ai %s)\n",
+           (unsigned long long)((s.polledAtUs - start) / 1000),
+           s.nav.meshHealthy ? "ok" : "down", s.nav.crmHealthy ? "ok" : "down", s.nav.aiHealthy ? "ok" : "down");
+  }
+};
+
+// ─────────────────────────────────────────────────────────────────────
+// DEVICE CONNECTIONS
+// ─────────────────────────────────────────────────────────────────────
+
+static bool sendAll(int fd, const uint8_t* buf, size_t len) {
+  while (len > 0) {
+    ssize_t n = send(fd, buf, len, MSG_NOSIGNAL);
+    if (n <= 0) return false;
+    buf += n;
+    len -= n;
+  }
+  return true;
+}
+
+static int listenOn(const char* addr, int port) {
+  int fd = socket(AF_INET, SOCK_STREAM, 0);
+  if (fd < 0) return -1;
+  int one = 1;
+  setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+
+  sockaddr_in sa;
+  memset(&sa, 0, sizeof(sa));
+  sa.sin_family = AF_INET;
+  sa.sin_port = htons(port);
+  inet_pton(AF_INET, addr, &sa.sin_addr);
+  if (bind(fd, (sockaddr*)&sa, sizeof(sa)) < 0 || listen(fd, 16) < 0) {
+    close(fd);
+    return -1;
+  }
+  return fd;
+}
+
+static void tuneClientSocket(int fd) {
+  int one = 1;
+  setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+  timeval tv = {SEND_TIMEOUT_SEC, 0};
+  setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof(tv));
+}
+
+struct Client {
+  int fd;
+  std::string peer;
+};
+
+class Hub {
+public:
+  // Send to every client, dropping the ones that fail
+  void broadcast(const uint8_t* frame, size_t len) {
+    for (size_t i = 0; i < _clients.size();) {
+      if (sendAll(_clients[i].fd, frame, len)) {
+        i++;
+        continue;
+      }
+      printf("🔌 %s dropped (send failed)\n", _clients[i].peer.c_str());
+      close(_clients[i].fd);
+      _clients.erase(_clients.begin() + i);
+    }
+  }
+
+  void add(int fd, const std::string& peer) { _clients.push_back({fd, peer}); }
+
+  // Devices never send; readable means closed (or junk to discard)
+  void reap(const std::vector<pollfd>& fds) {
+    for (const pollfd& p : fds) {
+      if (!(p.revents & (POLLIN | POLLHUP | POLLERR))) continue;
+      char junk[256];
+      ssize_t n = recv(p.fd, junk, sizeof(junk), MSG_DONTWAIT);
+      if (n > 0) continue;
+      for (size_t i = 0; i < _clients.size(); i++) {
+        if (_clients[i].fd != p.fd) continue;
+        printf("🔌 %s disconnected\n", _clients[i].peer.c_str());
+        close(p.fd);
+        _clients.erase(_clients.begin() + i);
+        break;
+      }
+    }
+  }
+
+  const std::vector<Client>& clients() const { return _clients; }
+
+private:
+  std::vector<Client> _clients;
+};
+
+// ─────────────────────────────────────────────────────────────────────
+// SERVICE
+// ─────────────────────────────────────────────────────────────────────
+
+static std::atomic<bool> running(true);
+
+static void onSignal(int) { running = false; }
+
+static int runService(const Config& cfg) {
+  int listenFd = listenOn("0.0.0.0", cfg.port);
+  if (listenFd < 0) {
+    perror("❌ listen");
+    return 1;
+  }
+  printf("🚀 Snapshot aggregator on :%d, polling every %ds\n", cfg.port, cfg.intervalSec);
+
+  std::mutex lock;
+  Snapshot latest;          // Written by the poller thread
+  bool fresh = false;
+
+  std::thread poller([&] {
+    Poller p;
+    p.cfg = cfg;
+    Snapshot work;
+    while (running) {
+      p.poll(work);
+      {
+        std::lock_guard<std::mutex> guard(lock);
+        latest = work;
+        fresh = true;
+      }
+      for (int i = 0; i < cfg.intervalSec * 10 && running; i++) std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    }
+  });
+
+  Hub hub;
+  Snapshot sent;            // What devices last got
+  uint32_t seq = 0;
+  alignas(4) uint8_t frame[SNAP_FRAME_MAX];
+  auto lastFrameAt = Clock::now();
+
+  while (running) {
+    std::vector<pollfd> fds;
+    fds.push_back({listenFd, POLLIN, 0});
+    for (const Client& c : hub.clients()) fds.push_back({c.fd, POLLIN, 0});
+    poll(fds.data(), fds.size(), 500);
+
+    Snapshot current;
+    bool changed;
+    {
+      std::lock_guard<std::mutex> guard(lock);
+      current = latest;
+      changed = fresh;
+      fresh = false;
+    }
+
+    // New devices get everything
+    if (fds[0].revents & POLLIN) {
+      sockaddr_in sa;
+      socklen_t saLen = sizeof(sa);
+      int fd = accept(listenFd, (sockaddr*)&sa, &saLen);
+      if (fd >= 0) {
+        tuneClientSocket(fd);
+        char ip[INET_ADDRSTRLEN];
+        inet_ntop(AF_INET, &sa.sin_addr, ip, sizeof(ip));
+        std::string peer = std::string(ip) + ":" + std::to_string(ntohs(sa.sin_port));
+        size_t len = encodeSnapshot(sent.polledAtUs ? sent : current, MASK_ALL, ++seq, frame, sizeof(frame));
+        if (len && sendAll(fd, frame, len)) {
+          hub.add(fd, peer);
+          printf("⚡ %s connected (%zu byte snapshot, %zu devices)\n", peer.c_str(), len, hub.clients().size());
+        } else {
+          close(fd);
+        }
+      }
+    }
+    fds.erase(fds.begin());
+    hub.reap(fds);
+
+    // Push only what changed
+    if (changed) {
+      unsigned mask = sent.polledAtUs ? diffSnapshots(sent, current) : (unsigned)MASK_ALL;
+      mask |= MASK_NAV;  // Carries the age, doubles as "still polling"
+      size_t len = encodeSnapshot(current, mask, ++seq, frame, sizeof(frame));
+      if (len) {
+        hub.broadcast(frame, len);
+        lastFrameAt = Clock::now();
+        printf("📤 seq %u: %zu bytes (sections 0x%X) to %zu devices\n", seq, len, mask, hub.clients().size());
+      }
+      sent = current;
+    }
+
+    if (Clock::now() - lastFrameAt > std::chrono::seconds(KEEPALIVE_SEC)) {
+      size_t len = encodeSnapshot(current, 0, ++seq, frame, sizeof(frame));
+      hub.broadcast(frame, len);
+      lastFrameAt = Clock::now();
+    }
+  }
+
+  poller.join();
+  for (const Client& c : hub.clients()) close(c.fd);
+  close(listenFd);
+  return 0;
+}
+
+// ─────────────────────────────────────────────────────────────────────
+// LOOPBACK BENCHMARK
+// ─────────────────────────────────────────────────────────────────────
+
+// Device-side structs, as in dynamic_nav.h (minus Arduino String)
+struct BenchDeviceState {
+  int activeNodes, hotLeads, aiRequests;
+  bool meshHealthy, crmHealthy, aiHealthy;
+  int totalContacts, openDeals, activity24h, topLeadScore;
+  float pipelineValue;
+  char topLead[33];
+  char modelName[33], status[17], lastInference[17];
+  int requestsToday, tokensGenerated;
+  float avgLatency, gpuUtil;
+  struct { char name[32], company[32], email[64], temperature[16], lastActivity[32], stage[24];
+           int score, opens, clicks; bool hasReplied; } leads[SNAP_MAX_LEADS];
+  int leadCount;
+};
+
+// What snapshotApply() does on the device
+static void benchApply(const SnapView& v, BenchDeviceState& d) {
+  if (v.nav) {
+    d.activeNodes = v.nav->activeNodes;
+    d.hotLeads = v.nav->hotLeads;
+    d.aiRequests = v.nav->aiRequests;
+    d.meshHealthy = v.nav->meshHealthy;
+    d.crmHealthy = v.nav->crmHealthy;
+    d.aiHealthy = v.nav->aiHealthy;
+  }
+  if (v.crm) {
+    d.totalContacts = v.crm->totalContacts;
+    d.openDeals = v.crm->openDeals;
+    d.pipelineValue = v.crm->pipelineValue;
+    d.activity24h = v.crm->activity24h;
+    d.topLeadScore = v.crm->topLeadScore;
+    SNAP_COPY(d.topLead, v.crm->topLead);
+  }
+  if (v.ai) {
+    SNAP_COPY(d.modelName, v.ai->modelName);
+    SNAP_COPY(d.status, v.ai->status);
+    SNAP_COPY(d.lastInference, v.ai->lastInference);
+    d.requestsToday = v.ai->requestsToday;
+    d.avgLatency = v.ai->avgLatency;
+    d.tokensGenerated = v.ai->tokensGenerated;
+    d.gpuUtil = v.ai->gpuUtil;
+  }
+  if (v.leads) {
+    d.leadCount = std::min<uint32_t>(v.leads->count, SNAP_MAX_LEADS);
+    for (int i = 0; i < d.leadCount; i++) {
+      const SnapLead* l = snapLead(v.leads, i);
+      SNAP_COPY(d.leads[i].name, l->name);
+      SNAP_COPY(d.leads[i].company, l->company);
+      SNAP_COPY(d.leads[i].email, l->email);
+      SNAP_COPY(d.leads[i].temperature, l->temperature);
+      SNAP_COPY(d.leads[i].lastActivity, l->lastActivity);
+      SNAP_COPY(d.leads[i].stage, l->stage);
+      d.leads[i].score = l->score;
+      d.leads[i].opens = l->opens;
+      d.leads[i].clicks = l->clicks;
+      d.leads[i].hasReplied = l->hasReplied;
+    }
+  }
+}
+
+static Snapshot benchSnapshot(int i) {
+  Snapshot s;
+  s.nav = {4, 7 + i % 3, 1200 + i, 1, 1, 1, 0, 0};
+  s.crm.totalContacts = 4210;
+  s.crm.hotLeads = 7 + i % 3;
+  s.crm.openDeals = 31;
+  s.crm.pipelineValue = 1250000.0f + i;
+  s.crm.activity24h = 96;
+  s.crm.topLeadScore = 97;
+  SNAP_SET(s.crm.topLead, "Ada Lovelace");
+  SNAP_SET(s.ai.modelName, "Lucidia-7B");
+  SNAP_SET(s.ai.status, "running");
+  s.ai.requestsToday = 1200 + i;
+  s.ai.avgLatency = 142.5f;
+  s.ai.tokensGenerated = 845210;
+  s.ai.gpuUtil = 61.0f;
+  SNAP_SET(s.ai.lastInference, "12s ago");
+  for (int k = 0; k < SNAP_MAX_LEADS; k++) {
+    SnapLead l;
+    memset(&l, 0, sizeof(l));
+    SNAP_SET(l.name, ("Lead " + std::to_string(k)).c_str());
+    SNAP_SET(l.company, "Acme Corp");
+    SNAP_SET(l.email, ("lead" + std::to_string(k) + "@acme.com").c_str());
+    l.score = 90 - k;
+    SNAP_SET(l.temperature, "hot");
+    l.opens = 12;
+    l.clicks = 4;
+    SNAP_SET(l.lastActivity, "Recent");
+    SNAP_SET(l.stage, "Evaluating");
+    l.hasReplied = k & 1;
+    s.leads.push_back(l);
+  }
+  s.polledAtUs = nowUs();
+  return s;
+}
+
+// The same content as the JSON the device parses today
+static std::string benchJson(const Snapshot& s) {
+  char buf[512];
+  std::string out;
+  snprintf(buf, sizeof(buf),
+           "{\"nav\":{\"activeNodes\":%d,\"hotLeads\":%d,\"aiRequests\":%d,\"meshHealthy\":true,"
+           "\"crmHealthy\":true,\"aiHealthy\":true},\"crm\":{\"total_contacts\":%d,\"hot_leads\":%d,"
+           "\"open_deals\":%d,\"pipeline_value\":%.1f,\"activity_24h\":%d},",
+           s.nav.activeNodes, s.nav.hotLeads, s.nav.aiRequests, s.crm.totalContacts, s.crm.hotLeads,
+           s.crm.openDeals, s.crm.pipelineValue, s.crm.activity24h);
+  out += buf;
+  snprintf(buf, sizeof(buf),
+           "\"ai\":{\"model\":\"%s\",\"status\":\"%s\",\"requests_today\":%d,\"avg_latency\":%.1f,"
+           "\"tokens_generated\":%d,\"gpu_util\":%.1f},\"contacts\":[",
+           s.ai.modelName, s.ai.status, s.ai.requestsToday, s.ai.avgLatency, s.ai.tokensGenerated, s.ai.gpuUtil);
+  out += buf;
+  for (size_t k = 0; k < s.leads.size(); k++) {
+    const SnapLead& l = s.leads[k];
+    snprintf(buf, sizeof(buf),
+             "%s{\"first_name\":\"%s\",\"last_name\":\"\",\"company\":\"%s\",\"email\":\"%s\","
+             "\"lead_score\":%d,\"temperature\":\"%s\",\"email_opens\":%d,\"email_clicks\":%d,"
+             "\"stage\":\"%s\",\"has_replied\":%s}",
+             k ? "," : "", l.name, l.company, l.email, l.score, l.temperature, l.opens, l.clicks, l.stage,
+             l.hasReplied ? "true" : "false");
+    out += buf;
+  }
+  out += "]}";
+  return out;
+}
+
+static bool recvAll(int fd, uint8_t* buf, size_t len) {
+  while (len > 0) {
+    ssize_t n = recv(fd, buf, len, 0);
+    if (n <= 0) return false;
+    buf += n;
+    len -= n;
+  }
+  return true;
+}
+
+static int runBench(int iterations) {
+  printf("⏱️  Snapshot benchmark, %d iterations\n\n", iterations);
+  std::vector<Snapshot> snaps;
+  for (int i = 0; i < 16; i++) snaps.push_back(benchSnapshot(i));
+  alignas(4) uint8_t frame[SNAP_FRAME_MAX];
+  BenchDeviceState device;
+  memset(&device, 0, sizeof(device));
+
+  // Encode
+  uint64_t start = nowUs();
+  size_t frameLen = 0;
+  for (int i = 0; i < iterations; i++) {
+    frameLen = encodeSnapshot(snaps[i & 15], MASK_ALL, i, frame, sizeof(frame));
+  }
+  double encodeNs = (nowUs() - start) * 1000.0 / iterations;
+
+  // Decode + apply (in place, as on the device)
+  start = nowUs();
+  int bad = 0;
+  for (int i = 0; i < iterations; i++) {
+    SnapView view;
+    if (snapParse(frame, frameLen, &view) != SNAP_OK) bad++;
+    benchApply(view, device);
+  }
+  double decodeNs = (nowUs() - start) * 1000.0 / iterations;
+
+  // Same content as JSON, for comparison
+  std::string json = benchJson(snaps[0]);
+  start = nowUs();
+  for (int i = 0; i < iterations; i++) {
+    JsonLite::Value doc;
+    if (!JsonLite::parse(json, doc)) bad++;
+  }
+  double jsonNs = (nowUs() - start) * 1000.0 / iterations;
+
+  // Loopback TCP: stream every frame through a real socket pair
+  int listenFd = listenOn("127.0.0.1", 0);
+  sockaddr_in sa;
+  socklen_t saLen = sizeof(sa);
+  getsockname(listenFd, (sockaddr*)&sa, &saLen);
+
+  std::atomic<int> received(0);
+  std::atomic<int> errors(0);
+  std::thread device_thread([&] {
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (connect(fd, (sockaddr*)&sa, sizeof(sa)) < 0) {
+      errors++;
+      return;
+    }
+    alignas(4) uint8_t buf[SNAP_FRAME_MAX];
+    BenchDeviceState state;
+    uint32_t expectSeq = 0;
+    while (recvAll(fd, buf, sizeof(SnapFrameHeader))) {
+      size_t total = snapFrameSize((const SnapFrameHeader*)buf, sizeof(buf));
+      if (total == 0 || !recvAll(fd, buf + sizeof(SnapFrameHeader), total - sizeof(SnapFrameHeader))) {
+        errors++;
+        break;
+      }
+      SnapView view;
+      if (snapParse(buf, total, &view) != SNAP_OK || view.header->seq != expectSeq++) errors++;
+      benchApply(view, state);
+      received++;
+    }
+    close(fd);
+  });
+
+  int fd = accept(listenFd, NULL, NULL);
+  tuneClientSocket(fd);
+  start = nowUs();
+  size_t bytes = 0;
+  for (int i = 0; i < iterations; i++) {
+    size_t len = encodeSnapshot(snaps[i & 15], MASK_ALL, i, frame, sizeof(frame));
+    if (!sendAll(fd, frame, len)) break;
+    bytes += len;
+  }
+  shutdown(fd, SHUT_WR);
+  device_thread.join();
+  double loopUs = nowUs() - start;
+  close(fd);
+  close(listenFd);
+
+  printf("  Frame:         %6zu bytes (JSON equivalent %zu bytes, %.0f%%)\n", frameLen, json.size(),
+         100.0 * frameLen / json.size());
+  printf("  Encode:        %9.0f ns/snapshot\n", encodeNs);
+  printf("  Decode+apply:  %9.0f ns/snapshot (in place)\n", decodeNs);
+  printf("  JSON parse:    %9.0f ns/snapshot (DOM, for comparison)\n", jsonNs);
+  printf("  Loopback TCP:  %9.0f snapshots/s, %.1f MB/s (%d/%d received, %d errors)\n",
+         received * 1e6 / loopUs, bytes / loopUs, received.load(), iterations, errors.load());
+  return bad == 0 && errors == 0 && received == iterations ? 0 : 1;
+}
+
+// ─────────────────────────────────────────────────────────────────────
+// MAIN
+// ─────────────────────────────────────────────────────────────────────
+
+static void printSnapshot(const Snapshot& s) {
+  printf("\nnav:   %d nodes, %d hot leads, %d AI requests (mesh %d crm %d ai %d)\n", s.nav.activeNodes,
+         s.nav.hotLeads, s.nav.aiRequests, s.nav.meshHealthy, s.nav.crmHealthy, s.nav.aiHealthy);
+  printf("crm:   %d contacts, %d open deals, $%.0fK pipeline, top %s (%d)\n", s.crm.totalContacts,
+         s.crm.openDeals, s.crm.pipelineValue / 1000.0, s.crm.topLead, s.crm.topLeadScore);
+  printf("ai:    %s %s, %d requests, %.1f ms\n", s.ai.modelName, s.ai.status, s.ai.requestsToday, s.ai.avgLatency);
+  for (const SnapLead& l : s.leads) printf("lead:  %s (%s) %d\n", l.name, l.company, l.score);
+
+  alignas(4) uint8_t frame[SNAP_FRAME_MAX];
+  printf("frame: %zu bytes\n", encodeSnapshot(s, MASK_ALL, 0, frame, sizeof(frame)));
+}
+
+int main(int argc, char** argv) {
+  uint16_t probe = 1;
+  if (*(uint8_t*)&probe != 1) {
+    fprintf(stderr, "❌ Snapshot wire format is little-endian only\n");
+    return 1;
+  }
+
+  Config cfg;
+  if (const char* secret = getenv("CRM_SECRET")) cfg.crmSecret = secret;
+  bool once = false;
+  int bench = 0;
+
+  for (int i = 1; i < argc; i++) {
+    std::string arg = argv[i];
+    bool hasValue = i + 1 < argc;
+    if (arg == "--port" && hasValue) cfg.port = atoi(argv[++i]);
+    else if (arg == "--interval" && hasValue) cfg.intervalSec = std::max(1, atoi(argv[++i]));
+    else if (arg == "--mesh" && hasValue) cfg.meshUrl = argv[++i];
+    else if (arg == "--crm" && hasValue) cfg.crmUrl = argv[++i];
+    else if (arg == "--hf" && hasValue) cfg.hfUrl = argv[++i];
+    else if (arg == "--once") once = true;
+    else if (arg == "--bench") bench = (hasValue && argv[i + 1][0] != '-') ? atoi(argv[++i]) : 100000;
+    else {
+      fprintf(stderr, "usage: %s [--port N] [--interval SEC] [--mesh URL] [--crm URL] [--hf URL] [--once] [--bench [N]]\n",
+              argv[0]);
+      return 2;
+    }
+  }
+
+  if (bench > 0) return runBench(bench);
+
+  curl_global_init(CURL_GLOBAL_DEFAULT);
+  int rc = 0;
+  if (once) {
+    Poller p;
+    p.cfg = cfg;
+    Snapshot s;
+    p.poll(s);
+    printSnapshot(s);
+  } else {
+    signal(SIGINT, onSignal);
+    signal(SIGTERM, onSignal);
+    signal(SIGPIPE, SIG_IGN);
+    rc = runService(cfg);
+  }
+  curl_global_cleanup();
+  return rc;
+}
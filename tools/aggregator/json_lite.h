@@ -0,0 +1,184 @@
+#ifndef JSON_LITE_H
+#define JSON_LITE_H
+
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <utility>
+#include <vector>
+
+/*
+ * Minimal JSON DOM for the aggregator - just enough to read the upstream
+ * API responses without pulling in a JSON library. UTF-8 passes through
+ * untouched; \u escapes outside ASCII become '?'.
+ *
+ *   JsonLite::Value doc;
+ *   if (JsonLite::parse(body, doc)) int n = doc["hot_leads"].asInt();
+ */
+
+namespace JsonLite {
+
+enum Type { NUL, BOOL, NUMBER, STRING, ARRAY, OBJECT };
+
+struct Value {
+  Type type = NUL;
+  bool b = false;
+  double num = 0;
+  std::string str;
+  std::vector<Value> items;                          // ARRAY
+  std::vector<std::pair<std::string, Value>> fields; // OBJECT
+
+  const Value& operator[](const char* key) const {
+    static const Value null;
+    if (type != OBJECT) return null;
+    for (const auto& f : fields) {
+      if (f.first == key) return f.second;
+    }
+    return null;
+  }
+
+  bool isNull() const { return type == NUL; }
+  int asInt(int def = 0) const { return type == NUMBER ? (int)num : def; }
+  double asDouble(double def = 0) const { return type == NUMBER ? num : def; }
+  bool asBool(bool def = false) const { return type == BOOL ? b : def; }
+  const char* asString(const char* def = "") const { return type == STRING ? str.c_str() : def; }
+};
+
+class Parser {
+public:
+  Parser(const char* p, const char* end) : _p(p), _end(end) {}
+
+  bool parseDocument(Value& out) {
+    if (!parseValue(out, 0)) return false;
+    skipSpace();
+    return _p == _end;
+  }
+
+private:
+  const char* _p;
+  const char* _end;
+
+  static const int MAX_DEPTH = 64;
+
+  void skipSpace() {
+    while (_p < _end && (*_p == ' ' || *_p == '\t' || *_p == '\n' || *_p == '\r')) _p++;
+  }
+
+  bool literal(const char* word) {
+    size_t n = strlen(word);
+    if ((size_t)(_end - _p) < n || memcmp(_p, word, n) != 0) return false;
+    _p += n;
+    return true;
+  }
+
+  bool parseValue(Value& v, int depth) {
+    if (depth > MAX_DEPTH) return false;
+    skipSpace();
+    if (_p >= _end) return false;
+
+    switch (*_p) {
+      case '{': return parseObject(v, depth);
+      case '[': return parseArray(v, depth);
+      case '"': v.type = STRING; return parseString(v.str);
+      case 't': v.type = BOOL; v.b = true; return literal("true");
+      case 'f': v.type = BOOL; v.b = false; return literal("false");
+      case 'n': v.type = NUL; return literal("null");
+      default: return parseNumber(v);
+    }
+  }
+
+  bool parseNumber(Value& v) {
+    std::string text;
+    while (_p < _end && strchr("+-0123456789.eE", *_p)) text += *_p++;
+    if (text.empty()) return false;
+    char* stop;
+    v.num = strtod(text.c_str(), &stop);
+    v.type = NUMBER;
+    return *stop == '\0';
+  }
+
+  bool parseString(std::string& out) {
+    _p++;  // Opening quote
+    while (_p < _end && *_p != '"') {
+      char c = *_p++;
+      if (c != '\\') {
+        out += c;
+        continue;
+      }
+      if (_p >= _end) return false;
+      char e = *_p++;
+      switch (e) {
+        case 'n': out += '\n'; break;
+        case 't': out += '\t'; break;
+        case 'r': out += '\r'; break;
+        case 'b': out += '\b'; break;
+        case 'f': out += '\f'; break;
+        case 'u': {
+          if (_end - _p < 4) return false;
+          unsigned code = strtoul(std::string(_p, 4).c_str(), NULL, 16);
+          out += code < 0x80 ? (char)code : '?';
+          _p += 4;
+          break;
+        }
+        default: out += e; break;  // \" \\ \/
+      }
+    }
+    if (_p >= _end) return false;
+    _p++;  // Closing quote
+    return true;
+  }
+
+  bool parseArray(Value& v, int depth) {
+    v.type = ARRAY;
+    _p++;
+    skipSpace();
+    if (_p < _end && *_p == ']') {
+      _p++;
+      return true;
+    }
+    while (true) {
+      v.items.emplace_back();
+      if (!parseValue(v.items.back(), depth + 1)) return false;
+      skipSpace();
+      if (_p >= _end) return false;
+      if (*_p == ',') { _p++; continue; }
+      if (*_p == ']') { _p++; return true; }
+      return false;
+    }
+  }
+
+  bool parseObject(Value& v, int depth) {
+    v.type = OBJECT;
+    _p++;
+    skipSpace();
+    if (_p < _end && *_p == '}') {
+      _p++;
+      return true;
+    }
+    while (true) {
+      skipSpace();
+      if (_p >= _end || *_p != '"') return false;
+      v.fields.emplace_back();
+      if (!parseString(v.fields.back().first)) return false;
+      skipSpace();
+      if (_p >= _end || *_p != ':') return false;
+      _p++;
+      if (!parseValue(v.fields.back().second, depth + 1)) return false;
+      skipSpace();
+      if (_p >= _end) return false;
+      if (*_p == ',') { _p++; continue; }
+      if (*_p == '}') { _p++; return true; }
+      return false;
+    }
+  }
+};
+
+inline bool parse(const std::string& text, Value& out) {
+  out = Value();
+  Parser parser(text.data(), text.data() + text.size());
+  return parser.parseDocument(out);
+}
+
+}  // namespace JsonLite
+
+#endif // JSON_LITE_H
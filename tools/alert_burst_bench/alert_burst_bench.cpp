@@ -0,0 +1,349 @@
+/*
+ * ═══════════════════════════════════════════════════════════════════════
+ * BLACKROAD ALERT BURST BENCHMARK
+ * ═══════════════════════════════════════════════════════════════════════
+ *
+ * Host run of src/alerts.h (dispatcher task on std::thread, journal on
+ * the RAM flash) against Discord and Slack stand-ins on loopback, each
+ * answering after an injected delay:
+ * - A burst of N alerts raised back to back, as in an incident storm
+ * - Caller time per alert (enqueue + buzzer/LED start), next to what the
+ *   old inline sendAlert() blocked for: one POST per alert per webhook
+ * - Alert-to-dispatch latency per webhook, stamped when the stand-in has
+ *   the POST - split into alerts that fit the RAM queue and alerts that
+ *   overflowed into the journal and were replayed at the rate limit
+ * - Checks: every alert reaches every webhook exactly once and in order,
+ *   POSTs are coalesced, nothing is dropped or rejected, the journal is
+ *   acked empty at the end
+ *
+ * Build:   make
+ * Run:     ./alert_burst_bench [N] [DELAY_MS]   defaults: 100 alerts, 120 ms
+ */
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <Arduino.h>
+#include <HTTPClient.h>
+
+// ─────────────────────────────────────────────────────────────────────
+// FIRMWARE STAND-INS
+// ─────────────────────────────────────────────────────────────────────
+
+// src/json_stream.h brings the connection pool and endpoint guards; the
+// dispatcher only needs its JsonHttpRequest POST, one connection each
+#define JSON_STREAM_H
+
+class JsonHttpRequest {
+public:
+  HTTPClient http;
+
+  bool begin(const char* url, uint16_t timeoutMs = 5000) {
+    http.setTimeout(timeoutMs);
+    return http.begin(url);
+  }
+
+  int POST(const char* payload, size_t len) { return http.POST((uint8_t*)payload, len); }
+
+  void end() { http.end(); }
+};
+
+// What the alert condition checkers read - not exercised here
+#define COLOR_WHITE 0xFFFF
+#define COLOR_HOT_PINK 0xF8EA
+#define COLOR_SUNRISE 0xF52C
+#define COLOR_CYBER_BLUE 0x2BDF
+
+struct CRMMetrics {
+  int hotLeads;
+  int openDeals;
+  float pipelineValue;
+};
+
+struct NavigationState {
+  int activeNodes;
+  bool meshHealthy;
+  bool crmHealthy;
+  bool aiHealthy;
+};
+
+struct SovereigntyMetrics {
+  int totalComponents;
+  int sovereignComponents;
+  float sovereigntyScore;
+};
+
+CRMMetrics crmMetrics = {0, 0, 0};
+NavigationState navState = {4, true, true, true};
+SovereigntyMetrics getSovereigntyMetrics() { return {10, 10, 100.0f}; }
+String getSovereigntyStatus() { return "SOVEREIGN"; }
+
+#include "alerts.h"
+
+static int failures = 0;
+
+#define CHECK(cond)                                                        \
+  do {                                                                     \
+    if (!(cond)) {                                                         \
+      printf("FAIL %s:%d: %s\n", __FILE__, __LINE__, #cond);               \
+      failures++;                                                          \
+    }                                                                      \
+  } while (0)
+
+#define CALLER_MAX_MS 5.0            // Enqueue must never wait on the network
+#define DRAIN_DEADLINE_MS 120000
+
+static double nowMs() {
+  static const auto epoch = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - epoch).count();
+}
+
+// ─────────────────────────────────────────────────────────────────────
+// WEBHOOK STAND-IN
+// ─────────────────────────────────────────────────────────────────────
+
+// Accepts every POST after `delayMs`, noting which burst alerts it
+// carried (found by `marker`, followed by the alert number) and when
+class WebhookStandIn {
+public:
+  struct Hit {
+    int index;
+    double atMs;
+  };
+
+  WebhookStandIn(const char* marker, unsigned long delayMs, int status)
+    : _marker(marker), _delayMs(delayMs), _status(status) {
+    _fd = socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in sa = {};
+    sa.sin_family = AF_INET;
+    sa.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    bind(_fd, (sockaddr*)&sa, sizeof(sa));
+    listen(_fd, 8);
+    socklen_t len = sizeof(sa);
+    getsockname(_fd, (sockaddr*)&sa, &len);
+    port = ntohs(sa.sin_port);
+    _thread = std::thread(&WebhookStandIn::run, this);
+  }
+
+  ~WebhookStandIn() {
+    shutdown(_fd, SHUT_RDWR);  // Wakes accept()
+    _thread.join();
+    close(_fd);
+  }
+
+  int port;
+  std::atomic<int> posts{0};        // POSTs carrying burst alerts
+  std::atomic<int> largestPost{0};  // Most burst alerts in one POST
+
+  std::vector<Hit> hits() {
+    std::lock_guard<std::mutex> guard(_lock);
+    return _hits;
+  }
+
+private:
+  int _fd;
+  std::string _marker;
+  unsigned long _delayMs;
+  int _status;
+  std::thread _thread;
+  std::mutex _lock;
+  std::vector<Hit> _hits;
+
+  void run() {
+    for (;;) {
+      int c = accept(_fd, NULL, NULL);
+      if (c < 0) return;
+      std::thread(&WebhookStandIn::serve, this, c).detach();
+    }
+  }
+
+  void serve(int c) {
+    char buf[2048];
+    std::string req;
+    size_t split = std::string::npos;
+    size_t bodyLen = 0;
+    for (;;) {
+      if (split == std::string::npos && (split = req.find("\r\n\r\n")) != std::string::npos) {
+        size_t cl = req.find("Content-Length: ");
+        bodyLen = cl < split ? strtoul(req.c_str() + cl + 16, NULL, 10) : 0;
+      }
+      if (split != std::string::npos && req.size() >= split + 4 + bodyLen) break;
+      ssize_t n = recv(c, buf, sizeof(buf), 0);
+      if (n <= 0) break;
+      req.append(buf, n);
+    }
+    double at = nowMs();
+
+    int carried = 0;
+    if (split != std::string::npos) {
+      std::lock_guard<std::mutex> guard(_lock);
+      for (size_t pos = req.find(_marker, split); pos != std::string::npos;
+           pos = req.find(_marker, pos + 1)) {
+        _hits.push_back({atoi(req.c_str() + pos + _marker.size()), at});
+        carried++;
+      }
+    }
+    if (carried) {
+      posts++;
+      if (carried > largestPost) largestPost = carried;
+    }
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(_delayMs));
+    std::string resp = "HTTP/1.1 " + std::to_string(_status) + " X\r\nContent-Length: 0\r\nConnection: close\r\n\r\n";
+    send(c, resp.data(), resp.size(), MSG_NOSIGNAL);
+    close(c);
+  }
+};
+
+// ─────────────────────────────────────────────────────────────────────
+// HELPERS
+// ─────────────────────────────────────────────────────────────────────
+
+static double percentile(std::vector<double> v, double p) {
+  if (v.empty()) return 0;
+  std::sort(v.begin(), v.end());
+  return v[(size_t)(p * (v.size() - 1) + 0.5)];
+}
+
+static void printLatency(const char* label, const std::vector<double>& v) {
+  if (v.empty()) return;
+  printf("%-17s%3zu alerts  p50 %7.0f ms  p95 %7.0f ms  max %7.0f ms\n", label, v.size(),
+         percentile(v, 0.50), percentile(v, 0.95), percentile(v, 1.0));
+}
+
+// One inline POST of a single alert, the way the old sendAlert() did it
+static double inlinePostMs(AlertWebhook* hook) {
+  OutboundAlert alert = {0, ALERT_WARNING, "baseline", "one alert, one connection", -1, 0, 0};
+  OutboundAlert* batch[1] = {&alert};
+  static char payload[ALERT_PAYLOAD_MAX];
+  JsonWriter w(payload, sizeof(payload));
+  hook->buildPayload(batch, 1, w);
+
+  double start = nowMs();
+  JsonHttpRequest req;
+  req.begin(hook->url, 5000);
+  req.http.addHeader("Content-Type", "application/json");
+  int code = req.POST(w.c_str(), w.length());
+  req.end();
+  CHECK(code >= 200 && code < 300);
+  return nowMs() - start;
+}
+
+// Everything delivered and acked - read under the dispatcher's lock
+static bool drained() {
+  xSemaphoreTake(alertQueueMutex, portMAX_DELAY);
+  bool done = getPendingAlertCount() == 0 && alertJournal.pending() == 0;
+  xSemaphoreGive(alertQueueMutex);
+  return done;
+}
+
+// ─────────────────────────────────────────────────────────────────────
+// BENCH
+// ─────────────────────────────────────────────────────────────────────
+
+int main(int argc, char** argv) {
+  int n = argc > 1 ? atoi(argv[1]) : 100;
+  unsigned long delayMs = argc > 2 ? strtoul(argv[2], NULL, 10) : 120;
+  if (n < 1 || n > 999) n = 100;
+
+  WebhookStandIn discord("\"title\":\"burst-", delayMs, 204);
+  WebhookStandIn slack("\"text\":\"*burst-", delayMs, 200);
+  snprintf(benchDiscordUrl, sizeof(benchDiscordUrl), "http://127.0.0.1:%d/api/webhooks/bench", discord.port);
+  snprintf(benchSlackUrl, sizeof(benchSlackUrl), "http://127.0.0.1:%d/services/bench", slack.port);
+  CHECK(ALERT_WEBHOOK_COUNT == 2);
+
+  printf("burst:           %d alerts, webhooks answer after %lu ms\n", n, delayMs);
+
+  // What each alert used to cost the caller
+  double inlineMs = 0;
+  for (int i = 0; i < ALERT_WEBHOOK_COUNT; i++) inlineMs += inlinePostMs(&alertWebhooks[i]);
+  printf("inline (old):    %.0f ms per alert blocked, ~%.1f s for the burst (est.)\n", inlineMs,
+         inlineMs * n / 1000.0);
+
+  // The burst
+  std::vector<double> enqueuedAt(n);
+  std::vector<double> callerMs(n);
+  static const AlertLevel levels[] = {ALERT_CRITICAL, ALERT_WARNING, ALERT_INFO};
+  for (int i = 0; i < n; i++) {
+    char title[24];
+    snprintf(title, sizeof(title), "burst-%03d", i);
+    AlertLevel level = levels[i % 3];
+    String message = String("Mesh node ") + String(i % 4) +
+                     " stopped answering health checks. Expected: 4 nodes. Network redundancy compromised.";
+
+    double start = nowMs();
+    enqueuedAt[i] = start;
+    enqueueOutboundAlert(level, title, message, -1);
+    triggerLocalAlert(level);
+    callerMs[i] = nowMs() - start;
+  }
+  double callerMax = *std::max_element(callerMs.begin(), callerMs.end());
+  printf("caller:          p50 %.3f ms  max %.3f ms per alert (first starts the task)\n",
+         percentile(callerMs, 0.50), callerMax);
+  CHECK(callerMax < CALLER_MAX_MS);
+
+  double deadline = nowMs() + DRAIN_DEADLINE_MS;
+  while (!drained() && nowMs() < deadline) {
+    localAlertTick();
+    delay(10);
+  }
+  double lastHitMs = 0;
+
+  // Per webhook: exactly once, in order, latency split ring / journal
+  uint32_t inRing = alertDispatchStats.queued;
+  WebhookStandIn* hooks[] = {&discord, &slack};
+  for (int h = 0; h < ALERT_WEBHOOK_COUNT; h++) {
+    std::vector<WebhookStandIn::Hit> hits = hooks[h]->hits();
+    bool inOrder = (int)hits.size() == n;
+    std::vector<double> ring, journaled;
+    for (size_t i = 0; i < hits.size(); i++) {
+      if (hits[i].index != (int)i) inOrder = false;
+      if (hits[i].index < 0 || hits[i].index >= n) continue;
+      double latency = hits[i].atMs - enqueuedAt[hits[i].index];
+      ((uint32_t)hits[i].index < inRing ? ring : journaled).push_back(latency);
+      if (hits[i].atMs > lastHitMs) lastHitMs = hits[i].atMs;
+    }
+    CHECK(inOrder);
+    CHECK(hooks[h]->posts < n);
+    CHECK(hooks[h]->largestPost <= ALERT_BATCH_MAX);
+
+    printf("%-8s         %zu/%d delivered in %d POSTs (up to %d per POST)%s\n", alertWebhooks[h].name,
+           hits.size(), n, hooks[h]->posts.load(), hooks[h]->largestPost.load(), inOrder ? ", in order" : "");
+    printLatency("  RAM queue:", ring);
+    printLatency("  via journal:", journaled);
+  }
+
+  printf("burst drained:   %.1f s after the first alert\n", (lastHitMs - enqueuedAt[0]) / 1000.0);
+  printf("dispatcher:      queued %lu  journaled %lu  replayed %lu  dropped %lu  rejected %lu  retries %lu\n",
+         (unsigned long)alertDispatchStats.queued, (unsigned long)alertDispatchStats.journaled,
+         (unsigned long)alertDispatchStats.replayed, (unsigned long)alertDispatchStats.dropped,
+         (unsigned long)alertDispatchStats.rejected, (unsigned long)alertDispatchStats.retries);
+  printf("                 own latency avg %lu ms  max %lu ms (journaled alerts count from replay)\n",
+         (unsigned long)getAlertAvgLatencyMs(), (unsigned long)alertDispatchStats.latencyMaxMs);
+
+  CHECK(alertDispatchStats.queued + alertDispatchStats.journaled == (uint32_t)n);
+  CHECK(alertDispatchStats.replayed == alertDispatchStats.journaled);
+  CHECK(alertDispatchStats.delivered == (uint32_t)n * ALERT_WEBHOOK_COUNT);
+  CHECK(alertDispatchStats.dropped == 0);
+  CHECK(alertDispatchStats.rejected == 0);
+  CHECK(drained());
+
+  if (failures) {
+    printf("%d check(s) failed\n", failures);
+    return 1;
+  }
+  printf("all checks passed\n");
+  return 0;
+}
@@ -0,0 +1,12 @@
+#ifndef SECRETS_H
+#define SECRETS_H
+
+// Stands in for src/secrets.h: both webhooks point at the bench's
+// loopback stand-ins, filled in once their ports are known
+inline char benchDiscordUrl[64];
+inline char benchSlackUrl[64];
+
+#define DISCORD_WEBHOOK_URL benchDiscordUrl
+#define SLACK_WEBHOOK_URL benchSlackUrl
+
+#endif // SECRETS_H
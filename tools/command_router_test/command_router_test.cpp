@@ -0,0 +1,169 @@
+/*
+ * ═══════════════════════════════════════════════════════════════════════
+ * BLACKROAD COMMAND ROUTER TEST
+ * ═══════════════════════════════════════════════════════════════════════
+ *
+ * Host run of lib/CommandRouter:
+ * - Subject wildcards (* and >) match the way the NATS server does
+ * - Command name from the "command" field or the last subject token
+ * - Declared arguments: defaults, required, type mismatches, escapes;
+ *   undeclared fields (nested objects included) are skipped
+ * - Malformed bodies fail cleanly with the right result code
+ * - Table order is checked at compile time (static_assert below)
+ * Last, the dispatch cost with a 64-command table.
+ *
+ * Build:   make
+ * Run:     ./command_router_test       exits non-zero on any failure
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <string>
+
+#include "CommandRouter.h"
+
+static int failures = 0;
+
+#define CHECK(cond)                                                        \
+  do {                                                                     \
+    if (!(cond)) {                                                         \
+      printf("FAIL %s:%d: %s\n", __FILE__, __LINE__, #cond);               \
+      failures++;                                                          \
+    }                                                                      \
+  } while (0)
+
+static std::string last;   // What the last handler saw
+
+static void cmdPing(const CommandCall& c) { last = std::string("ping:") + (c.isRequest() ? "req" : "pub"); }
+static void cmdReboot(const CommandCall& c) { last = "reboot:" + std::to_string(c.integer(0, 3000)); }
+static void cmdEncoding(const CommandCall& c) { last = std::string("encoding:") + (c.flag(0) ? "1" : "0"); }
+static void cmdSay(const CommandCall& c) {
+  last = std::string("say:") + c.str(0) + ":" + std::to_string(c.number(1, -1));
+}
+
+constexpr Command COMMANDS[] = {
+  {"encoding", cmdEncoding, {{"binary", CMD_ARG_BOOL, true}}},
+  {"ping", cmdPing, {}},
+  {"reboot", cmdReboot, {{"delay_ms", CMD_ARG_INT, false}}},
+  {"say", cmdSay, {{"text", CMD_ARG_STRING, true}, {"gain", CMD_ARG_FLOAT, false}}},
+};
+static_assert(commandTableSorted(COMMANDS), "COMMANDS must be sorted");
+
+constexpr Command UNSORTED[] = {{"b", cmdPing, {}}, {"a", cmdPing, {}}};
+static_assert(!commandTableSorted(UNSORTED), "unsorted table not detected");
+
+const CommandRoute ROUTES[] = {
+  {"dev.commands", COMMANDS, 4, CMD_NAME_FROM_FIELD},
+  {"dev.d1.cmd.*", COMMANDS, 4, CMD_NAME_FROM_SUBJECT},
+};
+static CommandRouter router(ROUTES, 2);
+
+static NatsOp message(const char* subject, const char* body, const char* reply = "") {
+  NatsOp op = {};
+  op.type = NATS_OP_MSG;
+  op.subject = subject;
+  op.sid = "1";
+  op.args = "";
+  op.replyTo = reply;
+  op.headers = "";
+  op.payload = body;
+  op.payloadLen = strlen(body);
+  return op;
+}
+
+static CommandResult go(const char* subject, const char* body, const char* reply = "") {
+  last.clear();
+  return router.dispatch(message(subject, body, reply));
+}
+
+static void testSubjectMatching() {
+  CHECK(natsSubjectMatches("a.*.c", "a.b.c"));
+  CHECK(!natsSubjectMatches("a.*.c", "a.b.d"));
+  CHECK(!natsSubjectMatches("a.*", "a.b.c"));
+  CHECK(natsSubjectMatches("a.>", "a.b.c"));
+  CHECK(!natsSubjectMatches("a.>", "a"));
+  CHECK(natsSubjectMatches("a.b", "a.b"));
+  CHECK(!natsSubjectMatches("a.b", "a.bc"));
+  CHECK(!natsSubjectMatches("a.bc", "a.b"));
+  printf("subjects:        * and > wildcards\n");
+}
+
+static void testNameFromField() {
+  CHECK(go("dev.commands", "{\"command\":\"ping\"}") == CMD_OK && last == "ping:pub");
+  CHECK(go("dev.commands", "{\"command\":\"ping\"}", "_INBOX.x") == CMD_OK && last == "ping:req");
+  CHECK(go("dev.commands", "  {\"x\":{\"a\":[1,\"}\",{}]},\"delay_ms\": 500 , \"command\" : \"reboot\"}") == CMD_OK &&
+        last == "reboot:500");
+  printf("name from body:  found after skipped nested fields\n");
+}
+
+static void testNameFromSubject() {
+  CHECK(go("dev.d1.cmd.reboot", "{\"delay_ms\":10}") == CMD_OK && last == "reboot:10");
+  CHECK(go("dev.d1.cmd.ping", "") == CMD_OK && last == "ping:pub");
+  CHECK(go("dev.d1.cmd.zzz", "") == CMD_UNKNOWN);
+  CHECK(go("dev.other", "{}") == CMD_UNROUTED);
+  printf("name from subj:  last token, empty body allowed\n");
+}
+
+static void testArguments() {
+  CHECK(go("dev.commands", "{\"command\":\"reboot\"}") == CMD_OK && last == "reboot:3000");
+  CHECK(go("dev.commands", "{\"command\":\"reboot\",\"delay_ms\":\"soon\"}") == CMD_BAD_ARGS);
+  CHECK(std::string(router.error()) == "bad argument delay_ms");
+  CHECK(go("dev.commands", "{\"command\":\"encoding\"}") == CMD_BAD_ARGS);
+  CHECK(std::string(router.error()) == "missing argument binary");
+  CHECK(go("dev.commands", "{\"command\":\"encoding\",\"binary\":true}") == CMD_OK && last == "encoding:1");
+  CHECK(go("dev.commands", "{\"command\":\"encoding\",\"binary\":null}") == CMD_BAD_ARGS);
+  CHECK(go("dev.commands", "{\"command\":\"say\",\"text\":\"a\\\"b\\u0041\\n\",\"gain\":1.5}") == CMD_OK &&
+        last == "say:a\"bA\n:1.500000");
+  printf("arguments:       defaults, required, types, escapes\n");
+}
+
+static void testFailures() {
+  CHECK(go("dev.commands", "{\"command\":\"nope\"}") == CMD_UNKNOWN);
+  CHECK(std::string(router.error()) == "unknown command nope");
+  CHECK(go("dev.commands", "{}") == CMD_NO_NAME);
+  CHECK(go("dev.commands", "{\"command\":5}") == CMD_NO_NAME);
+  CHECK(go("dev.commands", "") == CMD_NO_NAME);
+  CHECK(go("dev.commands", "{\"command\":\"ping\"") == CMD_BAD_JSON);
+  CHECK(go("dev.commands", "{\"command\" \"ping\"}") == CMD_BAD_JSON);
+  CHECK(go("dev.commands", "[1]") == CMD_BAD_JSON);
+  std::string longName = "{\"command\":\"" + std::string(CMD_NAME_MAX + 9, 'p') + "\"}";
+  CHECK(go("dev.commands", longName.c_str()) == CMD_NO_NAME);
+  CHECK(last.empty());
+  printf("failures:        unknown / no name / bad json, no handler called\n");
+}
+
+static void benchDispatch() {
+  static Command big[64];
+  static char names[64][16];
+  for (int i = 0; i < 64; i++) {
+    snprintf(names[i], sizeof(names[i]), "cmd%02d", i);
+    big[i] = {names[i], cmdPing, {}};
+  }
+  const CommandRoute routes[] = {{"b", big, 64, CMD_NAME_FROM_FIELD}};
+  CommandRouter bigRouter(routes, 1);
+  NatsOp op = message("b", "{\"command\":\"cmd47\",\"junk\":[1,2,3],\"more\":\"x\"}");
+
+  const long n = 1000000;
+  long ok = 0;
+  auto start = std::chrono::steady_clock::now();
+  for (long i = 0; i < n; i++) ok += bigRouter.dispatch(op) == CMD_OK;
+  double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / n;
+  CHECK(ok == n);
+  printf("dispatch:        %.0f ns per message (64 commands)\n", ns);
+}
+
+int main() {
+  testSubjectMatching();
+  testNameFromField();
+  testNameFromSubject();
+  testArguments();
+  testFailures();
+  benchDispatch();
+
+  if (failures) {
+    printf("%d check(s) failed\n", failures);
+    return 1;
+  }
+  printf("all checks passed\n");
+  return 0;
+}
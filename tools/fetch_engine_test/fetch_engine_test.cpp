@@ -0,0 +1,289 @@
+/*
+ * ═══════════════════════════════════════════════════════════════════════
+ * BLACKROAD FETCH ENGINE TEST
+ * ═══════════════════════════════════════════════════════════════════════
+ *
+ * Host run of src/fetch_engine.h (FreeRTOS tasks on std::thread) with
+ * three jobs doing real HTTP GETs against stub servers on loopback, each
+ * answering after an injected delay:
+ * - Parallel: a refresh takes as long as the slowest source, not the sum
+ * - Deadline: runFetchJobs() returns at the deadline with partial results,
+ *   the slow job keeps running
+ * - A job still in flight is not started again by the next refresh
+ * - A late job is harvested loop()-style (copy, then FETCH_IDLE)
+ * - Failures (refused, 500) report false; no task -> the job runs inline
+ *
+ * Build:   make
+ * Run:     ./fetch_engine_test         exits non-zero on any failure
+ */
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <cstdio>
+#include <string>
+#include <thread>
+
+#include <Arduino.h>
+#include "fetch_engine.h"
+
+static int failures = 0;
+
+#define CHECK(cond)                                                        \
+  do {                                                                     \
+    if (!(cond)) {                                                         \
+      printf("FAIL %s:%d: %s\n", __FILE__, __LINE__, #cond);               \
+      failures++;                                                          \
+    }                                                                      \
+  } while (0)
+
+#define SLACK_MS 150                 // Scheduling + loopback overhead allowed
+
+// ─────────────────────────────────────────────────────────────────────
+// STUB HTTP SERVER
+// ─────────────────────────────────────────────────────────────────────
+
+// Answers every GET with `status` and `body` after `delayMs`
+class StubServer {
+public:
+  StubServer(unsigned long delayMs, int status, const std::string& body)
+    : _delayMs(delayMs), _status(status), _body(body) {
+    _fd = socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in sa = {};
+    sa.sin_family = AF_INET;
+    sa.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    bind(_fd, (sockaddr*)&sa, sizeof(sa));
+    listen(_fd, 8);
+    socklen_t len = sizeof(sa);
+    getsockname(_fd, (sockaddr*)&sa, &len);
+    port = ntohs(sa.sin_port);
+    _thread = std::thread(&StubServer::run, this);
+  }
+
+  ~StubServer() {
+    shutdown(_fd, SHUT_RDWR);  // Wakes accept()
+    _thread.join();
+    close(_fd);
+  }
+
+  int port;
+  std::atomic<int> requests{0};
+
+private:
+  int _fd;
+  unsigned long _delayMs;
+  int _status;
+  std::string _body;
+  std::thread _thread;
+
+  void run() {
+    for (;;) {
+      int c = accept(_fd, NULL, NULL);
+      if (c < 0) return;
+      requests++;
+      std::thread(&StubServer::serve, this, c).detach();
+    }
+  }
+
+  void serve(int c) {
+    char buf[1024];
+    std::string req;
+    while (req.find("\r\n\r\n") == std::string::npos) {
+      ssize_t n = recv(c, buf, sizeof(buf), 0);
+      if (n <= 0) break;
+      req.append(buf, n);
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(_delayMs));
+    std::string resp = "HTTP/1.0 " + std::to_string(_status) + " X\r\nContent-Length: " +
+                       std::to_string(_body.size()) + "\r\n\r\n" + _body;
+    send(c, resp.data(), resp.size(), MSG_NOSIGNAL);
+    close(c);
+  }
+};
+
+// ─────────────────────────────────────────────────────────────────────
+// FETCHER
+// ─────────────────────────────────────────────────────────────────────
+
+// What a job writes - its arg, never shared state
+struct StubResult {
+  int port;
+  int status;
+  std::string body;
+};
+
+static bool fetchStub(void* arg) {
+  StubResult* out = (StubResult*)arg;
+  out->status = 0;
+  out->body.clear();
+
+  int fd = socket(AF_INET, SOCK_STREAM, 0);
+  timeval tv = {3, 0};
+  setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+  sockaddr_in sa = {};
+  sa.sin_family = AF_INET;
+  sa.sin_port = htons(out->port);
+  sa.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  if (connect(fd, (sockaddr*)&sa, sizeof(sa)) < 0) {
+    close(fd);
+    return false;
+  }
+
+  const char* req = "GET / HTTP/1.0\r\nHost: stub\r\n\r\n";
+  send(fd, req, strlen(req), MSG_NOSIGNAL);
+  std::string resp;
+  char buf[1024];
+  ssize_t n;
+  while ((n = recv(fd, buf, sizeof(buf), 0)) > 0) resp.append(buf, n);
+  close(fd);
+
+  size_t split = resp.find("\r\n\r\n");
+  if (resp.compare(0, 9, "HTTP/1.0 ") != 0 || split == std::string::npos) return false;
+  out->status = atoi(resp.c_str() + 9);
+  out->body = resp.substr(split + 4);
+  return out->status == 200;
+}
+
+// ─────────────────────────────────────────────────────────────────────
+// HARNESS
+// ─────────────────────────────────────────────────────────────────────
+
+struct Rig {
+  StubResult results[3];
+  FetchJob jobs[3] = {
+    {"Mesh", fetchStub, &results[0], FETCH_IDLE, false, 0, 0},
+    {"CRM", fetchStub, &results[1], FETCH_IDLE, false, 0, 0},
+    {"AI", fetchStub, &results[2], FETCH_IDLE, false, 0, 0},
+  };
+  std::string shown[3];              // What loop() displays
+
+  Rig(int a, int b, int c) {
+    results[0].port = a;
+    results[1].port = b;
+    results[2].port = c;
+  }
+
+  // navFetchTick(): copy finished results on the caller's thread
+  int harvest() {
+    int landed = 0;
+    for (int i = 0; i < 3; i++) {
+      if (jobs[i].state != FETCH_DONE) continue;
+      shown[i] = jobs[i].result ? results[i].body : "static";
+      jobs[i].state = FETCH_IDLE;
+      landed++;
+    }
+    return landed;
+  }
+
+  void waitAll() {
+    for (int i = 0; i < 3; i++) {
+      while (jobs[i].state == FETCH_RUNNING) delay(5);
+    }
+  }
+};
+
+static int closedPort() {
+  StubServer gone(0, 200, "");
+  return gone.port;  // Nobody listens here once it's destroyed
+}
+
+// ─────────────────────────────────────────────────────────────────────
+// TESTS
+// ─────────────────────────────────────────────────────────────────────
+
+static void testParallel() {
+  StubServer mesh(300, 200, "{\"nodes\":4}");
+  StubServer crm(500, 200, "{\"leads\":7}");
+  StubServer ai(200, 200, "{\"requests\":9}");
+  Rig rig(mesh.port, crm.port, ai.port);
+
+  unsigned long start = millis();
+  int finished = runFetchJobs(rig.jobs, 3, 3000);
+  unsigned long elapsed = millis() - start;
+
+  CHECK(finished == 3);
+  CHECK(elapsed >= 500 && elapsed < 500 + SLACK_MS);
+  CHECK(rig.harvest() == 3);
+  CHECK(rig.shown[0] == "{\"nodes\":4}" && rig.shown[1] == "{\"leads\":7}" && rig.shown[2] == "{\"requests\":9}");
+  printf("parallel:        300 + 500 + 200 ms sources in %lu ms\n", elapsed);
+}
+
+static void testDeadline() {
+  StubServer mesh(100, 200, "m");
+  StubServer crm(100, 200, "c");
+  StubServer ai(800, 200, "late");
+  Rig rig(mesh.port, crm.port, ai.port);
+
+  unsigned long start = millis();
+  int finished = runFetchJobs(rig.jobs, 3, 300);
+  unsigned long elapsed = millis() - start;
+  CHECK(finished == 2);
+  CHECK(elapsed >= 300 && elapsed < 300 + SLACK_MS);
+  CHECK(rig.jobs[2].state == FETCH_RUNNING);
+  CHECK(rig.harvest() == 2);
+  CHECK(rig.shown[0] == "m" && rig.shown[1] == "c" && rig.shown[2].empty());
+  printf("deadline:        returned at %lu ms with 2/3, slow source still running\n", elapsed);
+
+  // Next refresh while the slow job is in flight: it isn't started twice
+  finished = runFetchJobs(rig.jobs, 3, 300);
+  CHECK(finished == 2);
+  CHECK(ai.requests == 1);
+  CHECK(mesh.requests == 2 && crm.requests == 2);
+  rig.harvest();
+
+  // The late one lands and is picked up by the next loop() pass
+  rig.waitAll();
+  CHECK(rig.jobs[2].state == FETCH_DONE && rig.jobs[2].result);
+  CHECK(getFetchJobDuration(&rig.jobs[2]) >= 800);
+  CHECK(rig.harvest() == 1);
+  CHECK(rig.shown[2] == "late");
+  CHECK(rig.jobs[2].state == FETCH_IDLE);
+  printf("late harvest:    no double start, landed after %lu ms\n", getFetchJobDuration(&rig.jobs[2]));
+}
+
+static void testFailures() {
+  StubServer ok(50, 200, "ok");
+  StubServer broken(50, 500, "oops");
+  Rig rig(ok.port, broken.port, closedPort());
+
+  CHECK(runFetchJobs(rig.jobs, 3, 1000) == 3);
+  CHECK(rig.jobs[0].result && !rig.jobs[1].result && !rig.jobs[2].result);
+  CHECK(rig.harvest() == 3);
+  CHECK(rig.shown[0] == "ok" && rig.shown[1] == "static" && rig.shown[2] == "static");
+  printf("failures:        500 and refused fall back to static data\n");
+}
+
+static void testInlineFallback() {
+  StubServer a(50, 200, "a");
+  StubServer b(50, 200, "b");
+  StubServer c(50, 200, "c");
+  Rig rig(a.port, b.port, c.port);
+
+  hostTaskCreateFails = true;
+  unsigned long start = millis();
+  CHECK(runFetchJobs(rig.jobs, 3, 1000) == 3);
+  unsigned long elapsed = millis() - start;
+  hostTaskCreateFails = false;
+
+  CHECK(elapsed >= 150);  // Sequential again, but still correct
+  CHECK(rig.harvest() == 3);
+  CHECK(rig.shown[0] == "a" && rig.shown[1] == "b" && rig.shown[2] == "c");
+  printf("no task:         jobs ran inline, %lu ms\n", elapsed);
+}
+
+int main() {
+  testParallel();
+  testDeadline();
+  testFailures();
+  testInlineFallback();
+
+  if (failures) {
+    printf("%d check(s) failed\n", failures);
+    return 1;
+  }
+  printf("all checks passed\n");
+  return 0;
+}
@@ -0,0 +1,391 @@
+#ifndef HOST_SHIM_ARDUINO_H
+#define HOST_SHIM_ARDUINO_H
+
+/*
+ * ═══════════════════════════════════════════════════════════════════════
+ * BLACKROAD HOST SHIM - ARDUINO CORE
+ * ═══════════════════════════════════════════════════════════════════════
+ *
+ * Just enough of the ESP32 Arduino core to run lib/ and src/ headers in
+ * the host tests and benches under tools/:
+ * - millis() / micros() off the steady clock, or a manual clock a test
+ *   steps itself (hostClock.manual = true; hostClock.nowMs = ...)
+ * - String, Print, Stream (timed reads, find / findUntil), Serial -> stdout
+ * - IPAddress, ESP, esp_random()
+ *
+ * Header-only, every test is one translation unit. Not a general port:
+ * add what the next header under test needs, nothing more.
+ *
+ * Usage (Makefile):
+ *   CPPFLAGS += -I../host_shim -I../../lib/NatsOutbox
+ */
+
+#include <math.h>
+#include <stdarg.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <string>
+#include <thread>
+
+typedef bool boolean;
+typedef uint8_t byte;
+
+#define HIGH 1
+#define LOW 0
+#define INPUT 0
+#define OUTPUT 1
+
+using std::max;
+using std::min;
+
+#ifndef constrain
+#define constrain(amt, low, high) ((amt) < (low) ? (low) : ((amt) > (high) ? (high) : (amt)))
+#endif
+
+// ─────────────────────────────────────────────────────────────────────
+// TIME
+// ─────────────────────────────────────────────────────────────────────
+
+struct HostClock {
+  bool manual;               // Tests drive nowMs; delay() advances it
+  unsigned long nowMs;
+};
+
+inline HostClock hostClock = {false, 0};
+
+inline std::chrono::steady_clock::time_point hostClockEpoch() {
+  static const std::chrono::steady_clock::time_point epoch = std::chrono::steady_clock::now();
+  return epoch;
+}
+
+inline unsigned long micros() {
+  if (hostClock.manual) return hostClock.nowMs * 1000UL;
+  return (unsigned long)std::chrono::duration_cast<std::chrono::microseconds>(
+             std::chrono::steady_clock::now() - hostClockEpoch()).count();
+}
+
+inline unsigned long millis() {
+  if (hostClock.manual) return hostClock.nowMs;
+  return micros() / 1000UL;
+}
+
+inline void delay(unsigned long ms) {
+  if (hostClock.manual) {
+    hostClock.nowMs += ms;
+    return;
+  }
+  std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+}
+
+inline void delayMicroseconds(unsigned int us) {
+  std::this_thread::sleep_for(std::chrono::microseconds(us));
+}
+
+inline void yield() { std::this_thread::yield(); }
+
+// ─────────────────────────────────────────────────────────────────────
+// GPIO / RANDOM (no hardware on the host)
+// ─────────────────────────────────────────────────────────────────────
+
+inline void pinMode(int, int) {}
+inline void digitalWrite(int, int) {}
+inline int digitalRead(int) { return LOW; }
+inline void analogWrite(int, int) {}
+
+inline uint32_t esp_random() {
+  static std::mt19937 rng(std::random_device{}());
+  return rng();
+}
+
+inline long random(long maxValue) { return maxValue > 0 ? (long)(esp_random() % (uint32_t)maxValue) : 0; }
+inline long random(long minValue, long maxValue) { return minValue + random(maxValue - minValue); }
+
+inline long map(long x, long inMin, long inMax, long outMin, long outMax) {
+  return (x - inMin) * (outMax - outMin) / (inMax - inMin) + outMin;
+}
+
+// ─────────────────────────────────────────────────────────────────────
+// STRING
+// ─────────────────────────────────────────────────────────────────────
+
+class String {
+public:
+  String(const char* s = "") : _s(s ? s : "") {}
+  String(const std::string& s) : _s(s) {}
+  String(char c) : _s(1, c) {}
+  String(int v) : _s(std::to_string(v)) {}
+  String(unsigned int v) : _s(std::to_string(v)) {}
+  String(long v) : _s(std::to_string(v)) {}
+  String(unsigned long v) : _s(std::to_string(v)) {}
+  String(float v, unsigned int decimals = 2) : _s(fixed(v, decimals)) {}
+  String(double v, unsigned int decimals = 2) : _s(fixed(v, decimals)) {}
+
+  const char* c_str() const { return _s.c_str(); }
+  unsigned int length() const { return (unsigned int)_s.size(); }
+  bool isEmpty() const { return _s.empty(); }
+  void reserve(unsigned int n) { _s.reserve(n); }
+  char charAt(unsigned int i) const { return i < _s.size() ? _s[i] : 0; }
+  char operator[](unsigned int i) const { return charAt(i); }
+
+  String& operator+=(const String& o) { _s += o._s; return *this; }
+  String& operator+=(const char* o) { _s += o ? o : ""; return *this; }
+  String& operator+=(char c) { _s += c; return *this; }
+  String& operator+=(int v) { _s += std::to_string(v); return *this; }
+  String& operator+=(unsigned int v) { _s += std::to_string(v); return *this; }
+  String& operator+=(long v) { _s += std::to_string(v); return *this; }
+  String& operator+=(unsigned long v) { _s += std::to_string(v); return *this; }
+  bool concat(const String& o) { _s += o._s; return true; }
+
+  bool operator==(const String& o) const { return _s == o._s; }
+  bool operator==(const char* o) const { return _s == (o ? o : ""); }
+  bool operator!=(const String& o) const { return !(*this == o); }
+  bool operator!=(const char* o) const { return !(*this == o); }
+  bool equals(const String& o) const { return *this == o; }
+  bool equalsIgnoreCase(const String& o) const { return strcasecmp(_s.c_str(), o._s.c_str()) == 0; }
+  bool startsWith(const String& p) const { return _s.compare(0, p._s.size(), p._s) == 0; }
+  bool endsWith(const String& p) const {
+    return _s.size() >= p._s.size() && _s.compare(_s.size() - p._s.size(), p._s.size(), p._s) == 0;
+  }
+
+  int indexOf(char c, unsigned int from = 0) const { return pos(_s.find(c, from)); }
+  int indexOf(const String& s, unsigned int from = 0) const { return pos(_s.find(s._s, from)); }
+  int lastIndexOf(char c) const { return pos(_s.rfind(c)); }
+  String substring(unsigned int from) const { return from < _s.size() ? String(_s.substr(from)) : String(); }
+  String substring(unsigned int from, unsigned int to) const {
+    if (from > to) std::swap(from, to);
+    return from < _s.size() ? String(_s.substr(from, to - from)) : String();
+  }
+
+  long toInt() const { return atol(_s.c_str()); }
+  float toFloat() const { return (float)atof(_s.c_str()); }
+  void toLowerCase() { for (char& c : _s) c = (char)tolower((unsigned char)c); }
+  void toUpperCase() { for (char& c : _s) c = (char)toupper((unsigned char)c); }
+  void trim() {
+    size_t a = _s.find_first_not_of(" \t\r\n");
+    size_t b = _s.find_last_not_of(" \t\r\n");
+    _s = a == std::string::npos ? std::string() : _s.substr(a, b - a + 1);
+  }
+  void remove(unsigned int index) { if (index < _s.size()) _s.erase(index); }
+  void remove(unsigned int index, unsigned int count) { if (index < _s.size()) _s.erase(index, count); }
+  void replace(const String& from, const String& to) {
+    if (from._s.empty()) return;
+    for (size_t p = 0; (p = _s.find(from._s, p)) != std::string::npos; p += to._s.size()) {
+      _s.replace(p, from._s.size(), to._s);
+    }
+  }
+
+  const std::string& str() const { return _s; }
+
+private:
+  std::string _s;
+
+  static int pos(size_t p) { return p == std::string::npos ? -1 : (int)p; }
+  static std::string fixed(double v, unsigned int decimals) {
+    char buf[48];
+    snprintf(buf, sizeof(buf), "%.*f", (int)decimals, v);
+    return buf;
+  }
+};
+
+inline String operator+(const String& a, const String& b) { String r(a); r += b; return r; }
+inline String operator+(const String& a, const char* b) { String r(a); r += b; return r; }
+inline String operator+(const char* a, const String& b) { String r(a); r += b; return r; }
+inline String operator+(const String& a, char b) { String r(a); r += b; return r; }
+
+// ─────────────────────────────────────────────────────────────────────
+// PRINT / STREAM
+// ─────────────────────────────────────────────────────────────────────
+
+class Print {
+public:
+  virtual ~Print() {}
+  virtual size_t write(uint8_t c) = 0;
+  virtual size_t write(const uint8_t* buf, size_t n) {
+    size_t done = 0;
+    while (n--) done += write(*buf++);
+    return done;
+  }
+  size_t write(const char* s) { return write((const uint8_t*)s, strlen(s)); }
+  size_t write(const char* s, size_t n) { return write((const uint8_t*)s, n); }
+  virtual void flush() {}
+
+  size_t print(const char* s) { return write(s); }
+  size_t print(const String& s) { return write(s.c_str()); }
+  size_t print(char c) { return write((uint8_t)c); }
+  size_t print(int v) { return print(String(v)); }
+  size_t print(unsigned int v) { return print(String(v)); }
+  size_t print(long v) { return print(String(v)); }
+  size_t print(unsigned long v) { return print(String(v)); }
+  size_t print(double v, int decimals = 2) { return print(String(v, decimals)); }
+  size_t println() { return write("\r\n"); }
+  template <typename T> size_t println(T v) { return print(v) + println(); }
+
+  size_t printf(const char* fmt, ...) __attribute__((format(printf, 2, 3))) {
+    char small[256];
+    va_list args;
+    va_start(args, fmt);
+    int n = vsnprintf(small, sizeof(small), fmt, args);
+    va_end(args);
+    if (n < 0) return 0;
+    if ((size_t)n < sizeof(small)) return write((const uint8_t*)small, n);
+
+    std::string big(n + 1, '\0');
+    va_start(args, fmt);
+    vsnprintf(&big[0], big.size(), fmt, args);
+    va_end(args);
+    return write((const uint8_t*)big.data(), n);
+  }
+};
+
+class Stream : public Print {
+public:
+  virtual int available() = 0;
+  virtual int read() = 0;
+  virtual int peek() = 0;
+
+  void setTimeout(unsigned long ms) { _timeout = ms; }
+  unsigned long getTimeout() const { return _timeout; }
+
+  size_t readBytes(char* buf, size_t n) {
+    size_t got = 0;
+    while (got < n) {
+      int c = timedRead();
+      if (c < 0) break;
+      buf[got++] = (char)c;
+    }
+    return got;
+  }
+  size_t readBytes(uint8_t* buf, size_t n) { return readBytes((char*)buf, n); }
+
+  size_t readBytesUntil(char terminator, char* buf, size_t n) {
+    size_t got = 0;
+    while (got < n) {
+      int c = timedRead();
+      if (c < 0 || c == terminator) break;
+      buf[got++] = (char)c;
+    }
+    return got;
+  }
+
+  String readStringUntil(char terminator) {
+    std::string s;
+    int c;
+    while ((c = timedRead()) >= 0 && c != terminator) s += (char)c;
+    return String(s);
+  }
+
+  String readString() {
+    std::string s;
+    int c;
+    while ((c = timedRead()) >= 0) s += (char)c;
+    return String(s);
+  }
+
+  bool find(const char* target) { return findUntil(target, NULL); }
+
+  bool findUntil(const char* target, const char* terminator) {
+    size_t tLen = strlen(target);
+    size_t termLen = terminator ? strlen(terminator) : 0;
+    size_t tIdx = 0, termIdx = 0;
+    if (tLen == 0) return true;
+    int c;
+    while ((c = timedRead()) >= 0) {
+      tIdx = (c == target[tIdx]) ? tIdx + 1 : (c == target[0] ? 1 : 0);
+      if (tIdx >= tLen) return true;
+      if (termLen) {
+        termIdx = (c == terminator[termIdx]) ? termIdx + 1 : (c == terminator[0] ? 1 : 0);
+        if (termIdx >= termLen) return false;
+      }
+    }
+    return false;
+  }
+
+protected:
+  unsigned long _timeout = 1000;
+
+  int timedRead() {
+    unsigned long start = millis();
+    do {
+      int c = read();
+      if (c >= 0) return c;
+      if (hostClock.manual) break;  // Nothing will arrive while time stands still
+      std::this_thread::sleep_for(std::chrono::microseconds(100));
+    } while (millis() - start < _timeout);
+    return -1;
+  }
+};
+
+// Serial is stdout; nothing ever arrives on it
+class HardwareSerial : public Stream {
+public:
+  void begin(unsigned long) {}
+  size_t write(uint8_t c) override { return fputc(c, stdout) == EOF ? 0 : 1; }
+  size_t write(const uint8_t* buf, size_t n) override { return fwrite(buf, 1, n, stdout); }
+  using Print::write;
+  int available() override { return 0; }
+  int read() override { return -1; }
+  int peek() override { return -1; }
+  void flush() override { fflush(stdout); }
+  operator bool() const { return true; }
+};
+
+inline HardwareSerial Serial;
+
+// ─────────────────────────────────────────────────────────────────────
+// IPADDRESS / ESP
+// ─────────────────────────────────────────────────────────────────────
+
+class IPAddress {
+public:
+  IPAddress() : _addr(0) {}
+  IPAddress(uint8_t a, uint8_t b, uint8_t c, uint8_t d)
+      : _addr((uint32_t)a | ((uint32_t)b << 8) | ((uint32_t)c << 16) | ((uint32_t)d << 24)) {}
+  IPAddress(uint32_t networkOrder) : _addr(networkOrder) {}
+
+  operator uint32_t() const { return _addr; }  // Network byte order, like lwIP
+  uint8_t operator[](int i) const { return (uint8_t)(_addr >> (8 * i)); }
+  bool operator==(const IPAddress& o) const { return _addr == o._addr; }
+
+  bool fromString(const char* s) {
+    unsigned int a, b, c, d;
+    char extra;
+    if (sscanf(s, "%u.%u.%u.%u%c", &a, &b, &c, &d, &extra) != 4 || a > 255 || b > 255 || c > 255 || d > 255) {
+      return false;
+    }
+    *this = IPAddress(a, b, c, d);
+    return true;
+  }
+
+  String toString() const {
+    char buf[16];
+    snprintf(buf, sizeof(buf), "%u.%u.%u.%u", (*this)[0], (*this)[1], (*this)[2], (*this)[3]);
+    return String(buf);
+  }
+
+private:
+  uint32_t _addr;
+};
+
+// A host has plenty of heap - report a roomy ESP32 so heap guards pass
+class EspClass {
+public:
+  uint32_t getFreeHeap() { return 200000; }
+  uint32_t getMinFreeHeap() { return 150000; }
+  uint32_t getMaxAllocHeap() { return 110000; }
+  uint32_t getHeapSize() { return 320000; }
+  uint32_t getCpuFreqMHz() { return 240; }
+  const char* getChipModel() { return "host"; }
+  uint8_t getChipRevision() { return 0; }
+  void restart() { fflush(stdout); exit(0); }
+};
+
+inline EspClass ESP;
+
+#endif // HOST_SHIM_ARDUINO_H
@@ -0,0 +1,19 @@
+#ifndef HOST_SHIM_CLIENT_H
+#define HOST_SHIM_CLIENT_H
+
+#include "Arduino.h"
+
+// Arduino's network client interface - tests subclass it with a fake
+class Client : public Stream {
+public:
+  virtual int connect(IPAddress ip, uint16_t port) = 0;
+  virtual int connect(const char* host, uint16_t port) = 0;
+  virtual int read(uint8_t* buf, size_t size) = 0;
+  virtual void stop() = 0;
+  virtual uint8_t connected() = 0;
+  virtual operator bool() = 0;
+  using Stream::read;
+  using Print::write;
+};
+
+#endif // HOST_SHIM_CLIENT_H
@@ -0,0 +1,189 @@
+#ifndef HOST_SHIM_FS_H
+#define HOST_SHIM_FS_H
+
+/*
+ * ═══════════════════════════════════════════════════════════════════════
+ * BLACKROAD HOST SHIM - RAM FLASH FILESYSTEM
+ * ═══════════════════════════════════════════════════════════════════════
+ *
+ * fs::FS and fs::File over RAM, with the wear a SPIFFS partition on the
+ * ESP32's SPI NOR flash would see:
+ * - Every write() programs the FLASH_PAGE_BYTES pages it touches (a
+ *   partial page still costs a whole program), every close() after a
+ *   write one more page of file index
+ * - remove() and "w" truncation release the file's pages for erase
+ * - Bytes / pages read are counted the same way
+ * - modelUs() adds up programs and reads with datasheet-typical timings,
+ *   for an on-device estimate next to the host CPU time. Erases are left
+ *   out: SPIFFS runs them later, in garbage collection
+ *
+ * failAfterBytes cuts a write short once that many more bytes have been
+ * programmed - a reset in the middle of a record.
+ *
+ * Usage:
+ *   fs::FS flash;                   // Stands in for SPIFFS
+ *   OutboundJournal journal(flash, "/jrnl", 4096, 8);
+ *   ... flash.stats.pagesProgrammed, flash.modelUs() ...
+ */
+
+#include <stdint.h>
+#include <string.h>
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#define FLASH_PAGE_BYTES 256
+#define FLASH_PROGRAM_US 700         // Page program, typ.
+#define FLASH_READ_US 30             // One page at 40 MHz DIO, incl. command
+
+struct RamFlashStats {
+  uint64_t bytesWritten;
+  uint64_t pagesProgrammed;
+  uint64_t bytesRead;
+  uint64_t pagesRead;
+  uint64_t pagesErased;
+  uint32_t opens;
+};
+
+namespace fs {
+
+typedef std::vector<uint8_t> Blob;
+
+class File {
+public:
+  File() {}
+
+  explicit operator bool() const { return (bool)_blob; }
+
+  size_t write(const uint8_t* buf, size_t n);
+  size_t write(uint8_t c) { return write(&c, 1); }
+
+  size_t read(uint8_t* buf, size_t n);
+  int read() {
+    uint8_t c;
+    return read(&c, 1) == 1 ? c : -1;
+  }
+
+  bool seek(uint32_t pos) {
+    if (!_blob || pos > _blob->size()) return false;
+    _pos = pos;
+    return true;
+  }
+
+  size_t position() const { return _pos; }
+  size_t size() const { return _blob ? _blob->size() : 0; }
+  int available() { return _blob ? (int)(_blob->size() - _pos) : 0; }
+
+  void close();
+
+private:
+  friend class FS;
+  class FS* _fs = nullptr;
+  std::shared_ptr<Blob> _blob;
+  size_t _pos = 0;
+  bool _append = false;
+  bool _dirty = false;
+};
+
+class FS {
+public:
+  RamFlashStats stats = {};
+  int64_t failAfterBytes = -1;       // < 0: never fail
+
+  File open(const char* path, const char* mode = "r") {
+    File f;
+    auto it = _files.find(path);
+    if (mode[0] == 'r') {
+      if (it == _files.end()) return f;
+    } else if (it == _files.end()) {
+      it = _files.emplace(path, std::make_shared<Blob>()).first;
+    } else if (mode[0] == 'w') {
+      release(it->second->size());
+      it->second->clear();
+    }
+    stats.opens++;
+    f._fs = this;
+    f._blob = it->second;
+    f._append = mode[0] == 'a';
+    f._pos = f._append ? f._blob->size() : 0;
+    return f;
+  }
+
+  bool exists(const char* path) const { return _files.count(path) != 0; }
+
+  bool remove(const char* path) {
+    auto it = _files.find(path);
+    if (it == _files.end()) return false;
+    release(it->second->size());
+    _files.erase(it);
+    return true;
+  }
+
+  bool mkdir(const char*) { return true; }  // Flat namespace, like SPIFFS
+
+  size_t fileCount() const { return _files.size(); }
+
+  size_t usedBytes() const {
+    size_t n = 0;
+    for (const auto& kv : _files) n += kv.second->size();
+    return n;
+  }
+
+  uint64_t modelUs() const {
+    return stats.pagesProgrammed * FLASH_PROGRAM_US + stats.pagesRead * FLASH_READ_US;
+  }
+
+  void resetStats() { stats = RamFlashStats(); }
+
+private:
+  friend class File;
+  std::map<std::string, std::shared_ptr<Blob>> _files;
+
+  static uint64_t pagesSpanned(size_t off, size_t n) {
+    if (n == 0) return 0;
+    return (off + n - 1) / FLASH_PAGE_BYTES - off / FLASH_PAGE_BYTES + 1;
+  }
+
+  void release(size_t bytes) { stats.pagesErased += (bytes + FLASH_PAGE_BYTES - 1) / FLASH_PAGE_BYTES; }
+};
+
+inline size_t File::write(const uint8_t* buf, size_t n) {
+  if (!_blob) return 0;
+  if (_fs->failAfterBytes >= 0) {
+    if ((int64_t)n > _fs->failAfterBytes) n = (size_t)_fs->failAfterBytes;
+    _fs->failAfterBytes -= n;
+  }
+  if (_append) _pos = _blob->size();
+  if (_pos + n > _blob->size()) _blob->resize(_pos + n);
+  memcpy(_blob->data() + _pos, buf, n);
+  _fs->stats.bytesWritten += n;
+  _fs->stats.pagesProgrammed += FS::pagesSpanned(_pos, n);
+  _pos += n;
+  if (n) _dirty = true;
+  return n;
+}
+
+inline size_t File::read(uint8_t* buf, size_t n) {
+  if (!_blob || _pos >= _blob->size()) return 0;
+  if (n > _blob->size() - _pos) n = _blob->size() - _pos;
+  memcpy(buf, _blob->data() + _pos, n);
+  _fs->stats.bytesRead += n;
+  _fs->stats.pagesRead += FS::pagesSpanned(_pos, n);
+  _pos += n;
+  return n;
+}
+
+inline void File::close() {
+  if (_blob && _dirty) _fs->stats.pagesProgrammed++;  // File index update
+  _blob.reset();
+  _dirty = false;
+}
+
+}  // namespace fs
+
+using fs::File;
+using fs::FS;
+
+#endif // HOST_SHIM_FS_H
@@ -0,0 +1,50 @@
+#ifndef HOST_SHIM_FAKE_CLIENT_H
+#define HOST_SHIM_FAKE_CLIENT_H
+
+#include <string>
+#include "Client.h"
+
+// In-memory Client for protocol tests: records every socket write, serves
+// reads from `input`, and can be told to refuse writes (dead connection)
+class FakeClient : public Client {
+public:
+  std::string out;           // Everything written, in order
+  std::string input;         // Bytes read() hands out
+  uint32_t writes = 0;       // write() calls = TCP segments on a real socket
+  bool failWrites = false;
+  bool open = true;
+
+  size_t write(uint8_t c) override { return write(&c, 1); }
+  size_t write(const uint8_t* buf, size_t n) override {
+    writes++;
+    if (failWrites || !open) return 0;
+    out.append((const char*)buf, n);
+    return n;
+  }
+  using Print::write;
+
+  int available() override { return (int)input.size(); }
+  int read() override {
+    if (input.empty()) return -1;
+    int c = (uint8_t)input[0];
+    input.erase(0, 1);
+    return c;
+  }
+  int read(uint8_t* buf, size_t size) override {
+    size_t n = std::min(size, input.size());
+    memcpy(buf, input.data(), n);
+    input.erase(0, n);
+    return (int)n;
+  }
+  int peek() override { return input.empty() ? -1 : (uint8_t)input[0]; }
+
+  int connect(IPAddress, uint16_t) override { open = true; return 1; }
+  int connect(const char*, uint16_t) override { open = true; return 1; }
+  void stop() override { open = false; }
+  uint8_t connected() override { return open; }
+  operator bool() override { return open; }
+
+  void reset() { out.clear(); writes = 0; }
+};
+
+#endif // HOST_SHIM_FAKE_CLIENT_H
@@ -0,0 +1,107 @@
+#ifndef HOST_SHIM_HTTP_CLIENT_H
+#define HOST_SHIM_HTTP_CLIENT_H
+
+/*
+ * ═══════════════════════════════════════════════════════════════════════
+ * BLACKROAD HOST SHIM - HTTP CLIENT
+ * ═══════════════════════════════════════════════════════════════════════
+ *
+ * The slice of the ESP32 core's HTTPClient the alert dispatcher uses, over
+ * WiFiClient - http:// URLs only (tests point the firmware at stand-ins
+ * on loopback):
+ * - begin(url) / addHeader() / setTimeout() / POST() / end()
+ * - One request per connection ("Connection: close"); the response body
+ *   is read and dropped, POST() returns the status code
+ * - Negative HTTPC_ERROR_* codes for refused connections and timeouts,
+ *   same values as the core
+ *
+ * Usage:
+ *   HTTPClient http;
+ *   http.begin("http://127.0.0.1:8080/hook");
+ *   int code = http.POST((uint8_t*)body, len);
+ *   http.end();
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <string>
+
+#include "WiFiClient.h"
+
+#define HTTPC_ERROR_CONNECTION_REFUSED (-1)
+#define HTTPC_ERROR_SEND_PAYLOAD_FAILED (-3)
+#define HTTPC_ERROR_NOT_CONNECTED (-4)
+#define HTTPC_ERROR_READ_TIMEOUT (-11)
+
+#define HTTP_CODE_OK 200
+#define HTTP_CODE_NOT_MODIFIED 304
+
+class HTTPClient {
+public:
+  bool begin(const char* url) {
+    end();
+    if (strncmp(url, "http://", 7) != 0) return false;
+    const char* host = url + 7;
+    const char* path = strchr(host, '/');
+    std::string authority = path ? std::string(host, path - host) : std::string(host);
+    _path = path ? path : "/";
+    size_t colon = authority.find(':');
+    _host = authority.substr(0, colon);
+    _port = colon == std::string::npos ? 80 : (uint16_t)atoi(authority.c_str() + colon + 1);
+    _headers.clear();
+    return true;
+  }
+
+  bool begin(const String& url) { return begin(url.c_str()); }
+
+  void setTimeout(uint16_t ms) { _timeoutMs = ms; }
+
+  void addHeader(const String& name, const String& value) {
+    _headers += std::string(name.c_str()) + ": " + value.c_str() + "\r\n";
+  }
+
+  int POST(uint8_t* payload, size_t size) { return sendRequest("POST", payload, size); }
+  int POST(const String& payload) { return POST((uint8_t*)payload.c_str(), payload.length()); }
+
+  void end() { _client.stop(); }
+
+private:
+  WiFiClient _client;
+  std::string _host;
+  std::string _path;
+  std::string _headers;
+  uint16_t _port = 80;
+  uint16_t _timeoutMs = 5000;
+
+  int sendRequest(const char* method, const uint8_t* payload, size_t size) {
+    _client.setTimeout(_timeoutMs);
+    if (!_client.connect(_host.c_str(), _port)) return HTTPC_ERROR_CONNECTION_REFUSED;
+
+    std::string head = std::string(method) + " " + _path + " HTTP/1.1\r\nHost: " + _host +
+                       "\r\nConnection: close\r\nContent-Length: " + std::to_string(size) + "\r\n" +
+                       _headers + "\r\n";
+    if (_client.write((const uint8_t*)head.data(), head.size()) != head.size() ||
+        _client.write(payload, size) != size) {
+      _client.stop();
+      return HTTPC_ERROR_SEND_PAYLOAD_FAILED;
+    }
+
+    // "HTTP/1.1 204 No Content" - then skip headers and body
+    String status = _client.readStringUntil('\n');
+    const char* sp = strchr(status.c_str(), ' ');
+    int code = sp ? atoi(sp + 1) : 0;
+    if (code <= 0) {
+      _client.stop();
+      return HTTPC_ERROR_READ_TIMEOUT;
+    }
+    unsigned long start = millis();
+    while (_client.connected() && millis() - start < _timeoutMs) {
+      if (_client.read() < 0) delay(1);
+    }
+    _client.stop();
+    return code;
+  }
+};
+
+#endif // HOST_SHIM_HTTP_CLIENT_H
@@ -0,0 +1,17 @@
+#ifndef HOST_SHIM_SPIFFS_H
+#define HOST_SHIM_SPIFFS_H
+
+#include "FS.h"
+
+// The SPIFFS partition is a RAM flash (FS.h); mounting always works
+class SPIFFSFS : public fs::FS {
+public:
+  bool begin(bool formatOnFail = false) {
+    (void)formatOnFail;
+    return true;
+  }
+};
+
+inline SPIFFSFS SPIFFS;
+
+#endif // HOST_SHIM_SPIFFS_H
@@ -0,0 +1,34 @@
+#ifndef HOST_SHIM_WIFI_H
+#define HOST_SHIM_WIFI_H
+
+#include <netdb.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+
+#include "Arduino.h"
+
+// The station is always up on the host; names resolve through the OS
+typedef enum {
+  WL_IDLE_STATUS = 0,
+  WL_CONNECTED = 3,
+  WL_DISCONNECTED = 6
+} wl_status_t;
+
+class WiFiClass {
+public:
+  wl_status_t status() { return WL_CONNECTED; }
+
+  int hostByName(const char* host, IPAddress& out) {
+    addrinfo hints = {};
+    hints.ai_family = AF_INET;
+    addrinfo* res = NULL;
+    if (getaddrinfo(host, NULL, &hints, &res) != 0 || !res) return 0;
+    out = IPAddress((uint32_t)((sockaddr_in*)res->ai_addr)->sin_addr.s_addr);
+    freeaddrinfo(res);
+    return 1;
+  }
+};
+
+inline WiFiClass WiFi;
+
+#endif // HOST_SHIM_WIFI_H
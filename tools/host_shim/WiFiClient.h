@@ -0,0 +1,115 @@
+#ifndef HOST_SHIM_WIFI_CLIENT_H
+#define HOST_SHIM_WIFI_CLIENT_H
+
+#include <errno.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "Client.h"
+#include "WiFi.h"
+
+// The ESP32 core's plain TCP client over a POSIX socket. read() never
+// blocks (Stream::timedRead() does the waiting); setTimeout() also bounds
+// connect and send, like the core's socket options.
+class WiFiClient : public Client {
+public:
+  ~WiFiClient() override { stop(); }
+
+  int connect(IPAddress ip, uint16_t port) override {
+    stop();
+    _fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (_fd < 0) return 0;
+    timeval tv = {(long)(_timeout / 1000), (long)(_timeout % 1000) * 1000};
+    setsockopt(_fd, SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof(tv));
+    int one = 1;
+    setsockopt(_fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    sockaddr_in addr = {};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = (uint32_t)ip;
+    addr.sin_port = htons(port);
+    if (::connect(_fd, (sockaddr*)&addr, sizeof(addr)) < 0) {
+      stop();
+      return 0;
+    }
+    return 1;
+  }
+
+  int connect(const char* host, uint16_t port) override {
+    IPAddress ip;
+    if (!WiFi.hostByName(host, ip)) return 0;
+    return connect(ip, port);
+  }
+
+  size_t write(uint8_t c) override { return write(&c, 1); }
+
+  size_t write(const uint8_t* buf, size_t n) override {
+    if (_fd < 0) return 0;
+    size_t done = 0;
+    while (done < n) {
+      ssize_t sent = send(_fd, buf + done, n - done, MSG_NOSIGNAL);
+      if (sent <= 0) break;
+      done += sent;
+    }
+    return done;
+  }
+
+  int available() override {
+    if (_peeked >= 0) return 1;
+    if (_fd < 0) return 0;
+    uint8_t c;
+    ssize_t n = recv(_fd, &c, 1, MSG_PEEK | MSG_DONTWAIT);
+    if (n == 0 || (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK)) _eof = true;
+    return n > 0 ? 1 : 0;
+  }
+
+  int read() override {
+    uint8_t c;
+    return read(&c, 1) == 1 ? c : -1;
+  }
+
+  int read(uint8_t* buf, size_t size) override {
+    if (size == 0) return 0;
+    size_t got = 0;
+    if (_peeked >= 0) {
+      buf[got++] = (uint8_t)_peeked;
+      _peeked = -1;
+    }
+    if (_fd < 0 || got == size) return got ? (int)got : -1;
+    ssize_t n = recv(_fd, buf + got, size - got, MSG_DONTWAIT);
+    if (n == 0 || (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK)) _eof = true;
+    if (n > 0) got += n;
+    return got ? (int)got : -1;
+  }
+
+  int peek() override {
+    if (_peeked < 0) _peeked = read();
+    return _peeked;
+  }
+
+  void stop() override {
+    if (_fd >= 0) close(_fd);
+    _fd = -1;
+    _peeked = -1;
+    _eof = false;
+  }
+
+  // Still open, or closed by the peer with bytes left to read
+  uint8_t connected() override {
+    if (_fd < 0) return 0;
+    available();
+    return !_eof || _peeked >= 0;
+  }
+
+  operator bool() override { return _fd >= 0; }
+
+  using Print::write;
+
+private:
+  int _fd = -1;
+  int _peeked = -1;
+  bool _eof = false;
+};
+
+#endif // HOST_SHIM_WIFI_CLIENT_H
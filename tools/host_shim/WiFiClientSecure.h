@@ -0,0 +1,127 @@
+#ifndef HOST_SHIM_WIFI_CLIENT_SECURE_H
+#define HOST_SHIM_WIFI_CLIENT_SECURE_H
+
+#include <string.h>
+
+#include <lwip/sockets.h>
+
+#include "Client.h"
+#include "WiFi.h"
+#include "ssl_client.h"
+
+// The ESP32 core's WiFiClientSecure over a system mbedTLS 2.x: a full
+// handshake on every connect(), no certificate check (setInsecure()), and
+// the protected sslclient / _connected members subclasses reach into
+class WiFiClientSecure : public Client {
+public:
+  WiFiClientSecure() {
+    sslclient = new sslclient_context();
+    ssl_init(sslclient);
+    sslclient->socket = -1;
+  }
+
+  ~WiFiClientSecure() override {
+    stop();
+    delete sslclient;
+  }
+
+  void setInsecure() {}
+
+  int connect(IPAddress ip, uint16_t port) override {
+    return connect(ip.toString().c_str(), port);
+  }
+
+  int connect(const char* host, uint16_t port) override { return connect(host, port, 10000); }
+
+  virtual int connect(const char* host, uint16_t port, int32_t timeoutMs) {
+    IPAddress ip;
+    if (!WiFi.hostByName(host, ip)) return 0;
+
+    stop();
+    ssl_init(sslclient);
+    sslclient->socket = lwip_socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+    sockaddr_in addr = {};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = (uint32_t)ip;
+    addr.sin_port = htons(port);
+    timeval tv = {timeoutMs / 1000, (timeoutMs % 1000) * 1000};
+    setsockopt(sslclient->socket, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+    if (lwip_connect(sslclient->socket, (sockaddr*)&addr, sizeof(addr)) < 0) {
+      stop();
+      return 0;
+    }
+
+    const char* pers = "esp32-ssl";
+    mbedtls_entropy_init(&sslclient->entropy_ctx);
+    int ret = mbedtls_ctr_drbg_seed(&sslclient->drbg_ctx, mbedtls_entropy_func, &sslclient->entropy_ctx,
+                                    (const unsigned char*)pers, strlen(pers));
+    if (ret == 0) {
+      ret = mbedtls_ssl_config_defaults(&sslclient->ssl_conf, MBEDTLS_SSL_IS_CLIENT,
+                                        MBEDTLS_SSL_TRANSPORT_STREAM, MBEDTLS_SSL_PRESET_DEFAULT);
+    }
+    if (ret == 0) {
+      mbedtls_ssl_conf_authmode(&sslclient->ssl_conf, MBEDTLS_SSL_VERIFY_NONE);
+      mbedtls_ssl_conf_rng(&sslclient->ssl_conf, mbedtls_ctr_drbg_random, &sslclient->drbg_ctx);
+      ret = mbedtls_ssl_setup(&sslclient->ssl_ctx, &sslclient->ssl_conf);
+    }
+    if (ret == 0) ret = mbedtls_ssl_set_hostname(&sslclient->ssl_ctx, host);
+    if (ret == 0) {
+      mbedtls_ssl_set_bio(&sslclient->ssl_ctx, &sslclient->socket, mbedtls_net_send, mbedtls_net_recv, NULL);
+      while ((ret = mbedtls_ssl_handshake(&sslclient->ssl_ctx)) == MBEDTLS_ERR_SSL_WANT_READ ||
+             ret == MBEDTLS_ERR_SSL_WANT_WRITE) {
+      }
+    }
+    if (ret != 0) {
+      stop();
+      return 0;
+    }
+    _connected = true;
+    return 1;
+  }
+
+  size_t write(uint8_t c) override { return write(&c, 1); }
+  size_t write(const uint8_t* buf, size_t n) override {
+    if (!_connected) return 0;
+    int ret = mbedtls_ssl_write(&sslclient->ssl_ctx, buf, n);
+    return ret > 0 ? (size_t)ret : 0;
+  }
+  using Print::write;
+
+  int available() override { return _connected ? (int)mbedtls_ssl_get_bytes_avail(&sslclient->ssl_ctx) : 0; }
+
+  int read() override {
+    uint8_t c;
+    return read(&c, 1) == 1 ? c : -1;
+  }
+
+  // Blocks for the next record; 0 once the peer closed
+  int read(uint8_t* buf, size_t size) override {
+    if (!_connected) return -1;
+    int ret = mbedtls_ssl_read(&sslclient->ssl_ctx, buf, size);
+    if (ret <= 0) {
+      _connected = false;
+      return ret == 0 || ret == MBEDTLS_ERR_SSL_PEER_CLOSE_NOTIFY ? 0 : -1;
+    }
+    return ret;
+  }
+
+  int peek() override { return -1; }
+
+  void stop() override {
+    if (sslclient->socket >= 0) {
+      lwip_close(sslclient->socket);
+      sslclient->socket = -1;
+    }
+    _connected = false;
+    stop_ssl_socket(sslclient);
+  }
+
+  uint8_t connected() override { return _connected; }
+  operator bool() override { return _connected; }
+
+protected:
+  sslclient_context* sslclient;
+  bool _connected = false;
+};
+
+#endif // HOST_SHIM_WIFI_CLIENT_SECURE_H
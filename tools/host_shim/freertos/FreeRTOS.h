@@ -0,0 +1,36 @@
+#ifndef HOST_SHIM_FREERTOS_H
+#define HOST_SHIM_FREERTOS_H
+
+/*
+ * ═══════════════════════════════════════════════════════════════════════
+ * BLACKROAD HOST SHIM - FREERTOS
+ * ═══════════════════════════════════════════════════════════════════════
+ *
+ * Tasks and semaphores on std::thread, for the src/ headers that start
+ * FreeRTOS tasks or take a semaphore (fetch_engine.h):
+ * - One tick is one millisecond (configTICK_RATE_HZ 1000)
+ * - xTaskCreate() starts a detached thread; hostTaskCreateFails makes it
+ *   refuse, like an ESP32 out of heap for another stack
+ * - vTaskDelete(NULL) only returns - the task function ends right after
+ *   it, and the thread with it
+ *
+ * Usage:
+ *   #include <freertos/FreeRTOS.h>        // -I../host_shim
+ */
+
+#include <stdint.h>
+
+typedef uint32_t TickType_t;
+typedef int BaseType_t;
+typedef unsigned int UBaseType_t;
+
+#define configTICK_RATE_HZ 1000
+#define portTICK_PERIOD_MS 1
+#define portMAX_DELAY ((TickType_t)0xFFFFFFFF)
+#define pdMS_TO_TICKS(ms) ((TickType_t)(ms))
+#define pdTRUE 1
+#define pdFALSE 0
+#define pdPASS pdTRUE
+#define pdFAIL pdFALSE
+
+#endif // HOST_SHIM_FREERTOS_H
@@ -0,0 +1,51 @@
+#ifndef HOST_SHIM_FREERTOS_SEMPHR_H
+#define HOST_SHIM_FREERTOS_SEMPHR_H
+
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+
+#include "FreeRTOS.h"
+
+// Counting semaphore; a mutex is one with a single token
+struct HostSemaphore {
+  std::mutex lock;
+  std::condition_variable given;
+  UBaseType_t count;
+  UBaseType_t max;
+};
+
+typedef HostSemaphore* SemaphoreHandle_t;
+
+inline SemaphoreHandle_t xSemaphoreCreateCounting(UBaseType_t max, UBaseType_t initial) {
+  SemaphoreHandle_t s = new HostSemaphore();
+  s->count = initial;
+  s->max = max;
+  return s;
+}
+
+inline SemaphoreHandle_t xSemaphoreCreateMutex() { return xSemaphoreCreateCounting(1, 1); }
+inline SemaphoreHandle_t xSemaphoreCreateBinary() { return xSemaphoreCreateCounting(1, 0); }
+
+inline BaseType_t xSemaphoreTake(SemaphoreHandle_t s, TickType_t ticks) {
+  std::unique_lock<std::mutex> guard(s->lock);
+  if (ticks == portMAX_DELAY) {
+    s->given.wait(guard, [s] { return s->count > 0; });
+  } else if (!s->given.wait_for(guard, std::chrono::milliseconds(ticks), [s] { return s->count > 0; })) {
+    return pdFALSE;
+  }
+  s->count--;
+  return pdTRUE;
+}
+
+inline BaseType_t xSemaphoreGive(SemaphoreHandle_t s) {
+  std::lock_guard<std::mutex> guard(s->lock);
+  if (s->count >= s->max) return pdFALSE;
+  s->count++;
+  s->given.notify_one();
+  return pdTRUE;
+}
+
+inline void vSemaphoreDelete(SemaphoreHandle_t s) { delete s; }
+
+#endif // HOST_SHIM_FREERTOS_SEMPHR_H
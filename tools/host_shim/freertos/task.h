@@ -0,0 +1,28 @@
+#ifndef HOST_SHIM_FREERTOS_TASK_H
+#define HOST_SHIM_FREERTOS_TASK_H
+
+#include <chrono>
+#include <thread>
+
+#include "FreeRTOS.h"
+
+typedef void (*TaskFunction_t)(void*);
+typedef void* TaskHandle_t;
+
+inline bool hostTaskCreateFails = false;
+
+inline BaseType_t xTaskCreate(TaskFunction_t fn, const char*, uint32_t, void* param, UBaseType_t,
+                              TaskHandle_t* handle) {
+  if (hostTaskCreateFails) return pdFAIL;
+  std::thread(fn, param).detach();
+  if (handle) *handle = NULL;
+  return pdPASS;
+}
+
+inline void vTaskDelete(TaskHandle_t) {}
+
+inline void vTaskDelay(TickType_t ticks) {
+  std::this_thread::sleep_for(std::chrono::milliseconds(ticks));
+}
+
+#endif // HOST_SHIM_FREERTOS_TASK_H
@@ -0,0 +1,18 @@
+#ifndef HOST_SHIM_LWIP_SOCKETS_H
+#define HOST_SHIM_LWIP_SOCKETS_H
+
+// lwIP's BSD socket names over the host's own sockets
+
+#include <errno.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/select.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+inline int lwip_socket(int domain, int type, int protocol) { return ::socket(domain, type, protocol); }
+inline int lwip_connect(int s, const struct sockaddr* addr, socklen_t len) { return ::connect(s, addr, len); }
+inline int lwip_close(int s) { return ::close(s); }
+
+#endif // HOST_SHIM_LWIP_SOCKETS_H
@@ -0,0 +1,40 @@
+#ifndef HOST_SHIM_SSL_CLIENT_H
+#define HOST_SHIM_SSL_CLIENT_H
+
+// The ESP32 core's mbedTLS client context (libraries/WiFiClientSecure),
+// same fields, so code that drives the handshake itself can run on the
+// host against a system mbedTLS 2.x
+
+#include <mbedtls/ctr_drbg.h>
+#include <mbedtls/entropy.h>
+#include <mbedtls/net_sockets.h>
+#include <mbedtls/ssl.h>
+#include <mbedtls/x509_crt.h>
+
+typedef struct sslclient_context {
+  int socket;
+  mbedtls_ssl_context ssl_ctx;
+  mbedtls_ssl_config ssl_conf;
+  mbedtls_ctr_drbg_context drbg_ctx;
+  mbedtls_entropy_context entropy_ctx;
+  mbedtls_x509_crt ca_cert;
+  mbedtls_x509_crt client_cert;
+  mbedtls_pk_context client_key;
+  unsigned long handshake_timeout;
+} sslclient_context;
+
+inline void ssl_init(sslclient_context* ssl_client) {
+  mbedtls_ssl_init(&ssl_client->ssl_ctx);
+  mbedtls_ssl_config_init(&ssl_client->ssl_conf);
+  mbedtls_ctr_drbg_init(&ssl_client->drbg_ctx);
+}
+
+// Free the mbedTLS state; the caller closes the socket
+inline void stop_ssl_socket(sslclient_context* ssl_client) {
+  mbedtls_ssl_free(&ssl_client->ssl_ctx);
+  mbedtls_ssl_config_free(&ssl_client->ssl_conf);
+  mbedtls_ctr_drbg_free(&ssl_client->drbg_ctx);
+  mbedtls_entropy_free(&ssl_client->entropy_ctx);
+}
+
+#endif // HOST_SHIM_SSL_CLIENT_H
@@ -0,0 +1,211 @@
+/*
+ * ═══════════════════════════════════════════════════════════════════════
+ * BLACKROAD JETSTREAM PUBLISHER TEST
+ * ═══════════════════════════════════════════════════════════════════════
+ *
+ * Host run of lib/JetStreamPublisher with the real NatsInbox, NatsOutbox
+ * and NatsParser; the server side is scripted MSG / HMSG frames:
+ * - Window: JS_WINDOW publishes in flight, the next one is refused
+ * - Framing: HPUB with the inbox reply subject and a Nats-Msg-Id header
+ * - Acks: plain, duplicate and error acks settle (or don't) the right slot
+ * - Retransmit after JS_ACK_TIMEOUT_MS with the same Msg-Id, give-up after
+ *   JS_MAX_ATTEMPTS, rewind() after a reconnect
+ * - A 503 no-responders status switches JetStream off, begin() back on
+ *
+ * Build:   make
+ * Run:     ./jetstream_publisher_test  exits non-zero on any failure
+ */
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "FakeClient.h"
+#include "JetStreamPublisher.h"
+
+static int failures = 0;
+
+#define CHECK(cond)                                                        \
+  do {                                                                     \
+    if (!(cond)) {                                                         \
+      printf("FAIL %s:%d: %s\n", __FILE__, __LINE__, #cond);               \
+      failures++;                                                          \
+    }                                                                      \
+  } while (0)
+
+#define BOOT_ID 0xabc
+#define REPLY_PREFIX "_INBOX.dev1.00000abc"
+
+// One device: client, outbox, inbox, publisher and the parser feeding acks
+struct Rig {
+  FakeClient client;
+  NatsOutbox outbox{client, 20};
+  NatsInbox inbox{outbox, "dev1"};
+  JetStreamPublisher js{outbox, inbox, "dev1"};
+  NatsParser parser{onOp, this};
+  std::vector<std::string> gaveUp;
+
+  Rig() {
+    inbox.begin(BOOT_ID);
+    js.begin(BOOT_ID);
+    js.onGiveUp(onGiveUp, this);
+  }
+
+  static void onOp(const NatsOp& op, void* ctx) { ((Rig*)ctx)->inbox.handle(op); }
+
+  static void onGiveUp(const char*, const char* data, size_t len, void* ctx) {
+    ((Rig*)ctx)->gaveUp.push_back(std::string(data, len));
+  }
+
+  void feed(const std::string& frame) { parser.parse((const uint8_t*)frame.data(), frame.size()); }
+
+  void ack(uint32_t token, const std::string& payload) {
+    feed("MSG " REPLY_PREFIX + std::to_string(token) + " 2 " + std::to_string(payload.size()) +
+         "\r\n" + payload + "\r\n");
+  }
+
+  std::string sent() {
+    outbox.flush();
+    std::string s = client.out;
+    client.reset();
+    return s;
+  }
+};
+
+static size_t count(const std::string& s, const std::string& needle) {
+  size_t n = 0;
+  for (size_t at = s.find(needle); at != std::string::npos; at = s.find(needle, at + 1)) n++;
+  return n;
+}
+
+static void testWindowAndFraming() {
+  hostClock.nowMs = 1000;
+  Rig rig;
+
+  for (int i = 0; i < JS_WINDOW; i++) CHECK(rig.js.publish("s", "{\"t\":1}", 7));
+  CHECK(!rig.js.publish("s", "x", 1));
+  CHECK(rig.js.room() == 0);
+  CHECK(rig.inbox.pending() == JS_WINDOW);
+
+  std::string out = rig.sent();
+  std::string first = "HPUB s " REPLY_PREFIX "1 42 49\r\nNATS/1.0\r\nNats-Msg-Id: dev1-00000abc-1\r\n\r\n{\"t\":1}\r\n";
+  CHECK(out.compare(0, first.size(), first) == 0);
+  CHECK(count(out, "HPUB s ") == JS_WINDOW);
+  CHECK(count(out, "Nats-Msg-Id: dev1-00000abc-8\r\n") == 1);
+  printf("window:          %d HPUBs in flight, #%d refused\n", JS_WINDOW, JS_WINDOW + 1);
+}
+
+static void testAcks() {
+  hostClock.nowMs = 1000;
+  Rig rig;
+  for (int i = 0; i < 4; i++) CHECK(rig.js.publish("s", "{}", 2));
+  rig.sent();
+
+  hostClock.nowMs += 30;
+  rig.ack(1, "{\"stream\":\"SENSORS\",\"seq\":1}");
+  rig.ack(2, "{\"stream\":\"SENSORS\",\"seq\":2,\"duplicate\":true}");
+  rig.ack(3, "{\"error\":{\"code\":500,\"description\":\"x\"}}");
+  rig.ack(1, "{\"stream\":\"SENSORS\",\"seq\":1}");  // Late copy: already settled
+
+  CHECK(rig.js.stats.acked == 2);
+  CHECK(rig.js.stats.duplicates == 1);
+  CHECK(rig.js.stats.errors == 1);
+  CHECK(rig.js.inFlight() == 2);
+  CHECK(rig.js.avgAckMs() == 30);
+  CHECK(rig.inbox.stats.unmatched == 1);
+
+  // The error ack is retransmitted on the next tick, same Msg-Id
+  rig.js.tick();
+  std::string out = rig.sent();
+  CHECK(rig.js.stats.retransmits == 1);
+  CHECK(count(out, "Nats-Msg-Id: dev1-00000abc-3\r\n") == 1);
+  CHECK(count(out, "HPUB") == 1);
+  printf("acks:            ack / duplicate / error / late copy, avg %u ms\n", rig.js.avgAckMs());
+}
+
+static void testRetransmitAndGiveUp() {
+  hostClock.nowMs = 1000;
+  Rig rig;
+  CHECK(rig.js.publish("s", "lost", 4));
+  rig.sent();
+
+  hostClock.nowMs += JS_ACK_TIMEOUT_MS - 1;
+  rig.js.tick();
+  CHECK(rig.js.stats.retransmits == 0);
+
+  for (int i = 1; i < JS_MAX_ATTEMPTS; i++) {
+    hostClock.nowMs += JS_ACK_TIMEOUT_MS;
+    rig.js.tick();
+  }
+  std::string out = rig.sent();
+  CHECK(rig.js.stats.retransmits == JS_MAX_ATTEMPTS - 1);
+  CHECK(count(out, "Nats-Msg-Id: dev1-00000abc-1\r\n") == JS_MAX_ATTEMPTS - 1);
+  CHECK(rig.gaveUp.empty());
+
+  hostClock.nowMs += JS_ACK_TIMEOUT_MS;
+  rig.js.tick();
+  CHECK(rig.js.stats.gaveUp == 1);
+  CHECK(rig.gaveUp.size() == 1 && rig.gaveUp[0] == "lost");
+  CHECK(rig.js.inFlight() == 0);
+  CHECK(rig.inbox.pending() == 0);
+  printf("give-up:         %d attempts, then handed back\n", JS_MAX_ATTEMPTS);
+}
+
+static void testRewind() {
+  hostClock.nowMs = 1000;
+  Rig rig;
+  CHECK(rig.js.publish("s", "a", 1));
+  CHECK(rig.js.publish("s", "b", 1));
+  rig.sent();
+
+  rig.js.rewind();
+  std::string out = rig.sent();
+  CHECK(count(out, "Nats-Msg-Id: dev1-00000abc-1\r\n") == 1);
+  CHECK(count(out, "Nats-Msg-Id: dev1-00000abc-2\r\n") == 1);
+  printf("rewind:          in-flight messages resent with their Msg-Ids\n");
+}
+
+static void testNoResponders() {
+  hostClock.nowMs = 1000;
+  Rig rig;
+  CHECK(rig.js.publish("s", "y", 1));
+  CHECK(rig.js.publish("s", "z", 1));
+  rig.sent();
+
+  rig.feed("HMSG " REPLY_PREFIX "1 2 16 16\r\nNATS/1.0 503\r\n\r\n\r\n");
+  CHECK(!rig.js.enabled());
+  CHECK(rig.js.room() == 0);
+  CHECK(rig.gaveUp.size() == 2);
+  CHECK(rig.inbox.pending() == 0);
+  CHECK(!rig.js.publish("s", "w", 1));
+  printf("no responders:   503 disables JetStream, %zu handed back\n", rig.gaveUp.size());
+
+  // A later probe finds a stream again: Msg-Ids carry on where they were
+  rig.js.begin(BOOT_ID);
+  CHECK(rig.js.enabled());
+  CHECK(rig.js.publish("s", "w", 1));
+  CHECK(count(rig.sent(), "Nats-Msg-Id: dev1-00000abc-3\r\n") == 1);
+
+  rig.js.end();
+  CHECK(!rig.js.enabled());
+  CHECK(rig.gaveUp.size() == 3 && rig.gaveUp[2] == "w");
+  CHECK(rig.inbox.pending() == 0);
+  printf("re-enable:       begin() resumes at Msg-Id 3, end() hands back the rest\n");
+}
+
+int main() {
+  hostClock.manual = true;
+
+  testWindowAndFraming();
+  testAcks();
+  testRetransmitAndGiveUp();
+  testRewind();
+  testNoResponders();
+
+  if (failures) {
+    printf("%d check(s) failed\n", failures);
+    return 1;
+  }
+  printf("all checks passed\n");
+  return 0;
+}
@@ -0,0 +1,179 @@
+/*
+ * ═══════════════════════════════════════════════════════════════════════
+ * BLACKROAD OUTBOUND JOURNAL BENCHMARK
+ * ═══════════════════════════════════════════════════════════════════════
+ *
+ * Host run of lib/OutboundJournal on the RAM flash emulator (host_shim
+ * FS.h), with the NATS firmware's geometry (16 x 4 KB segments):
+ * - Write amplification per payload size: journal bytes (headers + ack
+ *   metadata) and flash pages programmed, per payload byte, for an
+ *   offline spell followed by a batched drain
+ * - Replay throughput: a full journal reopened after a reset and replayed
+ *   in firmware-sized batches - host CPU rate and the emulator's
+ *   on-device estimate
+ * - Checks along the way: order across the reset, the size bound, and a
+ *   record torn mid-write skipped on the next begin()
+ *
+ * Build:   make
+ * Run:     ./journal_bench [N]      N records per amplification run (default 2,000)
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+#include <Arduino.h>
+#include <FS.h>
+#include "OutboundJournal.h"
+
+static int failures = 0;
+
+#define CHECK(cond)                                                        \
+  do {                                                                     \
+    if (!(cond)) {                                                         \
+      printf("FAIL %s:%d: %s\n", __FILE__, __LINE__, #cond);               \
+      failures++;                                                          \
+    }                                                                      \
+  } while (0)
+
+#define SEGMENT_BYTES 4096           // Same as the NATS firmware
+#define SEGMENTS 16
+#define REPLAY_BATCH 10
+#define TOPIC "blackroad.devices.esp32.telemetry"
+
+static std::string payload(uint32_t i, size_t len) {
+  std::string p = "{\"i\":" + std::to_string(i) + ",\"v\":\"";
+  while (p.size() + 2 < len) p += (char)('a' + p.size() % 26);
+  p += "\"}";
+  return p.substr(0, len);
+}
+
+// Replay everything the journal holds, acking one batch at a time like
+// natsReplayTick(). Returns the number of records; checks seq order.
+static uint32_t drain(OutboundJournal& journal, size_t len) {
+  OutboundJournal::Record rec;
+  uint32_t n = 0;
+  uint32_t lastSeq = 0;
+  for (;;) {
+    int batch = 0;
+    while (batch < REPLAY_BATCH && journal.read(rec)) {
+      CHECK(rec.seq > lastSeq);
+      CHECK(rec.dataLen == len && strcmp(rec.topic, TOPIC) == 0);
+      lastSeq = rec.seq;
+      batch++;
+    }
+    if (batch == 0) break;
+    journal.ack(lastSeq);  // PONG for the batch
+    n += batch;
+  }
+  return n;
+}
+
+static void benchAmplification(uint32_t records) {
+  printf("amplification:   %u records per run, acked in batches of %d\n", records, REPLAY_BATCH);
+  printf("   payload   journal  flash pages   erased KB\n");
+
+  const size_t sizes[] = {32, 128, 480};
+  for (size_t len : sizes) {
+    fs::FS flash;
+    OutboundJournal journal(flash, "/jrnl", SEGMENT_BYTES, SEGMENTS);
+    CHECK(journal.begin());
+
+    // Offline spells of 100 records, each drained before the next
+    uint32_t replayed = 0;
+    for (uint32_t i = 0; i < records; i++) {
+      std::string p = payload(i, len);
+      CHECK(journal.append(1, TOPIC, p.data(), p.size()) != 0);
+      if ((i + 1) % 100 == 0) replayed += drain(journal, len);
+    }
+    replayed += drain(journal, len);
+    CHECK(replayed == records);
+    CHECK(journal.pending() == 0);
+    CHECK(journal.stats.dropped == 0);
+
+    double payloadBytes = journal.stats.payloadBytes;
+    printf("   %5zu B    %5.2fx       %5.2fx   %9.1f\n", len, journal.writeAmplificationX100() / 100.0,
+           flash.stats.pagesProgrammed * FLASH_PAGE_BYTES / payloadBytes,
+           flash.stats.pagesErased * FLASH_PAGE_BYTES / 1024.0);
+  }
+}
+
+static void benchReplay() {
+  fs::FS flash;
+  const size_t len = 128;
+  uint32_t appended = 0;
+  {
+    OutboundJournal journal(flash, "/jrnl", SEGMENT_BYTES, SEGMENTS);
+    CHECK(journal.begin());
+    // Fill to the bound: the oldest segment goes, the rest stays in order
+    for (uint32_t i = 0; i < 600; i++) {
+      std::string p = payload(i, len);
+      if (journal.append(1, TOPIC, p.data(), p.size())) appended++;
+    }
+    CHECK(journal.stats.dropped > 0);
+    CHECK(journal.sizeBytes() <= (uint32_t)SEGMENT_BYTES * SEGMENTS);
+    printf("size bound:      %u appended, %u dropped, %u KB on flash\n", appended, journal.stats.dropped,
+           journal.sizeBytes() / 1024);
+  }
+
+  // Reset: a new journal object over the same flash
+  OutboundJournal journal(flash, "/jrnl", SEGMENT_BYTES, SEGMENTS);
+  CHECK(journal.begin());
+  uint32_t waiting = journal.pending();
+  CHECK(waiting > 0 && journal.lastSeq() == appended);
+  flash.resetStats();
+
+  auto start = std::chrono::steady_clock::now();
+  uint32_t replayed = drain(journal, len);
+  double sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  CHECK(replayed == waiting);
+  CHECK(journal.pending() == 0);
+  CHECK(flash.fileCount() <= 1);  // Only the ack metadata is left
+  printf("replay:          %u records after reset, %.0f rec/s host, %.0f rec/s on-flash estimate\n",
+         replayed, replayed / sec, replayed * 1e6 / flash.modelUs());
+  printf("                 %.1f KB read in %llu pages, %llu pages erased on compaction\n",
+         flash.stats.bytesRead / 1024.0, (unsigned long long)flash.stats.pagesRead,
+         (unsigned long long)flash.stats.pagesErased);
+}
+
+static void checkTornWrite() {
+  fs::FS flash;
+  {
+    OutboundJournal journal(flash, "/jrnl", SEGMENT_BYTES, SEGMENTS);
+    CHECK(journal.begin());
+    for (uint32_t i = 0; i < 5; i++) CHECK(journal.append(1, TOPIC, "{}", 2) == i + 1);
+    flash.failAfterBytes = 7;  // Reset inside the next record's header
+    CHECK(journal.append(1, TOPIC, "{}", 2) == 0);
+    flash.failAfterBytes = -1;
+  }
+
+  OutboundJournal journal(flash, "/jrnl", SEGMENT_BYTES, SEGMENTS);
+  CHECK(journal.begin());
+  CHECK(journal.stats.corrupt == 1);
+  CHECK(journal.pending() == 5);
+  CHECK(journal.append(1, TOPIC, "{\"after\":1}", 11) == 6);  // Into a fresh segment
+
+  OutboundJournal::Record rec;
+  uint32_t seq = 0;
+  while (journal.read(rec)) CHECK(rec.seq == ++seq);
+  CHECK(seq == 6);
+  CHECK(strcmp(rec.data, "{\"after\":1}") == 0);
+  printf("torn write:      partial record skipped, 5 + 1 replayed in order\n");
+}
+
+int main(int argc, char** argv) {
+  uint32_t records = argc > 1 ? (uint32_t)atol(argv[1]) : 2000;
+
+  benchAmplification(records);
+  benchReplay();
+  checkTornWrite();
+
+  if (failures) {
+    printf("%d check(s) failed\n", failures);
+    return 1;
+  }
+  printf("all checks passed\n");
+  return 0;
+}
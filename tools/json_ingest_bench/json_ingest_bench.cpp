@@ -0,0 +1,524 @@
+/*
+ * ═══════════════════════════════════════════════════════════════════════
+ * BLACKROAD JSON INGESTION BENCHMARK
+ * ═══════════════════════════════════════════════════════════════════════
+ *
+ * Replays API responses through both ways the dashboard has parsed them
+ * and reports peak heap and parse time for each:
+ * - Buffered (before): the whole body in a String, then an unfiltered
+ *   DynamicJsonDocument sized like the old fetchers (16 KB / 8 KB / 8 KB)
+ * - Streamed (now): straight from the body Stream with the fetchers'
+ *   filters and document sizes; the GitHub repo list one element at a
+ *   time (jsonPeekToken), as fetchGitHubStats() walks it
+ *
+ * Payloads are generated with the fields and sizes of real responses
+ * (GitHub /users/:user/repos?per_page=100, Stripe /v1/charges?limit=10,
+ * Linear issues query), or replayed from a recorded file. The totals the
+ * dashboard shows must come out the same either way.
+ *
+ * Heap is every operator new plus every ArduinoJson pool, counted while
+ * one parse runs; the StaticJsonDocuments the fetchers keep on the task
+ * stack are listed separately. ArduinoJson slots are twice the ESP32's
+ * size on a 64-bit host, so the fixed pools fill up sooner here.
+ *
+ * Build:   make                       (needs ArduinoJson 6, see Makefile)
+ * Run:     ./json_ingest_bench                    generated payloads
+ *          ./json_ingest_bench github FILE        replay a recorded body
+ *          (kinds: github, stripe, linear)
+ */
+
+#include <chrono>
+#include <cstdarg>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <new>
+#include <sstream>
+#include <string>
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+
+static int failures = 0;
+
+#define CHECK(cond)                                                        \
+  do {                                                                     \
+    if (!(cond)) {                                                         \
+      printf("FAIL %s:%d: %s\n", __FILE__, __LINE__, #cond);               \
+      failures++;                                                          \
+    }                                                                      \
+  } while (0)
+
+#define RUNS 50                      // Parses averaged per path
+
+// ─────────────────────────────────────────────────────────────────────
+// HEAP ACCOUNTING
+// ─────────────────────────────────────────────────────────────────────
+
+static size_t heapNow = 0;
+static size_t heapPeak = 0;
+
+// Size lives in front of the block so frees can be counted too
+static void* trackedAlloc(size_t n) {
+  max_align_t* p = (max_align_t*)malloc(n + sizeof(max_align_t));
+  if (!p) return NULL;
+  *(size_t*)p = n;
+  heapNow += n;
+  if (heapNow > heapPeak) heapPeak = heapNow;
+  return p + 1;
+}
+
+static void trackedFree(void* ptr) {
+  if (!ptr) return;
+  max_align_t* p = (max_align_t*)ptr - 1;
+  heapNow -= *(size_t*)p;
+  free(p);
+}
+
+static void* trackedRealloc(void* ptr, size_t n) {
+  void* q = trackedAlloc(n);
+  if (q && ptr) {
+    size_t old = *(size_t*)((max_align_t*)ptr - 1);
+    memcpy(q, ptr, old < n ? old : n);
+    trackedFree(ptr);
+  }
+  return q;
+}
+
+void* operator new(size_t n) {
+  void* p = trackedAlloc(n);
+  if (!p) throw std::bad_alloc();
+  return p;
+}
+void* operator new[](size_t n) { return operator new(n); }
+void operator delete(void* p) noexcept { trackedFree(p); }
+void operator delete[](void* p) noexcept { trackedFree(p); }
+void operator delete(void* p, size_t) noexcept { trackedFree(p); }
+void operator delete[](void* p, size_t) noexcept { trackedFree(p); }
+
+// DynamicJsonDocument with its pool counted
+struct CountingAllocator {
+  void* allocate(size_t n) { return trackedAlloc(n); }
+  void deallocate(void* p) { trackedFree(p); }
+  void* reallocate(void* p, size_t n) { return trackedRealloc(p, n); }
+};
+typedef BasicJsonDocument<CountingAllocator> CountedJsonDocument;
+
+// Peak heap above what was live when the measurement started
+struct HeapMark {
+  size_t base;
+  HeapMark() : base(heapNow) { heapPeak = heapNow; }
+  size_t peak() const { return heapPeak - base; }
+};
+
+// ─────────────────────────────────────────────────────────────────────
+// BODY STREAM
+// ─────────────────────────────────────────────────────────────────────
+
+// A response body as the fetchers see it: bytes off the socket, read once
+class ReplayStream : public Stream {
+public:
+  explicit ReplayStream(const std::string& body) : _body(body), _pos(0) { setTimeout(0); }
+
+  int available() override { return (int)(_body.size() - _pos); }
+  int read() override { return _pos < _body.size() ? (uint8_t)_body[_pos++] : -1; }
+  int peek() override { return _pos < _body.size() ? (uint8_t)_body[_pos] : -1; }
+  size_t write(uint8_t) override { return 0; }
+
+private:
+  const std::string& _body;
+  size_t _pos;
+};
+
+// Same as src/json_stream.h
+static int jsonPeekToken(Stream& s) {
+  int c;
+  while ((c = s.peek()) == ' ' || c == '\n' || c == '\r' || c == '\t') s.read();
+  return c;
+}
+
+// old http.getString(): Content-Length known, one allocation
+static String bufferBody(Stream& s, size_t len) {
+  String body;
+  body.reserve(len);
+  int c;
+  while ((c = s.read()) >= 0) body += (char)c;
+  return body;
+}
+
+// ─────────────────────────────────────────────────────────────────────
+// PAYLOADS
+// ─────────────────────────────────────────────────────────────────────
+
+static std::string fmt(const char* f, ...) {
+  va_list ap;
+  va_start(ap, f);
+  int len = vsnprintf(NULL, 0, f, ap);
+  va_end(ap);
+
+  std::string s(len, '\0');
+  va_start(ap, f);
+  vsnprintf(&s[0], len + 1, f, ap);
+  va_end(ap);
+  return s;
+}
+
+// What the dashboard shows, to compare the two paths
+struct Totals {
+  int count;                 // Repos / succeeded charges / issues
+  long sum;                  // Stars / cents / priorities
+  long sum2;                 // Forks / - / -
+  std::string first;         // Newest repo / first description / first title
+  bool operator==(const Totals& o) const {
+    return count == o.count && sum == o.sum && sum2 == o.sum2 && first == o.first;
+  }
+};
+
+static const char* GITHUB_URLS[] = {
+  "archive_url", "assignees_url", "blobs_url", "branches_url", "collaborators_url", "comments_url",
+  "commits_url", "compare_url", "contents_url", "contributors_url", "deployments_url", "downloads_url",
+  "events_url", "forks_url", "git_commits_url", "git_refs_url", "git_tags_url", "hooks_url",
+  "issue_comment_url", "issue_events_url", "issues_url", "keys_url", "labels_url", "languages_url",
+  "merges_url", "milestones_url", "notifications_url", "pulls_url", "releases_url", "stargazers_url",
+  "statuses_url", "subscribers_url", "subscription_url", "tags_url", "teams_url", "trees_url",
+};
+
+static const char* GITHUB_OWNER_URLS[] = {
+  "url", "html_url", "followers_url", "following_url", "gists_url", "starred_url",
+  "subscriptions_url", "organizations_url", "repos_url", "events_url", "received_events_url",
+};
+
+// /users/blackroad/repos?per_page=100 - ~5 KB per repo
+static std::string githubRepos(int n, Totals* truth) {
+  *truth = Totals{n, 0, 0, "repo-0"};
+  std::string s = "[";
+  for (int i = 0; i < n; i++) {
+    int stars = (i * 37) % 500;
+    int forks = (i * 11) % 60;
+    truth->sum += stars;
+    truth->sum2 += forks;
+
+    std::string name = fmt("repo-%d", i);
+    std::string api = "https://api.github.com/repos/blackroad/" + name;
+    if (i) s += ",";
+    s += fmt("{\"id\":%d,\"node_id\":\"R_kgDOJ%07d\",\"name\":\"%s\",\"full_name\":\"blackroad/%s\",\"private\":false,",
+             700000000 + i, i, name.c_str(), name.c_str());
+    s += "\"owner\":{\"login\":\"blackroad\",\"id\":118630001,\"node_id\":\"O_kgDOBxIycQ\","
+         "\"avatar_url\":\"https://avatars.githubusercontent.com/u/118630001?v=4\",\"gravatar_id\":\"\",";
+    for (const char* u : GITHUB_OWNER_URLS) s += fmt("\"%s\":\"https://api.github.com/users/blackroad/%s\",", u, u);
+    s += "\"type\":\"Organization\",\"site_admin\":false},";
+    s += fmt("\"html_url\":\"https://github.com/blackroad/%s\",\"description\":\"BlackRoad OS component %d - "
+             "services, firmware and tooling for the sovereign stack\",\"fork\":false,\"url\":\"%s\",",
+             name.c_str(), i, api.c_str());
+    for (const char* u : GITHUB_URLS) s += fmt("\"%s\":\"%s/%s{/sha}\",", u, api.c_str(), u);
+    s += fmt("\"created_at\":\"2024-03-%02dT10:00:00Z\",\"updated_at\":\"2025-10-%02dT12:00:00Z\","
+             "\"pushed_at\":\"2025-10-%02dT12:00:00Z\",\"git_url\":\"git://github.com/blackroad/%s.git\","
+             "\"ssh_url\":\"git@github.com:blackroad/%s.git\",\"clone_url\":\"https://github.com/blackroad/%s.git\","
+             "\"svn_url\":\"https://github.com/blackroad/%s\",\"homepage\":null,\"size\":%d,",
+             1 + i % 28, 28 - i % 28, 28 - i % 28, name.c_str(), name.c_str(), name.c_str(), name.c_str(),
+             1000 + i * 13);
+    s += fmt("\"stargazers_count\":%d,\"watchers_count\":%d,\"language\":\"C++\",\"has_issues\":true,"
+             "\"has_projects\":true,\"has_downloads\":true,\"has_wiki\":false,\"has_pages\":false,"
+             "\"has_discussions\":false,\"forks_count\":%d,\"mirror_url\":null,\"archived\":false,"
+             "\"disabled\":false,\"open_issues_count\":%d,",
+             stars, stars, forks, i % 7);
+    s += "\"license\":{\"key\":\"mit\",\"name\":\"MIT License\",\"spdx_id\":\"MIT\","
+         "\"url\":\"https://api.github.com/licenses/mit\",\"node_id\":\"MDc6TGljZW5zZTEz\"},"
+         "\"allow_forking\":true,\"is_template\":false,\"web_commit_signoff_required\":false,"
+         "\"topics\":[\"esp32\",\"iot\",\"dashboard\"],\"visibility\":\"public\",";
+    s += fmt("\"forks\":%d,\"open_issues\":%d,\"watchers\":%d,\"default_branch\":\"main\","
+             "\"permissions\":{\"admin\":true,\"maintain\":true,\"push\":true,\"triage\":true,\"pull\":true}}",
+             forks, i % 7, stars);
+  }
+  return s + "]";
+}
+
+// /v1/charges?limit=10 - ~3 KB per charge, every 4th one failed
+static std::string stripeCharges(int n, Totals* truth) {
+  *truth = Totals{0, 0, 0, ""};
+  std::string s = "{\"object\":\"list\",\"data\":[";
+  for (int i = 0; i < n; i++) {
+    bool ok = i % 4 != 3;
+    int amount = 1999 + i * 500;
+    std::string desc = fmt("Order #%d - BlackRoad Pro", 1000 + i);
+    if (ok) {
+      if (truth->count == 0) truth->first = desc;
+      truth->count++;
+      truth->sum += amount;
+    }
+    if (i) s += ",";
+    s += fmt("{\"id\":\"ch_3N%020d\",\"object\":\"charge\",\"amount\":%d,\"amount_captured\":%d,"
+             "\"amount_refunded\":0,\"application\":null,\"application_fee\":null,\"application_fee_amount\":null,"
+             "\"balance_transaction\":\"txn_3N%018d\",",
+             i, amount, ok ? amount : 0, i);
+    s += "\"billing_details\":{\"address\":{\"city\":\"Minneapolis\",\"country\":\"US\",\"line1\":\"100 Main St\","
+         "\"line2\":null,\"postal_code\":\"55401\",\"state\":\"MN\"},\"email\":\"ops@blackroad.io\","
+         "\"name\":\"BlackRoad Customer\",\"phone\":null},\"calculated_statement_descriptor\":\"BLACKROAD\",";
+    s += fmt("\"captured\":%s,\"created\":%d,\"currency\":\"usd\",\"customer\":\"cus_P%013d\",\"description\":\"%s\","
+             "\"disputed\":false,\"failure_balance_transaction\":null,\"failure_code\":%s,\"failure_message\":%s,"
+             "\"fraud_details\":{},\"invoice\":null,\"livemode\":true,\"metadata\":{\"plan\":\"pro\",\"seats\":\"%d\"},"
+             "\"on_behalf_of\":null,\"order\":null,",
+             ok ? "true" : "false", 1760000000 + i * 3600, i, desc.c_str(),
+             ok ? "null" : "\"card_declined\"", ok ? "null" : "\"Your card was declined.\"", 1 + i % 9);
+    s += fmt("\"outcome\":{\"network_status\":\"%s\",\"reason\":null,\"risk_level\":\"normal\",\"risk_score\":%d,"
+             "\"seller_message\":\"Payment complete.\",\"type\":\"%s\"},\"paid\":%s,"
+             "\"payment_intent\":\"pi_3N%018d\",\"payment_method\":\"pm_1N%018d\",",
+             ok ? "approved_by_network" : "declined_by_network", 10 + i, ok ? "authorized" : "issuer_declined",
+             ok ? "true" : "false", i, i);
+    s += "\"payment_method_details\":{\"card\":{\"amount_authorized\":null,\"brand\":\"visa\",\"checks\":"
+         "{\"address_line1_check\":\"pass\",\"address_postal_code_check\":\"pass\",\"cvc_check\":\"pass\"},"
+         "\"country\":\"US\",\"exp_month\":12,\"exp_year\":2028,\"extended_authorization\":{\"status\":\"disabled\"},"
+         "\"fingerprint\":\"Xt5EWLLDS7FJjR1c\",\"funding\":\"credit\",\"incremental_authorization\":"
+         "{\"status\":\"unavailable\"},\"installments\":null,\"last4\":\"4242\",\"mandate\":null,"
+         "\"multicapture\":{\"status\":\"unavailable\"},\"network\":\"visa\",\"network_token\":{\"used\":false},"
+         "\"overcapture\":{\"maximum_amount_capturable\":0,\"status\":\"unavailable\"},\"three_d_secure\":null,"
+         "\"wallet\":null},\"type\":\"card\"},";
+    s += fmt("\"receipt_email\":\"ops@blackroad.io\",\"receipt_number\":null,\"receipt_url\":"
+             "\"https://pay.stripe.com/receipts/payment/CAcaFwoVYWNjdF8xTjRoUmxCVW5Wc2JpQ0JtKL%020d\","
+             "\"refunded\":false,\"refunds\":{\"object\":\"list\",\"data\":[],\"has_more\":false,\"total_count\":0,"
+             "\"url\":\"/v1/charges/ch_3N%020d/refunds\"},\"review\":null,\"shipping\":null,\"source\":null,"
+             "\"source_transfer\":null,\"statement_descriptor\":null,\"statement_descriptor_suffix\":null,"
+             "\"status\":\"%s\",\"transfer_data\":null,\"transfer_group\":null}",
+             i, i, ok ? "succeeded" : "failed");
+  }
+  return s + "],\"has_more\":true,\"url\":\"/v1/charges\"}";
+}
+
+// Linear issues query - only the selected fields come back
+static std::string linearIssues(int n, Totals* truth) {
+  static const char* STATES[] = {"Todo", "In Progress", "In Review", "Backlog"};
+  *truth = Totals{n, 0, 0, "BR-100: Wire the dashboard to the sovereign stack"};
+  std::string s = "{\"data\":{\"issues\":{\"nodes\":[";
+  for (int i = 0; i < n; i++) {
+    truth->sum += i % 5;
+    if (i) s += ",";
+    s += fmt("{\"id\":\"9c3d2f1e-%04d-4b7a-8e21-5f6a7b8c9d%02d\",\"title\":\"BR-%d: %s\",\"state\":{\"name\":\"%s\"},"
+             "\"priority\":%d}",
+             i, i % 100, 100 + i, i == 0 ? "Wire the dashboard to the sovereign stack" : "Follow-up work item",
+             STATES[i % 4], i % 5);
+  }
+  return s + "]}}}";
+}
+
+// ─────────────────────────────────────────────────────────────────────
+// PARSE PATHS
+// ─────────────────────────────────────────────────────────────────────
+
+struct Outcome {
+  bool ok;
+  const char* error;
+  Totals totals;
+};
+
+// Sum an array of repo objects, as the dashboard does
+static void githubSum(JsonArrayConst repos, Totals* t) {
+  for (JsonObjectConst repo : repos) {
+    if (t->count == 0) t->first = repo["name"] | "";
+    t->count++;
+    t->sum += repo["stargazers_count"].as<int>();
+    t->sum2 += repo["forks_count"].as<int>();
+  }
+}
+
+static Outcome githubBuffered(const std::string& payload) {
+  ReplayStream s(payload);
+  String body = bufferBody(s, payload.size());
+  CountedJsonDocument doc(16384);
+  DeserializationError error = deserializeJson(doc, body);
+  Outcome o = {!error, error.c_str(), Totals{0, 0, 0, ""}};
+  if (!error) githubSum(doc.as<JsonArrayConst>(), &o.totals);
+  return o;
+}
+
+// fetchGitHubStats(): one repo at a time, three fields each
+static Outcome githubStreamed(const std::string& payload) {
+  ReplayStream body(payload);
+  StaticJsonDocument<128> filter;
+  filter["name"] = true;
+  filter["stargazers_count"] = true;
+  filter["forks_count"] = true;
+
+  Outcome o = {true, "Ok", Totals{0, 0, 0, ""}};
+  if (jsonPeekToken(body) != '[') return Outcome{false, "expected a repo array", o.totals};
+  body.read();
+  if (jsonPeekToken(body) == ']') return o;
+
+  StaticJsonDocument<256> repo;
+  while (true) {
+    DeserializationError error = deserializeJson(repo, body, DeserializationOption::Filter(filter));
+    if (error) return Outcome{false, error.c_str(), o.totals};
+
+    if (o.totals.count == 0) o.totals.first = repo["name"] | "";
+    o.totals.count++;
+    o.totals.sum += repo["stargazers_count"].as<int>();
+    o.totals.sum2 += repo["forks_count"].as<int>();
+
+    int next = jsonPeekToken(body);
+    body.read();
+    if (next == ']') return o;
+    if (next != ',') return Outcome{false, "repo list cut short", o.totals};
+  }
+}
+
+static void stripeSum(JsonVariantConst doc, Totals* t) {
+  for (JsonObjectConst charge : doc["data"].as<JsonArrayConst>()) {
+    if (charge["status"] != "succeeded") continue;
+    if (t->count == 0) t->first = charge["description"] | "";
+    t->count++;
+    t->sum += charge["amount"].as<long>();
+  }
+}
+
+static Outcome stripeBuffered(const std::string& payload) {
+  ReplayStream s(payload);
+  String body = bufferBody(s, payload.size());
+  CountedJsonDocument doc(8192);
+  DeserializationError error = deserializeJson(doc, body);
+  Outcome o = {!error, error.c_str(), Totals{0, 0, 0, ""}};
+  if (!error) stripeSum(doc.as<JsonVariantConst>(), &o.totals);
+  return o;
+}
+
+// fetchStripeMetrics()
+static Outcome stripeStreamed(const std::string& payload) {
+  ReplayStream body(payload);
+  StaticJsonDocument<128> filter;
+  filter["data"][0]["status"] = true;
+  filter["data"][0]["amount"] = true;
+  filter["data"][0]["description"] = true;
+
+  CountedJsonDocument doc(2048);
+  DeserializationError error = deserializeJson(doc, body, DeserializationOption::Filter(filter));
+  Outcome o = {!error, error.c_str(), Totals{0, 0, 0, ""}};
+  if (!error) stripeSum(doc.as<JsonVariantConst>(), &o.totals);
+  return o;
+}
+
+static void linearSum(JsonVariantConst doc, Totals* t) {
+  for (JsonObjectConst issue : doc["data"]["issues"]["nodes"].as<JsonArrayConst>()) {
+    if (t->count == 0) t->first = issue["title"] | "";
+    t->count++;
+    t->sum += issue["priority"].as<int>();
+  }
+}
+
+static Outcome linearBuffered(const std::string& payload) {
+  ReplayStream s(payload);
+  String body = bufferBody(s, payload.size());
+  CountedJsonDocument doc(8192);
+  DeserializationError error = deserializeJson(doc, body);
+  Outcome o = {!error, error.c_str(), Totals{0, 0, 0, ""}};
+  if (!error) linearSum(doc.as<JsonVariantConst>(), &o.totals);
+  return o;
+}
+
+// fetchLinearTasks()
+static Outcome linearStreamed(const std::string& payload) {
+  ReplayStream body(payload);
+  StaticJsonDocument<192> filter;
+  JsonObject node = filter["data"]["issues"]["nodes"][0].to<JsonObject>();
+  node["id"] = true;
+  node["title"] = true;
+  node["state"]["name"] = true;
+  node["priority"] = true;
+
+  CountedJsonDocument doc(3072);
+  DeserializationError error = deserializeJson(doc, body, DeserializationOption::Filter(filter));
+  Outcome o = {!error, error.c_str(), Totals{0, 0, 0, ""}};
+  if (!error) linearSum(doc.as<JsonVariantConst>(), &o.totals);
+  return o;
+}
+
+// ─────────────────────────────────────────────────────────────────────
+// BENCH
+// ─────────────────────────────────────────────────────────────────────
+
+typedef Outcome (*ParseFn)(const std::string& payload);
+
+struct Measured {
+  Outcome outcome;
+  size_t peakHeap;
+  double parseUs;
+};
+
+static Measured measure(ParseFn fn, const std::string& payload) {
+  Measured m;
+  {
+    HeapMark mark;
+    m.outcome = fn(payload);
+    m.peakHeap = mark.peak();
+  }
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < RUNS; i++) fn(payload);
+  m.parseUs = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / RUNS;
+  return m;
+}
+
+static void printRow(const char* path, const Measured& m) {
+  if (m.outcome.ok) {
+    printf("   %-10s %8zu B heap  %9.1f us  %d items\n", path, m.peakHeap, m.parseUs, m.outcome.totals.count);
+  } else {
+    printf("   %-10s %8zu B heap  %9.1f us  failed: %s\n", path, m.peakHeap, m.parseUs, m.outcome.error);
+  }
+}
+
+// truth is NULL for a recorded payload - then the paths must agree
+static void bench(const char* label, const std::string& payload, ParseFn buffered, ParseFn streamed,
+                  size_t stackBytes, const Totals* truth) {
+  printf("%-16s %zu byte body\n", label, payload.size());
+  Measured before = measure(buffered, payload);
+  Measured after = measure(streamed, payload);
+  printRow("buffered", before);
+  printRow("streamed", after);
+  printf("   %-10s %8zu B in StaticJsonDocuments on the task stack\n", "", stackBytes);
+  if (after.peakHeap > 0) printf("   heap peak %.1fx lower\n", (double)before.peakHeap / after.peakHeap);
+
+  CHECK(after.outcome.ok);
+  CHECK(after.peakHeap < before.peakHeap);
+  if (truth) CHECK(after.outcome.totals == *truth);
+  if (before.outcome.ok) CHECK(before.outcome.totals == after.outcome.totals);
+}
+
+static bool readFile(const char* path, std::string* out) {
+  std::ifstream f(path, std::ios::binary);
+  if (!f) return false;
+  std::stringstream ss;
+  ss << f.rdbuf();
+  *out = ss.str();
+  return true;
+}
+
+int main(int argc, char** argv) {
+  if (argc == 3) {
+    std::string payload;
+    if (!readFile(argv[2], &payload)) {
+      printf("can't read %s\n", argv[2]);
+      return 1;
+    }
+    std::string kind = argv[1];
+    if (kind == "github") bench("github (file):", payload, githubBuffered, githubStreamed, 128 + 256, NULL);
+    else if (kind == "stripe") bench("stripe (file):", payload, stripeBuffered, stripeStreamed, 128, NULL);
+    else if (kind == "linear") bench("linear (file):", payload, linearBuffered, linearStreamed, 192, NULL);
+    else {
+      printf("unknown kind %s (github, stripe, linear)\n", argv[1]);
+      return 1;
+    }
+  } else {
+    Totals truth;
+    std::string payload = githubRepos(100, &truth);
+    bench("github repos:", payload, githubBuffered, githubStreamed, 128 + 256, &truth);
+    payload = githubRepos(2, &truth);
+    bench("github (2):", payload, githubBuffered, githubStreamed, 128 + 256, &truth);
+    payload = stripeCharges(10, &truth);
+    bench("stripe charges:", payload, stripeBuffered, stripeStreamed, 128, &truth);
+    payload = linearIssues(10, &truth);
+    bench("linear issues:", payload, linearBuffered, linearStreamed, 192, &truth);
+  }
+
+  if (failures) {
+    printf("%d check(s) failed\n", failures);
+    return 1;
+  }
+  printf("all checks passed\n");
+  return 0;
+}
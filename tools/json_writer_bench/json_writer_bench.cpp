@@ -0,0 +1,433 @@
+/*
+ * ═══════════════════════════════════════════════════════════════════════
+ * BLACKROAD JSON WRITER BENCHMARK
+ * ═══════════════════════════════════════════════════════════════════════
+ *
+ * The payloads lib/JsonWriter replaced, built both ways - the String
+ * concatenation they used before, and JsonWriter as the firmware uses it
+ * now - with heap allocations, heap bytes and time per payload:
+ * - Discord / Slack alert: sendDiscordAlert() / sendSlackAlert() before,
+ *   the batch builders in src/alerts.h now
+ * - Filesystem export (24 files): exportFileSystemJSON() returning a
+ *   String before, streamed to a Print through 128 bytes of scratch now
+ * - NATS sensor PUB: publishToNATS() framing a String (copied in by
+ *   value) before, one frame in a stack buffer now
+ *
+ * Every heap byte is a copy of payload bytes into a fresh buffer, so heap
+ * bytes is also what the String path copies; JsonWriter copies each
+ * output byte once. Host String is std::string, which grows
+ * geometrically - the ESP32 core's String reallocs on every concat that
+ * grows it, so on the device the String counts are higher still.
+ *
+ * Checks: JsonWriter output parses as JSON (alert text with quotes and a
+ * newline included) and allocates nothing; LONG_MIN / ULONG_MAX come out
+ * whole (64-bit long on the host).
+ *
+ * Build:   make
+ * Run:     ./json_writer_bench
+ */
+
+#include <chrono>
+#include <climits>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <string>
+
+#include <Arduino.h>
+#include "JsonWriter.h"
+
+static int failures = 0;
+
+#define CHECK(cond)                                                        \
+  do {                                                                     \
+    if (!(cond)) {                                                         \
+      printf("FAIL %s:%d: %s\n", __FILE__, __LINE__, #cond);               \
+      failures++;                                                          \
+    }                                                                      \
+  } while (0)
+
+#define RUNS 20000                   // Builds timed per path
+
+// ─────────────────────────────────────────────────────────────────────
+// HEAP ACCOUNTING
+// ─────────────────────────────────────────────────────────────────────
+
+static size_t heapAllocs = 0;
+static size_t heapBytes = 0;
+
+void* operator new(size_t n) {
+  heapAllocs++;
+  heapBytes += n;
+  void* p = malloc(n ? n : 1);
+  if (!p) throw std::bad_alloc();
+  return p;
+}
+void* operator new[](size_t n) { return operator new(n); }
+void operator delete(void* p) noexcept { free(p); }
+void operator delete[](void* p) noexcept { free(p); }
+void operator delete(void* p, size_t) noexcept { free(p); }
+void operator delete[](void* p, size_t) noexcept { free(p); }
+
+// Where a payload goes: bytes counted, nothing kept
+class CountingPrint : public Print {
+public:
+  size_t bytes = 0;
+  size_t write(uint8_t) override { bytes++; return 1; }
+  size_t write(const uint8_t*, size_t n) override { bytes += n; return n; }
+  using Print::write;
+};
+
+// ─────────────────────────────────────────────────────────────────────
+// JSON CHECK
+// ─────────────────────────────────────────────────────────────────────
+
+// Just enough of a parser to tell whether a payload is valid JSON
+struct JsonCheck {
+  const char* p;
+
+  void ws() { while (*p == ' ' || *p == '\n' || *p == '\r' || *p == '\t') p++; }
+
+  bool string() {
+    if (*p++ != '"') return false;
+    while (*p && *p != '"') {
+      if ((uint8_t)*p < 0x20) return false;
+      if (*p == '\\') {
+        p++;
+        if (*p == 'u') {
+          for (int i = 1; i <= 4; i++) if (!isxdigit((uint8_t)p[i])) return false;
+          p += 4;
+        } else if (!strchr("\"\\/bfnrt", *p) || !*p) {
+          return false;
+        }
+      }
+      p++;
+    }
+    return *p++ == '"';
+  }
+
+  bool value() {
+    ws();
+    if (*p == '{' || *p == '[') {
+      char close = *p == '{' ? '}' : ']';
+      bool object = *p++ == '{';
+      ws();
+      if (*p == close) { p++; return true; }
+      while (true) {
+        if (object) {
+          ws();
+          if (!string()) return false;
+          ws();
+          if (*p++ != ':') return false;
+        }
+        if (!value()) return false;
+        ws();
+        if (*p == close) { p++; return true; }
+        if (*p++ != ',') return false;
+      }
+    }
+    if (*p == '"') return string();
+    if (!strncmp(p, "true", 4) || !strncmp(p, "null", 4)) { p += 4; return true; }
+    if (!strncmp(p, "false", 5)) { p += 5; return true; }
+    char* end;
+    strtod(p, &end);
+    if (end == p) return false;
+    p = end;
+    return true;
+  }
+
+  static bool valid(const char* json) {
+    JsonCheck c = {json};
+    if (!c.value()) return false;
+    c.ws();
+    return *c.p == '\0';
+  }
+};
+
+// ─────────────────────────────────────────────────────────────────────
+// PAYLOADS
+// ─────────────────────────────────────────────────────────────────────
+
+static const char* TITLE = "🌐 Mesh Network Degraded";
+static const char* MESSAGE = "Only 1 mesh nodes active. Expected: 4 nodes (\"lucidia\", octavia, alice,\nshellfish).";
+
+struct FileEntry {
+  const char* name;
+  unsigned long size;
+};
+
+static const FileEntry FILES[] = {
+  {"/config.json", 412}, {"/secrets.json", 230}, {"/cache/github.json", 1830},
+  {"/cache/stripe.json", 960}, {"/cache/linear.json", 2210}, {"/cache/crypto.json", 388},
+  {"/cache/weather.json", 742}, {"/cache/mesh.json", 655}, {"/logs/boot.log", 4096},
+  {"/logs/alerts.log", 3122}, {"/logs/nats.log", 2048}, {"/logs/perf.log", 1500},
+  {"/ui/theme.json", 188}, {"/ui/layout.json", 934}, {"/ui/fonts.bin", 16384},
+  {"/crm/contacts.json", 5120}, {"/crm/deals.json", 3300}, {"/crm/leads.json", 2780},
+  {"/ai/models.json", 610}, {"/ai/prompts.json", 1404}, {"/jrnl/0000.seg", 4096},
+  {"/jrnl/0001.seg", 4096}, {"/jrnl/meta", 16}, {"/ota/last.json", 96},
+};
+static const int FILE_COUNT = sizeof(FILES) / sizeof(FILES[0]);
+static const unsigned long FS_TOTAL = 1441792, FS_USED = 62003, FS_FREE = 1379789;
+
+// Old builders, as they were before JsonWriter
+
+static String discordString(const String& title, const String& message) {
+  int color = 0xFF0000;
+  String payload = "{\"embeds\":[{";
+  payload += "\"title\":\"" + title + "\",";
+  payload += "\"description\":\"" + message + "\",";
+  payload += "\"color\":" + String(color) + ",";
+  payload += "\"footer\":{\"text\":\"BlackRoad CEO Hub\"},";
+  payload += "\"timestamp\":\"" + String(123456UL) + "\"";
+  payload += "}]}";
+  return payload;
+}
+
+static String slackString(const String& title, const String& message) {
+  String emoji = ":rotating_light:";
+  String payload = "{";
+  payload += "\"text\":\"" + emoji + " *" + title + "*\",";
+  payload += "\"blocks\":[{";
+  payload += "\"type\":\"section\",";
+  payload += "\"text\":{\"type\":\"mrkdwn\",\"text\":\"" + message + "\"}";
+  payload += "}]";
+  payload += "}";
+  return payload;
+}
+
+static String exportString() {
+  String json = "{\"files\":[";
+  bool first = true;
+  for (int i = 0; i < FILE_COUNT; i++) {
+    if (!first) json += ",";
+    json += "{";
+    json += "\"name\":\"" + String(FILES[i].name) + "\",";
+    json += "\"size\":" + String(FILES[i].size);
+    json += "}";
+    first = false;
+  }
+  json += "],";
+  json += "\"stats\":{";
+  json += "\"total\":" + String(FS_TOTAL) + ",";
+  json += "\"used\":" + String(FS_USED) + ",";
+  json += "\"free\":" + String(FS_FREE);
+  json += "}}";
+  return json;
+}
+
+// publishToNATS(subject, String payload) - payload passed by value
+static void natsString(Print& out, const char* subject, String payload) {
+  String msg = "PUB ";
+  msg += subject;
+  msg += " ";
+  msg += payload.length();
+  msg += "\r\n";
+  msg += payload;
+  msg += "\r\n";
+  out.print(msg);
+}
+
+// New builders, same calls as the firmware
+
+static void discordWriter(JsonWriter& w, const char* title, const char* message) {
+  w.beginObject();
+  w.arrayField("embeds");
+  w.beginObject();
+  w.field("title", title);
+  w.field("description", message);
+  w.field("color", 0xFF0000L);
+  w.objectField("footer");
+  w.field("text", "BlackRoad CEO Hub");
+  w.endObject();
+  w.endObject();
+  w.endArray();
+  w.endObject();
+}
+
+static void slackWriter(JsonWriter& w, const char* title, const char* message) {
+  w.beginObject();
+  w.key("text");
+  w.beginString();
+  w.stringPart(":rotating_light:");
+  w.stringPart(" *");
+  w.stringPart(title);
+  w.stringPart("*");
+  w.endString();
+  w.arrayField("blocks");
+  w.beginObject();
+  w.field("type", "section");
+  w.objectField("text");
+  w.field("type", "mrkdwn");
+  w.key("text");
+  w.beginString();
+  w.stringPart("*");
+  w.stringPart(title);
+  w.stringPart("*\n");
+  w.stringPart(message);
+  w.endString();
+  w.endObject();
+  w.endObject();
+  w.endArray();
+  w.endObject();
+}
+
+static size_t exportWriter(Print& out) {
+  char scratch[128];
+  JsonWriter w(out, scratch, sizeof(scratch));
+  w.beginObject();
+  w.arrayField("files");
+  for (int i = 0; i < FILE_COUNT; i++) {
+    w.beginObject();
+    w.field("name", FILES[i].name);
+    w.field("size", FILES[i].size);
+    w.endObject();
+  }
+  w.endArray();
+  w.objectField("stats");
+  w.field("total", FS_TOTAL);
+  w.field("used", FS_USED);
+  w.field("free", FS_FREE);
+  w.endObject();
+  w.endObject();
+  w.flush();
+  return w.bytesWritten();
+}
+
+static void sensorWriter(JsonWriter& w) {
+  w.beginObject();
+  w.field("device_id", "esp32-device1");
+  w.field("timestamp", 123456UL);
+  w.field("temperature_c", 24);
+  w.field("humidity_pct", 51);
+  w.field("wifi_rssi", -61);
+  w.field("free_heap", 201344UL);
+  w.endObject();
+}
+
+// publishToNATS(subject, payload, len) - one frame, one write
+static size_t natsWriter(Print& out, const char* subject, const char* payload, size_t len) {
+  char frame[512];
+  int header = snprintf(frame, sizeof(frame), "PUB %s %u\r\n", subject, (unsigned)len);
+  memcpy(frame + header, payload, len);
+  frame[header + len] = '\r';
+  frame[header + len + 1] = '\n';
+  return out.write((const uint8_t*)frame, header + len + 2);
+}
+
+// ─────────────────────────────────────────────────────────────────────
+// BENCH
+// ─────────────────────────────────────────────────────────────────────
+
+struct Measured {
+  size_t allocs;
+  size_t bytes;
+  double ns;
+};
+
+template <typename Fn>
+static Measured measure(Fn fn) {
+  Measured m;
+  size_t allocs = heapAllocs, bytes = heapBytes;
+  fn();
+  m.allocs = heapAllocs - allocs;
+  m.bytes = heapBytes - bytes;
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < RUNS; i++) fn();
+  m.ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / RUNS;
+  return m;
+}
+
+static void report(const char* label, size_t outBytes, const Measured& before, const Measured& after,
+                   bool beforeValid) {
+  printf("%-16s %zu byte payload\n", label, outBytes);
+  printf("   %-12s %4zu allocs  %6zu heap bytes  %8.0f ns%s\n", "String", before.allocs, before.bytes, before.ns,
+         beforeValid ? "" : "  (invalid JSON)");
+  printf("   %-12s %4zu allocs  %6zu heap bytes  %8.0f ns\n", "JsonWriter", after.allocs, after.bytes, after.ns);
+  CHECK(after.allocs == 0);
+  CHECK(before.allocs > 0);
+}
+
+int main() {
+  String title = TITLE, message = MESSAGE;
+  char buf[1024];
+  volatile size_t sink = 0;
+
+  // Discord
+  String old = discordString(title, message);
+  JsonWriter w(buf, sizeof(buf));
+  discordWriter(w, TITLE, MESSAGE);
+  CHECK(!w.overflowed() && JsonCheck::valid(w.c_str()));
+  report("discord alert:", w.length(),
+         measure([&] { sink += discordString(title, message).length(); }),
+         measure([&] { w.reset(); discordWriter(w, TITLE, MESSAGE); sink += w.length(); }),
+         JsonCheck::valid(old.c_str()));
+
+  // Slack
+  old = slackString(title, message);
+  w.reset();
+  slackWriter(w, TITLE, MESSAGE);
+  CHECK(!w.overflowed() && JsonCheck::valid(w.c_str()));
+  report("slack alert:", w.length(),
+         measure([&] { sink += slackString(title, message).length(); }),
+         measure([&] { w.reset(); slackWriter(w, TITLE, MESSAGE); sink += w.length(); }),
+         JsonCheck::valid(old.c_str()));
+
+  // Filesystem export - streamed output must be the same document
+  old = exportString();
+  std::string streamed;
+  {
+    class Capture : public Print {
+    public:
+      std::string* s;
+      size_t write(uint8_t c) override { s->push_back((char)c); return 1; }
+      size_t write(const uint8_t* b, size_t n) override { s->append((const char*)b, n); return n; }
+      using Print::write;
+    } capture;
+    capture.s = &streamed;
+    exportWriter(capture);
+  }
+  CHECK(JsonCheck::valid(streamed.c_str()));
+  CHECK(streamed == old.c_str());
+  CountingPrint out;
+  report("fs export:", streamed.size(),
+         measure([&] { sink += exportString().length(); }),
+         measure([&] { sink += exportWriter(out); }),
+         JsonCheck::valid(old.c_str()));
+
+  // NATS sensor PUB - framing only; the String path starts from the
+  // payload as serializeJson() left it, the new one from the stack buffer
+  w.reset();
+  sensorWriter(w);
+  String sensorJson = w.c_str();
+  const char* subject = "blackroad.devices.esp32.sensors";
+  CountingPrint framed;
+  natsWriter(framed, subject, w.c_str(), w.length());
+  report("nats sensor PUB:", framed.bytes,
+         measure([&] { natsString(out, subject, sensorJson); }),
+         measure([&] { sink += natsWriter(out, subject, w.c_str(), w.length()); }),
+         true);
+
+  // Integer limits - every digit, not cut at a 32-bit sized buffer
+  char expect[96];
+  snprintf(expect, sizeof(expect), "[%ld,%ld,%lu,\"n%ld\"]", LONG_MIN, LONG_MAX, ULONG_MAX, LONG_MIN);
+  w.reset();
+  w.beginArray();
+  w.value(LONG_MIN);
+  w.value(LONG_MAX);
+  w.value(ULONG_MAX);
+  w.beginString();
+  w.stringPart("n");
+  w.stringPart(LONG_MIN);
+  w.endString();
+  w.endArray();
+  CHECK(!w.overflowed() && strcmp(w.c_str(), expect) == 0);
+  printf("integer limits:  %s\n", w.c_str());
+
+  (void)sink;
+  if (failures) {
+    printf("%d check(s) failed\n", failures);
+    return 1;
+  }
+  printf("all checks passed\n");
+  return 0;
+}
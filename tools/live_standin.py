@@ -0,0 +1,234 @@
+#!/usr/bin/env python3
+"""
+BlackRoad OS - live update stand-in server (WebSocket + SSE)
+
+Serves the delta protocol that src/live_updates.h consumes, so the push
+path can be exercised on a Linux box without Octavia or Railway:
+
+  ws://<host>:<port>/ws     RFC 6455, one delta per text message
+  http://<host>:<port>/sse  text/event-stream, chunked, id: + heartbeats
+
+Point the device at it with build flags, e.g.
+  -DWS_OCTAVIA=\\"ws://192.168.4.20:8765/ws\\"
+  -DSSE_RAILWAY=\\"http://192.168.4.20:8765/sse\\"
+
+Knobs for the failure paths:
+  --gap-every N    skip a sequence number every N deltas (client resyncs)
+  --drop-after N   close the connection after N deltas (client reconnects)
+  --fragment       split every WS message into two frames
+  --ping-every N   send a WS ping every N deltas
+
+Standard library only.
+"""
+
+import argparse
+import base64
+import hashlib
+import json
+import random
+import socket
+import socketserver
+import struct
+import time
+
+WS_GUID = "258EAFA5-E914-47DA-95CA-C5AB0DC85B11"
+NODES = ["lucidia", "octavia", "alice", "shellfish", "aria"]
+
+
+def make_deltas(args):
+    """Yield (seq, json) forever, cycling nav / crm / mesh / resync."""
+    seq = 0
+    hot_leads = 5
+    pipeline = 125000.0
+    n = 0
+    while True:
+        n += 1
+        seq += 1
+        if args.gap_every and n % args.gap_every == 0:
+            seq += 1  # Lost on the wire, as far as the client can tell
+
+        kind = n % 4
+        if kind == 1:
+            hot_leads = max(0, hot_leads + random.choice([-1, 0, 1]))
+            delta = {"type": "nav", "data": {"hotLeads": hot_leads, "crmHealthy": True}}
+        elif kind == 2:
+            pipeline += random.randint(-5000, 15000)
+            delta = {"type": "crm", "data": {"pipelineValue": round(pipeline, 2),
+                                             "hotLeads": hot_leads,
+                                             "topLead": random.choice(["Ada", "Grace", "Linus"])}}
+        elif kind == 3:
+            delta = {"type": "mesh", "data": {"name": random.choice(NODES),
+                                              "online": random.random() > 0.1,
+                                              "latency": random.randint(2, 40),
+                                              "bandwidth": round(random.uniform(0.5, 6.0), 1)}}
+        else:
+            delta = {"type": "resync"} if n % 20 == 0 else {"type": "nav", "data": {"aiHealthy": True}}
+
+        delta = {"seq": seq, **delta}
+        yield seq, json.dumps(delta, separators=(",", ":"))
+
+
+class Handler(socketserver.BaseRequestHandler):
+    def setup(self):
+        self.args = self.server.args
+        self.request.settimeout(0.05)
+
+    def log(self, msg):
+        print(f"[{self.client_address[0]}:{self.client_address[1]}] {msg}", flush=True)
+
+    def read_request(self):
+        data = b""
+        deadline = time.time() + 5
+        while b"\r\n\r\n" not in data and time.time() < deadline:
+            try:
+                chunk = self.request.recv(1024)
+            except socket.timeout:
+                continue
+            if not chunk:
+                return None, {}
+            data += chunk
+        head = data.split(b"\r\n\r\n", 1)[0].decode("latin-1")
+        lines = head.split("\r\n")
+        headers = {}
+        for line in lines[1:]:
+            if ":" in line:
+                k, v = line.split(":", 1)
+                headers[k.strip().lower()] = v.strip()
+        return lines[0], headers
+
+    def handle(self):
+        request_line, headers = self.read_request()
+        if not request_line:
+            return
+        path = request_line.split(" ")[1] if " " in request_line else "/"
+        self.log(request_line)
+        if path.startswith("/ws") and headers.get("upgrade", "").lower() == "websocket":
+            self.serve_ws(headers)
+        elif path.startswith("/sse"):
+            self.serve_sse(headers)
+        else:
+            self.request.sendall(b"HTTP/1.1 404 Not Found\r\nContent-Length: 0\r\n\r\n")
+
+    # ── WebSocket ──────────────────────────────────────────────────────
+
+    def ws_frame(self, opcode, payload, fin=True):
+        header = bytes([(0x80 if fin else 0) | opcode])
+        n = len(payload)
+        if n < 126:
+            header += bytes([n])
+        elif n < 65536:
+            header += bytes([126]) + struct.pack("!H", n)
+        else:
+            header += bytes([127]) + struct.pack("!Q", n)
+        self.request.sendall(header + payload)
+
+    def ws_poll(self):
+        """Read (masked) client frames: answer pings, notice close."""
+        try:
+            data = self.request.recv(1024)
+        except socket.timeout:
+            return True
+        if not data:
+            return False
+        while len(data) >= 2:
+            opcode = data[0] & 0x0F
+            length = data[1] & 0x7F
+            masked = data[1] & 0x80
+            pos = 2 + (4 if masked else 0)
+            mask = data[2:6] if masked else b"\0\0\0\0"
+            payload = bytes(b ^ mask[i % 4] for i, b in enumerate(data[pos:pos + length]))
+            data = data[pos + length:]
+            if not masked:
+                self.log("client frame not masked (protocol error)")
+            if opcode == 0x8:
+                self.log("client close")
+                return False
+            if opcode == 0x9:
+                self.ws_frame(0xA, payload)
+                self.log("client ping -> pong")
+            elif opcode == 0xA:
+                self.log("client pong")
+        return True
+
+    def serve_ws(self, headers):
+        key = headers.get("sec-websocket-key", "")
+        accept = base64.b64encode(hashlib.sha1((key + WS_GUID).encode()).digest()).decode()
+        self.request.sendall(("HTTP/1.1 101 Switching Protocols\r\n"
+                              "Upgrade: websocket\r\nConnection: Upgrade\r\n"
+                              f"Sec-WebSocket-Accept: {accept}\r\n\r\n").encode())
+        sent = 0
+        next_at = time.time()
+        for seq, msg in make_deltas(self.args):
+            while time.time() < next_at:
+                if not self.ws_poll():
+                    return
+            payload = msg.encode()
+            if self.args.fragment and len(payload) > 1:
+                half = len(payload) // 2
+                self.ws_frame(0x1, payload[:half], fin=False)
+                self.ws_frame(0x0, payload[half:])
+            else:
+                self.ws_frame(0x1, payload)
+            self.log(f"ws  -> {msg}")
+            sent += 1
+            if self.args.ping_every and sent % self.args.ping_every == 0:
+                self.ws_frame(0x9, b"standin")
+            if self.args.drop_after and sent >= self.args.drop_after:
+                self.ws_frame(0x8, struct.pack("!H", 1001) + b"going away")
+                self.log("dropping connection")
+                return
+            next_at = time.time() + self.args.interval
+
+    # ── Server-Sent Events ─────────────────────────────────────────────
+
+    def chunk(self, text):
+        data = text.encode()
+        self.request.sendall(f"{len(data):x}\r\n".encode() + data + b"\r\n")
+
+    def serve_sse(self, headers):
+        resume = headers.get("last-event-id")
+        if resume:
+            self.log(f"resuming after id {resume}")
+        self.request.sendall(b"HTTP/1.1 200 OK\r\nContent-Type: text/event-stream\r\n"
+                             b"Cache-Control: no-cache\r\nTransfer-Encoding: chunked\r\n\r\n")
+        self.chunk(": blackroad stand-in\n\n")
+        sent = 0
+        for seq, msg in make_deltas(self.args):
+            time.sleep(self.args.interval)
+            try:
+                self.chunk(f"id: {seq}\ndata: {msg}\n\n")
+                if sent % 5 == 4:
+                    self.chunk(":heartbeat\n\n")
+            except OSError:
+                return
+            self.log(f"sse -> {msg}")
+            sent += 1
+            if self.args.drop_after and sent >= self.args.drop_after:
+                self.request.sendall(b"0\r\n\r\n")
+                self.log("dropping connection")
+                return
+
+
+class Server(socketserver.ThreadingTCPServer):
+    allow_reuse_address = True
+    daemon_threads = True
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--port", type=int, default=8765)
+    parser.add_argument("--interval", type=float, default=2.0, help="seconds between deltas")
+    parser.add_argument("--gap-every", type=int, default=0)
+    parser.add_argument("--drop-after", type=int, default=0)
+    parser.add_argument("--fragment", action="store_true")
+    parser.add_argument("--ping-every", type=int, default=5)
+    args = parser.parse_args()
+
+    with Server(("0.0.0.0", args.port), Handler) as server:
+        server.args = args
+        print(f"⚡ live stand-in on :{args.port} (/ws, /sse)", flush=True)
+        server.serve_forever()
+
+
+if __name__ == "__main__":
+    main()
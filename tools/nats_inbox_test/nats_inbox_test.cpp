@@ -0,0 +1,199 @@
+/*
+ * ═══════════════════════════════════════════════════════════════════════
+ * BLACKROAD NATS INBOX TEST
+ * ═══════════════════════════════════════════════════════════════════════
+ *
+ * Host run of lib/NatsInbox with the real NatsOutbox and NatsParser:
+ * - One wildcard SUB covers every request
+ * - Concurrent requests answered out of order reach the right callback,
+ *   exactly once; late copies and previous-boot tokens are unmatched
+ * - Unanswered requests time out at their own deadline
+ * - All NATS_INBOX_SLOTS taken: the next request is refused
+ * - open() / close() tokens survive replies until closed
+ * - respond() answers an incoming request on its reply subject
+ *
+ * Build:   make
+ * Run:     ./nats_inbox_test           exits non-zero on any failure
+ */
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "FakeClient.h"
+#include "NatsInbox.h"
+
+static int failures = 0;
+
+#define CHECK(cond)                                                        \
+  do {                                                                     \
+    if (!(cond)) {                                                         \
+      printf("FAIL %s:%d: %s\n", __FILE__, __LINE__, #cond);               \
+      failures++;                                                          \
+    }                                                                      \
+  } while (0)
+
+#define REPLY_PREFIX "_INBOX.dev1.00000abc"
+
+struct Rig {
+  FakeClient client;
+  NatsOutbox outbox{client, 20};
+  NatsInbox inbox{outbox, "dev1"};
+  NatsParser parser{onOp, this};
+  std::vector<std::string> got;       // "<token>:<payload>" or "<token>:timeout"
+  std::vector<std::string> passed;    // Subjects the inbox didn't claim
+
+  Rig() { inbox.begin(0xabc); }
+
+  static void onOp(const NatsOp& op, void* ctx) {
+    Rig* rig = (Rig*)ctx;
+    if (!rig->inbox.handle(op)) rig->passed.push_back(op.subject);
+  }
+
+  static void onReply(uint32_t token, const NatsOp* reply, void* ctx) {
+    ((Rig*)ctx)->got.push_back(std::to_string(token) + ":" + (reply ? reply->payload : "timeout"));
+  }
+
+  void feed(const std::string& frame) { parser.parse((const uint8_t*)frame.data(), frame.size()); }
+
+  void reply(const std::string& subject, const std::string& payload) {
+    feed("MSG " + subject + " 2 " + std::to_string(payload.size()) + "\r\n" + payload + "\r\n");
+  }
+
+  std::string sent() {
+    outbox.flush();
+    std::string s = client.out;
+    client.reset();
+    return s;
+  }
+};
+
+static std::string tok(uint32_t token) { return std::to_string(token); }
+
+static void testSubscribe() {
+  Rig rig;
+  rig.inbox.subscribe();
+  CHECK(rig.sent() == "SUB _INBOX.dev1.* " NATS_INBOX_SID "\r\n");
+  printf("subscribe:       one wildcard SUB\n");
+}
+
+static void testConcurrentRequests() {
+  hostClock.nowMs = 1000;
+  Rig rig;
+
+  uint32_t a = rig.inbox.request("svc.a", "{}", 2, Rig::onReply, &rig, 1000);
+  uint32_t b = rig.inbox.request("svc.b", "{}", 2, Rig::onReply, &rig, 1000);
+  uint32_t c = rig.inbox.request("svc.c", "{}", 2, Rig::onReply, &rig, 500);
+  CHECK(a && b && c);
+  CHECK(rig.inbox.pending() == 3);
+  CHECK(rig.sent().find("PUB svc.a " REPLY_PREFIX + tok(a) + " 2\r\n{}\r\n") == 0);
+
+  rig.reply(REPLY_PREFIX + tok(b), "B!");
+  rig.reply(REPLY_PREFIX + tok(a), "A!");
+  rig.reply(REPLY_PREFIX + tok(a), "A2");                // Late duplicate
+  rig.reply("_INBOX.dev1.deadbeef" + tok(c), "x");       // Previous boot
+  rig.reply(REPLY_PREFIX + tok(c) + "x", "x");           // Not a token
+  rig.reply("sensors.other", "x");                       // Not ours at all
+
+  CHECK(rig.got.size() == 2);
+  CHECK(rig.got.size() == 2 && rig.got[0] == tok(b) + ":B!" && rig.got[1] == tok(a) + ":A!");
+  CHECK(rig.inbox.stats.replies == 2);
+  CHECK(rig.inbox.stats.unmatched == 3);
+  CHECK(rig.passed.size() == 1 && rig.passed[0] == "sensors.other");
+  CHECK(rig.inbox.pending() == 1);
+  printf("concurrent:      3 in flight, answered out of order, 3 strays unmatched\n");
+
+  hostClock.nowMs += 499;
+  rig.inbox.tick();
+  CHECK(rig.got.size() == 2);
+  hostClock.nowMs += 1;
+  rig.inbox.tick();
+  CHECK(rig.got.size() == 3 && rig.got.back() == tok(c) + ":timeout");
+  CHECK(rig.inbox.stats.timeouts == 1);
+  CHECK(rig.inbox.pending() == 0);
+  printf("timeout:         fired at 500 ms, not before\n");
+}
+
+static void testFull() {
+  hostClock.nowMs = 1000;
+  Rig rig;
+  for (int i = 0; i < NATS_INBOX_SLOTS; i++) CHECK(rig.inbox.request("q", "", 0, Rig::onReply, &rig, 100));
+  CHECK(!rig.inbox.request("q", "", 0, Rig::onReply, &rig, 100));
+  CHECK(rig.inbox.stats.full == 1);
+
+  hostClock.nowMs += 100;
+  rig.inbox.tick();
+  CHECK(rig.inbox.pending() == 0);
+  CHECK(rig.got.size() == NATS_INBOX_SLOTS);
+  CHECK(rig.inbox.request("q", "", 0, Rig::onReply, &rig, 100));
+  printf("full:            %d slots, #%d refused, freed by timeouts\n", NATS_INBOX_SLOTS, NATS_INBOX_SLOTS + 1);
+}
+
+static void testOpenClose() {
+  hostClock.nowMs = 1000;
+  Rig rig;
+  char reply[NATS_INBOX_REPLY_MAX + 1];
+  uint32_t t = rig.inbox.open(Rig::onReply, &rig, reply, sizeof(reply));
+  CHECK(t != 0);
+  CHECK(std::string(reply) == REPLY_PREFIX + tok(t));
+
+  rig.reply(reply, "1");
+  rig.reply(reply, "2");
+  hostClock.nowMs += 60000;
+  rig.inbox.tick();  // open() slots never time out
+  CHECK(rig.got.size() == 2);
+  CHECK(rig.inbox.pending() == 1);
+
+  rig.inbox.close(t);
+  rig.reply(reply, "3");
+  CHECK(rig.got.size() == 2);
+  CHECK(rig.inbox.pending() == 0);
+  printf("open/close:      reused reply subject until closed\n");
+}
+
+static void testNotBegun() {
+  Rig rig;
+  NatsInbox cold(rig.outbox, "dev1");
+  char reply[NATS_INBOX_REPLY_MAX + 1];
+  CHECK(cold.open(Rig::onReply, &rig, reply, sizeof(reply)) == 0);
+  CHECK(cold.request("q", "", 0, Rig::onReply, &rig, 100) == 0);
+  printf("before begin():  requests refused\n");
+}
+
+static void testRespondAndNoResponders() {
+  Rig rig;
+  NatsOp req = {};
+  req.subject = "cmds";
+  req.replyTo = "_INBOX.ctl.abc.7";
+  CHECK(rig.inbox.respond(req, "{\"pong\":true}", 13));
+  CHECK(rig.sent() == "PUB _INBOX.ctl.abc.7 13\r\n{\"pong\":true}\r\n");
+
+  req.replyTo = "";
+  CHECK(!rig.inbox.respond(req, "{}", 2));
+  CHECK(rig.inbox.stats.responses == 1);
+
+  NatsOp status = {};
+  status.headers = "NATS/1.0 503\r\n\r\n";
+  CHECK(NatsInbox::noResponders(status));
+  status.headers = "NATS/1.0\r\nNats-Msg-Id: x\r\n\r\n";
+  CHECK(!NatsInbox::noResponders(status));
+  printf("respond:         answered on the reply subject; 503 recognised\n");
+}
+
+int main() {
+  hostClock.manual = true;
+
+  testSubscribe();
+  testConcurrentRequests();
+  testFull();
+  testOpenClose();
+  testNotBegun();
+  testRespondAndNoResponders();
+
+  if (failures) {
+    printf("%d check(s) failed\n", failures);
+    return 1;
+  }
+  printf("all checks passed\n");
+  return 0;
+}
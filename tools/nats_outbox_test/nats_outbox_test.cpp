@@ -0,0 +1,116 @@
+/*
+ * ═══════════════════════════════════════════════════════════════════════
+ * BLACKROAD NATS OUTBOX TEST
+ * ═══════════════════════════════════════════════════════════════════════
+ *
+ * Host run of lib/NatsOutbox against a recording client (FakeClient):
+ * - Framing: PUB / HPUB / control lines come out byte-exact and in order
+ * - Time flush: nothing is written before flushMs, everything at flushMs
+ * - Coalescing: 100 sensor PUBs leave in a handful of socket writes
+ * - Oversized frames are written straight through after a flush
+ * - A refused write drops the buffer and reports failure
+ *
+ * Build:   make
+ * Run:     ./nats_outbox_test          exits non-zero on any failure
+ */
+
+#include <cstdio>
+#include <string>
+
+#include "FakeClient.h"
+#include "NatsOutbox.h"
+
+static int failures = 0;
+
+#define CHECK(cond)                                                        \
+  do {                                                                     \
+    if (!(cond)) {                                                         \
+      printf("FAIL %s:%d: %s\n", __FILE__, __LINE__, #cond);               \
+      failures++;                                                          \
+    }                                                                      \
+  } while (0)
+
+#define FLUSH_MS 20
+
+static void testFramingAndTimeFlush() {
+  FakeClient client;
+  NatsOutbox outbox(client, FLUSH_MS);
+  hostClock.nowMs = 0;
+
+  CHECK(outbox.publish("a.b", "hello", 5));
+  CHECK(outbox.publish("x", "", 0));
+  CHECK(outbox.publish("req", "r.1", "NATS/1.0\r\nK: V\r\n\r\n", 18, "{}", 2));
+  CHECK(outbox.control("PING\r\n"));
+  CHECK(client.writes == 0);
+
+  hostClock.nowMs = FLUSH_MS - 1;
+  CHECK(outbox.tick());
+  CHECK(client.writes == 0);
+
+  hostClock.nowMs = FLUSH_MS;
+  CHECK(outbox.tick());
+  CHECK(client.writes == 1);
+  CHECK(client.out ==
+        "PUB a.b 5\r\nhello\r\n"
+        "PUB x 0\r\n\r\n"
+        "HPUB req r.1 18 20\r\nNATS/1.0\r\nK: V\r\n\r\n{}\r\n"
+        "PING\r\n");
+  CHECK(outbox.buffered() == 0);
+  printf("framing:         PUB / HPUB / PING in order, one write at %d ms\n", FLUSH_MS);
+}
+
+static void testCoalescing() {
+  FakeClient client;
+  NatsOutbox outbox(client, FLUSH_MS);
+
+  const char* subject = "blackroad.devices.esp32.sensors";
+  std::string payload(100, 'p');
+  for (int i = 0; i < 100; i++) CHECK(outbox.publish(subject, payload.c_str(), payload.size()));
+  CHECK(outbox.flush());
+
+  std::string frame = std::string("PUB ") + subject + " 100\r\n" + payload + "\r\n";
+  CHECK(client.out.size() == frame.size() * 100);
+  CHECK(client.out.compare(0, frame.size(), frame) == 0);
+  printf("coalescing:      100 PUBs -> %u writes (%.1f frames/write)\n",
+         client.writes, outbox.framesPerWriteX100() / 100.0);
+}
+
+static void testWriteThrough() {
+  FakeClient client;
+  NatsOutbox outbox(client, FLUSH_MS);
+
+  std::string big(NATS_OUTBOX_BYTES * 2, 'B');
+  CHECK(outbox.publish("s", "tiny", 4));
+  CHECK(outbox.publish("big", big.c_str(), big.size()));
+  CHECK(client.out == "PUB s 4\r\ntiny\r\nPUB big " + std::to_string(big.size()) + "\r\n" + big + "\r\n");
+  CHECK(outbox.buffered() == 0);
+  printf("write-through:   %zu byte frame after flushing the small one\n", big.size());
+}
+
+static void testFailedWrite() {
+  FakeClient client;
+  NatsOutbox outbox(client, FLUSH_MS);
+
+  client.failWrites = true;
+  CHECK(outbox.publish("a", "b", 1));  // Buffered - nothing written yet
+  CHECK(!outbox.flush());
+  CHECK(outbox.buffered() == 0);
+  CHECK(outbox.stats.failures == 1);
+  printf("failed write:    buffer dropped, failure reported\n");
+}
+
+int main() {
+  hostClock.manual = true;
+
+  testFramingAndTimeFlush();
+  testCoalescing();
+  testWriteThrough();
+  testFailedWrite();
+
+  if (failures) {
+    printf("%d check(s) failed\n", failures);
+    return 1;
+  }
+  printf("all checks passed\n");
+  return 0;
+}
@@ -0,0 +1,201 @@
+/*
+ * ═══════════════════════════════════════════════════════════════════════
+ * BLACKROAD NATS PARSER TEST
+ * ═══════════════════════════════════════════════════════════════════════
+ *
+ * Host run of lib/NatsParser against one byte stream that has every op
+ * the server sends (INFO, +OK, PING, MSG, HMSG, PONG, -ERR, an oversized
+ * MSG), delivered:
+ * - Pipelined: the whole stream in one parse() call
+ * - Fragmented: in chunks of 1..64 bytes
+ * - Split in two at every byte offset
+ * Each delivery must produce the same ops. Malformed input must put the
+ * parser in its error state, and an over-long INFO is delivered cut
+ * short. Last, a throughput figure for a burst of command messages.
+ *
+ * Build:   make
+ * Run:     ./nats_parser_test          exits non-zero on any failure
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "NatsParser.h"
+
+static int failures = 0;
+
+#define CHECK(cond)                                                        \
+  do {                                                                     \
+    if (!(cond)) {                                                         \
+      printf("FAIL %s:%d: %s\n", __FILE__, __LINE__, #cond);               \
+      failures++;                                                          \
+    }                                                                      \
+  } while (0)
+
+// ─────────────────────────────────────────────────────────────────────
+// RECORDED OPS
+// ─────────────────────────────────────────────────────────────────────
+
+struct Event {
+  int type;
+  std::string args, subject, sid, replyTo, headers, payload;
+  bool truncated;
+};
+
+static std::vector<Event> events;
+
+static void record(const NatsOp& op, void*) {
+  Event e;
+  e.type = op.type;
+  e.args = op.args ? op.args : "";
+  e.subject = op.subject ? op.subject : "";
+  e.sid = op.sid ? op.sid : "";
+  e.replyTo = op.replyTo ? op.replyTo : "";
+  e.headers = op.headers ? op.headers : "";
+  e.payload = op.payload ? std::string(op.payload, op.payloadLen) : "";
+  e.truncated = op.truncated;
+  events.push_back(e);
+}
+
+static const std::string stream =
+    "INFO {\"server_id\":\"x\",\"max_payload\":1048576}\r\n"
+    "+OK\r\n"
+    "PING\r\n"
+    "MSG a.b 1 5\r\nhello\r\n"
+    "msg a.c 2 reply.x 0\r\n\r\n"                        // Lower case verb, empty payload
+    "HMSG h.s 3 18 23\r\nNATS/1.0\r\nK: V\r\n\r\nworld\r\n"
+    "PONG\r\n"
+    "-ERR 'Permissions Violation'\r\n"
+    "MSG big 1 2000\r\n" + std::string(2000, 'z') + "\r\n"  // Over NATS_PAYLOAD_MAX
+    "PING\r\n";
+
+#define STREAM_OPS 10
+
+static void checkEvents() {
+  CHECK(events.size() == STREAM_OPS);
+  if (events.size() != STREAM_OPS) return;
+
+  CHECK(events[0].type == NATS_OP_INFO && events[0].args.find("max_payload") != std::string::npos);
+  CHECK(events[1].type == NATS_OP_OK);
+  CHECK(events[2].type == NATS_OP_PING);
+  CHECK(events[3].type == NATS_OP_MSG && events[3].subject == "a.b" && events[3].sid == "1");
+  CHECK(events[3].payload == "hello" && events[3].replyTo.empty());
+  CHECK(events[4].subject == "a.c" && events[4].replyTo == "reply.x" && events[4].payload.empty());
+  CHECK(events[5].subject == "h.s" && events[5].payload == "world");
+  CHECK(events[5].headers.compare(0, 8, "NATS/1.0") == 0);
+  CHECK(events[6].type == NATS_OP_PONG);
+  CHECK(events[7].type == NATS_OP_ERR && events[7].args == "'Permissions Violation'");
+  CHECK(events[8].subject == "big" && events[8].truncated);
+  CHECK(events[9].type == NATS_OP_PING);
+}
+
+// ─────────────────────────────────────────────────────────────────────
+// DELIVERY PATTERNS
+// ─────────────────────────────────────────────────────────────────────
+
+static void testPipelined() {
+  events.clear();
+  NatsParser parser(record, NULL);
+  CHECK(parser.parse((const uint8_t*)stream.data(), stream.size()));
+  checkEvents();
+  printf("pipelined:       %zu ops from one %zu byte read\n", events.size(), stream.size());
+}
+
+static void testFragmented() {
+  for (size_t chunk = 1; chunk <= 64; chunk++) {
+    events.clear();
+    NatsParser parser(record, NULL);
+    for (size_t i = 0; i < stream.size(); i += chunk) {
+      size_t n = std::min(chunk, stream.size() - i);
+      CHECK(parser.parse((const uint8_t*)stream.data() + i, n));
+    }
+    checkEvents();
+  }
+  printf("fragmented:      chunks of 1..64 bytes\n");
+}
+
+static void testEverySplit() {
+  for (size_t cut = 0; cut <= stream.size(); cut++) {
+    events.clear();
+    NatsParser parser(record, NULL);
+    CHECK(parser.parse((const uint8_t*)stream.data(), cut));
+    CHECK(parser.parse((const uint8_t*)stream.data() + cut, stream.size() - cut));
+    CHECK(events.size() == STREAM_OPS);
+  }
+  printf("split:           every one of %zu offsets\n", stream.size() + 1);
+}
+
+static void testMalformed() {
+  const char* bad[] = {
+    "FOO\r\n",                       // Unknown verb
+    "MSG a\r\n",                     // Missing sid / size
+    "MSG a 1 x\r\n",                 // Size not a number
+    "MSG a 1 3\r\nabcX\r\n",         // Payload longer than declared
+    "HMSG a 1 9 3\r\n",              // Header block larger than the total
+    "PING\r\nMSG a 1 2 3 4 5\r\n",   // Too many arguments
+  };
+  for (const char* b : bad) {
+    events.clear();
+    NatsParser parser(record, NULL);
+    CHECK(!parser.parse((const uint8_t*)b, strlen(b)));
+    CHECK(parser.error() != NULL);
+    CHECK(!parser.parse((const uint8_t*)"PING\r\n", 6));  // Stays failed until reset()
+  }
+
+  std::string longLine = "PONG" + std::string(NATS_CTRL_MAX + 40, ' ') + "x\r\n";
+  {
+    NatsParser parser(record, NULL);
+    CHECK(!parser.parse((const uint8_t*)longLine.data(), longLine.size()));
+  }
+
+  std::string longInfo = "INFO {" + std::string(NATS_CTRL_MAX * 2, 'a') + "}\r\nPING\r\n";
+  {
+    events.clear();
+    NatsParser parser(record, NULL);
+    CHECK(parser.parse((const uint8_t*)longInfo.data(), longInfo.size()));
+    CHECK(events.size() == 2 && events[0].truncated && events[1].type == NATS_OP_PING);
+  }
+  printf("malformed:       %zu streams rejected, long INFO truncated\n", sizeof(bad) / sizeof(bad[0]));
+}
+
+// ─────────────────────────────────────────────────────────────────────
+// THROUGHPUT
+// ─────────────────────────────────────────────────────────────────────
+
+static void benchThroughput() {
+  std::string burst;
+  for (int i = 0; i < 1000; i++) {
+    burst += "MSG blackroad.devices.esp32.commands 1 20\r\n{\"command\":\"status\"}\r\n";
+  }
+
+  static long delivered = 0;
+  NatsParser parser([](const NatsOp&, void*) { delivered++; }, NULL);
+
+  const int rounds = 1000;
+  auto start = std::chrono::steady_clock::now();
+  for (int r = 0; r < rounds; r++) parser.parse((const uint8_t*)burst.data(), burst.size());
+  double sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  CHECK(delivered == 1000L * rounds);
+  printf("throughput:      %.1f M msg/s, %.0f MB/s (%ld msgs)\n",
+         delivered / sec / 1e6, burst.size() * (double)rounds / sec / 1e6, delivered);
+}
+
+int main() {
+  testPipelined();
+  testFragmented();
+  testEverySplit();
+  testMalformed();
+  benchThroughput();
+
+  if (failures) {
+    printf("%d check(s) failed\n", failures);
+    return 1;
+  }
+  printf("all checks passed\n");
+  return 0;
+}
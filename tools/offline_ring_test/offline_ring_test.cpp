@@ -0,0 +1,106 @@
+/*
+ * ═══════════════════════════════════════════════════════════════════════
+ * BLACKROAD OFFLINE RING TEST
+ * ═══════════════════════════════════════════════════════════════════════
+ *
+ * Host run of lib/OfflineRing with the NATS firmware's three kinds
+ * (sensors, heartbeat, status) pushed through an outage:
+ * - A kind at its quota evicts its own oldest (DROP_OLDEST) or refuses
+ *   the new message (DROP_NEWEST)
+ * - A full ring evicts the ring's oldest message, whatever its kind
+ * - Evictions go to the spill callback first; only refused ones drop
+ * - The drain comes out oldest first, per kind in push order
+ * - Oversized messages are rejected
+ *
+ * Build:   make
+ * Run:     ./offline_ring_test         exits non-zero on any failure
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include "OfflineRing.h"
+
+static int failures = 0;
+
+#define CHECK(cond)                                                        \
+  do {                                                                     \
+    if (!(cond)) {                                                         \
+      printf("FAIL %s:%d: %s\n", __FILE__, __LINE__, #cond);               \
+      failures++;                                                          \
+    }                                                                      \
+  } while (0)
+
+enum { KIND_SENSORS, KIND_HEARTBEAT, KIND_STATUS };
+
+// Stands in for the flash journal: keeps status, refuses heartbeats
+static std::vector<std::string> spilled;
+
+static bool spillToJournal(const OfflineRing::Entry& e, void*) {
+  if (e.kind == KIND_HEARTBEAT) return false;
+  spilled.push_back(e.data);
+  return true;
+}
+
+static void push(OfflineRing& ring, uint8_t kind, const char* topic, const std::string& data) {
+  ring.push(kind, topic, data.c_str(), data.size());
+}
+
+int main() {
+  static OfflineRing ring;  // ~7KB, keep it off the stack like the firmware
+  ring.setPolicy(KIND_SENSORS, OFFLINE_RING_SLOTS, RING_DROP_OLDEST);
+  ring.setPolicy(KIND_HEARTBEAT, 4, RING_DROP_NEWEST);
+  ring.setPolicy(KIND_STATUS, 2, RING_DROP_OLDEST);
+  ring.onSpill(spillToJournal, NULL);
+
+  // Heartbeat quota 4, DROP_NEWEST: hb4 and hb5 are refused
+  for (int i = 0; i < 6; i++) push(ring, KIND_HEARTBEAT, "hb", "hb" + std::to_string(i));
+  CHECK(ring.count(KIND_HEARTBEAT) == 4);
+  CHECK(ring.stats.dropped == 2);
+
+  // Status quota 2, DROP_OLDEST: st0 is evicted into the journal
+  for (int i = 0; i < 3; i++) push(ring, KIND_STATUS, "st", "st" + std::to_string(i));
+  CHECK(ring.count(KIND_STATUS) == 2);
+  CHECK(spilled.size() == 1 && spilled[0] == "st0");
+  printf("kind quotas:     DROP_NEWEST refused 2, DROP_OLDEST spilled 1\n");
+
+  // 6 slots used; 12 sensors fill the ring and evict the two oldest
+  // messages overall (hb0, hb1), which the journal refuses -> dropped
+  for (int i = 0; i < 12; i++) push(ring, KIND_SENSORS, "s", "s" + std::to_string(i));
+  CHECK(ring.count() == OFFLINE_RING_SLOTS);
+  CHECK(ring.count(KIND_HEARTBEAT) == 2);
+  CHECK(ring.stats.dropped == 4);
+  CHECK(ring.stats.evicted == 3 && ring.stats.spilled == 1);
+  printf("ring full:       global oldest evicted, %u dropped in total\n", ring.stats.dropped);
+
+  std::vector<std::string> drained;
+  const OfflineRing::Entry* e;
+  while ((e = ring.peek())) {
+    drained.push_back(e->data);
+    ring.pop();
+  }
+  CHECK(drained.size() == OFFLINE_RING_SLOTS);
+  CHECK(drained.front() == "hb2" && drained.back() == "s11");
+  int lastSensor = -1;
+  for (const std::string& d : drained) {
+    if (d[0] != 's' || d[1] == 't') continue;
+    CHECK(atoi(d.c_str() + 1) == lastSensor + 1);
+    lastSensor = atoi(d.c_str() + 1);
+  }
+  CHECK(ring.count() == 0 && ring.stats.drained == OFFLINE_RING_SLOTS);
+  printf("drain:           %zu messages oldest first, sensors in order\n", drained.size());
+
+  std::string big(OFFLINE_RING_DATA_MAX + 1, 'x');
+  CHECK(!ring.push(KIND_SENSORS, "s", big.c_str(), big.size()));
+  CHECK(ring.stats.rejected == 1);
+  printf("oversized:       rejected (%zu byte ring)\n", sizeof(ring));
+
+  if (failures) {
+    printf("%d check(s) failed\n", failures);
+    return 1;
+  }
+  printf("all checks passed\n");
+  return 0;
+}
@@ -0,0 +1,188 @@
+/*
+ * ═══════════════════════════════════════════════════════════════════════
+ * BLACKROAD SENSOR PIPELINE BENCHMARK
+ * ═══════════════════════════════════════════════════════════════════════
+ *
+ * Host run of lib/SensorPipeline with synthetic sources:
+ * - Kernel: sensorAggregate() throughput over a prefilled frame buffer
+ * - Pipeline: a producer thread sampling into the lock-free ring while the
+ *   main thread drains it; the window must match a single-threaded fold
+ * - Rates: virtual minute at rising sample rates - publishes per minute
+ *   stay the same while the samples behind each one grow
+ *
+ * Build:   make
+ * Run:     ./sensor_bench [N]       N kernel frames (default 10,000,000)
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+#include "SensorPipeline.h"
+
+#define PUBLISH_MS 5000              // Same window as the firmware
+
+static uint64_t nowNs() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static SyntheticSource synthetic(float base, float amplitude, float periodMs, float noise, float stepMs,
+                                 uint32_t seed) {
+  SyntheticSource s = {base, amplitude, periodMs, noise, stepMs, seed, 0};
+  return s;
+}
+
+static bool sameWindow(const SensorWindow& a, const SensorWindow& b) {
+  return a.count == b.count && a.min == b.min && a.max == b.max && a.last == b.last &&
+         fabsf(a.sum - b.sum) <= 1e-3f * fabsf(b.sum) + 1e-3f;
+}
+
+static int benchKernel(long frames) {
+  const size_t block = 4096;
+  std::vector<SensorFrame> buf(block);
+  SyntheticSource src[SENSOR_PIPELINE_CHANNELS];
+  for (int c = 0; c < SENSOR_PIPELINE_CHANNELS; c++) src[c] = synthetic(20 + c, 5, 60000, 0.5f, 10, 1 + c);
+  for (size_t i = 0; i < block; i++) {
+    buf[i].atMs = i * 10;
+    buf[i].valid = (1 << SENSOR_PIPELINE_CHANNELS) - 1;
+    for (int c = 0; c < SENSOR_PIPELINE_CHANNELS; c++) SyntheticSource::read(&buf[i].v[c], &src[c]);
+  }
+
+  SensorWindow w[SENSOR_PIPELINE_CHANNELS];
+  for (int c = 0; c < SENSOR_PIPELINE_CHANNELS; c++) w[c].reset();
+
+  long done = 0;
+  uint64_t start = nowNs();
+  while (done < frames) {
+    sensorAggregate(buf.data(), block, SENSOR_PIPELINE_CHANNELS, w);
+    done += block;
+  }
+  double ns = (double)(nowNs() - start) / done;
+
+  printf("  Kernel:    %7.2f ns/frame (%d channels), %.0f Mframes/s\n", ns, SENSOR_PIPELINE_CHANNELS,
+         1000.0 / ns);
+  if (w[0].count != (uint32_t)done || w[0].min > w[0].max) {
+    printf("  ❌ kernel window inconsistent\n");
+    return 1;
+  }
+  return 0;
+}
+
+static int benchPipeline(long samples) {
+  SensorPipeline pipe;
+  SyntheticSource src[SENSOR_PIPELINE_CHANNELS], ref[SENSOR_PIPELINE_CHANNELS];
+  for (int c = 0; c < SENSOR_PIPELINE_CHANNELS; c++) {
+    src[c] = ref[c] = synthetic(20 + c, 5, 60000, 0.5f, 1, 7 + c);
+    pipe.addSource("ch", SyntheticSource::read, &src[c]);
+  }
+
+  // The producer waits for room instead of overrunning, so every frame
+  // crosses the ring and the result can be checked exactly
+  uint64_t start = nowNs();
+  std::thread producer([&] {
+    for (long i = 0; i < samples; i++) {
+      while (pipe.queued() == SENSOR_RING_FRAMES) std::this_thread::yield();
+      pipe.sample(i);
+    }
+  });
+  long drained = 0;
+  while (drained < samples) {
+    size_t n = pipe.drain();
+    if (n == 0) std::this_thread::yield();
+    drained += n;
+  }
+  producer.join();
+  double ns = (double)(nowNs() - start) / samples;
+
+  SensorWindow got[SENSOR_PIPELINE_CHANNELS], expect[SENSOR_PIPELINE_CHANNELS];
+  pipe.takeWindow(got, samples);
+  for (int c = 0; c < SENSOR_PIPELINE_CHANNELS; c++) expect[c].reset();
+  for (long i = 0; i < samples; i++) {
+    SensorFrame f;
+    f.valid = (1 << SENSOR_PIPELINE_CHANNELS) - 1;
+    for (int c = 0; c < SENSOR_PIPELINE_CHANNELS; c++) SyntheticSource::read(&f.v[c], &ref[c]);
+    sensorAggregate(&f, 1, SENSOR_PIPELINE_CHANNELS, expect);
+  }
+  printf("  Pipeline:  %7.2f ns/sample producer thread -> ring -> drain, %lu overruns\n", ns,
+         (unsigned long)pipe.overruns());
+
+  for (int c = 0; c < SENSOR_PIPELINE_CHANNELS; c++) {
+    // Sums are folded in different batch sizes - compare min/max/last/count exactly
+    if (got[c].count != expect[c].count || got[c].min != expect[c].min || got[c].max != expect[c].max ||
+        got[c].last != expect[c].last || pipe.overruns() != 0) {
+      printf("  ❌ channel %d differs after crossing threads\n", c);
+      return 1;
+    }
+  }
+  return 0;
+}
+
+// Single-threaded, so nothing overruns: the window must equal a direct fold
+static int checkWindow() {
+  SensorPipeline pipe;
+  SyntheticSource src = synthetic(24, 3, 60000, 0.3f, 10, 42), ref = src;
+  pipe.addSource("temperature_c", SyntheticSource::read, &src);
+
+  SensorWindow expect;
+  expect.reset();
+  for (int i = 0; i < 500; i++) {
+    pipe.sample(i * 10);
+    if (i % 37 == 0) pipe.drain();
+    SensorFrame f;
+    f.valid = 1;
+    SyntheticSource::read(&f.v[0], &ref);
+    sensorAggregate(&f, 1, 1, &expect);
+  }
+  pipe.drain();
+  SensorWindow got;
+  uint32_t length = pipe.takeWindow(&got, 5000);
+  printf("  Window:    n=%lu min=%.2f max=%.2f mean=%.2f last=%.2f over %lu ms\n", (unsigned long)got.count,
+         got.min, got.max, got.mean(), got.last, (unsigned long)length);
+  if (!sameWindow(got, expect) || got.min < 24 - 3.3f || got.max > 24 + 3.3f) {
+    printf("  ❌ window differs from the reference fold\n");
+    return 1;
+  }
+  return 0;
+}
+
+static void publishVolume() {
+  printf("\n  Sample rate   Samples/min   Publishes/min\n");
+  const int rates[] = {1, 10, 100, 1000};
+  for (int r = 0; r < 4; r++) {
+    SensorPipeline pipe;
+    float stepMs = 1000.0f / rates[r];
+    SyntheticSource temp = synthetic(24, 3, 60000, 0.3f, stepMs, 1), hum = synthetic(50, 8, 90000, 1, stepMs, 2);
+    pipe.addSource("temperature_c", SyntheticSource::read, &temp);
+    pipe.addSource("humidity_pct", SyntheticSource::read, &hum);
+
+    uint32_t samples = 0, publishes = 0, nextPublish = PUBLISH_MS;
+    for (uint32_t t = 1000 / rates[r]; t <= 60000; t += 1000 / rates[r]) {
+      pipe.sample(t);
+      samples++;
+      if (t >= nextPublish) {
+        pipe.drain();
+        SensorWindow w[SENSOR_PIPELINE_CHANNELS];
+        pipe.takeWindow(w, t);
+        publishes++;
+        nextPublish += PUBLISH_MS;
+      }
+      if (samples % 64 == 0) pipe.drain();  // loop() keeps up
+    }
+    printf("  %8d Hz   %11lu   %13lu\n", rates[r], (unsigned long)samples, (unsigned long)publishes);
+  }
+}
+
+int main(int argc, char** argv) {
+  long frames = argc > 1 ? atol(argv[1]) : 10000000;
+  printf("⏱️  Sensor pipeline benchmark\n\n");
+  int failed = 0;
+  failed += benchKernel(frames);
+  failed += benchPipeline(frames / 10);
+  failed += checkWindow();
+  publishVolume();
+  printf(failed ? "\n❌ FAILED\n" : "\n✅ OK\n");
+  return failed ? 1 : 0;
+}
@@ -0,0 +1,233 @@
+/*
+ * ═══════════════════════════════════════════════════════════════════════
+ * BLACKROAD TELEMETRY DECODER
+ * ═══════════════════════════════════════════════════════════════════════
+ *
+ * Server-side reader for the compact telemetry bodies (lib/TelemetryCodec)
+ * the NATS firmware publishes on the sensors and heartbeat subjects:
+ * - Decode: one raw message body on stdin (or a file) -> one JSON object
+ *   per record on stdout, in the same shape as the firmware's JSON bodies.
+ *   JSON bodies pass through unchanged, so either encoding can be piped in
+ * - Bench: bytes and CPU time per window, JSON vs binary, single records
+ *   and batches, plus a round-trip check
+ *
+ * Build:   make
+ * Decode:  nats sub --raw blackroad.devices.esp32.sensors --count 1 | ./telemetry_decode
+ *          ./telemetry_decode message.bin
+ * Bench:   ./telemetry_decode --bench [N]
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "TelemetryCodec.h"
+
+static uint64_t nowNs() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// ─────────────────────────────────────────────────────────────────────
+// RECORDS -> JSON (the firmware's JSON layout)
+// ─────────────────────────────────────────────────────────────────────
+
+static size_t sensorJson(char* out, size_t cap, const char* deviceId, const TelSensorRecord& r) {
+  size_t n = snprintf(out, cap,
+                      "{\"device_id\":\"%s\",\"timestamp\":%lu,\"window_ms\":%lu,\"sample_hz\":%lu,\"overruns\":%lu",
+                      deviceId, (unsigned long)r.timestamp, (unsigned long)r.windowMs,
+                      (unsigned long)r.sampleHz, (unsigned long)r.overruns);
+  for (uint8_t c = 0; c < r.channels && n < cap; c++) {
+    const TelChannelStats& s = r.ch[c];
+    const char* name = telChannelName(s.id);
+    char unknown[12];
+    if (!name) {
+      snprintf(unknown, sizeof(unknown), "ch%u", s.id);
+      name = unknown;
+    }
+    if (s.count == 0) {
+      n += snprintf(out + n, cap - n, ",\"%s\":null", name);
+    } else {
+      n += snprintf(out + n, cap - n, ",\"%s\":{\"min\":%.2f,\"max\":%.2f,\"mean\":%.2f,\"last\":%.2f,\"count\":%lu}",
+                    name, s.min, s.max, s.mean, s.last, (unsigned long)s.count);
+    }
+  }
+  if (n < cap) {
+    n += snprintf(out + n, cap - n, ",\"wifi_rssi\":%ld,\"free_heap\":%lu}", (long)r.rssi,
+                  (unsigned long)r.freeHeap);
+  }
+  return n < cap ? n : cap - 1;
+}
+
+static size_t heartbeatJson(char* out, size_t cap, const char* deviceId, const TelHeartbeat& h) {
+  size_t n = snprintf(out, cap,
+                      "{\"device_id\":\"%s\",\"status\":\"alive\",\"uptime\":%lu,\"free_heap\":%lu,"
+                      "\"connected\":%s,\"buffered\":%lu,\"journaled\":%lu,\"dropped\":%lu}",
+                      deviceId, (unsigned long)h.uptimeS, (unsigned long)h.freeHeap,
+                      h.connected ? "true" : "false", (unsigned long)h.buffered,
+                      (unsigned long)h.journaled, (unsigned long)h.dropped);
+  return n < cap ? n : cap - 1;
+}
+
+static const char* resultName(TelResult r) {
+  switch (r) {
+    case TEL_OK: return "ok";
+    case TEL_END: return "end";
+    case TEL_ERR_SHORT: return "truncated";
+    case TEL_ERR_MAGIC: return "bad magic";
+    case TEL_ERR_VERSION: return "unsupported version";
+    case TEL_ERR_KIND: return "unknown kind";
+    case TEL_ERR_RANGE: return "field out of range";
+  }
+  return "?";
+}
+
+static int decode(const std::vector<uint8_t>& body) {
+  if (!TelemetryDecoder::isBinary(body.data(), body.size())) {
+    fwrite(body.data(), 1, body.size(), stdout);  // Already JSON
+    if (body.empty() || body.back() != '\n') putchar('\n');
+    return 0;
+  }
+
+  TelemetryDecoder d(body.data(), body.size());
+  TelResult res = d.begin();
+  char json[1024];
+  while (res == TEL_OK) {
+    if (d.kind() == TEL_KIND_SENSORS) {
+      TelSensorRecord r;
+      if ((res = d.next(&r)) == TEL_OK) sensorJson(json, sizeof(json), d.deviceId(), r);
+    } else {
+      TelHeartbeat h;
+      if ((res = d.next(&h)) == TEL_OK) heartbeatJson(json, sizeof(json), d.deviceId(), h);
+    }
+    if (res == TEL_OK) puts(json);
+  }
+  if (res != TEL_END) {
+    fprintf(stderr, "telemetry_decode: %s\n", resultName(res));
+    return 1;
+  }
+  return 0;
+}
+
+// ─────────────────────────────────────────────────────────────────────
+// BENCH
+// ─────────────────────────────────────────────────────────────────────
+
+static TelSensorRecord benchWindow(int i) {
+  TelSensorRecord r;
+  memset(&r, 0, sizeof(r));
+  r.timestamp = 600000 + i * 5000;
+  r.windowMs = 5000 + (i % 3);
+  r.sampleHz = 100;
+  r.overruns = i / 40;
+  r.rssi = -60 - (i % 7);
+  r.freeHeap = 212000 - (i % 50) * 16;
+  r.channels = 2;
+  float temp = 24 + 3 * sinf(i * 0.05f);
+  float hum = 50 + 8 * sinf(i * 0.03f);
+  r.ch[0] = {TEL_CH_TEMPERATURE_C, 500, temp - 0.41f, temp + 0.37f, temp, temp + 0.12f};
+  r.ch[1] = {TEL_CH_HUMIDITY_PCT, 500, hum - 1.23f, hum + 1.08f, hum, hum - 0.57f};
+  return r;
+}
+
+static bool close2(float a, float b) { return fabsf(a - b) <= 0.006f; }
+
+static int runBench(int iterations) {
+  printf("⏱️  Telemetry encoding benchmark, %d windows\n\n", iterations);
+  const char* device = "esp32-device1";
+  std::vector<TelSensorRecord> windows;
+  for (int i = 0; i < 256; i++) windows.push_back(benchWindow(i));
+
+  // JSON, one window per message (what the firmware publishes today)
+  char json[512];
+  size_t jsonBytes = 0;
+  uint64_t start = nowNs();
+  for (int i = 0; i < iterations; i++) jsonBytes += sensorJson(json, sizeof(json), device, windows[i & 255]);
+  double jsonNs = (double)(nowNs() - start) / iterations;
+
+  // Binary, batch of 1 and of 12 windows (a minute)
+  uint8_t buf[2048];
+  int failed = 0;
+  printf("  Encoding          Bytes/window   Encode ns/window   Decode ns/window\n");
+  printf("  JSON              %12.1f   %16.0f                  -\n", (double)jsonBytes / iterations, jsonNs);
+
+  const int batches[] = {1, 12};
+  for (int b = 0; b < 2; b++) {
+    int batch = batches[b];
+    int messages = iterations / batch;
+    size_t bytes = 0;
+    start = nowNs();
+    for (int m = 0; m < messages; m++) {
+      TelemetryEncoder e(buf, sizeof(buf));
+      e.begin(TEL_KIND_SENSORS, device, windows[(m * batch) & 255].timestamp);
+      for (int k = 0; k < batch; k++) e.sensors(windows[(m * batch + k) & 255]);
+      if (!e.finish()) failed++;
+      bytes += e.length();
+    }
+    double encodeNs = (double)(nowNs() - start) / (messages * batch);
+
+    // Encode one batch, then decode it repeatedly and check the round trip
+    TelemetryEncoder e(buf, sizeof(buf));
+    e.begin(TEL_KIND_SENSORS, device, windows[0].timestamp);
+    for (int k = 0; k < batch; k++) e.sensors(windows[k]);
+    e.finish();
+    size_t len = e.length();
+    start = nowNs();
+    for (int m = 0; m < messages; m++) {
+      TelemetryDecoder d(buf, len);
+      TelSensorRecord r;
+      if (d.begin() != TEL_OK) failed++;
+      int k = 0;
+      while (d.next(&r) == TEL_OK) {
+        const TelSensorRecord& w = windows[k++];
+        if (m == 0 && (r.timestamp != w.timestamp || r.overruns != w.overruns || r.rssi != w.rssi ||
+                       !close2(r.ch[1].min, w.ch[1].min) || !close2(r.ch[0].last, w.ch[0].last) ||
+                       strcmp(d.deviceId(), device) != 0)) {
+          failed++;
+        }
+      }
+      if (k != batch) failed++;
+    }
+    double decodeNs = (double)(nowNs() - start) / (messages * batch);
+
+    double perWindow = (double)bytes / (messages * batch);
+    printf("  Binary, batch %-3d %12.1f   %16.0f   %16.0f   (%.1fx smaller, %.1fx faster)\n", batch, perWindow,
+           encodeNs, decodeNs, (double)jsonBytes / iterations / perWindow, jsonNs / encodeNs);
+  }
+
+  // Heartbeat
+  TelHeartbeat h = {600000, 600, 212000, true, 3, 0, 0};
+  TelemetryEncoder e(buf, sizeof(buf));
+  e.begin(TEL_KIND_HEARTBEAT, device, h.timestamp);
+  e.heartbeat(h);
+  e.finish();
+  size_t hbJson = heartbeatJson(json, sizeof(json), device, h);
+  TelemetryDecoder d(buf, e.length());
+  TelHeartbeat back;
+  if (d.begin() != TEL_OK || d.next(&back) != TEL_OK || back.uptimeS != h.uptimeS || !back.connected) failed++;
+  printf("  Heartbeat: %zu bytes binary vs %zu bytes JSON\n", e.length(), hbJson);
+
+  printf(failed ? "\n❌ %d round-trip failure(s)\n" : "\n✅ Round trip OK\n", failed);
+  return failed ? 1 : 0;
+}
+
+int main(int argc, char** argv) {
+  if (argc > 1 && strcmp(argv[1], "--bench") == 0) {
+    return runBench(argc > 2 ? atoi(argv[2]) : 1000000);
+  }
+
+  FILE* in = stdin;
+  if (argc > 1 && !(in = fopen(argv[1], "rb"))) {
+    perror(argv[1]);
+    return 1;
+  }
+  std::vector<uint8_t> body;
+  uint8_t chunk[4096];
+  size_t n;
+  while ((n = fread(chunk, 1, sizeof(chunk), in)) > 0) body.insert(body.end(), chunk, chunk + n);
+  if (in != stdin) fclose(in);
+  return decode(body);
+}
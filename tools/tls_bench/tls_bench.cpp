@@ -0,0 +1,240 @@
+/*
+ * ═══════════════════════════════════════════════════════════════════════
+ * BLACKROAD TLS SESSION CACHE BENCHMARK
+ * ═══════════════════════════════════════════════════════════════════════
+ *
+ * Host run of src/tls_session_cache.h against a local TLS stand-in: an
+ * mbedTLS server thread on loopback with the mbedTLS test RSA-2048
+ * certificate, answering one small HTTP response per connection.
+ * - Baseline: the stock WiFiClientSecure, a full handshake every connect
+ * - ResumableClientSecure with the server resuming by session ticket,
+ *   then by session ID only (tickets off) - the first connect is full,
+ *   the rest abbreviated
+ * - tlsStats must count them that way, and a restarted server (cache
+ *   and ticket key gone) must fall back to a full handshake
+ *
+ * Times are host wall clock per connect; an ESP32 at 240 MHz is 20-50x slower on the same
+ * RSA/ECDHE work, so the ratio is what carries over.
+ *
+ * Build:   make                       (needs mbedTLS 2.x, see Makefile)
+ * Run:     ./tls_bench [N]            N connects per client (default 50)
+ */
+
+#include <arpa/inet.h>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+
+#include <Arduino.h>
+#include <freertos/task.h>
+#include "tls_session_cache.h"
+
+#include <mbedtls/certs.h>
+#include <mbedtls/ssl_cache.h>
+#include <mbedtls/ssl_ticket.h>
+
+static int failures = 0;
+
+#define CHECK(cond)                                                        \
+  do {                                                                     \
+    if (!(cond)) {                                                         \
+      printf("FAIL %s:%d: %s\n", __FILE__, __LINE__, #cond);               \
+      failures++;                                                          \
+    }                                                                      \
+  } while (0)
+
+#define RESPONSE "HTTP/1.0 200 OK\r\nContent-Length: 2\r\n\r\n{}"
+
+// ─────────────────────────────────────────────────────────────────────
+// TLS STAND-IN SERVER
+// ─────────────────────────────────────────────────────────────────────
+
+class TlsStandIn {
+public:
+  explicit TlsStandIn(bool tickets) {
+    mbedtls_net_init(&_listen);
+    mbedtls_ssl_config_init(&_conf);
+    mbedtls_x509_crt_init(&_cert);
+    mbedtls_pk_init(&_key);
+    mbedtls_entropy_init(&_entropy);
+    mbedtls_ctr_drbg_init(&_drbg);
+    mbedtls_ssl_cache_init(&_cache);
+    mbedtls_ssl_ticket_init(&_ticket);
+
+    const char* pers = "tls-standin";
+    bool ok = mbedtls_ctr_drbg_seed(&_drbg, mbedtls_entropy_func, &_entropy, (const unsigned char*)pers,
+                                    strlen(pers)) == 0 &&
+              mbedtls_x509_crt_parse(&_cert, (const unsigned char*)mbedtls_test_srv_crt,
+                                     mbedtls_test_srv_crt_len) == 0 &&
+              mbedtls_pk_parse_key(&_key, (const unsigned char*)mbedtls_test_srv_key, mbedtls_test_srv_key_len,
+                                   NULL, 0) == 0 &&
+              mbedtls_ssl_config_defaults(&_conf, MBEDTLS_SSL_IS_SERVER, MBEDTLS_SSL_TRANSPORT_STREAM,
+                                          MBEDTLS_SSL_PRESET_DEFAULT) == 0 &&
+              mbedtls_ssl_conf_own_cert(&_conf, &_cert, &_key) == 0 &&
+              mbedtls_net_bind(&_listen, "127.0.0.1", "0", MBEDTLS_NET_PROTO_TCP) == 0;
+    CHECK(ok);
+
+    mbedtls_ssl_conf_rng(&_conf, mbedtls_ctr_drbg_random, &_drbg);
+    mbedtls_ssl_conf_session_cache(&_conf, &_cache, mbedtls_ssl_cache_get, mbedtls_ssl_cache_set);
+    if (tickets) {
+      CHECK(mbedtls_ssl_ticket_setup(&_ticket, mbedtls_ctr_drbg_random, &_drbg, MBEDTLS_CIPHER_AES_256_GCM,
+                                     86400) == 0);
+      mbedtls_ssl_conf_session_tickets_cb(&_conf, mbedtls_ssl_ticket_write, mbedtls_ssl_ticket_parse, &_ticket);
+    }
+
+    sockaddr_in sa = {};
+    socklen_t len = sizeof(sa);
+    getsockname(_listen.fd, (sockaddr*)&sa, &len);
+    port = ntohs(sa.sin_port);
+    _thread = std::thread(&TlsStandIn::run, this);
+  }
+
+  ~TlsStandIn() {
+    shutdown(_listen.fd, SHUT_RDWR);  // Wakes accept()
+    _thread.join();
+    mbedtls_net_free(&_listen);
+    mbedtls_ssl_ticket_free(&_ticket);
+    mbedtls_ssl_cache_free(&_cache);
+    mbedtls_ssl_config_free(&_conf);
+    mbedtls_x509_crt_free(&_cert);
+    mbedtls_pk_free(&_key);
+    mbedtls_ctr_drbg_free(&_drbg);
+    mbedtls_entropy_free(&_entropy);
+  }
+
+  uint16_t port;
+
+private:
+  mbedtls_net_context _listen;
+  mbedtls_ssl_config _conf;
+  mbedtls_x509_crt _cert;
+  mbedtls_pk_context _key;
+  mbedtls_entropy_context _entropy;
+  mbedtls_ctr_drbg_context _drbg;
+  mbedtls_ssl_cache_context _cache;
+  mbedtls_ssl_ticket_context _ticket;
+  std::thread _thread;
+
+  // One connection at a time - the clients connect one after another
+  void run() {
+    for (;;) {
+      mbedtls_net_context client;
+      mbedtls_net_init(&client);
+      if (mbedtls_net_accept(&_listen, &client, NULL, 0, NULL) != 0) return;
+
+      mbedtls_ssl_context ssl;
+      mbedtls_ssl_init(&ssl);
+      if (mbedtls_ssl_setup(&ssl, &_conf) == 0) {
+        mbedtls_ssl_set_bio(&ssl, &client, mbedtls_net_send, mbedtls_net_recv, NULL);
+        if (mbedtls_ssl_handshake(&ssl) == 0) {
+          unsigned char req[512];
+          mbedtls_ssl_read(&ssl, req, sizeof(req));
+          mbedtls_ssl_write(&ssl, (const unsigned char*)RESPONSE, strlen(RESPONSE));
+          mbedtls_ssl_close_notify(&ssl);
+        }
+      }
+      mbedtls_ssl_free(&ssl);
+      mbedtls_net_free(&client);
+    }
+  }
+};
+
+// ─────────────────────────────────────────────────────────────────────
+// CLIENT SIDE
+// ─────────────────────────────────────────────────────────────────────
+
+// Connect, GET, read the reply. Returns the connect (handshake) time.
+static double oneRequest(WiFiClientSecure& client, uint16_t port) {
+  auto start = std::chrono::steady_clock::now();
+  bool connected = client.connect("localhost", port);
+  double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+  CHECK(connected);
+  if (!connected) return ms;
+
+  client.print("GET / HTTP/1.0\r\nHost: localhost\r\n\r\n");
+  std::string reply;
+  uint8_t buf[256];
+  int n;
+  while ((n = client.read(buf, sizeof(buf))) > 0) reply.append((const char*)buf, n);
+  CHECK(reply == RESPONSE);
+  client.stop();
+  return ms;
+}
+
+static void resetStats() {
+  tlsCacheClear();
+  memset(&tlsStats, 0, sizeof(tlsStats));
+}
+
+// n connects to a fresh server: the first is full, the rest resumed
+static void benchMode(const char* label, bool tickets, int n, double baselineMs) {
+  TlsStandIn server(tickets);
+  resetStats();
+
+  ResumableClientSecure client;
+  double firstMs = oneRequest(client, server.port);
+  double resumedMs = 0;
+  for (int i = 1; i < n; i++) resumedMs += oneRequest(client, server.port);
+  resumedMs /= n - 1;
+
+  CHECK(tlsStats.fullHandshakes == 1);
+  CHECK(tlsStats.resumedHandshakes == (uint32_t)n - 1);
+  CHECK(tlsStats.failedHandshakes == 0);
+  CHECK(resumedMs < baselineMs);
+
+  printf("%-16s 1 full (%.2f ms) + %u resumed (%.2f ms), %.1fx faster than stock\n", label, firstMs,
+         tlsStats.resumedHandshakes, resumedMs, baselineMs / resumedMs);
+}
+
+static void checkServerRestart() {
+  resetStats();
+  ResumableClientSecure client;
+  uint16_t port;
+  {
+    TlsStandIn server(true);
+    port = server.port;
+    oneRequest(client, port);
+    oneRequest(client, port);
+  }
+  CHECK(tlsStats.fullHandshakes == 1 && tlsStats.resumedHandshakes == 1);
+
+  // Same host:port isn't guaranteed after a restart, so re-key the entry
+  TlsStandIn fresh(true);
+  tlsCacheLock();
+  for (int i = 0; i < TLS_SESSION_CACHE_SIZE; i++) {
+    if (tlsSessionCache[i].valid && tlsSessionCache[i].port == port) tlsSessionCache[i].port = fresh.port;
+  }
+  tlsCacheUnlock();
+
+  oneRequest(client, fresh.port);  // Stale session offered, server refuses it
+  CHECK(tlsStats.fullHandshakes == 2);
+  oneRequest(client, fresh.port);
+  CHECK(tlsStats.resumedHandshakes == 2);
+  printf("server restart:  stale session refused, full handshake, then resumed again\n");
+}
+
+int main(int argc, char** argv) {
+  int n = argc > 1 ? atoi(argv[1]) : 50;
+  if (n < 2) n = 2;
+
+  double baselineMs;
+  {
+    TlsStandIn server(true);
+    WiFiClientSecure stock;
+    baselineMs = 0;
+    for (int i = 0; i < n; i++) baselineMs += oneRequest(stock, server.port);
+    baselineMs /= n;
+    printf("stock client:    %d full handshakes, %.2f ms per connect\n", n, baselineMs);
+  }
+
+  benchMode("session ticket:", true, n, baselineMs);
+  benchMode("session id:", false, n, baselineMs);
+  checkServerRestart();
+
+  if (failures) {
+    printf("%d check(s) failed\n", failures);
+    return 1;
+  }
+  printf("all checks passed\n");
+  return 0;
+}